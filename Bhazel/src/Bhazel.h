@@ -5,6 +5,7 @@
 #include "bzpch.h"
 
 #include "Core/Engine.h"
+#include "Core/FixedTimestep.h"
 #include "Core/Input.h"
 #include "Core/KeyCodes.h"
 #include "Core/Timer.h"
@@ -24,6 +25,7 @@
 #include "Graphics/PipelineState.h"
 #include "Graphics/Shader.h"
 #include "Graphics/Texture.h"
+#include "Graphics/TextureAtlas.h"
 
 #include "Entities/CameraController.h"
 #include "Renderer/Camera.h"
@@ -33,7 +35,16 @@
 #include "Renderer/Renderer.h"
 #include "Renderer/Renderer2D.h"
 #include "Renderer/Scene.h"
+#include "Renderer/SpriteGrid.h"
+#include "Renderer/TransformHierarchy.h"
 
 #include "Collisions/AABB.h"
 #include "Collisions/BoundingSphere.h"
-#include "Collisions/CollisionUtils.h"
\ No newline at end of file
+#include "Collisions/BVH.h"
+#include "Collisions/CollisionUtils.h"
+#include "Collisions/GridBroadphase.h"
+#include "Collisions/SweepAndPruneBroadphase.h"
+#include "Collisions/BatchIntersections.h"
+#include "Collisions/Ray.h"
+#include "Collisions/TriangleMesh.h"
+#include "Collisions/Frustum.h"
\ No newline at end of file
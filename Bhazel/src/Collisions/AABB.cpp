@@ -33,7 +33,7 @@ AABB::AABB(const glm::vec3 &center, const glm::vec3 &dimensions) : IBoundingVolu
 
 void AABB::empty() {
     min[0] = min[1] = min[2] = std::numeric_limits<float>::max();
-    max[0] = max[1] = max[2] = std::numeric_limits<float>::min();
+    max[0] = max[1] = max[2] = std::numeric_limits<float>::lowest();
 }
 
 std::unique_ptr<IBoundingVolume> AABB::clone() const {
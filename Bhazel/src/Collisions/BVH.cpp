@@ -0,0 +1,541 @@
+#include "bzpch.h"
+
+#include "BVH.h"
+
+#include "BoundingSphere.h"
+#include "CollisionUtils.h"
+#include "Frustum.h"
+
+
+namespace BZ {
+
+static AABB merge(const AABB &a, const AABB &b) {
+    AABB result(a);
+    CollisionUtils::enclose(result, b);
+    return result;
+}
+
+static float surfaceArea(const AABB &aabb) {
+    const glm::vec3 d = aabb.getDimensions();
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+// From the min and max, so a 0 margin gives back the exact same AABB, and update() finds it unchanged.
+static AABB fatten(const AABB &aabb, float margin) {
+    const glm::vec3 corners[2] = { aabb.getMin() - glm::vec3(margin), aabb.getMax() + glm::vec3(margin) };
+    return AABB(corners, 2);
+}
+
+static bool contains(const AABB &outer, const AABB &inner) {
+    return glm::all(glm::lessThanEqual(outer.getMin(), inner.getMin())) &&
+           glm::all(glm::greaterThanEqual(outer.getMax(), inner.getMax()));
+}
+
+/*
+ * Traversal stack. On the program stack while small enough, to not allocate on every query.
+ */
+template <typename T> class TraversalStack {
+  public:
+    void push(const T &node) {
+        if (count < LOCAL_SIZE) {
+            local[count] = node;
+        }
+        else {
+            overflow.push_back(node);
+        }
+        count++;
+    }
+
+    T pop() {
+        count--;
+        if (count < LOCAL_SIZE) {
+            return local[count];
+        }
+        const T node = overflow.back();
+        overflow.pop_back();
+        return node;
+    }
+
+    bool isEmpty() const { return count == 0; }
+
+  private:
+    static constexpr uint32 LOCAL_SIZE = 64;
+
+    T local[LOCAL_SIZE];
+    std::vector<T> overflow;
+    uint32 count = 0;
+};
+
+using NodeStack = TraversalStack<uint32>;
+
+
+/*-------------------------------------------------------------------------------------------*/
+BVH::BVH(float margin) : margin(margin) {
+}
+
+uint32 BVH::insert(const AABB &aabb, uint32 userData) {
+    const uint32 leaf = allocateNode();
+    nodes[leaf].aabb = fatten(aabb, margin);
+    nodes[leaf].userData = userData;
+
+    insertLeaf(leaf);
+    proxyCount++;
+    return leaf;
+}
+
+void BVH::remove(uint32 proxy) {
+    BZ_ASSERT_CORE(proxy < nodes.size() && nodes[proxy].height == 0, "Invalid proxy!");
+
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount--;
+}
+
+bool BVH::update(uint32 proxy, const AABB &aabb) {
+    BZ_ASSERT_CORE(proxy < nodes.size() && nodes[proxy].height == 0, "Invalid proxy!");
+
+    if (contains(nodes[proxy].aabb, aabb)) {
+        return false;
+    }
+
+    const AABB fatAABB = fatten(aabb, margin);
+    const uint32 parent = nodes[proxy].parent;
+
+    // Refit in place while the proxy stays inside its parent. Otherwise it's on the wrong branch, reinsert it.
+    if (parent != NULL_NODE && contains(nodes[parent].aabb, fatAABB)) {
+        nodes[proxy].aabb = fatAABB;
+        refitAncestors(parent);
+    }
+    else {
+        removeLeaf(proxy);
+        nodes[proxy].aabb = fatAABB;
+        insertLeaf(proxy);
+    }
+    return true;
+}
+
+void BVH::rebuild() {
+    BZ_PROFILE_FUNCTION();
+
+    std::vector<uint32> leaves;
+    leaves.reserve(proxyCount);
+    for (uint32 i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].height == 0) {
+            leaves.push_back(i);
+        }
+        else if (nodes[i].height > 0) {
+            freeNode(i);
+        }
+    }
+
+    root = leaves.empty() ? NULL_NODE : buildRecursive(leaves.data(), static_cast<uint32>(leaves.size()));
+    if (root != NULL_NODE) {
+        nodes[root].parent = NULL_NODE;
+    }
+}
+
+void BVH::clear() {
+    nodes.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+    proxyCount = 0;
+}
+
+float BVH::getCost() const {
+    if (root == NULL_NODE || nodes[root].isLeaf()) {
+        return 0.0f;
+    }
+
+    float internalArea = 0.0f;
+    for (const Node &node : nodes) {
+        if (node.height > 0) {
+            internalArea += surfaceArea(node.aabb);
+        }
+    }
+    return internalArea / surfaceArea(nodes[root].aabb);
+}
+
+void BVH::queryAABB(const AABB &aabb, const QueryFn &fn) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    NodeStack stack;
+    stack.push(root);
+    while (!stack.isEmpty()) {
+        const Node &node = nodes[stack.pop()];
+        if (CollisionUtils::overlaps(node.aabb, aabb)) {
+            if (node.isLeaf()) {
+                if (!fn(node.userData)) {
+                    return;
+                }
+            }
+            else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+}
+
+void BVH::querySphere(const BoundingSphere &sphere, const QueryFn &fn) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    NodeStack stack;
+    stack.push(root);
+    while (!stack.isEmpty()) {
+        const Node &node = nodes[stack.pop()];
+        if (CollisionUtils::overlaps(node.aabb, sphere)) {
+            if (node.isLeaf()) {
+                if (!fn(node.userData)) {
+                    return;
+                }
+            }
+            else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+}
+
+void BVH::queryFrustum(const Frustum &frustum, const QueryFn &fn) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    // Children only test the planes their parent is not fully inside of, none for whole visible subtrees.
+    struct Entry {
+        uint32 node;
+        uint32 planeMask;
+    };
+
+    uint32 lastPlane = 0;
+    TraversalStack<Entry> stack;
+    stack.push({ root, Frustum::ALL_PLANES_MASK });
+    while (!stack.isEmpty()) {
+        Entry entry = stack.pop();
+        const Node &node = nodes[entry.node];
+        if (entry.planeMask != 0 &&
+            frustum.test(node.aabb, entry.planeMask, lastPlane) == Frustum::TestResult::Outside) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            if (!fn(node.userData)) {
+                return;
+            }
+        }
+        else {
+            stack.push({ node.child1, entry.planeMask });
+            stack.push({ node.child2, entry.planeMask });
+        }
+    }
+}
+
+void BVH::raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                  const RaycastFn &fn) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+
+    const glm::vec3 invDirection = CollisionUtils::safeInverse(direction);
+
+    NodeStack stack;
+    stack.push(root);
+    while (!stack.isEmpty()) {
+        const Node &node = nodes[stack.pop()];
+        if (CollisionUtils::overlapsRay(node.aabb, origin, invDirection, maxDistance)) {
+            if (node.isLeaf()) {
+                maxDistance = fn(node.userData, maxDistance);
+                if (maxDistance <= 0.0f) {
+                    return;
+                }
+            }
+            else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+}
+
+uint32 BVH::allocateNode() {
+    uint32 index;
+    if (freeList == NULL_NODE) {
+        index = static_cast<uint32>(nodes.size());
+        nodes.emplace_back();
+    }
+    else {
+        index = freeList;
+        freeList = nodes[index].parent;
+    }
+
+    Node &node = nodes[index];
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+    node.userData = 0;
+    return index;
+}
+
+void BVH::freeNode(uint32 node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+void BVH::insertLeaf(uint32 leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // Descend by the SAH, stopping when making a sibling here is cheaper than going further down.
+    const AABB leafAABB = nodes[leaf].aabb;
+    uint32 index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node &node = nodes[index];
+        const float area = surfaceArea(node.aabb);
+        const float combinedArea = surfaceArea(merge(node.aabb, leafAABB));
+
+        const float siblingCost = 2.0f * combinedArea;
+
+        // Every node below will grow by at least this much.
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [this, &leafAABB, inheritanceCost](uint32 child) {
+            const Node &childNode = nodes[child];
+            const float newArea = surfaceArea(merge(childNode.aabb, leafAABB));
+            return childNode.isLeaf() ? newArea + inheritanceCost
+                                      : newArea - surfaceArea(childNode.aabb) + inheritanceCost;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+
+        if (siblingCost < cost1 && siblingCost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const uint32 sibling = index;
+    const uint32 oldParent = nodes[sibling].parent;
+    const uint32 newParent = allocateNode();
+
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root = newParent;
+    }
+    else if (nodes[oldParent].child1 == sibling) {
+        nodes[oldParent].child1 = newParent;
+    }
+    else {
+        nodes[oldParent].child2 = newParent;
+    }
+
+    refitAncestors(newParent);
+}
+
+void BVH::removeLeaf(uint32 leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    const uint32 parent = nodes[leaf].parent;
+    const uint32 grandParent = nodes[parent].parent;
+    const uint32 sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    freeNode(parent);
+    nodes[sibling].parent = grandParent;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+    }
+    else {
+        if (nodes[grandParent].child1 == parent) {
+            nodes[grandParent].child1 = sibling;
+        }
+        else {
+            nodes[grandParent].child2 = sibling;
+        }
+        refitAncestors(grandParent);
+    }
+}
+
+void BVH::refitAncestors(uint32 node) {
+    while (node != NULL_NODE) {
+        recomputeNode(node);
+        rotate(node);
+        node = nodes[node].parent;
+    }
+}
+
+/*
+ * Tries swapping each child with a grandchild under the other child. The AABB of the node doesn't change, but the one
+ * of the child receiving the swapped node does, so keep the swap that shrinks it the most, if any.
+ */
+void BVH::rotate(uint32 node) {
+    if (nodes[node].height < 2) {
+        return;
+    }
+
+    const uint32 children[2] = { nodes[node].child1, nodes[node].child2 };
+
+    float bestGain = 0.0f;
+    uint32 bestChild = NULL_NODE;
+    uint32 bestGrandChild = NULL_NODE;
+
+    for (uint32 side = 0; side < 2; ++side) {
+        const uint32 child = children[side];
+        const Node &other = nodes[children[1 - side]];
+        if (other.isLeaf()) {
+            continue;
+        }
+
+        const float otherArea = surfaceArea(other.aabb);
+        const uint32 grandChildren[2] = { other.child1, other.child2 };
+        for (uint32 i = 0; i < 2; ++i) {
+            // The other child would enclose this child and the grandchild that stays.
+            const float gain = otherArea - surfaceArea(merge(nodes[child].aabb, nodes[grandChildren[1 - i]].aabb));
+            if (gain > bestGain) {
+                bestGain = gain;
+                bestChild = child;
+                bestGrandChild = grandChildren[i];
+            }
+        }
+    }
+
+    if (bestChild == NULL_NODE) {
+        return;
+    }
+
+    const uint32 other = nodes[bestGrandChild].parent;
+
+    if (nodes[node].child1 == bestChild) {
+        nodes[node].child1 = bestGrandChild;
+    }
+    else {
+        nodes[node].child2 = bestGrandChild;
+    }
+    if (nodes[other].child1 == bestGrandChild) {
+        nodes[other].child1 = bestChild;
+    }
+    else {
+        nodes[other].child2 = bestChild;
+    }
+    nodes[bestGrandChild].parent = node;
+    nodes[bestChild].parent = other;
+
+    recomputeNode(other);
+    recomputeNode(node);
+}
+
+void BVH::recomputeNode(uint32 node) {
+    Node &n = nodes[node];
+    n.aabb = merge(nodes[n.child1].aabb, nodes[n.child2].aabb);
+    n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+}
+
+/*
+ * Top-down build. Splits by the cheapest SAH bin boundary on the axis where the leaf centers spread the most, falling
+ * back to a median split when the centers are too close to separate.
+ */
+uint32 BVH::buildRecursive(uint32 *leaves, uint32 count) {
+    if (count == 1) {
+        return leaves[0];
+    }
+
+    AABB centerBounds;
+    for (uint32 i = 0; i < count; ++i) {
+        centerBounds.enclose(nodes[leaves[i]].aabb.getCenter());
+    }
+    const glm::vec3 extent = centerBounds.getDimensions();
+    const uint32 axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+
+    uint32 splitCount = 0;
+
+    if (extent[axis] > 0.0f) {
+        const float minCenter = centerBounds.getMin()[axis];
+        const float binScale = SAH_BIN_COUNT / extent[axis];
+        auto binOf = [this, axis, minCenter, binScale](uint32 leaf) {
+            const float center = nodes[leaf].aabb.getCenter()[axis];
+            return std::min(static_cast<uint32>((center - minCenter) * binScale), SAH_BIN_COUNT - 1);
+        };
+
+        AABB binAABBs[SAH_BIN_COUNT];
+        uint32 binCounts[SAH_BIN_COUNT] = {};
+        for (uint32 i = 0; i < count; ++i) {
+            const uint32 bin = binOf(leaves[i]);
+            CollisionUtils::enclose(binAABBs[bin], nodes[leaves[i]].aabb);
+            binCounts[bin]++;
+        }
+
+        // Areas and counts of everything right of each boundary.
+        float rightAreas[SAH_BIN_COUNT];
+        uint32 rightCounts[SAH_BIN_COUNT];
+        AABB accumulated;
+        uint32 accumulatedCount = 0;
+        for (uint32 i = SAH_BIN_COUNT - 1; i > 0; --i) {
+            if (binCounts[i] > 0) {
+                CollisionUtils::enclose(accumulated, binAABBs[i]);
+                accumulatedCount += binCounts[i];
+            }
+            rightAreas[i] = accumulatedCount > 0 ? surfaceArea(accumulated) : 0.0f;
+            rightCounts[i] = accumulatedCount;
+        }
+
+        float bestCost = std::numeric_limits<float>::max();
+        uint32 bestBoundary = 0;
+        accumulated.empty();
+        accumulatedCount = 0;
+        for (uint32 i = 1; i < SAH_BIN_COUNT; ++i) {
+            if (binCounts[i - 1] > 0) {
+                CollisionUtils::enclose(accumulated, binAABBs[i - 1]);
+                accumulatedCount += binCounts[i - 1];
+            }
+            if (accumulatedCount > 0 && rightCounts[i] > 0) {
+                const float cost = accumulatedCount * surfaceArea(accumulated) + rightCounts[i] * rightAreas[i];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestBoundary = i;
+                }
+            }
+        }
+
+        if (bestBoundary > 0) {
+            uint32 *middle = std::partition(leaves, leaves + count,
+                                            [&binOf, bestBoundary](uint32 leaf) { return binOf(leaf) < bestBoundary; });
+            splitCount = static_cast<uint32>(middle - leaves);
+        }
+    }
+
+    if (splitCount == 0 || splitCount == count) {
+        splitCount = count / 2;
+        std::nth_element(leaves, leaves + splitCount, leaves + count, [this, axis](uint32 a, uint32 b) {
+            return nodes[a].aabb.getCenter()[axis] < nodes[b].aabb.getCenter()[axis];
+        });
+    }
+
+    const uint32 child1 = buildRecursive(leaves, splitCount);
+    const uint32 child2 = buildRecursive(leaves + splitCount, count - splitCount);
+
+    const uint32 node = allocateNode();
+    nodes[node].child1 = child1;
+    nodes[node].child2 = child2;
+    nodes[child1].parent = node;
+    nodes[child2].parent = node;
+    recomputeNode(node);
+    return node;
+}
+}
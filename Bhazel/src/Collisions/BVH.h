@@ -0,0 +1,99 @@
+#pragma once
+
+#include "AABB.h"
+
+
+namespace BZ {
+
+class BoundingSphere;
+class Frustum;
+
+/*
+ * Dynamic bounding volume hierarchy of AABBs, each one tagged with user data (ex: an Entity index).
+ * Proxies are stored enlarged by a margin, so small movements don't touch the tree. Past it, a proxy still inside its
+ * parent is refit in place, otherwise it's reinserted. Ancestors are refit on the way up, rotating subtrees when that
+ * lowers their surface area.
+ * New proxies are inserted by the surface area heuristic (SAH), and rebuild() rebuilds the whole tree top-down with a
+ * binned SAH, which is the best option for proxies that don't move.
+ * Proxy ids are stable for the lifetime of the proxy, including across rebuilds.
+ */
+class BVH {
+  public:
+    static constexpr uint32 INVALID_PROXY = 0xffffffff;
+
+    // Return false to stop the query.
+    using QueryFn = std::function<bool(uint32 userData)>;
+
+    // Receives the current max distance of the ray and returns the new one. Return 0 to stop, or maxDistance to go on.
+    using RaycastFn = std::function<float(uint32 userData, float maxDistance)>;
+
+    explicit BVH(float margin = 0.0f);
+
+    BZ_NON_COPYABLE(BVH);
+
+    uint32 insert(const AABB &aabb, uint32 userData);
+    void remove(uint32 proxy);
+
+    // Returns true if the tree was touched, false if the AABB still fits on the enlarged one.
+    bool update(uint32 proxy, const AABB &aabb);
+
+    void rebuild();
+    void clear();
+
+    // Enlarged by the margin.
+    const AABB &getFatAABB(uint32 proxy) const { return nodes[proxy].aabb; }
+    uint32 getUserData(uint32 proxy) const { return nodes[proxy].userData; }
+
+    uint32 getProxyCount() const { return proxyCount; }
+    uint32 getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+    // Sum of the surface areas of the internal nodes over the root one. Lower is better.
+    float getCost() const;
+
+    void queryAABB(const AABB &aabb, const QueryFn &fn) const;
+    void querySphere(const BoundingSphere &sphere, const QueryFn &fn) const;
+
+    void queryFrustum(const Frustum &frustum, const QueryFn &fn) const;
+
+    // Distances are in units of direction, which doesn't need to be normalized.
+    void raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, const RaycastFn &fn) const;
+
+  private:
+    static constexpr uint32 NULL_NODE = 0xffffffff;
+    static constexpr uint32 SAH_BIN_COUNT = 12;
+
+    struct Node {
+        AABB aabb;
+
+        // Next free node when on the free list.
+        uint32 parent;
+        uint32 child1;
+        uint32 child2;
+
+        // Leaves have 0, free nodes -1.
+        int32 height;
+        uint32 userData;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    uint32 root = NULL_NODE;
+    uint32 freeList = NULL_NODE;
+    uint32 proxyCount = 0;
+    float margin;
+
+    uint32 allocateNode();
+    void freeNode(uint32 node);
+
+    void insertLeaf(uint32 leaf);
+    void removeLeaf(uint32 leaf);
+
+    // Walks up from the node recomputing the AABBs and heights, rotating along the way.
+    void refitAncestors(uint32 node);
+    void rotate(uint32 node);
+    void recomputeNode(uint32 node);
+
+    uint32 buildRecursive(uint32 *leaves, uint32 count);
+};
+}
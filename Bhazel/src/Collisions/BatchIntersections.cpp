@@ -0,0 +1,328 @@
+#include "bzpch.h"
+
+#include "BatchIntersections.h"
+
+#include "AABB.h"
+#include "BoundingSphere.h"
+#include "CollisionUtils.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BZ_BATCH_SSE
+#endif
+
+
+namespace BZ {
+
+/*
+ * The kernels are written once, as generic lambdas over one of these. SimdOps processes the bulk of a batch and
+ * ScalarOps the remainder, using exactly the same math.
+ */
+struct ScalarOps {
+    using Float = float;
+    using Mask = bool;
+    static constexpr uint32 WIDTH = 1;
+
+    static Float load(const float *p) { return *p; }
+    static Float set(float v) { return v; }
+    static Float add(Float a, Float b) { return a + b; }
+    static Float sub(Float a, Float b) { return a - b; }
+    static Float mul(Float a, Float b) { return a * b; }
+    static Float min(Float a, Float b) { return glm::min(a, b); }
+    static Float max(Float a, Float b) { return glm::max(a, b); }
+    static Mask lessEqual(Float a, Float b) { return a <= b; }
+    static Mask greaterEqual(Float a, Float b) { return a >= b; }
+    static Mask both(Mask a, Mask b) { return a && b; }
+    static uint32 moveMask(Mask m) { return m ? 1 : 0; }
+};
+
+#if defined(__AVX__)
+struct SimdOps {
+    using Float = __m256;
+    using Mask = __m256;
+    static constexpr uint32 WIDTH = 8;
+
+    static Float load(const float *p) { return _mm256_loadu_ps(p); }
+    static Float set(float v) { return _mm256_set1_ps(v); }
+    static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm256_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm256_max_ps(a, b); }
+    static Mask lessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static Mask greaterEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static Mask both(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+    static uint32 moveMask(Mask m) { return static_cast<uint32>(_mm256_movemask_ps(m)); }
+};
+#elif defined(BZ_BATCH_SSE)
+struct SimdOps {
+    using Float = __m128;
+    using Mask = __m128;
+    static constexpr uint32 WIDTH = 4;
+
+    static Float load(const float *p) { return _mm_loadu_ps(p); }
+    static Float set(float v) { return _mm_set1_ps(v); }
+    static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm_max_ps(a, b); }
+    static Mask lessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+    static Mask greaterEqual(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+    static Mask both(Mask a, Mask b) { return _mm_and_ps(a, b); }
+    static uint32 moveMask(Mask m) { return static_cast<uint32>(_mm_movemask_ps(m)); }
+};
+#else
+using SimdOps = ScalarOps;
+#endif
+
+// The widths divide 32, so a SIMD block never spans two mask words.
+template <typename Kernel> static void runKernel(uint32 count, uint32 outMask[], const Kernel &kernel) {
+    std::fill(outMask, outMask + BatchIntersections::getMaskWordCount(count), 0u);
+
+    uint32 i = 0;
+    for (; i + SimdOps::WIDTH <= count; i += SimdOps::WIDTH) {
+        outMask[i / 32] |= SimdOps::moveMask(kernel(SimdOps(), i)) << (i % 32);
+    }
+    for (; i < count; ++i) {
+        outMask[i / 32] |= ScalarOps::moveMask(kernel(ScalarOps(), i)) << (i % 32);
+    }
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+void AABBBatch::add(const AABB &aabb) {
+    minX.push_back(aabb.getMin().x);
+    minY.push_back(aabb.getMin().y);
+    minZ.push_back(aabb.getMin().z);
+    maxX.push_back(aabb.getMax().x);
+    maxY.push_back(aabb.getMax().y);
+    maxZ.push_back(aabb.getMax().z);
+}
+
+void AABBBatch::set(uint32 index, const AABB &aabb) {
+    minX[index] = aabb.getMin().x;
+    minY[index] = aabb.getMin().y;
+    minZ[index] = aabb.getMin().z;
+    maxX[index] = aabb.getMax().x;
+    maxY[index] = aabb.getMax().y;
+    maxZ[index] = aabb.getMax().z;
+}
+
+void AABBBatch::reserve(uint32 count) {
+    for (auto *array : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ }) {
+        array->reserve(count);
+    }
+}
+
+void AABBBatch::clear() {
+    for (auto *array : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ }) {
+        array->clear();
+    }
+}
+
+void SphereBatch::add(const BoundingSphere &sphere) {
+    centerX.push_back(sphere.getCenter().x);
+    centerY.push_back(sphere.getCenter().y);
+    centerZ.push_back(sphere.getCenter().z);
+    radius.push_back(sphere.getRadius());
+}
+
+void SphereBatch::set(uint32 index, const BoundingSphere &sphere) {
+    centerX[index] = sphere.getCenter().x;
+    centerY[index] = sphere.getCenter().y;
+    centerZ[index] = sphere.getCenter().z;
+    radius[index] = sphere.getRadius();
+}
+
+void SphereBatch::reserve(uint32 count) {
+    for (auto *array : { &centerX, &centerY, &centerZ, &radius }) {
+        array->reserve(count);
+    }
+}
+
+void SphereBatch::clear() {
+    for (auto *array : { &centerX, &centerY, &centerZ, &radius }) {
+        array->clear();
+    }
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+uint32 BatchIntersections::getSimdWidth() {
+    return SimdOps::WIDTH;
+}
+
+void BatchIntersections::overlaps(const AABBBatch &batch, const AABB &aabb, uint32 outMask[]) {
+    const glm::vec3 &min = aabb.getMin();
+    const glm::vec3 &max = aabb.getMax();
+
+    runKernel(batch.getCount(), outMask, [&](auto ops, uint32 i) {
+        using Ops = decltype(ops);
+        const auto x = Ops::both(Ops::lessEqual(Ops::load(&batch.minX[i]), Ops::set(max.x)),
+                                 Ops::greaterEqual(Ops::load(&batch.maxX[i]), Ops::set(min.x)));
+        const auto y = Ops::both(Ops::lessEqual(Ops::load(&batch.minY[i]), Ops::set(max.y)),
+                                 Ops::greaterEqual(Ops::load(&batch.maxY[i]), Ops::set(min.y)));
+        const auto z = Ops::both(Ops::lessEqual(Ops::load(&batch.minZ[i]), Ops::set(max.z)),
+                                 Ops::greaterEqual(Ops::load(&batch.maxZ[i]), Ops::set(min.z)));
+        return Ops::both(Ops::both(x, y), z);
+    });
+}
+
+void BatchIntersections::overlaps(const AABBBatch &batch, const BoundingSphere &sphere, uint32 outMask[]) {
+    const glm::vec3 center = sphere.getCenter();
+    const float radiusSq = sphere.getRadius() * sphere.getRadius();
+
+    runKernel(batch.getCount(), outMask, [&](auto ops, uint32 i) {
+        using Ops = decltype(ops);
+
+        // From the closest point on the AABB to the center.
+        const auto cx = Ops::set(center.x);
+        const auto cy = Ops::set(center.y);
+        const auto cz = Ops::set(center.z);
+        const auto dx = Ops::sub(Ops::min(Ops::max(cx, Ops::load(&batch.minX[i])), Ops::load(&batch.maxX[i])), cx);
+        const auto dy = Ops::sub(Ops::min(Ops::max(cy, Ops::load(&batch.minY[i])), Ops::load(&batch.maxY[i])), cy);
+        const auto dz = Ops::sub(Ops::min(Ops::max(cz, Ops::load(&batch.minZ[i])), Ops::load(&batch.maxZ[i])), cz);
+        const auto distSq = Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz));
+        return Ops::lessEqual(distSq, Ops::set(radiusSq));
+    });
+}
+
+void BatchIntersections::overlapsFrustum(const AABBBatch &batch, const glm::vec4 planes[6], uint32 outMask[]) {
+    // The corner furthest along each plane normal, picked once per plane.
+    const float *cornerX[6];
+    const float *cornerY[6];
+    const float *cornerZ[6];
+    for (uint32 p = 0; p < 6; ++p) {
+        cornerX[p] = planes[p].x >= 0.0f ? batch.maxX.data() : batch.minX.data();
+        cornerY[p] = planes[p].y >= 0.0f ? batch.maxY.data() : batch.minY.data();
+        cornerZ[p] = planes[p].z >= 0.0f ? batch.maxZ.data() : batch.minZ.data();
+    }
+
+    runKernel(batch.getCount(), outMask, [&](auto ops, uint32 i) {
+        using Ops = decltype(ops);
+        auto planeTest = [&](uint32 p) {
+            const auto dot = Ops::add(Ops::add(Ops::mul(Ops::set(planes[p].x), Ops::load(cornerX[p] + i)),
+                                               Ops::mul(Ops::set(planes[p].y), Ops::load(cornerY[p] + i))),
+                                      Ops::mul(Ops::set(planes[p].z), Ops::load(cornerZ[p] + i)));
+            return Ops::greaterEqual(Ops::add(dot, Ops::set(planes[p].w)), Ops::set(0.0f));
+        };
+
+        auto inside = planeTest(0);
+        for (uint32 p = 1; p < 6; ++p) {
+            inside = Ops::both(inside, planeTest(p));
+        }
+        return inside;
+    });
+}
+
+void BatchIntersections::overlapsRay(const AABBBatch &batch, const glm::vec3 &origin, const glm::vec3 &direction,
+                                     float maxDistance, uint32 outMask[]) {
+    const glm::vec3 invDirection = CollisionUtils::safeInverse(direction);
+
+    runKernel(batch.getCount(), outMask, [&](auto ops, uint32 i) {
+        using Ops = decltype(ops);
+
+        // Slab test.
+        auto slab = [&](const float *min, const float *max, float o, float invD, auto &outEnter, auto &outExit) {
+            const auto t1 = Ops::mul(Ops::sub(Ops::load(min + i), Ops::set(o)), Ops::set(invD));
+            const auto t2 = Ops::mul(Ops::sub(Ops::load(max + i), Ops::set(o)), Ops::set(invD));
+            outEnter = Ops::min(t1, t2);
+            outExit = Ops::max(t1, t2);
+        };
+
+        typename Ops::Float enterX, exitX, enterY, exitY, enterZ, exitZ;
+        slab(batch.minX.data(), batch.maxX.data(), origin.x, invDirection.x, enterX, exitX);
+        slab(batch.minY.data(), batch.maxY.data(), origin.y, invDirection.y, enterY, exitY);
+        slab(batch.minZ.data(), batch.maxZ.data(), origin.z, invDirection.z, enterZ, exitZ);
+
+        const auto enter = Ops::max(Ops::max(enterX, enterY), Ops::max(enterZ, Ops::set(0.0f)));
+        const auto exit = Ops::min(Ops::min(exitX, exitY), Ops::min(exitZ, Ops::set(maxDistance)));
+        return Ops::lessEqual(enter, exit);
+    });
+}
+
+void BatchIntersections::overlaps(const SphereBatch &batch, const AABB &aabb, uint32 outMask[]) {
+    const glm::vec3 &min = aabb.getMin();
+    const glm::vec3 &max = aabb.getMax();
+
+    runKernel(batch.getCount(), outMask, [&](auto ops, uint32 i) {
+        using Ops = decltype(ops);
+
+        // From each center to the closest point on the AABB.
+        const auto cx = Ops::load(&batch.centerX[i]);
+        const auto cy = Ops::load(&batch.centerY[i]);
+        const auto cz = Ops::load(&batch.centerZ[i]);
+        const auto dx = Ops::sub(Ops::min(Ops::max(cx, Ops::set(min.x)), Ops::set(max.x)), cx);
+        const auto dy = Ops::sub(Ops::min(Ops::max(cy, Ops::set(min.y)), Ops::set(max.y)), cy);
+        const auto dz = Ops::sub(Ops::min(Ops::max(cz, Ops::set(min.z)), Ops::set(max.z)), cz);
+        const auto distSq = Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz));
+        const auto radius = Ops::load(&batch.radius[i]);
+        return Ops::lessEqual(distSq, Ops::mul(radius, radius));
+    });
+}
+
+void BatchIntersections::overlaps(const SphereBatch &batch, const BoundingSphere &sphere, uint32 outMask[]) {
+    const glm::vec3 center = sphere.getCenter();
+    const float sphereRadius = sphere.getRadius();
+
+    runKernel(batch.getCount(), outMask, [&](auto ops, uint32 i) {
+        using Ops = decltype(ops);
+        const auto dx = Ops::sub(Ops::set(center.x), Ops::load(&batch.centerX[i]));
+        const auto dy = Ops::sub(Ops::set(center.y), Ops::load(&batch.centerY[i]));
+        const auto dz = Ops::sub(Ops::set(center.z), Ops::load(&batch.centerZ[i]));
+        const auto distSq = Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz));
+        const auto radiusSum = Ops::add(Ops::load(&batch.radius[i]), Ops::set(sphereRadius));
+        return Ops::lessEqual(distSq, Ops::mul(radiusSum, radiusSum));
+    });
+}
+
+void BatchIntersections::overlapsFrustum(const SphereBatch &batch, const glm::vec4 planes[6], uint32 outMask[]) {
+    runKernel(batch.getCount(), outMask, [&](auto ops, uint32 i) {
+        using Ops = decltype(ops);
+        const auto cx = Ops::load(&batch.centerX[i]);
+        const auto cy = Ops::load(&batch.centerY[i]);
+        const auto cz = Ops::load(&batch.centerZ[i]);
+        const auto negRadius = Ops::sub(Ops::set(0.0f), Ops::load(&batch.radius[i]));
+
+        auto planeTest = [&](uint32 p) {
+            const auto dot = Ops::add(Ops::add(Ops::mul(Ops::set(planes[p].x), cx),
+                                               Ops::mul(Ops::set(planes[p].y), cy)),
+                                      Ops::mul(Ops::set(planes[p].z), cz));
+            return Ops::greaterEqual(Ops::add(dot, Ops::set(planes[p].w)), negRadius);
+        };
+
+        auto inside = planeTest(0);
+        for (uint32 p = 1; p < 6; ++p) {
+            inside = Ops::both(inside, planeTest(p));
+        }
+        return inside;
+    });
+}
+
+void BatchIntersections::overlapsRay(const SphereBatch &batch, const glm::vec3 &origin, const glm::vec3 &direction,
+                                     float maxDistance, uint32 outMask[]) {
+    const float invLengthSq = CollisionUtils::safeInverse(glm::dot(direction, direction));
+
+    runKernel(batch.getCount(), outMask, [&](auto ops, uint32 i) {
+        using Ops = decltype(ops);
+
+        // From each center to the closest point of the segment.
+        const auto tx = Ops::sub(Ops::load(&batch.centerX[i]), Ops::set(origin.x));
+        const auto ty = Ops::sub(Ops::load(&batch.centerY[i]), Ops::set(origin.y));
+        const auto tz = Ops::sub(Ops::load(&batch.centerZ[i]), Ops::set(origin.z));
+        const auto dot = Ops::add(Ops::add(Ops::mul(tx, Ops::set(direction.x)), Ops::mul(ty, Ops::set(direction.y))),
+                                  Ops::mul(tz, Ops::set(direction.z)));
+        const auto t = Ops::min(Ops::max(Ops::mul(dot, Ops::set(invLengthSq)), Ops::set(0.0f)), Ops::set(maxDistance));
+
+        const auto dx = Ops::sub(tx, Ops::mul(Ops::set(direction.x), t));
+        const auto dy = Ops::sub(ty, Ops::mul(Ops::set(direction.y), t));
+        const auto dz = Ops::sub(tz, Ops::mul(Ops::set(direction.z), t));
+        const auto distSq = Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz));
+        const auto radius = Ops::load(&batch.radius[i]);
+        return Ops::lessEqual(distSq, Ops::mul(radius, radius));
+    });
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+
+namespace BZ {
+
+class AABB;
+class BoundingSphere;
+
+/*
+ * Many AABBs packed as arrays (SoA), for the batch tests on BatchIntersections.
+ */
+struct AABBBatch {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    void add(const AABB &aabb);
+    void set(uint32 index, const AABB &aabb);
+    void reserve(uint32 count);
+    void clear();
+
+    uint32 getCount() const { return static_cast<uint32>(minX.size()); }
+};
+
+/*
+ * Many BoundingSpheres packed as arrays (SoA), for the batch tests on BatchIntersections.
+ */
+struct SphereBatch {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> radius;
+
+    void add(const BoundingSphere &sphere);
+    void set(uint32 index, const BoundingSphere &sphere);
+    void reserve(uint32 count);
+    void clear();
+
+    uint32 getCount() const { return static_cast<uint32>(centerX.size()); }
+};
+
+/*
+ * Tests one volume against a whole batch, writing a bitmask with bit (i % 32) of word (i / 32) set when element i
+ * overlaps. Use getMaskWordCount() to size the mask.
+ * Uses AVX when compiled with it, SSE on x86 otherwise, and falls back to scalar code. The results match the boolean
+ * CollisionUtils::overlaps*() functions.
+ */
+namespace BatchIntersections {
+
+    inline uint32 getMaskWordCount(uint32 count) { return (count + 31) / 32; }
+    inline bool isBitSet(const uint32 mask[], uint32 index) { return (mask[index / 32] & (1u << (index % 32))) != 0; }
+
+    // Number of floats processed at once. 1 for the scalar fallback.
+    uint32 getSimdWidth();
+
+    void overlaps(const AABBBatch &batch, const AABB &aabb, uint32 outMask[]);
+    void overlaps(const AABBBatch &batch, const BoundingSphere &sphere, uint32 outMask[]);
+    void overlapsFrustum(const AABBBatch &batch, const glm::vec4 planes[6], uint32 outMask[]);
+    void overlapsRay(const AABBBatch &batch, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                     uint32 outMask[]);
+
+    void overlaps(const SphereBatch &batch, const AABB &aabb, uint32 outMask[]);
+    void overlaps(const SphereBatch &batch, const BoundingSphere &sphere, uint32 outMask[]);
+    void overlapsFrustum(const SphereBatch &batch, const glm::vec4 planes[6], uint32 outMask[]);
+    void overlapsRay(const SphereBatch &batch, const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                     uint32 outMask[]);
+}
+}
@@ -0,0 +1,81 @@
+#include "bzpch.h"
+
+#include "Broadphase.h"
+
+#include "BoundingSphere.h"
+
+
+namespace BZ {
+
+static AABB computeAABB(const IBoundingVolume &volume) {
+    if (volume.getType() == BoundingVolumeType::Sphere) {
+        const BoundingSphere &sphere = static_cast<const BoundingSphere &>(volume);
+        return AABB(sphere.getCenter(), glm::vec3(sphere.getRadius() * 2.0f));
+    }
+    return static_cast<const AABB &>(volume);
+}
+
+uint32 Broadphase::addCollider(const IBoundingVolume &volume, uint32 userData) {
+    uint32 collider;
+    if (freeColliders.empty()) {
+        collider = static_cast<uint32>(colliders.size());
+        colliders.emplace_back();
+    }
+    else {
+        collider = freeColliders.back();
+        freeColliders.pop_back();
+    }
+
+    Collider &newCollider = colliders[collider];
+    newCollider.volume = &volume;
+    newCollider.aabb = computeAABB(volume);
+    newCollider.userData = userData;
+    newCollider.isAlive = true;
+    colliderCount++;
+
+    onColliderAdded(collider);
+    return collider;
+}
+
+void Broadphase::removeCollider(uint32 collider) {
+    BZ_ASSERT_CORE(collider < colliders.size() && colliders[collider].isAlive, "Invalid collider!");
+
+    colliders[collider].isAlive = false;
+    onColliderRemoved(collider);
+
+    colliders[collider].volume = nullptr;
+    freeColliders.push_back(collider);
+    colliderCount--;
+}
+
+void Broadphase::updateCollider(uint32 collider) {
+    BZ_ASSERT_CORE(collider < colliders.size() && colliders[collider].isAlive, "Invalid collider!");
+
+    colliders[collider].aabb = computeAABB(*colliders[collider].volume);
+    onColliderUpdated(collider);
+}
+
+void Broadphase::findContacts(const ContactFn &fn) {
+    BZ_PROFILE_FUNCTION();
+
+    pairs.clear();
+    findPairs(pairs);
+
+    for (const ColliderPair &pair : pairs) {
+        const Collider &a = colliders[pair.first];
+        const Collider &b = colliders[pair.second];
+
+        const IntersectionResult result = a.volume->intersects(*b.volume);
+        if (result.intersects) {
+            fn(a.userData, b.userData, result);
+        }
+    }
+}
+
+void Broadphase::getPairs(std::vector<std::pair<uint32, uint32>> &outUserDataPairs) const {
+    outUserDataPairs.clear();
+    for (const ColliderPair &pair : pairs) {
+        outUserDataPairs.emplace_back(colliders[pair.first].userData, colliders[pair.second].userData);
+    }
+}
+}
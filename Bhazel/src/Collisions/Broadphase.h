@@ -0,0 +1,60 @@
+#pragma once
+
+#include "AABB.h"
+
+
+namespace BZ {
+
+/*
+ * Finds the pairs of colliders whose AABBs overlap, without testing every pair, and runs the narrowphase
+ * (IBoundingVolume::intersects()) on them. Subclasses implement the pair finding.
+ */
+class Broadphase {
+  public:
+    static constexpr uint32 INVALID_COLLIDER = 0xffffffff;
+
+    using ContactFn = std::function<void(uint32 userDataA, uint32 userDataB, const IntersectionResult &result)>;
+
+    virtual ~Broadphase() = default;
+
+    // The volume is not copied and needs to outlive the collider. Call updateCollider() after changing it.
+    uint32 addCollider(const IBoundingVolume &volume, uint32 userData);
+    void removeCollider(uint32 collider);
+    void updateCollider(uint32 collider);
+
+    // Reports the pairs that intersect, with the IntersectionResult going from A to B.
+    // Colliders can't be added or removed from the callback.
+    void findContacts(const ContactFn &fn);
+
+    uint32 getColliderCount() const { return colliderCount; }
+
+    // Overlapping pairs found by the last findContacts(), before the narrowphase. Touching AABBs overlap.
+    uint32 getPairCount() const { return static_cast<uint32>(pairs.size()); }
+    void getPairs(std::vector<std::pair<uint32, uint32>> &outUserDataPairs) const;
+
+  protected:
+    using ColliderPair = std::pair<uint32, uint32>;
+
+    struct Collider {
+        const IBoundingVolume *volume;
+        AABB aabb;
+        uint32 userData;
+        bool isAlive;
+    };
+
+    std::vector<Collider> colliders;
+
+    // Called after the Collider is set up, or marked as not alive for removals.
+    virtual void onColliderAdded(uint32 collider) = 0;
+    virtual void onColliderRemoved(uint32 collider) = 0;
+    virtual void onColliderUpdated(uint32 collider) = 0;
+
+    // Each pair only once.
+    virtual void findPairs(std::vector<ColliderPair> &outPairs) = 0;
+
+  private:
+    std::vector<uint32> freeColliders;
+    std::vector<ColliderPair> pairs;
+    uint32 colliderCount = 0;
+};
+}
@@ -76,6 +76,72 @@ IntersectionResult CollisionUtils::intersects(const BoundingSphere &sphere1, con
     return result;
 }
 
+bool CollisionUtils::overlaps(const AABB &aabb1, const AABB &aabb2) {
+    return glm::all(glm::lessThanEqual(aabb1.getMin(), aabb2.getMax())) &&
+           glm::all(glm::greaterThanEqual(aabb1.getMax(), aabb2.getMin()));
+}
+
+bool CollisionUtils::overlaps(const AABB &aabb, const BoundingSphere &sphere) {
+    const glm::vec3 d = findClosestPointOnAABB(aabb, sphere.getCenter()) - sphere.getCenter();
+    return glm::dot(d, d) <= sphere.getRadius() * sphere.getRadius();
+}
+
+bool CollisionUtils::overlaps(const BoundingSphere &sphere1, const BoundingSphere &sphere2) {
+    const glm::vec3 d = sphere2.getCenter() - sphere1.getCenter();
+    const float radiusSum = sphere1.getRadius() + sphere2.getRadius();
+    return glm::dot(d, d) <= radiusSum * radiusSum;
+}
+
+bool CollisionUtils::overlapsFrustum(const AABB &aabb, const glm::vec4 planes[6]) {
+    for (uint32 i = 0; i < 6; ++i) {
+        // The corner furthest along the plane normal.
+        const glm::vec3 normal = planes[i];
+        const glm::vec3 corner = glm::mix(aabb.getMin(), aabb.getMax(), glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+        if (glm::dot(normal, corner) + planes[i].w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CollisionUtils::overlapsFrustum(const BoundingSphere &sphere, const glm::vec4 planes[6]) {
+    for (uint32 i = 0; i < 6; ++i) {
+        if (glm::dot(glm::vec3(planes[i]), sphere.getCenter()) + planes[i].w < -sphere.getRadius()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CollisionUtils::overlapsRay(const AABB &aabb, const glm::vec3 &origin, const glm::vec3 &invDirection,
+                                 float maxDistance) {
+    const glm::vec3 t1 = (aabb.getMin() - origin) * invDirection;
+    const glm::vec3 t2 = (aabb.getMax() - origin) * invDirection;
+    const glm::vec3 tMin = glm::min(t1, t2);
+    const glm::vec3 tMax = glm::max(t1, t2);
+    const float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+    const float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+    return enter <= exit;
+}
+
+bool CollisionUtils::overlapsRay(const BoundingSphere &sphere, const glm::vec3 &origin, const glm::vec3 &direction,
+                                 float maxDistance) {
+    // Closest point of the segment to the center.
+    const glm::vec3 toCenter = sphere.getCenter() - origin;
+    const float invLengthSq = safeInverse(glm::dot(direction, direction));
+    const float t = glm::clamp(glm::dot(toCenter, direction) * invLengthSq, 0.0f, maxDistance);
+    const glm::vec3 d = toCenter - direction * t;
+    return glm::dot(d, d) <= sphere.getRadius() * sphere.getRadius();
+}
+
+float CollisionUtils::safeInverse(float x) {
+    return glm::clamp(1.0f / x, -std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+}
+
+glm::vec3 CollisionUtils::safeInverse(const glm::vec3 &v) {
+    return glm::vec3(safeInverse(v.x), safeInverse(v.y), safeInverse(v.z));
+}
+
 void CollisionUtils::enclose(AABB &encloser, const AABB &enclosee) {
     encloser.enclose(enclosee.getMin());
     encloser.enclose(enclosee.getMax());
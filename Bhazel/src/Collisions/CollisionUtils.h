@@ -15,6 +15,27 @@ namespace CollisionUtils {
     IntersectionResult intersects(const BoundingSphere &sphere, const AABB &aabb);
     IntersectionResult intersects(const BoundingSphere &sphere1, const BoundingSphere &sphere2);
 
+    // Cheaper boolean tests, for broadphases, hierarchies and culling. Unlike intersects(), touching counts as
+    // overlapping. These are the reference for the batch versions on BatchIntersections.
+    bool overlaps(const AABB &aabb1, const AABB &aabb2);
+    bool overlaps(const AABB &aabb, const BoundingSphere &sphere);
+    bool overlaps(const BoundingSphere &sphere1, const BoundingSphere &sphere2);
+
+    // Planes as (normal, distance), with the normals pointing inside.
+    bool overlapsFrustum(const AABB &aabb, const glm::vec4 planes[6]);
+    bool overlapsFrustum(const BoundingSphere &sphere, const glm::vec4 planes[6]);
+
+    // Ray segment from origin to origin + direction * maxDistance. The AABB version takes the inverse of the direction,
+    // to be computed once for many tests with safeInverse().
+    bool overlapsRay(const AABB &aabb, const glm::vec3 &origin, const glm::vec3 &invDirection, float maxDistance);
+    bool overlapsRay(const BoundingSphere &sphere, const glm::vec3 &origin, const glm::vec3 &direction,
+                     float maxDistance);
+
+    // 1 / x clamped to the finite range, so zeros give FLT_MAX with their sign. This way 0 * inverse is 0 instead of
+    // NaN, which the SIMD min and max would not propagate like the scalar ones.
+    float safeInverse(float x);
+    glm::vec3 safeInverse(const glm::vec3 &v);
+
     void enclose(AABB &encloser, const AABB &enclosee);
     void enclose(AABB &encloser, const BoundingSphere &enclosee);
     void enclose(BoundingSphere &encloser, const AABB &enclosee);
@@ -0,0 +1,134 @@
+#include "bzpch.h"
+
+#include "Frustum.h"
+
+#include "AABB.h"
+#include "CollisionUtils.h"
+
+
+namespace BZ {
+
+Frustum::Frustum(const glm::mat4 &viewProjection) {
+    const glm::mat4 m = glm::transpose(viewProjection);
+
+    // Rows of the matrix. z goes from 0 to 1, so the near plane is just the third row.
+    planes[0] = m[3] + m[0];
+    planes[1] = m[3] - m[0];
+    planes[2] = m[3] + m[1];
+    planes[3] = m[3] - m[1];
+    planes[NEAR_PLANE] = m[2];
+    planes[FAR_PLANE] = m[3] - m[2];
+
+    for (auto &plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    const glm::mat4 invViewProjection = glm::inverse(viewProjection);
+    for (uint32 i = 0; i < CORNER_COUNT; ++i) {
+        const glm::vec4 clip((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : 0.0f, 1.0f);
+        const glm::vec4 corner = invViewProjection * clip;
+        corners[i] = glm::vec3(corner) / corner.w;
+    }
+}
+
+Frustum Frustum::getSlice(float nearFraction, float farFraction) const {
+    Frustum slice(*this);
+    for (uint32 i = 0; i < 4; ++i) {
+        slice.corners[i] = glm::mix(corners[i], corners[i + 4], nearFraction);
+        slice.corners[i + 4] = glm::mix(corners[i], corners[i + 4], farFraction);
+    }
+
+    // The side planes stay the same, the near and far ones move along their normals.
+    slice.planes[NEAR_PLANE].w = -glm::dot(glm::vec3(planes[NEAR_PLANE]), slice.corners[0]);
+    slice.planes[FAR_PLANE].w = -glm::dot(glm::vec3(planes[FAR_PLANE]), slice.corners[4]);
+    return slice;
+}
+
+BoundingSphere Frustum::getBoundingSphere() const {
+    const glm::vec3 nearCenter = (corners[0] + corners[1] + corners[2] + corners[3]) * 0.25f;
+    const glm::vec3 farCenter = (corners[4] + corners[5] + corners[6] + corners[7]) * 0.25f;
+    const glm::vec3 axis = farCenter - nearCenter;
+
+    // Point on the axis at the same distance of a near corner and of the matching far one.
+    const glm::vec3 toNear = corners[0] - nearCenter;
+    const glm::vec3 toFar = corners[4] - nearCenter;
+    const float denominator = 2.0f * glm::dot(axis, toFar - toNear);
+    const float t = denominator != 0.0f
+                        ? glm::clamp((glm::dot(toFar, toFar) - glm::dot(toNear, toNear)) / denominator, 0.0f, 1.0f)
+                        : 0.5f;
+
+    const glm::vec3 center = nearCenter + axis * t;
+    return BoundingSphere(center, glm::max(glm::distance(center, corners[0]), glm::distance(center, corners[4])));
+}
+
+bool Frustum::contains(const glm::vec3 &point) const {
+    for (const auto &plane : planes) {
+        if (glm::dot(glm::vec3(plane), point) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::overlaps(const AABB &aabb) const {
+    return CollisionUtils::overlapsFrustum(aabb, planes);
+}
+
+bool Frustum::overlaps(const BoundingSphere &sphere) const {
+    return CollisionUtils::overlapsFrustum(sphere, planes);
+}
+
+template <typename PlaneTestFn>
+Frustum::TestResult Frustum::test(uint32 &inOutPlaneMask, uint32 &inOutLastPlane,
+                                  const PlaneTestFn &planeTestFn) const {
+    // Returns false if outside of the plane.
+    auto testPlane = [&](uint32 plane) {
+        const uint32 planeBit = 1 << plane;
+        if ((inOutPlaneMask & planeBit) == 0) {
+            return true;
+        }
+
+        float distance, extent;
+        planeTestFn(planes[plane], distance, extent);
+        if (distance + extent < 0.0f) {
+            inOutLastPlane = plane;
+            return false;
+        }
+        if (distance - extent >= 0.0f) {
+            inOutPlaneMask &= ~planeBit;
+        }
+        return true;
+    };
+
+    const uint32 firstPlane = inOutLastPlane;
+    if (!testPlane(firstPlane)) {
+        return TestResult::Outside;
+    }
+    for (uint32 plane = 0; plane < PLANE_COUNT; ++plane) {
+        if (plane != firstPlane && !testPlane(plane)) {
+            return TestResult::Outside;
+        }
+    }
+    return inOutPlaneMask == 0 ? TestResult::Inside : TestResult::Intersecting;
+}
+
+Frustum::TestResult Frustum::test(const AABB &aabb, uint32 &inOutPlaneMask, uint32 &inOutLastPlane) const {
+    const glm::vec3 center = aabb.getCenter();
+    const glm::vec3 halfDimensions = aabb.getDimensions() * 0.5f;
+
+    return test(inOutPlaneMask, inOutLastPlane, [&](const glm::vec4 &plane, float &outDistance, float &outExtent) {
+        outDistance = glm::dot(glm::vec3(plane), center) + plane.w;
+        outExtent = glm::dot(halfDimensions, glm::abs(glm::vec3(plane)));
+    });
+}
+
+Frustum::TestResult Frustum::test(const BoundingSphere &sphere, uint32 &inOutPlaneMask, uint32 &inOutLastPlane) const {
+    const glm::vec3 center = sphere.getCenter();
+    const float radius = sphere.getRadius();
+
+    return test(inOutPlaneMask, inOutLastPlane, [&](const glm::vec4 &plane, float &outDistance, float &outExtent) {
+        outDistance = glm::dot(glm::vec3(plane), center) + plane.w;
+        outExtent = radius;
+    });
+}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "BoundingSphere.h"
+
+
+namespace BZ {
+
+class AABB;
+
+/*
+ * Six planes as (normal, distance), with the normals pointing inside, and the eight corners of a view projection
+ * volume. The planes are extracted straight from the matrix (Gribb-Hartmann), for the Vulkan clip space.
+ */
+class Frustum {
+  public:
+    static constexpr uint32 PLANE_COUNT = 6;
+    static constexpr uint32 CORNER_COUNT = 8;
+    static constexpr uint32 ALL_PLANES_MASK = (1 << PLANE_COUNT) - 1;
+
+    enum class TestResult { Outside, Intersecting, Inside };
+
+    Frustum() = default;
+    explicit Frustum(const glm::mat4 &viewProjection);
+
+    // Between two distances along the depth, as fractions from the near (0) to the far (1) plane.
+    Frustum getSlice(float nearFraction, float farFraction) const;
+
+    // Centered on the axis, so it only depends on the shape, not on the orientation.
+    BoundingSphere getBoundingSphere() const;
+
+    // Order: -x, +x, -y, +y, near, far, in clip space.
+    const glm::vec4 *getPlanes() const { return planes; }
+
+    // Index bits are x, y and z in clip space, from -1 to 1 and from near to far. The first four are the near ones.
+    const glm::vec3 *getCorners() const { return corners; }
+
+    bool contains(const glm::vec3 &point) const;
+    bool overlaps(const AABB &aabb) const;
+    bool overlaps(const BoundingSphere &sphere) const;
+
+    // Only tests the planes set on inOutPlaneMask and clears the ones the volume is fully inside of, so the mask can be
+    // passed down to the children on a hierarchy. inOutLastPlane is tested first and updated with the plane that
+    // rejects the volume, as the next tests are likely to be rejected by the same one (plane coherency).
+    TestResult test(const AABB &aabb, uint32 &inOutPlaneMask, uint32 &inOutLastPlane) const;
+    TestResult test(const BoundingSphere &sphere, uint32 &inOutPlaneMask, uint32 &inOutLastPlane) const;
+
+  private:
+    static constexpr uint32 NEAR_PLANE = 4;
+    static constexpr uint32 FAR_PLANE = 5;
+
+    glm::vec4 planes[PLANE_COUNT];
+    glm::vec3 corners[CORNER_COUNT];
+
+    template <typename PlaneTestFn>
+    TestResult test(uint32 &inOutPlaneMask, uint32 &inOutLastPlane, const PlaneTestFn &planeTestFn) const;
+};
+}
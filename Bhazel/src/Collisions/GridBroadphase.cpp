@@ -0,0 +1,71 @@
+#include "bzpch.h"
+
+#include "GridBroadphase.h"
+
+#include "CollisionUtils.h"
+
+
+namespace BZ {
+
+size_t GridBroadphase::CellHash::operator()(const glm::ivec3 &coords) const {
+    // Large primes from "Optimized Spatial Hashing for Collision Detection of Deformable Objects".
+    return (static_cast<size_t>(static_cast<uint32>(coords.x)) * 73856093) ^
+           (static_cast<size_t>(static_cast<uint32>(coords.y)) * 19349663) ^
+           (static_cast<size_t>(static_cast<uint32>(coords.z)) * 83492791);
+}
+
+GridBroadphase::GridBroadphase(float cellSize) : invCellSize(1.0f / cellSize) {
+    BZ_ASSERT_CORE(cellSize > 0.0f, "Invalid cellSize!");
+}
+
+void GridBroadphase::findPairs(std::vector<ColliderPair> &outPairs) {
+    for (const glm::ivec3 &coords : usedCells) {
+        cells[coords].clear();
+    }
+    usedCells.clear();
+
+    for (uint32 i = 0; i < colliders.size(); ++i) {
+        if (!colliders[i].isAlive) {
+            continue;
+        }
+
+        const glm::ivec3 minCell = getCellCoords(colliders[i].aabb.getMin());
+        const glm::ivec3 maxCell = getCellCoords(colliders[i].aabb.getMax());
+        for (int32 z = minCell.z; z <= maxCell.z; ++z) {
+            for (int32 y = minCell.y; y <= maxCell.y; ++y) {
+                for (int32 x = minCell.x; x <= maxCell.x; ++x) {
+                    const glm::ivec3 coords(x, y, z);
+                    std::vector<uint32> &cell = cells[coords];
+                    if (cell.empty()) {
+                        usedCells.push_back(coords);
+                    }
+                    cell.push_back(i);
+                }
+            }
+        }
+    }
+
+    for (const glm::ivec3 &coords : usedCells) {
+        const std::vector<uint32> &cell = cells[coords];
+        for (uint32 i = 0; i < cell.size(); ++i) {
+            const AABB &aabbA = colliders[cell[i]].aabb;
+            for (uint32 j = i + 1; j < cell.size(); ++j) {
+                const AABB &aabbB = colliders[cell[j]].aabb;
+                if (!CollisionUtils::overlaps(aabbA, aabbB)) {
+                    continue;
+                }
+
+                // Pairs may share many cells. Only report them on the one with the min corner of the overlap.
+                const glm::vec3 overlapMin = glm::max(aabbA.getMin(), aabbB.getMin());
+                if (getCellCoords(overlapMin) == coords) {
+                    outPairs.emplace_back(cell[i], cell[j]);
+                }
+            }
+        }
+    }
+}
+
+glm::ivec3 GridBroadphase::getCellCoords(const glm::vec3 &position) const {
+    return glm::ivec3(glm::floor(position * invCellSize));
+}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Broadphase.h"
+
+
+namespace BZ {
+
+/*
+ * Uniform grid alternative to SweepAndPruneBroadphase, better when colliders have similar sizes and move a lot.
+ * Colliders are hashed into every cell their AABB touches, on each findContacts(), and only colliders sharing a cell
+ * are tested. Best with a cell size around the size of the typical collider.
+ */
+class GridBroadphase : public Broadphase {
+  public:
+    explicit GridBroadphase(float cellSize);
+
+    BZ_NON_COPYABLE(GridBroadphase);
+
+  protected:
+    void onColliderAdded(uint32 collider) override {}
+    void onColliderRemoved(uint32 collider) override {}
+    void onColliderUpdated(uint32 collider) override {}
+
+    void findPairs(std::vector<ColliderPair> &outPairs) override;
+
+  private:
+    // Keyed by the full cell coordinates, so far apart cells never share one.
+    struct CellHash {
+        size_t operator()(const glm::ivec3 &coords) const;
+    };
+
+    float invCellSize;
+
+    // Cells are kept between frames, cleared but not freed, to avoid allocations.
+    std::unordered_map<glm::ivec3, std::vector<uint32>, CellHash> cells;
+    std::vector<glm::ivec3> usedCells;
+
+    glm::ivec3 getCellCoords(const glm::vec3 &position) const;
+};
+}
@@ -0,0 +1,101 @@
+#include "bzpch.h"
+
+#include "Ray.h"
+
+#include "AABB.h"
+#include "BoundingSphere.h"
+#include "CollisionUtils.h"
+
+
+namespace BZ {
+
+Ray::Ray(const glm::vec3 &origin, const glm::vec3 &direction) :
+    origin(origin), direction(direction), invDirection(CollisionUtils::safeInverse(direction)) {
+}
+
+Ray Ray::transformed(const glm::mat4 &transform) const {
+    return Ray(transform * glm::vec4(origin, 1.0f), glm::mat3(transform) * direction);
+}
+
+bool Ray::intersects(const AABB &aabb, float maxDistance, float &outDistance) const {
+    const glm::vec3 t1 = (aabb.getMin() - origin) * invDirection;
+    const glm::vec3 t2 = (aabb.getMax() - origin) * invDirection;
+    const glm::vec3 tMin = glm::min(t1, t2);
+    const glm::vec3 tMax = glm::max(t1, t2);
+
+    const float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+    const float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+    if (enter > exit) {
+        return false;
+    }
+
+    outDistance = enter;
+    return true;
+}
+
+bool Ray::intersects(const BoundingSphere &sphere, float maxDistance, float &outDistance) const {
+    const glm::vec3 fromCenter = origin - sphere.getCenter();
+    const float c = glm::dot(fromCenter, fromCenter) - sphere.getRadius() * sphere.getRadius();
+    if (c <= 0.0f) {
+        outDistance = 0.0f;
+        return true;
+    }
+
+    // Outside and pointing away.
+    const float b = glm::dot(fromCenter, direction);
+    if (b > 0.0f) {
+        return false;
+    }
+
+    // Outside and not moving.
+    const float a = glm::dot(direction, direction);
+    if (a == 0.0f) {
+        return false;
+    }
+
+    const float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) {
+        return false;
+    }
+
+    const float distance = (-b - glm::sqrt(discriminant)) / a;
+    if (distance > maxDistance) {
+        return false;
+    }
+
+    outDistance = distance;
+    return true;
+}
+
+bool Ray::intersectsTriangle(const glm::vec3 &vertex0, const glm::vec3 &edge1, const glm::vec3 &edge2,
+                             float maxDistance, float &outDistance) const {
+    const glm::vec3 p = glm::cross(direction, edge2);
+    const float det = glm::dot(edge1, p);
+
+    // Parallel to the triangle plane.
+    if (det == 0.0f) {
+        return false;
+    }
+
+    const float invDet = 1.0f / det;
+    const glm::vec3 s = origin - vertex0;
+    const float u = glm::dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) {
+        return false;
+    }
+
+    const glm::vec3 q = glm::cross(s, edge1);
+    const float v = glm::dot(direction, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) {
+        return false;
+    }
+
+    const float distance = glm::dot(edge2, q) * invDet;
+    if (distance < 0.0f || distance > maxDistance) {
+        return false;
+    }
+
+    outDistance = distance;
+    return true;
+}
+}
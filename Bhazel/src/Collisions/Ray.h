@@ -0,0 +1,39 @@
+#pragma once
+
+
+namespace BZ {
+
+class AABB;
+class BoundingSphere;
+
+/*
+ * Distances along the Ray are in units of the direction, which doesn't need to be normalized. This way they are kept
+ * when the Ray is transformed, ex: to the model space of a Mesh.
+ */
+class Ray {
+  public:
+    Ray() = default;
+    Ray(const glm::vec3 &origin, const glm::vec3 &direction);
+
+    const glm::vec3 &getOrigin() const { return origin; }
+    const glm::vec3 &getDirection() const { return direction; }
+    const glm::vec3 &getInvDirection() const { return invDirection; }
+
+    glm::vec3 getPoint(float distance) const { return origin + direction * distance; }
+
+    Ray transformed(const glm::mat4 &transform) const;
+
+    // The distance where the Ray enters the volume, 0 if the origin is inside. Slab test for the AABB.
+    bool intersects(const AABB &aabb, float maxDistance, float &outDistance) const;
+    bool intersects(const BoundingSphere &sphere, float maxDistance, float &outDistance) const;
+
+    // Moller-Trumbore, taking the triangle as a vertex and the two edges leaving it. Both faces are hit.
+    bool intersectsTriangle(const glm::vec3 &vertex0, const glm::vec3 &edge1, const glm::vec3 &edge2,
+                            float maxDistance, float &outDistance) const;
+
+  private:
+    glm::vec3 origin;
+    glm::vec3 direction;
+    glm::vec3 invDirection;
+};
+}
@@ -0,0 +1,150 @@
+#include "bzpch.h"
+
+#include "SweepAndPruneBroadphase.h"
+
+#include "CollisionUtils.h"
+
+
+namespace BZ {
+
+static uint64 pairKey(uint32 colliderA, uint32 colliderB) {
+    return colliderA < colliderB ? (static_cast<uint64>(colliderA) << 32) | colliderB
+                                 : (static_cast<uint64>(colliderB) << 32) | colliderA;
+}
+
+void SweepAndPruneBroadphase::onColliderAdded(uint32 collider) {
+    if (endpointIndices.size() < colliders.size()) {
+        endpointIndices.resize(colliders.size());
+    }
+
+    const AABB &aabb = colliders[collider].aabb;
+    for (uint32 axis = 0; axis < 3; ++axis) {
+        std::vector<Endpoint> &axisEndpoints = endpoints[axis];
+
+        // Both at the end, then sorted into place. The min passes the max of everything that may overlap.
+        const uint32 minIndex = static_cast<uint32>(axisEndpoints.size());
+        axisEndpoints.push_back({});
+        axisEndpoints.push_back({});
+        setEndpoint(axis, minIndex, { aabb.getMin()[axis], collider << 1 });
+        setEndpoint(axis, minIndex + 1, { aabb.getMax()[axis], (collider << 1) | 1 });
+
+        siftDown(axis, minIndex);
+        siftDown(axis, endpointIndices[collider][axis * 2 + 1]);
+    }
+}
+
+void SweepAndPruneBroadphase::onColliderRemoved(uint32 collider) {
+    // Move the endpoints to the end, which removes all of its pairs, and drop them. Past any finite value, so no other
+    // endpoint ties with them.
+    for (uint32 axis = 0; axis < 3; ++axis) {
+        std::vector<Endpoint> &axisEndpoints = endpoints[axis];
+
+        const uint32 maxIndex = endpointIndices[collider][axis * 2 + 1];
+        axisEndpoints[maxIndex].value = std::numeric_limits<float>::infinity();
+        siftUp(axis, maxIndex);
+
+        const uint32 minIndex = endpointIndices[collider][axis * 2];
+        axisEndpoints[minIndex].value = std::numeric_limits<float>::infinity();
+        siftUp(axis, minIndex);
+
+        axisEndpoints.pop_back();
+        axisEndpoints.pop_back();
+    }
+}
+
+void SweepAndPruneBroadphase::onColliderUpdated(uint32 collider) {
+    const AABB &aabb = colliders[collider].aabb;
+    for (uint32 axis = 0; axis < 3; ++axis) {
+        std::vector<Endpoint> &axisEndpoints = endpoints[axis];
+
+        const uint32 minIndex = endpointIndices[collider][axis * 2];
+        const uint32 maxIndex = endpointIndices[collider][axis * 2 + 1];
+        const float oldMin = axisEndpoints[minIndex].value;
+        const float oldMax = axisEndpoints[maxIndex].value;
+        axisEndpoints[minIndex].value = aabb.getMin()[axis];
+        axisEndpoints[maxIndex].value = aabb.getMax()[axis];
+
+        // Grow first, then shrink.
+        if (aabb.getMin()[axis] < oldMin) {
+            siftDown(axis, minIndex);
+        }
+        if (aabb.getMax()[axis] > oldMax) {
+            siftUp(axis, maxIndex);
+        }
+        if (aabb.getMin()[axis] > oldMin) {
+            siftUp(axis, endpointIndices[collider][axis * 2]);
+        }
+        if (aabb.getMax()[axis] < oldMax) {
+            siftDown(axis, endpointIndices[collider][axis * 2 + 1]);
+        }
+    }
+}
+
+void SweepAndPruneBroadphase::findPairs(std::vector<ColliderPair> &outPairs) {
+    outPairs.reserve(overlappingPairs.size());
+    for (uint64 key : overlappingPairs) {
+        outPairs.emplace_back(static_cast<uint32>(key >> 32), static_cast<uint32>(key & 0xffffffff));
+    }
+}
+
+void SweepAndPruneBroadphase::setEndpoint(uint32 axis, uint32 index, const Endpoint &endpoint) {
+    endpoints[axis][index] = endpoint;
+    endpointIndices[endpoint.getCollider()][axis * 2 + (endpoint.isMax() ? 1 : 0)] = index;
+}
+
+void SweepAndPruneBroadphase::siftDown(uint32 axis, uint32 index) {
+    std::vector<Endpoint> &axisEndpoints = endpoints[axis];
+    const Endpoint endpoint = axisEndpoints[index];
+
+    while (index > 0 && endpoint.isBefore(axisEndpoints[index - 1])) {
+        const Endpoint &previous = axisEndpoints[index - 1];
+
+        // A min passing a max to the left starts overlapping on this axis. A max passing a min stops.
+        if (!endpoint.isMax() && previous.isMax()) {
+            addPair(endpoint.getCollider(), previous.getCollider());
+        }
+        else if (endpoint.isMax() && !previous.isMax()) {
+            removePair(endpoint.getCollider(), previous.getCollider());
+        }
+
+        setEndpoint(axis, index, previous);
+        index--;
+    }
+    setEndpoint(axis, index, endpoint);
+}
+
+void SweepAndPruneBroadphase::siftUp(uint32 axis, uint32 index) {
+    std::vector<Endpoint> &axisEndpoints = endpoints[axis];
+    const Endpoint endpoint = axisEndpoints[index];
+    const uint32 count = static_cast<uint32>(axisEndpoints.size());
+
+    while (index + 1 < count && axisEndpoints[index + 1].isBefore(endpoint)) {
+        const Endpoint &next = axisEndpoints[index + 1];
+
+        // A max passing a min to the right starts overlapping on this axis. A min passing a max stops.
+        if (endpoint.isMax() && !next.isMax()) {
+            addPair(endpoint.getCollider(), next.getCollider());
+        }
+        else if (!endpoint.isMax() && next.isMax()) {
+            removePair(endpoint.getCollider(), next.getCollider());
+        }
+
+        setEndpoint(axis, index, next);
+        index++;
+    }
+    setEndpoint(axis, index, endpoint);
+}
+
+void SweepAndPruneBroadphase::addPair(uint32 colliderA, uint32 colliderB) {
+    // Overlapping on one axis is not enough, test them all.
+    const Collider &a = colliders[colliderA];
+    const Collider &b = colliders[colliderB];
+    if (a.isAlive && b.isAlive && CollisionUtils::overlaps(a.aabb, b.aabb)) {
+        overlappingPairs.insert(pairKey(colliderA, colliderB));
+    }
+}
+
+void SweepAndPruneBroadphase::removePair(uint32 colliderA, uint32 colliderB) {
+    overlappingPairs.erase(pairKey(colliderA, colliderB));
+}
+}
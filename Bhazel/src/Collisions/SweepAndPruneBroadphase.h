@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Broadphase.h"
+
+
+namespace BZ {
+
+/*
+ * Incremental sweep and prune. Keeps the interval endpoints of the colliders sorted on each axis, and the set of
+ * overlapping pairs. Updates move the endpoints with insertion sort and pairs only change when an endpoint crosses
+ * another, so with small movements between frames the cost is close to linear.
+ */
+class SweepAndPruneBroadphase : public Broadphase {
+  public:
+    SweepAndPruneBroadphase() = default;
+
+    BZ_NON_COPYABLE(SweepAndPruneBroadphase);
+
+  protected:
+    void onColliderAdded(uint32 collider) override;
+    void onColliderRemoved(uint32 collider) override;
+    void onColliderUpdated(uint32 collider) override;
+
+    void findPairs(std::vector<ColliderPair> &outPairs) override;
+
+  private:
+    struct Endpoint {
+        float value;
+
+        // Collider index shifted left by one, with the lowest bit set on max endpoints.
+        uint32 colliderAndIsMax;
+
+        uint32 getCollider() const { return colliderAndIsMax >> 1; }
+        bool isMax() const { return (colliderAndIsMax & 1) != 0; }
+
+        // Touching intervals overlap, as on CollisionUtils::overlaps(), so on equal values mins go before maxes.
+        bool isBefore(const Endpoint &other) const {
+            return value < other.value || (value == other.value && !isMax() && other.isMax());
+        }
+    };
+
+    std::vector<Endpoint> endpoints[3];
+
+    // Per collider, the positions of its min and max endpoints on each axis, as [axis * 2 + isMax].
+    std::vector<std::array<uint32, 6>> endpointIndices;
+
+    std::unordered_set<uint64> overlappingPairs;
+
+    void setEndpoint(uint32 axis, uint32 index, const Endpoint &endpoint);
+
+    // Towards lower/higher indices, while the neighbour should go after/before.
+    void siftDown(uint32 axis, uint32 index);
+    void siftUp(uint32 axis, uint32 index);
+
+    void addPair(uint32 colliderA, uint32 colliderB);
+    void removePair(uint32 colliderA, uint32 colliderB);
+};
+}
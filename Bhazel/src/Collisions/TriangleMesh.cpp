@@ -0,0 +1,46 @@
+#include "bzpch.h"
+
+#include "TriangleMesh.h"
+
+#include "Ray.h"
+
+
+namespace BZ {
+
+TriangleMesh::TriangleMesh(const glm::vec3 positions[], const uint32 indices[], uint32 indexCount) {
+    BZ_ASSERT_CORE(indexCount % 3 == 0, "Index count must be a multiple of 3!");
+
+    const uint32 triangleCount = indexCount / 3;
+    vertices0.reserve(triangleCount);
+    edges1.reserve(triangleCount);
+    edges2.reserve(triangleCount);
+
+    for (uint32 i = 0; i < triangleCount; ++i) {
+        const glm::vec3 triangle[3] = { positions[indices[i * 3]], positions[indices[i * 3 + 1]],
+                                        positions[indices[i * 3 + 2]] };
+        vertices0.push_back(triangle[0]);
+        edges1.push_back(triangle[1] - triangle[0]);
+        edges2.push_back(triangle[2] - triangle[0]);
+        bvh.insert(AABB(triangle, 3), i);
+    }
+
+    // Triangles don't move, so build the best tree once.
+    bvh.rebuild();
+}
+
+bool TriangleMesh::raycast(const Ray &ray, float maxDistance, float &outDistance, uint32 &outTriangle) const {
+    bool hit = false;
+    bvh.raycast(ray.getOrigin(), ray.getDirection(), maxDistance, [&](uint32 triangle, float currentMaxDistance) {
+        float distance;
+        if (ray.intersectsTriangle(vertices0[triangle], edges1[triangle], edges2[triangle], currentMaxDistance,
+                                   distance)) {
+            hit = true;
+            outDistance = distance;
+            outTriangle = triangle;
+            return distance;
+        }
+        return currentMaxDistance;
+    });
+    return hit;
+}
+}
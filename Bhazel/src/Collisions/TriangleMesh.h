@@ -0,0 +1,37 @@
+#pragma once
+
+#include "BVH.h"
+
+
+namespace BZ {
+
+class Ray;
+
+/*
+ * CPU copy of the triangles of a Mesh, in model space, for ray casts. Each triangle is kept as a vertex and the two
+ * edges leaving it, ready for the Moller-Trumbore test, on contiguous arrays under a BVH.
+ */
+class TriangleMesh {
+  public:
+    TriangleMesh(const glm::vec3 positions[], const uint32 indices[], uint32 indexCount);
+
+    BZ_NON_COPYABLE(TriangleMesh);
+
+    uint32 getTriangleCount() const { return static_cast<uint32>(vertices0.size()); }
+    void getTriangle(uint32 triangle, glm::vec3 outVertices[3]) const {
+        outVertices[0] = vertices0[triangle];
+        outVertices[1] = vertices0[triangle] + edges1[triangle];
+        outVertices[2] = vertices0[triangle] + edges2[triangle];
+    }
+
+    // Closest hit, if any. Distances are in units of the Ray direction.
+    bool raycast(const Ray &ray, float maxDistance, float &outDistance, uint32 &outTriangle) const;
+
+  private:
+    std::vector<glm::vec3> vertices0;
+    std::vector<glm::vec3> edges1;
+    std::vector<glm::vec3> edges2;
+
+    BVH bvh;
+};
+}
@@ -43,10 +43,16 @@ Engine::Engine() {
     // windowData.fullScreen = settings.getFieldAsBasicType<bool>("fullScreen", false);
 
     window.init(windowData, BZ_BIND_EVENT_FN(Engine::onEvent));
-    graphicsContext.init();
+    graphicsContext.init(settings.getFieldAsBasicType<bool>("bindlessTextures", false));
 
     Input::init();
 
+    // The main thread also works on the parallel loops.
+    uint32 hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    jobSystem.init(settings.getFieldAsBasicType<uint32>("workerThreads", hardwareThreads - 1));
+
+    particlePool2D.init(settings.getFieldAsBasicType<uint32>("particleBudget", 65536));
+
 #ifdef BZ_HOT_RELOAD_SHADERS
     fileWatcher.startWatching();
 #endif
@@ -61,6 +67,8 @@ Engine::~Engine() {
     delete application;
 
     rendererCoordinator.destroy();
+    jobSystem.destroy();
+    particlePool2D.destroy();
 
     graphicsContext.destroy();
     window.destroy();
@@ -80,6 +88,12 @@ void Engine::attachApplication(Application *application) {
         rendererCoordinator.init(appSettings.enable2dRenderer, appSettings.enable3dRenderer, appSettings.enableImGuiRenderer);
     }
     
+    if (appSettings.fixedTimestep) {
+        BZ_ASSERT_CORE(appSettings.fixedUpdatesPerSecond > 0, "Invalid fixed updates per second!");
+        fixedTimestep = FixedTimestep(TimeDuration(1000000000ull / appSettings.fixedUpdatesPerSecond),
+                                      appSettings.maxFixedUpdatesPerFrame);
+    }
+
     application->onAttachToEngine();
 }
 
@@ -91,6 +105,9 @@ void Engine::mainLoop() {
 
     Timer frameTimer;
     frameTiming = {};
+    FrameTiming fixedFrameTiming;
+
+    const bool useFixedTimestep = application->getSettings().fixedTimestep;
 
     while (!window.isClosed() || forceStopLoop) {
 
@@ -104,6 +121,16 @@ void Engine::mainLoop() {
             frameTimer.restart();
             frameTiming.deltaTime = frameDuration;
             frameTiming.runningTime += frameDuration;
+
+            if (useFixedTimestep) {
+                const uint32 steps = fixedTimestep.advance(frameDuration);
+                for (uint32 i = 0; i < steps; ++i) {
+                    fixedFrameTiming.deltaTime = fixedTimestep.getStepDuration();
+                    fixedFrameTiming.runningTime += fixedTimestep.getStepDuration();
+                    application->onFixedUpdate(fixedFrameTiming);
+                }
+                frameTiming.interpolationAlpha = fixedTimestep.getInterpolationAlpha();
+            }
             application->onUpdate(frameTiming);
 
             RendererImGui::begin();
@@ -155,6 +182,10 @@ void Application::onAttachToEngine() {
     layerStack.onAttachToEngine();
 }
 
+void Application::onFixedUpdate(const FrameTiming &frameTiming) {
+    layerStack.onFixedUpdate(frameTiming);
+}
+
 void Application::onUpdate(const FrameTiming &frameTiming) {
     layerStack.onUpdate(frameTiming);
 }
@@ -2,13 +2,16 @@
 
 #include "Core/Window.h"
 
+#include "Core/FixedTimestep.h"
 #include "Core/Ini/IniParser.h"
 #include "Core/Input.h"
+#include "Core/JobSystem.h"
 #include "Core/Timer.h"
 
 #include "FileWatcher/FileWatcher.h"
 #include "Graphics/GraphicsContext.h"
 #include "Layers/LayerStack.h"
+#include "Renderer/ParticlePool2D.h"
 #include "Renderer/RendererCoordinator.h"
 
 
@@ -26,6 +29,10 @@ struct FrameTiming {
 
     // Cummulative/total running time.
     TimeDuration runningTime;
+
+    // With a fixed timestep, how far this frame is past the last fixed update, as a fraction of a step.
+    // Rendering interpolates the last two simulated states with it. Always 1 otherwise.
+    float interpolationAlpha = 1.0f;
 };
 
 
@@ -46,6 +53,8 @@ class Engine {
     Window &getWindow() { return window; }
     GraphicsContext &getGraphicsContext() { return graphicsContext; }
     RendererCoordinator &getRendererCoordinator() { return rendererCoordinator; }
+    JobSystem &getJobSystem() { return jobSystem; }
+    ParticlePool2D &getParticlePool2D() { return particlePool2D; }
 
     const std::string &getAssetsPath() const { return assetsPath; }
 
@@ -64,10 +73,14 @@ class Engine {
     Window window;
     GraphicsContext graphicsContext;
     RendererCoordinator rendererCoordinator;
+    JobSystem jobSystem;
+    ParticlePool2D particlePool2D;
 
     IniParser iniParser;
     FrameTiming frameTiming;
 
+    FixedTimestep fixedTimestep;
+
     std::string assetsPath;
 
 #ifdef BZ_HOT_RELOAD_SHADERS
@@ -90,6 +103,12 @@ class Application {
         bool enable2dRenderer = true;
         bool enable3dRenderer = true;
         bool enableImGuiRenderer = true;
+
+        // If true, onFixedUpdate is called at a constant rate before each onUpdate, as many times as the elapsed time
+        // requires, up to maxFixedUpdatesPerFrame. Past that the simulation falls behind real time.
+        bool fixedTimestep = false;
+        uint32 fixedUpdatesPerSecond = 60;
+        uint32 maxFixedUpdatesPerFrame = 5;
     };
 
     Application() = default;
@@ -100,6 +119,7 @@ class Application {
     void onEvent(Event &ev);
 
     void onAttachToEngine();
+    void onFixedUpdate(const FrameTiming &frameTiming);
     void onUpdate(const FrameTiming &frameTiming);
     void onImGuiRender(const FrameTiming &frameTiming);
 
@@ -0,0 +1,35 @@
+#include "bzpch.h"
+
+#include "FixedTimestep.h"
+
+
+namespace BZ {
+
+FixedTimestep::FixedTimestep(TimeDuration stepDuration, uint32 maxStepsPerFrame) :
+    stepDuration(stepDuration), maxStepsPerFrame(maxStepsPerFrame) {
+    BZ_ASSERT_CORE(stepDuration.asNanoseconds() > 0, "Invalid step duration!");
+    BZ_ASSERT_CORE(maxStepsPerFrame > 0, "Invalid max steps per frame!");
+}
+
+uint32 FixedTimestep::advance(const TimeDuration &frameDuration) {
+    accumulator += frameDuration;
+
+    // Integer nanoseconds, so the step count doesn't depend on floating point rounding.
+    const uint64 stepNanos = stepDuration.asNanoseconds();
+    uint64 steps = accumulator.asNanoseconds() / stepNanos;
+    accumulator = TimeDuration(accumulator.asNanoseconds() - steps * stepNanos);
+
+    if (steps > maxStepsPerFrame) {
+        droppedStepCount += steps - maxStepsPerFrame;
+        steps = maxStepsPerFrame;
+    }
+
+    stepCount += steps;
+    return static_cast<uint32>(steps);
+}
+
+float FixedTimestep::getInterpolationAlpha() const {
+    return static_cast<float>(static_cast<double>(accumulator.asNanoseconds()) /
+                              static_cast<double>(stepDuration.asNanoseconds()));
+}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Core/Timer.h"
+
+
+namespace BZ {
+
+/*
+ * Accumulates variable frame durations and converts them into a whole number of fixed duration simulation steps.
+ * The time left over is kept for the next frame and exposed as an interpolation alpha, so rendering can blend between
+ * the last two simulated states.
+ * Steps per frame are capped, and the time that doesn't fit is dropped. Otherwise a slow frame asks for more steps,
+ * which make the next frame slower and so on (spiral of death). The simulation runs slower than real time instead.
+ * It doesn't read any clock, feeding it the same durations always yields the same steps.
+ */
+class FixedTimestep {
+  public:
+    FixedTimestep() = default;
+    FixedTimestep(TimeDuration stepDuration, uint32 maxStepsPerFrame);
+
+    // Returns the number of steps to simulate for a frame that took frameDuration.
+    uint32 advance(const TimeDuration &frameDuration);
+
+    // Fraction of a step left on the accumulator, in [0, 1).
+    float getInterpolationAlpha() const;
+
+    const TimeDuration &getStepDuration() const { return stepDuration; }
+
+    uint64 getStepCount() const { return stepCount; }
+
+    // Steps that didn't fit under the cap since the start.
+    uint64 getDroppedStepCount() const { return droppedStepCount; }
+
+  private:
+    TimeDuration stepDuration;
+    uint32 maxStepsPerFrame = 0;
+
+    TimeDuration accumulator;
+    uint64 stepCount = 0;
+    uint64 droppedStepCount = 0;
+};
+}
@@ -0,0 +1,107 @@
+#include "bzpch.h"
+
+#include "JobSystem.h"
+
+
+namespace BZ {
+
+void JobSystem::init(uint32 workerCount) {
+    BZ_LOG_CORE_INFO("JobSystem: starting {} worker threads.", workerCount);
+
+    stopping = false;
+    for (uint32 i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+}
+
+void JobSystem::destroy() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void JobSystem::parallelFor(uint32 count, uint32 minChunkSize, const RangeFn &fn) {
+    BZ_ASSERT_CORE(minChunkSize > 0, "minChunkSize needs to be greater than zero!");
+
+    if (count == 0) {
+        return;
+    }
+
+    const uint32 threadCount = getWorkerCount() + 1;
+    const uint32 size = std::max(minChunkSize, (count + threadCount - 1) / threadCount);
+    const uint32 chunks = (count + size - 1) / size;
+
+    // Not worth waking anyone.
+    if (chunks == 1) {
+        fn(0, count);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        // Workers that woke up late for the previous loop may still be reading its state.
+        doneCondition.wait(lock, [this]() { return activeWorkers == 0; });
+
+        currentFn = &fn;
+        currentCount = count;
+        chunkSize = size;
+        chunkCount = chunks;
+        nextChunk = 0;
+        pendingChunks = chunks;
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this]() { return pendingChunks == 0 && activeWorkers == 0; });
+    currentFn = nullptr;
+}
+
+void JobSystem::workerLoop() {
+    uint64 lastGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [this, lastGeneration]() { return stopping || generation != lastGeneration; });
+            if (stopping) {
+                return;
+            }
+            lastGeneration = generation;
+            activeWorkers++;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            activeWorkers--;
+        }
+        doneCondition.notify_all();
+    }
+}
+
+void JobSystem::runChunks() {
+    uint32 chunk;
+    while ((chunk = nextChunk++) < chunkCount) {
+        uint32 begin = chunk * chunkSize;
+        uint32 end = std::min(begin + chunkSize, currentCount);
+        (*currentFn)(begin, end);
+
+        if (--pendingChunks == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            doneCondition.notify_all();
+        }
+    }
+}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+namespace BZ {
+
+/*
+ * Fixed pool of worker threads running fork-join parallel loops. The calling thread also does work and only returns
+ * when the whole loop is done. Only meant to be used from a single thread at a time, usually the main one.
+ */
+class JobSystem {
+  public:
+    JobSystem() = default;
+
+    BZ_NON_COPYABLE(JobSystem);
+
+    void init(uint32 workerCount);
+    void destroy();
+
+    using RangeFn = std::function<void(uint32 begin, uint32 end)>;
+
+    // Splits [0, count) into contiguous chunks of at least minChunkSize elements and runs fn over them in parallel.
+    void parallelFor(uint32 count, uint32 minChunkSize, const RangeFn &fn);
+
+    uint32 getWorkerCount() const { return static_cast<uint32>(workers.size()); }
+
+  private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    // The current loop. Written under the mutex, while no worker is active.
+    const RangeFn *currentFn = nullptr;
+    uint32 currentCount = 0;
+    uint32 chunkSize = 0;
+    uint32 chunkCount = 0;
+    std::atomic<uint32> nextChunk{ 0 };
+    std::atomic<uint32> pendingChunks{ 0 };
+
+    uint64 generation = 0;
+    uint32 activeWorkers = 0;
+    bool stopping = false;
+};
+}
@@ -87,4 +87,45 @@ glm::vec4 unpackColor(uint32 color) {
     vec.b = (color & 255) / 255.0f;
     return vec;
 }
+
+void radixSort(SortKeyIndex entries[], SortKeyIndex temp[], uint32 count) {
+    constexpr uint32 PASSES = sizeof(uint64);
+    constexpr uint32 BUCKETS = 256;
+
+    // All the histograms on a single read.
+    uint32 histograms[PASSES][BUCKETS] = {};
+    for (uint32 i = 0; i < count; ++i) {
+        uint64 key = entries[i].key;
+        for (uint32 pass = 0; pass < PASSES; ++pass) {
+            histograms[pass][(key >> (pass * 8)) & 0xff]++;
+        }
+    }
+
+    SortKeyIndex *src = entries;
+    SortKeyIndex *dst = temp;
+    for (uint32 pass = 0; pass < PASSES; ++pass) {
+        uint32 *histogram = histograms[pass];
+        const uint32 shift = pass * 8;
+
+        if (count == 0 || histogram[(src[0].key >> shift) & 0xff] == count) {
+            continue;
+        }
+
+        uint32 offset = 0;
+        for (uint32 bucket = 0; bucket < BUCKETS; ++bucket) {
+            uint32 bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (uint32 i = 0; i < count; ++i) {
+            dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != entries) {
+        memcpy(entries, src, count * sizeof(SortKeyIndex));
+    }
+}
 }
\ No newline at end of file
@@ -24,4 +24,13 @@ std::size_t hashCombine(std::size_t hash1, std::size_t hash2);
 // Returns ARGB
 uint32 packColor(const glm::vec4 &color);
 glm::vec4 unpackColor(uint32 color);
+
+struct SortKeyIndex {
+    uint64 key;
+    uint32 index;
+};
+
+// Stable LSD radix sort by key, 8 bits per pass. Passes where all the keys have the same byte are skipped.
+// temp needs space for count entries, the result ends up on entries.
+void radixSort(SortKeyIndex entries[], SortKeyIndex temp[], uint32 count);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Graphics/GpuObject.h"
+#include "Graphics/Internal/ResourceState.h"
 #include "Graphics/Internal/VulkanIncludes.h"
 
 
@@ -157,7 +158,12 @@ class Buffer : public GpuObject<BufferHandles> {
 
     bool isMapped = false;
 
+    // The whole Buffer is tracked as a single resource, including all the replicas.
+    mutable ResourceState state;
+
     VkBufferUsageFlags toRequiredVkBufferUsageFlags() const;
     VkBufferUsageFlags toPreferredVkBufferUsageFlags() const;
+
+    friend class CommandBuffer;
 };
 }
\ No newline at end of file
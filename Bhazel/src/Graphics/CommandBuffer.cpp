@@ -17,6 +17,88 @@
 
 namespace BZ {
 
+constexpr VkAccessFlags WRITE_ACCESS_MASK = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT |
+                                            VK_ACCESS_MEMORY_WRITE_BIT;
+
+struct ResourceUsageInfo {
+    VkImageLayout layout;
+    VkPipelineStageFlags stageMask;
+    VkAccessFlags accessMask;
+};
+
+static ResourceUsageInfo getResourceUsageInfo(ResourceUsage usage) {
+    switch (usage) {
+        case ResourceUsage::TransferSrc:
+            return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_ACCESS_TRANSFER_READ_BIT };
+        case ResourceUsage::TransferDst:
+            return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                     VK_ACCESS_TRANSFER_WRITE_BIT };
+        case ResourceUsage::VertexBuffer:
+            return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                     VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT };
+        case ResourceUsage::IndexBuffer:
+            return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT };
+        case ResourceUsage::IndirectBuffer:
+            return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                     VK_ACCESS_INDIRECT_COMMAND_READ_BIT };
+        case ResourceUsage::UniformBuffer:
+            return { VK_IMAGE_LAYOUT_UNDEFINED,
+                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                     VK_ACCESS_UNIFORM_READ_BIT };
+        case ResourceUsage::VertexShaderRead:
+            return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                     VK_ACCESS_SHADER_READ_BIT };
+        case ResourceUsage::FragmentShaderRead:
+            return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                     VK_ACCESS_SHADER_READ_BIT };
+        case ResourceUsage::ComputeShaderRead:
+            return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_SHADER_READ_BIT };
+        case ResourceUsage::ComputeShaderWrite:
+            return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT };
+        case ResourceUsage::ComputeShaderReadWrite:
+            return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT };
+        case ResourceUsage::ColorAttachment:
+            return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT };
+        case ResourceUsage::DepthStencilAttachment:
+            return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                     VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                     VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+        default:
+            BZ_ASSERT_ALWAYS_CORE("Invalid ResourceUsage!");
+            return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                     VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT };
+    }
+}
+
+static VkImageAspectFlags getImageAspectMask(const TextureFormat &format) {
+    VkImageAspectFlags aspectMask = 0;
+    if (format.isColor())
+        aspectMask |= VK_IMAGE_ASPECT_COLOR_BIT;
+    if (format.isDepth())
+        aspectMask |= VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (format.isStencil())
+        aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    return aspectMask;
+}
+
+// Puts the state as if the resource was just accessed with the given masks.
+static void setResourceState(ResourceState &state, VkImageLayout layout, VkPipelineStageFlags stageMask,
+                             VkAccessFlags accessMask) {
+    const bool isWrite = (accessMask & WRITE_ACCESS_MASK) != 0;
+
+    state.layout = layout;
+    state.writeStageMask = stageMask;
+    state.writeAccessMask = accessMask & WRITE_ACCESS_MASK;
+    state.readStageMask = isWrite ? 0 : stageMask;
+    state.readAccessMask = isWrite ? 0 : accessMask;
+}
+
 CommandBuffer &CommandBuffer::getAndBegin(QueueProperty queueProperty) {
     auto &buf = BZ_GRAPHICS_CTX.getCurrentFrameCommandPool(queueProperty).getCommandBuffer();
     buf.begin();
@@ -28,6 +110,12 @@ void CommandBuffer::init(VkCommandBuffer vkCommandBuffer, uint32 queueFamilyInde
 
     handle = vkCommandBuffer;
     commandCount = 0;
+    barrierCount = 0;
+    transitionCount = 0;
+    skippedTransitionCount = 0;
+    pendingSrcStageMask = 0;
+    pendingDstStageMask = 0;
+    insideRenderPass = false;
 }
 
 void CommandBuffer::begin() {
@@ -39,9 +127,14 @@ void CommandBuffer::begin() {
     BZ_ASSERT_VK(vkBeginCommandBuffer(handle, &beginInfo));
 
     commandCount = 0;
+    barrierCount = 0;
+    transitionCount = 0;
+    skippedTransitionCount = 0;
 }
 
 void CommandBuffer::end() {
+    BZ_ASSERT_CORE(!insideRenderPass, "Ending a CommandBuffer inside a RenderPass!");
+    flushBarriers();
     BZ_ASSERT_VK(vkEndCommandBuffer(handle));
 }
 
@@ -79,13 +172,20 @@ void CommandBuffer::beginRenderPass(const Ref<RenderPass> &renderPass, const Ref
                                               static_cast<uint32_t>(framebuffer->getDimensionsAndLayers().y) };
     renderPassBeginInfo.clearValueCount = renderPass->getAttachmentCount();
     renderPassBeginInfo.pClearValues = clearValues.data();
+
+    flushBarriers();
     vkCmdBeginRenderPass(handle, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
     commandCount++;
+
+    insideRenderPass = true;
+    recordRenderPassAttachmentStates(*renderPass, *framebuffer);
 }
 
 void CommandBuffer::endRenderPass() {
     vkCmdEndRenderPass(handle);
     commandCount++;
+
+    insideRenderPass = false;
 }
 
 void CommandBuffer::nextSubPass() {
@@ -157,12 +257,15 @@ void CommandBuffer::bindBuffer(const Ref<Buffer> &buffer, uint32 offset) {
 }
 
 void CommandBuffer::bindPipelineState(const Ref<PipelineState> &pipelineState) {
-    vkCmdBindPipeline(handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineState->getHandle());
+    VkPipelineBindPoint bindPoint =
+        pipelineState->isCompute() ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
+    vkCmdBindPipeline(handle, bindPoint, pipelineState->getHandle());
     commandCount++;
 }
 
 void CommandBuffer::bindDescriptorSet(const DescriptorSet &descriptorSet, const Ref<PipelineLayout> &pipelineLayout,
-                                      uint32 setIndex, uint32 dynamicBufferOffsets[], uint32 dynamicBufferCount) {
+                                      uint32 setIndex, uint32 dynamicBufferOffsets[], uint32 dynamicBufferCount,
+                                      VkPipelineBindPoint bindPoint) {
 
     constexpr uint32 MAX_DESCRIPTOR_DYNAMIC_OFFSETS = 8;
 
@@ -199,8 +302,8 @@ void CommandBuffer::bindDescriptorSet(const DescriptorSet &descriptorSet, const
     }
 
     VkDescriptorSet descSets[] = { descriptorSet.getHandle() };
-    vkCmdBindDescriptorSets(handle, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout->getHandle(), setIndex, 1, descSets,
-                            index, finalDynamicBufferOffsets);
+    vkCmdBindDescriptorSets(handle, bindPoint, pipelineLayout->getHandle(), setIndex, 1, descSets, index,
+                            finalDynamicBufferOffsets);
     commandCount++;
 }
 
@@ -218,16 +321,40 @@ void CommandBuffer::setPushConstants(const Ref<PipelineLayout> &pipelineLayout,
 }
 
 void CommandBuffer::draw(uint32 vertexCount, uint32 instanceCount, uint32 firstVertex, uint32 firstInstance) {
+    flushBarriers();
     vkCmdDraw(handle, vertexCount, instanceCount, firstVertex, firstInstance);
     commandCount++;
 }
 
 void CommandBuffer::drawIndexed(uint32 indexCount, uint32 instanceCount, uint32 firstIndex, uint32 vertexOffset,
                                 uint32 firstInstance) {
+    flushBarriers();
     vkCmdDrawIndexed(handle, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
     commandCount++;
 }
 
+void CommandBuffer::drawIndirect(const Ref<Buffer> &buffer, uint32 offset, uint32 drawCount, uint32 stride) {
+    flushBarriers();
+    vkCmdDrawIndirect(handle, buffer->getHandle().bufferHandle, offset, drawCount, stride);
+    commandCount++;
+}
+
+void CommandBuffer::drawIndexedIndirect(const Ref<Buffer> &buffer, uint32 offset, uint32 drawCount, uint32 stride) {
+    BZ_ASSERT_CORE(drawCount <= 1 || BZ_GRAPHICS_DEVICE.isMultiDrawIndirectEnabled(),
+                   "Multi draw indirect is not enabled on the Device!");
+    flushBarriers();
+    uint32 realOffset = buffer->getCurrentBaseOfReplicaOffset() + offset;
+    vkCmdDrawIndexedIndirect(handle, buffer->getHandle().bufferHandle, realOffset, drawCount, stride);
+    commandCount++;
+}
+
+void CommandBuffer::dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ) {
+    BZ_ASSERT_CORE(!insideRenderPass, "Can't dispatch inside a RenderPass!");
+    flushBarriers();
+    vkCmdDispatch(handle, groupCountX, groupCountY, groupCountZ);
+    commandCount++;
+}
+
 void CommandBuffer::setViewports(uint32 firstIndex, const VkViewport viewports[], uint32 viewportCount) {
     vkCmdSetViewport(handle, firstIndex, viewportCount, viewports);
     commandCount++;
@@ -243,8 +370,216 @@ void CommandBuffer::setDepthBias(float constantFactor, float clamp, float slopeF
     commandCount++;
 }
 
+void CommandBuffer::transitionTexture(const Ref<Texture> &texture, ResourceUsage usage, uint32 baseMipLevel,
+                                      uint32 mipLevels) {
+    transitionTexture(*texture, usage, baseMipLevel, mipLevels);
+}
+
+void CommandBuffer::transitionTexture(const Texture &texture, ResourceUsage usage, uint32 baseMipLevel,
+                                      uint32 mipLevels) {
+    BZ_ASSERT_CORE(!insideRenderPass, "Can't transition resources inside a RenderPass!");
+
+    const uint32 mipCount = mipLevels == VK_REMAINING_MIP_LEVELS ? texture.getMipLevels() - baseMipLevel : mipLevels;
+    BZ_ASSERT_CORE(mipCount > 0 && baseMipLevel + mipCount <= texture.getMipLevels(), "Invalid mip range!");
+
+    // The same subresource can't have two barriers on the same vkCmdPipelineBarrier, their order would be undefined.
+    bool hasPending = false;
+    for (uint32 mip = baseMipLevel; mip < baseMipLevel + mipCount && !hasPending; ++mip) {
+        for (uint32 layer = 0; layer < texture.getLayers() && !hasPending; ++layer) {
+            hasPending = texture.getSubresourceState(mip, layer).pending;
+        }
+    }
+    if (hasPending) {
+        flushBarriers();
+    }
+
+    const ResourceUsageInfo info = getResourceUsageInfo(usage);
+    for (uint32 mip = baseMipLevel; mip < baseMipLevel + mipCount; ++mip) {
+        for (uint32 layer = 0; layer < texture.getLayers(); ++layer) {
+            ResourceState &state = texture.getSubresourceState(mip, layer);
+            const VkImageLayout oldLayout = state.layout;
+
+            VkPipelineStageFlags srcStageMask;
+            VkAccessFlags srcAccessMask;
+            if (!computeTransition(state, info.layout, info.stageMask, info.accessMask, srcStageMask, srcAccessMask)) {
+                skippedTransitionCount++;
+                continue;
+            }
+
+            state.pending = true;
+            pendingStates.push_back(&state);
+            pendingSrcStageMask |= srcStageMask;
+            pendingDstStageMask |= info.stageMask;
+            addPendingImageBarrier(texture, oldLayout, info.layout, srcAccessMask, info.accessMask, mip, layer, 1);
+        }
+    }
+}
+
+void CommandBuffer::transitionBuffer(const Ref<Buffer> &buffer, ResourceUsage usage) {
+    transitionBuffer(*buffer, usage);
+}
+
+void CommandBuffer::transitionBuffer(const Buffer &buffer, ResourceUsage usage) {
+    BZ_ASSERT_CORE(!insideRenderPass, "Can't transition resources inside a RenderPass!");
+
+    if (buffer.state.pending) {
+        flushBarriers();
+    }
+
+    const ResourceUsageInfo info = getResourceUsageInfo(usage);
+
+    VkPipelineStageFlags srcStageMask;
+    VkAccessFlags srcAccessMask;
+    if (!computeTransition(buffer.state, VK_IMAGE_LAYOUT_UNDEFINED, info.stageMask, info.accessMask, srcStageMask,
+                           srcAccessMask)) {
+        skippedTransitionCount++;
+        return;
+    }
+
+    buffer.state.pending = true;
+    pendingStates.push_back(&buffer.state);
+    pendingSrcStageMask |= srcStageMask;
+    pendingDstStageMask |= info.stageMask;
+
+    VkBufferMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccessMask;
+    barrier.dstAccessMask = info.accessMask;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer.getHandle().bufferHandle;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    pendingBufferBarriers.push_back(barrier);
+}
+
+void CommandBuffer::flushBarriers() {
+    if (pendingImageBarriers.empty() && pendingBufferBarriers.empty()) {
+        return;
+    }
+
+    vkCmdPipelineBarrier(handle, pendingSrcStageMask, pendingDstStageMask, 0, 0, nullptr,
+                         static_cast<uint32>(pendingBufferBarriers.size()), pendingBufferBarriers.data(),
+                         static_cast<uint32>(pendingImageBarriers.size()), pendingImageBarriers.data());
+    commandCount++;
+    barrierCount++;
+    transitionCount += static_cast<uint32>(pendingBufferBarriers.size() + pendingImageBarriers.size());
+
+    for (ResourceState *state : pendingStates) {
+        state->pending = false;
+    }
+    pendingStates.clear();
+    pendingImageBarriers.clear();
+    pendingBufferBarriers.clear();
+    pendingSrcStageMask = 0;
+    pendingDstStageMask = 0;
+}
+
+bool CommandBuffer::computeTransition(ResourceState &state, VkImageLayout layout, VkPipelineStageFlags stageMask,
+                                      VkAccessFlags accessMask, VkPipelineStageFlags &outSrcStageMask,
+                                      VkAccessFlags &outSrcAccessMask) {
+    const bool isWrite = (accessMask & WRITE_ACCESS_MASK) != 0;
+
+    if (!isWrite && state.layout == layout) {
+        // Read after read, or after nothing at all. No barrier unless these stages haven't seen the last write yet.
+        const bool nothingToWait =
+            state.writeStageMask == VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT && state.writeAccessMask == 0;
+        const bool alreadyVisible =
+            (state.readStageMask & stageMask) == stageMask && (state.readAccessMask & accessMask) == accessMask;
+
+        if (!nothingToWait) {
+            outSrcStageMask = state.writeStageMask;
+            outSrcAccessMask = state.writeAccessMask;
+        }
+        state.readStageMask |= stageMask;
+        state.readAccessMask |= accessMask;
+        return !nothingToWait && !alreadyVisible;
+    }
+
+    // Write or layout transition. Needs to wait on the last write and on all the reads made since then.
+    outSrcStageMask = state.writeStageMask | state.readStageMask;
+    outSrcAccessMask = state.writeAccessMask;
+    setResourceState(state, layout, stageMask, accessMask);
+    return true;
+}
+
+void CommandBuffer::addPendingImageBarrier(const Texture &texture, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                           VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, uint32 mipLevel,
+                                           uint32 baseLayer, uint32 layerCount) {
+    const VkImage image = texture.getHandle().imageHandle;
+
+    // Try to widen the last barrier instead of adding a new one.
+    if (!pendingImageBarriers.empty()) {
+        VkImageMemoryBarrier &last = pendingImageBarriers.back();
+        VkImageSubresourceRange &range = last.subresourceRange;
+
+        if (last.image == image && last.oldLayout == oldLayout && last.newLayout == newLayout &&
+            last.srcAccessMask == srcAccessMask && last.dstAccessMask == dstAccessMask) {
+
+            // Next layer of the same mips.
+            if (range.levelCount == 1 && range.baseMipLevel == mipLevel &&
+                range.baseArrayLayer + range.layerCount == baseLayer) {
+                range.layerCount += layerCount;
+                return;
+            }
+
+            // Next mip of the same layers.
+            if (range.baseArrayLayer == baseLayer && range.layerCount == layerCount &&
+                range.baseMipLevel + range.levelCount == mipLevel) {
+                range.levelCount++;
+                return;
+            }
+        }
+    }
+
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = getImageAspectMask(texture.getFormat());
+    barrier.subresourceRange.baseMipLevel = mipLevel;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = baseLayer;
+    barrier.subresourceRange.layerCount = layerCount;
+    barrier.srcAccessMask = srcAccessMask;
+    barrier.dstAccessMask = dstAccessMask;
+    pendingImageBarriers.push_back(barrier);
+}
+
+void CommandBuffer::recordRenderPassAttachmentStates(const RenderPass &renderPass, const Framebuffer &framebuffer) {
+    // The RenderPass does its own layout transitions and syncs through its SubPassDependencies.
+    // Only record the state where it leaves the attachments.
+    auto recordView = [](const TextureView &view, VkImageLayout layout, VkPipelineStageFlags stageMask,
+                         VkAccessFlags accessMask) {
+        const Texture &texture = *view.getTexture();
+        for (uint32 mip = view.getBaseMipLevel(); mip < view.getBaseMipLevel() + view.getMipLevelCount(); ++mip) {
+            for (uint32 layer = view.getBaseLayer(); layer < view.getBaseLayer() + view.getLayerCount(); ++layer) {
+                setResourceState(texture.getSubresourceState(mip, layer), layout, stageMask, accessMask);
+            }
+        }
+    };
+
+    for (uint32 i = 0; i < framebuffer.getColorAttachmentCount(); ++i) {
+        recordView(*framebuffer.getColorAttachmentTextureView(i),
+                   renderPass.getColorAttachmentDescription(i).finalLayout,
+                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+    }
+
+    if (framebuffer.getDepthStencilTextureView()) {
+        recordView(*framebuffer.getDepthStencilTextureView(),
+                   renderPass.getDepthStencilAttachmentDescription()->finalLayout,
+                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+    }
+}
+
 void CommandBuffer::pipelineBarrierMemory(VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage,
                                           VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask) {
+    flushBarriers();
+
     VkMemoryBarrier barrier = {};
     barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     barrier.srcAccessMask = srcAccessMask;
@@ -255,6 +590,7 @@ void CommandBuffer::pipelineBarrierMemory(VkPipelineStageFlags srcStage, VkPipel
                          1, &barrier, 0, nullptr, 0, nullptr);
 
     commandCount++;
+    barrierCount++;
 }
 
 void CommandBuffer::pipelineBarrierTexture(const Ref<Texture> &texture, VkPipelineStageFlags srcStage,
@@ -270,6 +606,7 @@ void CommandBuffer::pipelineBarrierTexture(const Texture &texture, VkPipelineSta
                                            VkPipelineStageFlags dstStage, VkAccessFlags srcAccessMask,
                                            VkAccessFlags dstAccessMask, VkImageLayout oldLayout,
                                            VkImageLayout newLayout, uint32 baseMipLevel, uint32 mipLevels) {
+    flushBarriers();
 
     VkImageMemoryBarrier barrier = {};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -278,15 +615,7 @@ void CommandBuffer::pipelineBarrierTexture(const Texture &texture, VkPipelineSta
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = texture.getHandle().imageHandle;
-
-    barrier.subresourceRange.aspectMask = 0;
-    if (texture.getFormat().isColor())
-        barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_COLOR_BIT;
-    if (texture.getFormat().isDepth())
-        barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_DEPTH_BIT;
-    if (texture.getFormat().isStencil())
-        barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
-
+    barrier.subresourceRange.aspectMask = getImageAspectMask(texture.getFormat());
     barrier.subresourceRange.baseMipLevel = baseMipLevel;
     barrier.subresourceRange.levelCount = mipLevels;
     // TODO: those may be parameters
@@ -301,6 +630,15 @@ void CommandBuffer::pipelineBarrierTexture(const Texture &texture, VkPipelineSta
                          0, nullptr, 0, nullptr, 1, &barrier);
 
     commandCount++;
+    barrierCount++;
+    transitionCount++;
+
+    // Keep the tracked state coherent. The following commands are unknown, assume the worst case of the dst masks.
+    for (uint32 mip = baseMipLevel; mip < baseMipLevel + mipLevels; ++mip) {
+        for (uint32 layer = 0; layer < texture.getLayers(); ++layer) {
+            setResourceState(texture.getSubresourceState(mip, layer), newLayout, dstStage, dstAccessMask);
+        }
+    }
 }
 
 void CommandBuffer::copyBufferToBuffer(const Ref<Buffer> &src, const Ref<Buffer> &dst, VkBufferCopy regions[],
@@ -310,6 +648,7 @@ void CommandBuffer::copyBufferToBuffer(const Ref<Buffer> &src, const Ref<Buffer>
 
 void CommandBuffer::copyBufferToBuffer(const Buffer &src, const Buffer &dst, VkBufferCopy regions[],
                                        uint32 regionCount) {
+    flushBarriers();
     vkCmdCopyBuffer(handle, src.getHandle().bufferHandle, dst.getHandle().bufferHandle, regionCount, regions);
     commandCount++;
 }
@@ -321,6 +660,7 @@ void CommandBuffer::copyBufferToTexture(const Ref<Buffer> &src, const Ref<Textur
 
 void CommandBuffer::copyBufferToTexture(const Buffer &src, const Texture &dst, VkImageLayout imageLayout,
                                         const VkBufferImageCopy regions[], uint32 regionCount) {
+    flushBarriers();
     vkCmdCopyBufferToImage(handle, src.getHandle().bufferHandle, dst.getHandle().imageHandle, imageLayout, regionCount,
                            regions);
     commandCount++;
@@ -333,6 +673,7 @@ void CommandBuffer::blitTexture(const Ref<Texture> &src, const Ref<Texture> &dst
 
 void CommandBuffer::blitTexture(const Texture &src, const Texture &dst, VkImageLayout srcLayout,
                                 VkImageLayout dstLayout, VkImageBlit blit[], uint32 blitCount, VkFilter filter) {
+    flushBarriers();
     vkCmdBlitImage(handle, src.getHandle().imageHandle, srcLayout, dst.getHandle().imageHandle, dstLayout, blitCount,
                    blit, filter);
     commandCount++;
@@ -361,6 +702,7 @@ void CommandBuffer::writeTimestamp(VkPipelineStageFlagBits pipelineStage, const
 void CommandBuffer::copyQueryPoolResults(const QueryPool &pool, uint32 firstQuery, uint32 queryCount,
                                          const Ref<Buffer> &dstBuffer, uint32 dstOffset, uint32 stride,
                                          VkQueryResultFlags flags) {
+    flushBarriers();
     vkCmdCopyQueryPoolResults(handle, pool.getHandle(), firstQuery, queryCount, dstBuffer->getHandle().bufferHandle,
                               dstOffset, stride, flags);
     commandCount++;
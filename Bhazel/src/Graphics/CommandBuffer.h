@@ -17,6 +17,25 @@ class DescriptorSet;
 class PipelineState;
 class PipelineLayout;
 class QueryPool;
+struct ResourceState;
+
+// Intended usage of a resource on the following commands. Each one implies an image layout (ignored on Buffers), the
+// pipeline stages and the access types.
+enum class ResourceUsage {
+    TransferSrc,
+    TransferDst,
+    VertexBuffer,
+    IndexBuffer,
+    IndirectBuffer,
+    UniformBuffer,
+    VertexShaderRead,
+    FragmentShaderRead,
+    ComputeShaderRead,
+    ComputeShaderWrite,
+    ComputeShaderReadWrite,
+    ColorAttachment,
+    DepthStencilAttachment,
+};
 
 /*
  * CommandPools create the CommandBuffers.
@@ -44,7 +63,8 @@ class CommandBuffer : public GpuObject<VkCommandBuffer> {
     void bindPipelineState(const Ref<PipelineState> &pipelineState);
     // void bindDescriptorSets(const Ref<DescriptorSet> &descriptorSet);
     void bindDescriptorSet(const DescriptorSet &descriptorSet, const Ref<PipelineLayout> &pipelineLayout,
-                           uint32 setIndex, uint32 dynamicBufferOffsets[], uint32 dynamicBufferCount);
+                           uint32 setIndex, uint32 dynamicBufferOffsets[], uint32 dynamicBufferCount,
+                           VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
 
     void setPushConstants(const Ref<PipelineLayout> &pipelineLayout, VkShaderStageFlags shaderStageFlags,
                           const void *data, uint32 offset, uint32 size);
@@ -53,12 +73,34 @@ class CommandBuffer : public GpuObject<VkCommandBuffer> {
     void drawIndexed(uint32 indexCount, uint32 instanceCount, uint32 firstIndex, uint32 vertexOffset,
                      uint32 firstInstance);
 
+    // Parameters are read from a VkDrawIndirectCommand array on the buffer.
+    void drawIndirect(const Ref<Buffer> &buffer, uint32 offset, uint32 drawCount, uint32 stride);
+
+    // Parameters are read from a VkDrawIndexedIndirectCommand array on the buffer, on the current replica.
+    void drawIndexedIndirect(const Ref<Buffer> &buffer, uint32 offset, uint32 drawCount, uint32 stride);
+
+    // Needs a compute PipelineState bound. Not allowed inside a RenderPass.
+    void dispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ);
+
     // Pipeline dynamic state changes
     void setViewports(uint32 firstIndex, const VkViewport viewports[], uint32 viewportCount);
     void setScissorRects(uint32 firstIndex, const VkRect2D rects[], uint32 rectCount);
     void setDepthBias(float constantFactor, float clamp, float slopeFactor);
 
-    // Sync and Transitions
+    // Tracked sync and transitions. Declare the intended usage of a resource before the commands that use it.
+    // The needed barriers are accumulated and sent on a single vkCmdPipelineBarrier before the next draw, copy, blit or
+    // RenderPass. Redundant ones are skipped. Textures are transitioned on all the layers.
+    void transitionTexture(const Ref<Texture> &texture, ResourceUsage usage, uint32 baseMipLevel = 0,
+                           uint32 mipLevels = VK_REMAINING_MIP_LEVELS);
+    void transitionTexture(const Texture &texture, ResourceUsage usage, uint32 baseMipLevel = 0,
+                           uint32 mipLevels = VK_REMAINING_MIP_LEVELS);
+    void transitionBuffer(const Ref<Buffer> &buffer, ResourceUsage usage);
+    void transitionBuffer(const Buffer &buffer, ResourceUsage usage);
+
+    // Sends the pending barriers, if any. Usually there's no need to call this directly.
+    void flushBarriers();
+
+    // Raw sync and transitions. Will flush the pending barriers first.
     void pipelineBarrierMemory(VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage,
                                VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask);
 
@@ -101,11 +143,40 @@ class CommandBuffer : public GpuObject<VkCommandBuffer> {
 
     // Statistics
     uint32 getCommandCount() const { return commandCount; }
+    uint32 getBarrierCount() const { return barrierCount; }
+    uint32 getTransitionCount() const { return transitionCount; }
+    uint32 getSkippedTransitionCount() const { return skippedTransitionCount; }
     uint32 getQueueFamilyIndex() const { return queueFamilyIndex; }
 
   private:
     uint32 commandCount;
 
+    // vkCmdPipelineBarrier calls, the Image and Buffer barriers sent on them and the declared transitions found to be
+    // redundant.
+    uint32 barrierCount;
+    uint32 transitionCount;
+    uint32 skippedTransitionCount;
+
+    std::vector<VkImageMemoryBarrier> pendingImageBarriers;
+    std::vector<VkBufferMemoryBarrier> pendingBufferBarriers;
+    VkPipelineStageFlags pendingSrcStageMask;
+    VkPipelineStageFlags pendingDstStageMask;
+
+    // To clear their pending flag on flush.
+    std::vector<ResourceState *> pendingStates;
+
+    bool insideRenderPass;
+
+    // Returns true if a barrier is needed, filling the barrier masks and updating the state to the new usage.
+    bool computeTransition(ResourceState &state, VkImageLayout layout, VkPipelineStageFlags stageMask,
+                           VkAccessFlags accessMask, VkPipelineStageFlags &outSrcStageMask,
+                           VkAccessFlags &outSrcAccessMask);
+    void addPendingImageBarrier(const Texture &texture, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, uint32 mipLevel,
+                                uint32 baseLayer, uint32 layerCount);
+
+    void recordRenderPassAttachmentStates(const RenderPass &renderPass, const Framebuffer &framebuffer);
+
     // The queue family which this Buffer will be submitted to.
     uint32 queueFamilyIndex;
 
@@ -19,6 +19,9 @@ DescriptorSetLayout::DescriptorSetLayout(const std::initializer_list<DescriptorD
     BZ_ASSERT_CORE(!descriptorDescs.empty(), "No Descriptor descriptions added!");
 
     std::vector<VkDescriptorSetLayoutBinding> vkDescriptorSetLayoutBindings(descriptorDescs.size());
+    std::vector<VkDescriptorBindingFlagsEXT> vkDescriptorBindingFlags(descriptorDescs.size());
+    bool hasBindingFlags = false;
+    bool updateAfterBind = false;
     for (uint32 i = 0; i < descriptorDescs.size(); ++i) {
         const auto &descriptorDesc = descriptorDescs[i];
 
@@ -31,12 +34,26 @@ DescriptorSetLayout::DescriptorSetLayout(const std::initializer_list<DescriptorD
         descriptorSetLayoutBinding.stageFlags = descriptorDesc.shaderStageFlags;
         descriptorSetLayoutBinding.pImmutableSamplers = nullptr; // TODO: For image sampling descriptors
         vkDescriptorSetLayoutBindings[i] = descriptorSetLayoutBinding;
+
+        vkDescriptorBindingFlags[i] = descriptorDesc.bindingFlags;
+        hasBindingFlags |= descriptorDesc.bindingFlags != 0;
+        updateAfterBind |= (descriptorDesc.bindingFlags & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT) != 0;
     }
 
+    BZ_ASSERT_CORE(!hasBindingFlags || BZ_GRAPHICS_DEVICE.isDescriptorIndexingEnabled(),
+                   "Descriptor binding flags require VK_EXT_descriptor_indexing!");
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo = {};
+    bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlagsCreateInfo.bindingCount = static_cast<uint32>(vkDescriptorBindingFlags.size());
+    bindingFlagsCreateInfo.pBindingFlags = vkDescriptorBindingFlags.data();
+
     VkDescriptorSetLayoutCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     createInfo.bindingCount = static_cast<uint32>(vkDescriptorSetLayoutBindings.size());
     createInfo.pBindings = vkDescriptorSetLayoutBindings.data();
+    createInfo.pNext = hasBindingFlags ? &bindingFlagsCreateInfo : nullptr;
+    createInfo.flags = updateAfterBind ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT : 0;
 
     BZ_ASSERT_VK(vkCreateDescriptorSetLayout(BZ_GRAPHICS_DEVICE.getHandle(), &createInfo, nullptr, &handle));
 }
@@ -48,12 +65,25 @@ DescriptorSetLayout::~DescriptorSetLayout() {
 
 /*-------------------------------------------------------------------------------------------*/
 DescriptorSet &DescriptorSet::get(const Ref<DescriptorSetLayout> &layout) {
-    return BZ_GRAPHICS_CTX.getDescriptorPool().getDescriptorSet(layout);
+    return BZ_GRAPHICS_CTX.getDescriptorAllocator().getDescriptorSet(layout);
+}
+
+Ref<DescriptorSet> DescriptorSet::getShared(const Ref<DescriptorSetLayout> &layout) {
+    return Ref<DescriptorSet>(&get(layout), [](DescriptorSet *descriptorSet) { release(*descriptorSet); });
+}
+
+DescriptorSet &DescriptorSet::getTransient(const Ref<DescriptorSetLayout> &layout) {
+    return BZ_GRAPHICS_CTX.getDescriptorAllocator().getTransientDescriptorSet(layout);
+}
+
+void DescriptorSet::release(DescriptorSet &descriptorSet) {
+    BZ_GRAPHICS_CTX.getDescriptorAllocator().releaseDescriptorSet(descriptorSet);
 }
 
 void DescriptorSet::init(VkDescriptorSet vkDescriptorSet, const Ref<DescriptorSetLayout> &layout) {
     handle = vkDescriptorSet;
     this->layout = layout;
+    dynamicBuffers.clear();
 }
 
 void DescriptorSet::setConstantBuffer(const Ref<Buffer> &buffer, uint32 binding, uint32 offset, uint32 size) {
@@ -97,6 +127,49 @@ void DescriptorSet::setConstantBuffers(const Ref<Buffer> buffers[], uint32 srcAr
     vkUpdateDescriptorSets(BZ_GRAPHICS_DEVICE.getHandle(), 1, &write, 0, nullptr);
 }
 
+void DescriptorSet::setStorageBuffer(const Ref<Buffer> &buffer, uint32 binding, uint32 offset, uint32 size) {
+    setStorageBuffers(&buffer, 1, 0, binding, &offset, &size);
+}
+
+void DescriptorSet::setStorageBuffers(const Ref<Buffer> buffers[], uint32 srcArrayCount, uint32 dstArrayOffset,
+                                      uint32 binding, uint32 offsets[], uint32 sizes[]) {
+    BZ_ASSERT_CORE(layout->getDescriptorDescs()[binding].type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+                       layout->getDescriptorDescs()[binding].type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                   "Binding {} is not of type StorageBuffer!", binding);
+    BZ_ASSERT_CORE(layout->getDescriptorDescs()[binding].arrayCount >= dstArrayOffset + srcArrayCount,
+                   "Overflowing the array for binding {}!", binding);
+    BZ_ASSERT_CORE(binding < layout->getDescriptorDescs().size(),
+                   "Binding {} does not exist on the layout for this DescriptorSet!", binding);
+    BZ_ASSERT_CORE(!buffers[0]->isReplicated() ||
+                       (buffers[0]->isReplicated() &&
+                        layout->getDescriptorDescs()[binding].type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC),
+                   "The buffer is effectively \"dynamic\" (there are internally created replicas because of memory "
+                   "type), so the type on the layout needs to be VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC.");
+
+    if (layout->getDescriptorDescs()[binding].type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) {
+        dynamicBuffers.emplace_back(binding, buffers, srcArrayCount);
+    }
+
+    std::vector<VkDescriptorBufferInfo> bufferInfos(srcArrayCount);
+    for (uint32 i = 0; i < srcArrayCount; ++i) {
+        VkDescriptorBufferInfo bufferInfo = {};
+        bufferInfo.buffer = buffers[i]->getHandle().bufferHandle;
+        bufferInfo.offset = offsets[i];
+        bufferInfo.range = sizes[i];
+        bufferInfos[i] = bufferInfo;
+    }
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = handle;
+    write.dstBinding = binding;
+    write.dstArrayElement = dstArrayOffset;
+    write.descriptorCount = srcArrayCount;
+    write.descriptorType = layout->getDescriptorDescs()[binding].type;
+    write.pBufferInfo = bufferInfos.data();
+    vkUpdateDescriptorSets(BZ_GRAPHICS_DEVICE.getHandle(), 1, &write, 0, nullptr);
+}
+
 void DescriptorSet::setCombinedTextureSampler(const Ref<TextureView> &textureView, const Ref<Sampler> &sampler,
                                               uint32 binding) {
     setCombinedTextureSamplers(&textureView, 1, 0, sampler, binding);
@@ -161,6 +234,36 @@ void DescriptorSet::setSampledTextures(const Ref<TextureView> textureViews[], ui
     vkUpdateDescriptorSets(BZ_GRAPHICS_DEVICE.getHandle(), 1, &write, 0, nullptr);
 }
 
+void DescriptorSet::setStorageTexture(const Ref<TextureView> &textureView, uint32 binding) {
+    setStorageTextures(&textureView, 1, 0, binding);
+}
+
+void DescriptorSet::setStorageTextures(const Ref<TextureView> textureViews[], uint32 srcArrayCount,
+                                       uint32 dstArrayOffset, uint32 binding) {
+    BZ_ASSERT_CORE(layout->getDescriptorDescs()[binding].type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                   "Binding {} is not of type StorageTexture!", binding);
+    BZ_ASSERT_CORE(binding < layout->getDescriptorDescs().size(),
+                   "Binding {} does not exist on the layout for this DescriptorSet!", binding);
+
+    std::vector<VkDescriptorImageInfo> imageInfos(srcArrayCount);
+    for (uint32 i = 0; i < srcArrayCount; ++i) {
+        VkDescriptorImageInfo imageInfo = {};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        imageInfo.imageView = textureViews[i]->getHandle();
+        imageInfos[i] = imageInfo;
+    }
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = handle;
+    write.dstBinding = binding;
+    write.dstArrayElement = dstArrayOffset;
+    write.descriptorCount = srcArrayCount;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    write.pImageInfo = imageInfos.data();
+    vkUpdateDescriptorSets(BZ_GRAPHICS_DEVICE.getHandle(), 1, &write, 0, nullptr);
+}
+
 void DescriptorSet::setSampler(const Ref<Sampler> &sampler, uint32 binding) {
     setSamplers(&sampler, 1, 0, binding);
 }
@@ -10,6 +10,7 @@ struct DescriptorDesc {
     VkDescriptorType type;
     VkShaderStageFlags shaderStageFlags;
     uint32 arrayCount;
+    VkDescriptorBindingFlagsEXT bindingFlags = 0; // Requires VK_EXT_descriptor_indexing if not 0.
 };
 
 class DescriptorSetLayout : public GpuObject<VkDescriptorSetLayout> {
@@ -33,18 +34,33 @@ class TextureView;
 class Sampler;
 
 /*
- * DescriptorPools create the DescriptorSets.
+ * The DescriptorAllocator creates the DescriptorSets, from its DescriptorPools.
  */
 class DescriptorSet : public GpuObject<VkDescriptorSet> {
   public:
+    // Persistent DescriptorSet, valid until released.
     static DescriptorSet &get(const Ref<DescriptorSetLayout> &layout);
 
+    // Persistent DescriptorSet, released when the last Ref to it is gone. For owners that are copied around.
+    static Ref<DescriptorSet> getShared(const Ref<DescriptorSetLayout> &layout);
+
+    // Valid for the current frame only.
+    static DescriptorSet &getTransient(const Ref<DescriptorSetLayout> &layout);
+
+    // Return a persistent DescriptorSet to be recycled. It will not be reused while the current frame is in flight.
+    static void release(DescriptorSet &descriptorSet);
+
     BZ_NON_COPYABLE(DescriptorSet);
 
     void setConstantBuffer(const Ref<Buffer> &buffer, uint32 binding, uint32 offset, uint32 size);
     void setConstantBuffers(const Ref<Buffer> buffers[], uint32 srcArrayCount, uint32 dstArrayOffset, uint32 binding,
                             uint32 offsets[], uint32 sizes[]);
 
+    // Replicated buffers (on MemoryType::CpuToGpu or MemoryType::GpuToCpu) need a dynamic storage buffer binding.
+    void setStorageBuffer(const Ref<Buffer> &buffer, uint32 binding, uint32 offset, uint32 size);
+    void setStorageBuffers(const Ref<Buffer> buffers[], uint32 srcArrayCount, uint32 dstArrayOffset, uint32 binding,
+                           uint32 offsets[], uint32 sizes[]);
+
     void setCombinedTextureSampler(const Ref<TextureView> &textureView, const Ref<Sampler> &sampler, uint32 binding);
     void setCombinedTextureSamplers(const Ref<TextureView> textureViews[], uint32 srcArrayCount, uint32 dstArrayOffset,
                                     const Ref<Sampler> &sampler, uint32 binding);
@@ -53,6 +69,11 @@ class DescriptorSet : public GpuObject<VkDescriptorSet> {
     void setSampledTextures(const Ref<TextureView> textureViews[], uint32 srcArrayCount, uint32 dstArrayOffset,
                             uint32 binding);
 
+    // Storage textures are expected to be on VK_IMAGE_LAYOUT_GENERAL when used.
+    void setStorageTexture(const Ref<TextureView> &textureView, uint32 binding);
+    void setStorageTextures(const Ref<TextureView> textureViews[], uint32 srcArrayCount, uint32 dstArrayOffset,
+                            uint32 binding);
+
     void setSampler(const Ref<Sampler> &sampler, uint32 binding);
     void setSamplers(const Ref<Sampler> samplers[], uint32 srcArrayCount, uint32 dstArrayOffset, uint32 binding);
 
@@ -79,5 +100,6 @@ class DescriptorSet : public GpuObject<VkDescriptorSet> {
     std::vector<DynBufferData> dynamicBuffers;
 
     friend class DescriptorPool;
+    friend class DescriptorAllocator;
 };
 }
@@ -17,7 +17,7 @@
 
 namespace BZ {
 
-void GraphicsContext::init() {
+void GraphicsContext::init(bool enableBindlessTextures) {
     GLFWwindow *windowHandle = Engine::get().getWindow().getNativeHandle();
 
     instance.init();
@@ -27,7 +27,12 @@ void GraphicsContext::init() {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
     };
     physicalDevice.init(instance, surface, requiredDeviceExtensions);
-    device.init(physicalDevice, requiredDeviceExtensions);
+
+    bindlessTexturesEnabled = enableBindlessTextures && physicalDevice.isDescriptorIndexingSupported();
+    if (enableBindlessTextures && !bindlessTexturesEnabled) {
+        BZ_LOG_CORE_WARN("Bindless textures requested but descriptor indexing is not supported. Disabling.");
+    }
+    device.init(physicalDevice, requiredDeviceExtensions, bindlessTexturesEnabled);
 
     // Init VulkanMemoryAllocator lib.
     VmaAllocatorCreateInfo allocatorInfo = {};
@@ -37,19 +42,25 @@ void GraphicsContext::init() {
 
     createFrameData();
 
-    descriptorPool.init(device,
-                        { { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 64 },
-                          { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 64 },
-                          { VK_DESCRIPTOR_TYPE_SAMPLER, 64 },
-                          { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 64 } },
-                        128);
+    descriptorAllocator.init(device);
+
+    if (bindlessTexturesEnabled) {
+        uint32 capacity = std::min(MAX_BINDLESS_TEXTURES, physicalDevice.getMaxUpdateAfterBindSampledImages());
+        bindlessTextureTable.init(device, capacity);
+    }
 
     swapchain.init(device, surface);
     stats = {};
 }
 
 void GraphicsContext::destroy() {
-    descriptorPool.destroy();
+    // Releases the TextureViews and Samplers held by the table, before the SamplerCache.
+    if (bindlessTexturesEnabled) {
+        bindlessTextureTable.destroy();
+    }
+
+    descriptorAllocator.destroy();
+    samplerCache.destroy();
 
     swapchain.destroy();
 
@@ -74,6 +85,7 @@ void GraphicsContext::beginFrame() {
     for (auto &familyAndPool : frameData.commandPoolsByFamily) {
         familyAndPool.second.reset();
     }
+    descriptorAllocator.beginFrame(currentFrameIndex);
 
     swapchain.aquireImage(frameDatas[currentFrameIndex].imageAvailableSemaphore);
 
@@ -103,6 +115,7 @@ void GraphicsContext::beginFrame() {
 }
 
 void GraphicsContext::endFrame() {
+    flushSubmits();
     swapchain.presentImage(frameDatas[currentFrameIndex].renderFinishedSemaphore);
     currentFrameIndex = (currentFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
 
@@ -141,6 +154,9 @@ void GraphicsContext::submitCommandBuffers(const CommandBuffer *commandBuffers[]
     for (uint32 idx = 0; idx < commandBuffersCount; ++idx) {
         vkCommandBuffers[idx] = commandBuffers[idx]->getHandle();
         stats.commandCount += commandBuffers[idx]->getCommandCount();
+        stats.barrierCount += commandBuffers[idx]->getBarrierCount();
+        stats.transitionCount += commandBuffers[idx]->getTransitionCount();
+        stats.skippedTransitionCount += commandBuffers[idx]->getSkippedTransitionCount();
     }
 
 #ifdef BZ_GRAPHICS_DEBUG
@@ -165,29 +181,33 @@ void GraphicsContext::submitCommandBuffers(const CommandBuffer *commandBuffers[]
         signalSemaphores[idx] = semaphoresToSignal[idx]->getHandle();
     }
 
-    VkSubmitInfo submitInfo = {};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = semaphoresToWaitForCount;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
-    submitInfo.commandBufferCount = commandBuffersCount;
-    submitInfo.pCommandBuffers = vkCommandBuffers;
-    submitInfo.signalSemaphoreCount = semaphoresToSignalCount;
-    submitInfo.pSignalSemaphores = signalSemaphores;
-
     // The first CommandBuffer will determine the Queue to use.
     const Queue &queue = *device.getQueueContainer().getQueueByFamilyIndex(commandBuffers[0]->getQueueFamilyIndex());
-    BZ_ASSERT_VK(
-        vkQueueSubmit(queue.getHandle(), 1, &submitInfo, fenceToSignal ? fenceToSignal->getHandle() : VK_NULL_HANDLE));
+    submitBatcher.enqueue(queue, vkCommandBuffers, commandBuffersCount, waitSemaphores, waitStages,
+                          semaphoresToWaitForCount, signalSemaphores, semaphoresToSignalCount);
+
+    // Signaling a Fence is a sync point, the CPU will wait on it.
+    if (fenceToSignal) {
+        stats.vkSubmitCount += submitBatcher.flush(&queue, fenceToSignal->getHandle());
+    }
 
     stats.commandBufferCount += commandBuffersCount;
+    stats.submissionCount++;
+}
+
+void GraphicsContext::flushSubmits() {
+    if (submitBatcher.hasPendingSubmits()) {
+        stats.vkSubmitCount += submitBatcher.flush();
+    }
 }
 
 void GraphicsContext::waitForDevice() {
+    flushSubmits();
     BZ_ASSERT_VK(vkDeviceWaitIdle(device.getHandle()));
 }
 
 void GraphicsContext::waitForQueue(QueueProperty queueProperty) {
+    flushSubmits();
     const Queue &queue = device.getQueueContainer().getQueueByProperty(queueProperty);
     BZ_ASSERT_VK(vkQueueWaitIdle(queue.getHandle()));
 }
@@ -244,6 +264,8 @@ void GraphicsContext::cleanupFrameData() {
 void GraphicsContext::onImGuiRender(const FrameTiming &frameTiming) {
     stats.frameTimeCpu = frameTiming.deltaTime;
     stats.runningTime = frameTiming.runningTime;
+    stats.samplerCount = samplerCache.getLiveSamplerCount();
+    stats.samplerReferenceCount = samplerCache.getReferenceCount();
 
     statsTimeAcumMs += frameTiming.deltaTime.asMillisecondsUint32();
     if (statsTimeAcumMs >= statsRefreshPeriodMs) {
@@ -276,6 +298,28 @@ void GraphicsContext::onImGuiRender(const FrameTiming &frameTiming) {
         ImGui::Text("Stats:");
         ImGui::Text("CommandBuffer Count: %d.", visibleStats.commandBufferCount);
         ImGui::Text("Command Count: %d.", visibleStats.commandCount);
+        ImGui::Text("Submission Count: %d.", visibleStats.submissionCount);
+        ImGui::Text("vkQueueSubmit Count: %d.", visibleStats.vkSubmitCount);
+        ImGui::Text("Barrier Count: %d.", visibleStats.barrierCount);
+        ImGui::Text("Transition Count: %d.", visibleStats.transitionCount);
+        ImGui::Text("Skipped Transition Count: %d.", visibleStats.skippedTransitionCount);
+        ImGui::Text("Sampler Count: %d.", visibleStats.samplerCount);
+        ImGui::Text("Sampler References: %d.", visibleStats.samplerReferenceCount);
+        if (bindlessTexturesEnabled) {
+            ImGui::Text("Bindless Textures: %d/%d.", bindlessTextureTable.getTextureCount(),
+                        bindlessTextureTable.getCapacity());
+        }
+        else {
+            ImGui::Text("Bindless Textures: disabled.");
+        }
+        ImGui::Separator();
+
+        const DescriptorAllocatorStats &descStats = descriptorAllocator.getStats();
+        ImGui::Text("DescriptorSets:");
+        ImGui::Text("Pool Count: %d.", descStats.poolCount);
+        ImGui::Text("Live: %d. High Water: %d.", descStats.liveSetCount, descStats.liveSetHighWater);
+        ImGui::Text("Free: %d.", descStats.freeSetCount);
+        ImGui::Text("Transient: %d. High Water: %d.", descStats.transientSetCount, descStats.transientSetHighWater);
         ImGui::Separator();
 
         ImGui::Text("CPU Frame Times");
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "Graphics/Internal/BindlessTextureTable.h"
 #include "Graphics/Internal/CommandPool.h"
-#include "Graphics/Internal/DescriptorPool.h"
+#include "Graphics/Internal/DescriptorAllocator.h"
 #include "Graphics/Internal/Device.h"
 #include "Graphics/Internal/Instance.h"
 #include "Graphics/Internal/QueryPool.h"
+#include "Graphics/Internal/SamplerCache.h"
+#include "Graphics/Internal/SubmitBatcher.h"
 #include "Graphics/Internal/Surface.h"
 #include "Graphics/Internal/Swapchain.h"
 #include "Graphics/Internal/VulkanIncludes.h"
@@ -28,7 +31,8 @@ class GraphicsContext {
 
     BZ_NON_COPYABLE(GraphicsContext);
 
-    void init();
+    // Bindless textures will only be enabled if the device supports it.
+    void init(bool enableBindlessTextures);
     void destroy();
 
     void beginFrame();
@@ -42,6 +46,10 @@ class GraphicsContext {
                               uint32 semaphoresToWaitForCount, const Ref<Semaphore> semaphoresToSignal[],
                               uint32 semaphoresToSignalCount, const Ref<Fence> &fenceToSignal);
 
+    // Submissions are batched and only sent to the Queues on sync points: when signaling a Fence, waiting on a
+    // Queue/Device and presenting. This forces it.
+    void flushSubmits();
+
     void waitForDevice();
     void waitForQueue(QueueProperty queueProperty);
 
@@ -49,7 +57,10 @@ class GraphicsContext {
     void onImGuiRender(const FrameTiming &frameTiming); // For statistics.
 
     CommandPool &getCurrentFrameCommandPool(QueueProperty property);
-    DescriptorPool &getDescriptorPool() { return descriptorPool; }
+    DescriptorAllocator &getDescriptorAllocator() { return descriptorAllocator; }
+    SamplerCache &getSamplerCache() { return samplerCache; }
+    BindlessTextureTable &getBindlessTextureTable() { return bindlessTextureTable; }
+    bool isBindlessTexturesEnabled() const { return bindlessTexturesEnabled; }
     VmaAllocator getMemoryAllocator() const { return memoryAllocator; }
 
     uint32 getCurrentFrameIndex() const { return currentFrameIndex; }
@@ -81,6 +92,10 @@ class GraphicsContext {
     constexpr static uint32 MAX_COMMAND_BUFFERS_PER_SUBMIT = 32;
     constexpr static uint32 MAX_SEMAPHORES_PER_SUBMIT = 8;
     constexpr static uint32 MIN_UNIFORM_BUFFER_OFFSET_ALIGN = 256;
+    constexpr static uint32 MAX_BINDLESS_TEXTURES = 4096;
+
+    static_assert(DescriptorAllocator::MAX_FRAMES_IN_FLIGHT == MAX_FRAMES_IN_FLIGHT,
+                  "DescriptorAllocator::MAX_FRAMES_IN_FLIGHT needs to match.");
 
   private:
     void createFrameData();
@@ -92,7 +107,12 @@ class GraphicsContext {
     Device device;
     Swapchain swapchain;
 
-    DescriptorPool descriptorPool;
+    DescriptorAllocator descriptorAllocator;
+    SamplerCache samplerCache;
+    SubmitBatcher submitBatcher;
+
+    BindlessTextureTable bindlessTextureTable;
+    bool bindlessTexturesEnabled = false;
 
     VmaAllocator memoryAllocator;
 
@@ -133,6 +153,19 @@ class GraphicsContext {
         uint32 commandCount;
         uint32 commandBufferCount;
 
+        // Calls to submitCommandBuffers() and the resulting vkQueueSubmit calls, after batching.
+        uint32 submissionCount;
+        uint32 vkSubmitCount;
+
+        // vkCmdPipelineBarrier calls, the Image and Buffer barriers sent on them and the redundant transitions skipped.
+        uint32 barrierCount;
+        uint32 transitionCount;
+        uint32 skippedTransitionCount;
+
+        // Live VkSamplers and the references held to them through the SamplerCache.
+        uint32 samplerCount;
+        uint32 samplerReferenceCount;
+
         // Are we CPU bound? If not, we are GPU bound.
         bool cpuBound;
 
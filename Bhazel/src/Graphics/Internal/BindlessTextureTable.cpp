@@ -0,0 +1,59 @@
+#include "bzpch.h"
+
+#include "BindlessTextureTable.h"
+
+#include "Graphics/Internal/Device.h"
+#include "Graphics/Texture.h"
+
+
+namespace BZ {
+
+void BindlessTextureTable::init(const Device &device, uint32 capacity) {
+    BZ_ASSERT_CORE(device.isDescriptorIndexingEnabled(), "BindlessTextureTable requires descriptor indexing!");
+    BZ_ASSERT_CORE(capacity > 0, "capacity needs to be greater than zero!");
+
+    this->capacity = capacity;
+
+    // Partially bound: unused slots don't need valid descriptors. Update after bind: registering textures while the set
+    // is bound on CommandBuffers in flight is allowed.
+    descriptorSetLayout = DescriptorSetLayout::create(
+        { { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, capacity,
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT } });
+
+    const DescriptorPoolInitData poolSize = { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, capacity };
+    descriptorPool.init(device, &poolSize, 1, 1, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT);
+
+    descriptorSet = descriptorPool.getDescriptorSet(descriptorSetLayout);
+    BZ_CRITICAL_ERROR_CORE(descriptorSet, "Failed to allocate the bindless DescriptorSet!");
+}
+
+void BindlessTextureTable::destroy() {
+    indices.clear();
+    textureViews.clear();
+    samplers.clear();
+
+    descriptorPool.destroy();
+    descriptorSetLayout.reset();
+}
+
+uint32 BindlessTextureTable::registerTexture(const Ref<TextureView> &textureView, const Ref<Sampler> &sampler) {
+    BZ_ASSERT_CORE(textureView, "Invalid TextureView!");
+    BZ_ASSERT_CORE(sampler, "Invalid Sampler!");
+
+    auto key = std::make_pair(textureView.get(), sampler.get());
+    auto it = indices.find(key);
+    if (it != indices.end()) {
+        return it->second;
+    }
+
+    uint32 index = getTextureCount();
+    BZ_CRITICAL_ERROR_CORE(index < capacity, "BindlessTextureTable is full! Capacity: {}.", capacity);
+
+    descriptorSet->setCombinedTextureSamplers(&textureView, 1, index, sampler, 0);
+
+    textureViews.push_back(textureView);
+    samplers.push_back(sampler);
+    indices.emplace(key, index);
+    return index;
+}
+}
\ No newline at end of file
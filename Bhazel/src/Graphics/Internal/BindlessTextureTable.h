@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Graphics/Internal/DescriptorPool.h"
+
+
+namespace BZ {
+
+class Device;
+class TextureView;
+class Sampler;
+
+/*
+ * A single DescriptorSet with a big partially bound array of combined texture samplers, using
+ * VK_EXT_descriptor_indexing. Textures are registered once and referenced by index on the shaders, avoiding per
+ * Material/Sprite DescriptorSet binds.
+ * Slots are never freed, the table holds the registered TextureViews and Samplers until destroyed.
+ * Internal only, not exposed to upper layers.
+ */
+class BindlessTextureTable {
+  public:
+    BindlessTextureTable() = default;
+
+    BZ_NON_COPYABLE(BindlessTextureTable);
+
+    void init(const Device &device, uint32 capacity);
+    void destroy();
+
+    // Returns the index of the texture on the table. Registering the same pair again returns the same index.
+    uint32 registerTexture(const Ref<TextureView> &textureView, const Ref<Sampler> &sampler);
+
+    const Ref<DescriptorSetLayout> &getDescriptorSetLayout() const { return descriptorSetLayout; }
+    const DescriptorSet &getDescriptorSet() const { return *descriptorSet; }
+
+    uint32 getCapacity() const { return capacity; }
+    uint32 getTextureCount() const { return static_cast<uint32>(textureViews.size()); }
+
+  private:
+    uint32 capacity;
+
+    DescriptorPool descriptorPool;
+    Ref<DescriptorSetLayout> descriptorSetLayout;
+    DescriptorSet *descriptorSet;
+
+    std::vector<Ref<TextureView>> textureViews;
+    std::vector<Ref<Sampler>> samplers;
+    std::map<std::pair<const TextureView *, const Sampler *>, uint32> indices;
+};
+}
\ No newline at end of file
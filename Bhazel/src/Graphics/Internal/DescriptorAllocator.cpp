@@ -0,0 +1,124 @@
+#include "bzpch.h"
+
+#include "DescriptorAllocator.h"
+
+#include "Graphics/Internal/Device.h"
+
+
+namespace BZ {
+
+// Descriptor counts of each pool, for SETS_PER_POOL sets.
+static const DescriptorPoolInitData POOL_SIZES[] = {
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 128 },
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 128 },
+    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 512 },
+    { VK_DESCRIPTOR_TYPE_SAMPLER, 64 },
+    { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 128 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 64 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 64 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 32 },
+};
+
+void DescriptorAllocator::init(const Device &device) {
+    this->device = &device;
+    currentFrameIndex = 0;
+    currentPoolIdx = 0;
+    stats = {};
+}
+
+void DescriptorAllocator::destroy() {
+    for (auto &pool : pools) {
+        pool->destroy();
+    }
+    pools.clear();
+
+    for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+        for (auto &pool : transientFrameDatas[i].pools) {
+            pool->destroy();
+        }
+        transientFrameDatas[i].pools.clear();
+        pendingReleases[i].clear();
+    }
+
+    freeLists.clear();
+}
+
+void DescriptorAllocator::beginFrame(uint32 frameIndex) {
+    BZ_ASSERT_CORE(frameIndex < MAX_FRAMES_IN_FLIGHT, "Invalid frameIndex!");
+    currentFrameIndex = frameIndex;
+
+    // The frame that released these sets is done on the GPU, they can be reused.
+    for (DescriptorSet *descSet : pendingReleases[frameIndex]) {
+        freeLists[descSet->getLayout().get()].push_back(descSet);
+    }
+    pendingReleases[frameIndex].clear();
+
+    TransientFrameData &frameData = transientFrameDatas[frameIndex];
+    for (auto &pool : frameData.pools) {
+        pool->reset();
+    }
+    frameData.currentPoolIdx = 0;
+    stats.transientSetCount = 0;
+}
+
+DescriptorSet &DescriptorAllocator::getDescriptorSet(const Ref<DescriptorSetLayout> &layout) {
+    BZ_ASSERT_CORE(layout, "DescriptorSetLayout is invalid!")
+
+    DescriptorSet *descSet = nullptr;
+
+    auto it = freeLists.find(layout.get());
+    if (it != freeLists.end() && !it->second.empty()) {
+        descSet = it->second.back();
+        it->second.pop_back();
+        descSet->init(descSet->getHandle(), layout);
+        stats.freeSetCount--;
+    }
+    else {
+        descSet = allocateFromPools(pools, currentPoolIdx, layout);
+    }
+
+    stats.liveSetCount++;
+    stats.liveSetHighWater = std::max(stats.liveSetHighWater, stats.liveSetCount);
+    return *descSet;
+}
+
+DescriptorSet &DescriptorAllocator::getTransientDescriptorSet(const Ref<DescriptorSetLayout> &layout) {
+    BZ_ASSERT_CORE(layout, "DescriptorSetLayout is invalid!")
+
+    TransientFrameData &frameData = transientFrameDatas[currentFrameIndex];
+    DescriptorSet *descSet = allocateFromPools(frameData.pools, frameData.currentPoolIdx, layout);
+
+    stats.transientSetCount++;
+    stats.transientSetHighWater = std::max(stats.transientSetHighWater, stats.transientSetCount);
+    return *descSet;
+}
+
+void DescriptorAllocator::releaseDescriptorSet(DescriptorSet &descriptorSet) {
+    BZ_ASSERT_CORE(stats.liveSetCount > 0, "Releasing more DescriptorSets than allocated!");
+
+    pendingReleases[currentFrameIndex].push_back(&descriptorSet);
+    stats.liveSetCount--;
+    stats.freeSetCount++;
+}
+
+DescriptorSet *DescriptorAllocator::allocateFromPools(std::vector<Scope<DescriptorPool>> &poolList, uint32 &poolIdx,
+                                                      const Ref<DescriptorSetLayout> &layout) {
+    // Pools before poolIdx are considered full.
+    while (poolIdx < poolList.size()) {
+        DescriptorSet *descSet = poolList[poolIdx]->getDescriptorSet(layout);
+        if (descSet) {
+            return descSet;
+        }
+        poolIdx++;
+    }
+
+    auto &newPool = poolList.emplace_back(MakeScope<DescriptorPool>());
+    newPool->init(*device, POOL_SIZES, static_cast<uint32>(std::size(POOL_SIZES)), SETS_PER_POOL);
+    stats.poolCount++;
+    BZ_LOG_CORE_INFO("DescriptorAllocator created a new DescriptorPool. Total: {}.", stats.poolCount);
+
+    DescriptorSet *descSet = newPool->getDescriptorSet(layout);
+    BZ_CRITICAL_ERROR_CORE(descSet, "DescriptorSetLayout does not fit on an empty DescriptorPool!");
+    return descSet;
+}
+}
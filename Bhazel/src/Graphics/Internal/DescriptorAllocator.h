@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Graphics/Internal/DescriptorPool.h"
+
+
+namespace BZ {
+
+class Device;
+
+struct DescriptorAllocatorStats {
+    uint32 poolCount;
+
+    // Persistent DescriptorSets currently in use and the maximum ever reached.
+    uint32 liveSetCount;
+    uint32 liveSetHighWater;
+
+    // Released DescriptorSets waiting on the free lists to be recycled.
+    uint32 freeSetCount;
+
+    // Transient DescriptorSets allocated on the current frame and the maximum ever reached on a single frame.
+    uint32 transientSetCount;
+    uint32 transientSetHighWater;
+};
+
+/*
+ * Hands out DescriptorSets, growing by creating more DescriptorPools when needed.
+ * Persistent sets live until released, being then recycled through a free list per DescriptorSetLayout.
+ * Transient sets live for the current frame only, coming from per frame pools that are reset on beginFrame().
+ * Internal only, not exposed to upper layers.
+ */
+class DescriptorAllocator {
+  public:
+    DescriptorAllocator() = default;
+
+    BZ_NON_COPYABLE(DescriptorAllocator);
+
+    void init(const Device &device);
+    void destroy();
+
+    // Must be called when it's safe to reuse the data of frameIndex.
+    void beginFrame(uint32 frameIndex);
+
+    DescriptorSet &getDescriptorSet(const Ref<DescriptorSetLayout> &layout);
+    DescriptorSet &getTransientDescriptorSet(const Ref<DescriptorSetLayout> &layout);
+
+    // The DescriptorSet will only be recycled when the current frame is no longer in flight.
+    void releaseDescriptorSet(DescriptorSet &descriptorSet);
+
+    const DescriptorAllocatorStats &getStats() const { return stats; }
+
+    constexpr static uint32 SETS_PER_POOL = 128;
+
+    // Needs to match GraphicsContext::MAX_FRAMES_IN_FLIGHT.
+    constexpr static uint32 MAX_FRAMES_IN_FLIGHT = 3;
+
+  private:
+    DescriptorSet *allocateFromPools(std::vector<Scope<DescriptorPool>> &poolList, uint32 &poolIdx,
+                                     const Ref<DescriptorSetLayout> &layout);
+
+    const Device *device;
+    uint32 currentFrameIndex = 0;
+
+    std::vector<Scope<DescriptorPool>> pools;
+    uint32 currentPoolIdx = 0;
+
+    // Recycled sets, indexed by the layout. The sets hold a Ref to the layout so the key is never dangling.
+    std::unordered_map<const DescriptorSetLayout *, std::vector<DescriptorSet *>> freeLists;
+
+    // Sets released on each frame. They will be moved to the free lists when the frame is no longer in flight.
+    std::vector<DescriptorSet *> pendingReleases[MAX_FRAMES_IN_FLIGHT];
+
+    struct TransientFrameData {
+        std::vector<Scope<DescriptorPool>> pools;
+        uint32 currentPoolIdx = 0;
+    };
+    TransientFrameData transientFrameDatas[MAX_FRAMES_IN_FLIGHT];
+
+    DescriptorAllocatorStats stats = {};
+};
+}
@@ -7,9 +7,9 @@
 
 namespace BZ {
 
-void DescriptorPool::init(const Device &device, const std::initializer_list<DescriptorPoolInitData> &initDatas,
-                          uint32 maxSets) {
-    BZ_ASSERT_CORE(initDatas.size() > 0, "DescriptorPoolInitDatas is empty!");
+void DescriptorPool::init(const Device &device, const DescriptorPoolInitData initDatas[], uint32 initDatasCount,
+                          uint32 maxSets, VkDescriptorPoolCreateFlags flags) {
+    BZ_ASSERT_CORE(initDatasCount > 0, "DescriptorPoolInitDatas is empty!");
     BZ_ASSERT_CORE(maxSets > 0, "maxSets needs to be greater than zero!");
 
     this->maxSets = maxSets;
@@ -17,19 +17,16 @@ void DescriptorPool::init(const Device &device, const std::initializer_list<Desc
 
     nextFreeIndex = 0;
 
-    std::vector<VkDescriptorPoolSize> vkDescriptorPoolSizes(initDatas.size());
-
-    uint32_t i = 0;
-    for (const auto &initData : initDatas) {
-        vkDescriptorPoolSizes[i].type = initData.type;
-        vkDescriptorPoolSizes[i].descriptorCount = initData.count;
-        i++;
+    std::vector<VkDescriptorPoolSize> vkDescriptorPoolSizes(initDatasCount);
+    for (uint32 i = 0; i < initDatasCount; ++i) {
+        vkDescriptorPoolSizes[i].type = initDatas[i].type;
+        vkDescriptorPoolSizes[i].descriptorCount = initDatas[i].count;
     }
 
     VkDescriptorPoolCreateInfo poolInfo = {};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.flags = 0;
-    poolInfo.poolSizeCount = i;
+    poolInfo.flags = flags;
+    poolInfo.poolSizeCount = initDatasCount;
     poolInfo.pPoolSizes = vkDescriptorPoolSizes.data();
     poolInfo.maxSets = maxSets;
 
@@ -44,12 +41,12 @@ void DescriptorPool::destroy() {
     vkDestroyDescriptorPool(device->getHandle(), handle, nullptr);
 }
 
-DescriptorSet &DescriptorPool::getDescriptorSet(const Ref<DescriptorSetLayout> &layout) {
-
+DescriptorSet *DescriptorPool::getDescriptorSet(const Ref<DescriptorSetLayout> &layout) {
     BZ_ASSERT_CORE(layout, "DescriptorSetLayout is invalid!")
 
-    // TODO: Do better than this. It's OK for now.
-    BZ_ASSERT_CORE(nextFreeIndex < maxSets, "DescriptorPool has reached maximum capacity!");
+    if (isFull()) {
+        return nullptr;
+    }
 
     VkDescriptorSetLayout layouts[] = { layout->getHandle() };
 
@@ -63,18 +60,16 @@ DescriptorSet &DescriptorPool::getDescriptorSet(const Ref<DescriptorSetLayout> &
     VkResult res = vkAllocateDescriptorSets(device->getHandle(), &allocInfo, &newDescSet);
 
     // Besides maxSets already accounted for, the pool may exceed the number of a specific Descriptor type.
-    if (res == VK_ERROR_OUT_OF_POOL_MEMORY) {
-        // TODO: Do better than this. It's OK for now.
-        BZ_CRITICAL_ERROR_CORE_ALWAYS("DescriptorPool has reached maximum capacity!");
+    if (res == VK_ERROR_OUT_OF_POOL_MEMORY || res == VK_ERROR_FRAGMENTED_POOL) {
+        return nullptr;
     }
     else if (res < 0) {
         BZ_ASSERT_ALWAYS_CORE("vkAllocateDescriptorSets returned error {}!", res);
+        return nullptr;
     }
 
-    BZ_LOG_CORE_INFO("Allocated a DescriptorSet.");
-
     sets[nextFreeIndex].init(newDescSet, layout);
-    return sets[nextFreeIndex++];
+    return &sets[nextFreeIndex++];
 }
 
 void DescriptorPool::reset() {
@@ -13,20 +13,26 @@ struct DescriptorPoolInitData {
     uint32 count;
 };
 
-// Internal only, not exposed to upper layers.
+// A single fixed size VkDescriptorPool. Used as a block by the DescriptorAllocator. Internal only, not exposed to upper
+// layers.
 class DescriptorPool {
   public:
     DescriptorPool() = default;
 
     BZ_NON_COPYABLE(DescriptorPool);
 
-    void init(const Device &device, const std::initializer_list<DescriptorPoolInitData> &initDatas, uint32 maxSets);
+    void init(const Device &device, const DescriptorPoolInitData initDatas[], uint32 initDatasCount, uint32 maxSets,
+              VkDescriptorPoolCreateFlags flags = 0);
     void destroy();
 
-    DescriptorSet &getDescriptorSet(const Ref<DescriptorSetLayout> &layout);
+    // Returns nullptr when the pool is out of space, either on maxSets or on a specific Descriptor type.
+    DescriptorSet *getDescriptorSet(const Ref<DescriptorSetLayout> &layout);
 
     void reset();
 
+    uint32 getAllocatedSetCount() const { return nextFreeIndex; }
+    bool isFull() const { return nextFreeIndex >= maxSets; }
+
     VkDescriptorPool getHandle() const { return handle; }
 
   private:
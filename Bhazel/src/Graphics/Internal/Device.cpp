@@ -42,6 +42,27 @@ void PhysicalDevice::init(const Instance &instance, const Surface &surface,
     BZ_LOG_CORE_INFO("  DeviceId: 0x{:04x}.", physicalDeviceProperties.deviceID);
 
     limits = physicalDeviceProperties.limits;
+
+    descriptorIndexingSupported = checkDescriptorIndexingSupport(handle);
+    if (descriptorIndexingSupported) {
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptorIndexingProperties = {};
+        descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+        VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {};
+        physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        physicalDeviceProperties2.pNext = &descriptorIndexingProperties;
+        vkGetPhysicalDeviceProperties2(handle, &physicalDeviceProperties2);
+
+        maxUpdateAfterBindSampledImages =
+            std::min(descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+                     descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+    }
+    BZ_LOG_CORE_INFO("  Descriptor Indexing: {}.", descriptorIndexingSupported ? "supported" : "not supported");
+
+    VkPhysicalDeviceFeatures deviceFeatures;
+    vkGetPhysicalDeviceFeatures(handle, &deviceFeatures);
+    multiDrawIndirectSupported = deviceFeatures.multiDrawIndirect == VK_TRUE;
+    BZ_LOG_CORE_INFO("  Multi Draw Indirect: {}.", multiDrawIndirectSupported ? "supported" : "not supported");
 }
 
 QueueFamilyContainer PhysicalDevice::getQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface) {
@@ -150,10 +171,36 @@ bool PhysicalDevice::checkDeviceExtensionSupport(VkPhysicalDevice device,
     return true;
 }
 
+bool PhysicalDevice::checkDescriptorIndexingSupport(VkPhysicalDevice device) {
+    const std::vector<const char *> extensions = { VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME };
+    if (!checkDeviceExtensionSupport(device, extensions))
+        return false;
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+    descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+    VkPhysicalDeviceFeatures2 deviceFeatures2 = {};
+    deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures2.pNext = &descriptorIndexingFeatures;
+    vkGetPhysicalDeviceFeatures2(device, &deviceFeatures2);
+
+    return deviceFeatures2.features.shaderSampledImageArrayDynamicIndexing &&
+           descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing &&
+           descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+           descriptorIndexingFeatures.descriptorBindingPartiallyBound &&
+           descriptorIndexingFeatures.runtimeDescriptorArray;
+}
+
 
 /*-------------------------------------------------------------------------------------------*/
-void Device::init(const PhysicalDevice &physicalDevice, const std::vector<const char *> &requiredDeviceExtensions) {
+void Device::init(const PhysicalDevice &physicalDevice, const std::vector<const char *> &requiredDeviceExtensions,
+                  bool enableDescriptorIndexing) {
+    BZ_ASSERT_CORE(!enableDescriptorIndexing || physicalDevice.isDescriptorIndexingSupported(),
+                   "Descriptor indexing is not supported by the PhysicalDevice!");
+
     this->physicalDevice = &physicalDevice;
+    descriptorIndexingEnabled = enableDescriptorIndexing;
+    multiDrawIndirectEnabled = physicalDevice.isMultiDrawIndirectSupported();
 
     constexpr int QUEUE_PROPS_COUNT = static_cast<int>(QueueProperty::Count);
     int maxScores[QUEUE_PROPS_COUNT] = {};
@@ -254,14 +301,29 @@ void Device::init(const PhysicalDevice &physicalDevice, const std::vector<const
     deviceFeatures.depthClamp = VK_TRUE;
     deviceFeatures.depthBiasClamp = VK_TRUE;
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    deviceFeatures.multiDrawIndirect = physicalDevice.isMultiDrawIndirectSupported() ? VK_TRUE : VK_FALSE;
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = enableDescriptorIndexing ? VK_TRUE : VK_FALSE;
+
+    // Optional features, only the ones needed for bindless textures.
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+    descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+    descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+
+    std::vector<const char *> deviceExtensions = requiredDeviceExtensions;
+    if (enableDescriptorIndexing)
+        deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
 
     VkDeviceCreateInfo deviceCreateInfo = {};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceCreateInfo.pNext = enableDescriptorIndexing ? &descriptorIndexingFeatures : nullptr;
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
     deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(requiredDeviceExtensions.size());
-    deviceCreateInfo.ppEnabledExtensionNames = requiredDeviceExtensions.data();
+    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
     BZ_ASSERT_VK(vkCreateDevice(physicalDevice.getHandle(), &deviceCreateInfo, nullptr, &handle));
 
     queueContainer.graphics().init(*this, *selectedFamilies[static_cast<int>(QueueProperty::Graphics)]);
@@ -24,6 +24,13 @@ class PhysicalDevice {
 
     const VkPhysicalDeviceLimits &getLimits() const { return limits; }
 
+    // Support for the VK_EXT_descriptor_indexing features needed for bindless textures.
+    bool isDescriptorIndexingSupported() const { return descriptorIndexingSupported; }
+    uint32 getMaxUpdateAfterBindSampledImages() const { return maxUpdateAfterBindSampledImages; }
+
+    // Indirect draws with a drawCount over 1.
+    bool isMultiDrawIndirectSupported() const { return multiDrawIndirectSupported; }
+
     const QueueFamilyContainer &getQueueFamilyContainer() const { return queueFamilyContainer; }
     const SwapChainSupportDetails &getSwapChainSupportDetails() const { return swapChainSupportDetails; }
     VkPhysicalDevice getHandle() const { return handle; }
@@ -36,6 +43,10 @@ class PhysicalDevice {
 
     VkPhysicalDeviceLimits limits;
 
+    bool descriptorIndexingSupported = false;
+    uint32 maxUpdateAfterBindSampledImages = 0;
+    bool multiDrawIndirectSupported = false;
+
     static QueueFamilyContainer getQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface);
     static SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface);
     static bool isPhysicalDeviceSuitable(VkPhysicalDevice device,
@@ -44,6 +55,7 @@ class PhysicalDevice {
                                          const std::vector<const char *> &requiredExtensions);
     static bool checkDeviceExtensionSupport(VkPhysicalDevice device,
                                             const std::vector<const char *> &requiredExtensions);
+    static bool checkDescriptorIndexingSupport(VkPhysicalDevice device);
 
     friend class Device;
 };
@@ -57,11 +69,17 @@ class Device {
 
     BZ_NON_COPYABLE(Device);
 
-    void init(const PhysicalDevice &physicalDevice, const std::vector<const char *> &requiredDeviceExtensions);
+    void init(const PhysicalDevice &physicalDevice, const std::vector<const char *> &requiredDeviceExtensions,
+              bool enableDescriptorIndexing);
     void destroy();
 
     VkDevice getHandle() const { return handle; }
 
+    bool isDescriptorIndexingEnabled() const { return descriptorIndexingEnabled; }
+
+    // Enabled whenever supported. Otherwise indirect draws must be issued one command at a time.
+    bool isMultiDrawIndirectEnabled() const { return multiDrawIndirectEnabled; }
+
     const QueueContainer &getQueueContainer() const { return queueContainer; }
     const PhysicalDevice &getPhysicalDevice() const { return *physicalDevice; }
 
@@ -69,6 +87,9 @@ class Device {
     VkDevice handle = VK_NULL_HANDLE;
     const PhysicalDevice *physicalDevice;
 
+    bool descriptorIndexingEnabled = false;
+    bool multiDrawIndirectEnabled = false;
+
     QueueContainer queueContainer;
 };
 }
\ No newline at end of file
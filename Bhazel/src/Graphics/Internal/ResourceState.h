@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Graphics/Internal/VulkanIncludes.h"
+
+
+namespace BZ {
+
+/*
+ * Last known state of a Texture subresource (one mip of one layer) or of a whole Buffer, as recorded on the
+ * CommandBuffers. Used to find the barriers needed for the next declared usage and to skip the redundant ones.
+ * Assumes that CommandBuffers are submitted in the same order that they are recorded.
+ * Internal only, not exposed to upper layers.
+ */
+struct ResourceState {
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; // Ignored on Buffers.
+
+    // Stages and accesses of the last write (or layout transition).
+    VkPipelineStageFlags writeStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkAccessFlags writeAccessMask = 0;
+
+    // Stages and accesses that already read the data since the last write, which is visible to them.
+    VkPipelineStageFlags readStageMask = 0;
+    VkAccessFlags readAccessMask = 0;
+
+    // There's a barrier for this resource on a CommandBuffer waiting to be flushed.
+    bool pending = false;
+};
+}
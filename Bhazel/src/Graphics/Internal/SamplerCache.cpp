@@ -0,0 +1,41 @@
+#include "bzpch.h"
+
+#include "SamplerCache.h"
+
+
+namespace BZ {
+
+void SamplerCache::destroy() {
+    BZ_ASSERT_CORE(samplers.empty(), "Destroying SamplerCache with {} Samplers still alive!", samplers.size());
+    samplers.clear();
+}
+
+Ref<Sampler> SamplerCache::getSampler(const Sampler::Builder &builder) {
+    auto it = samplers.find(builder);
+    if (it != samplers.end()) {
+        Ref<Sampler> sampler = it->second.lock();
+        if (sampler) {
+            return sampler;
+        }
+    }
+
+    Ref<Sampler> sampler = MakeRef<Sampler>(builder);
+    samplers[builder] = sampler;
+    return sampler;
+}
+
+void SamplerCache::onSamplerDestroyed(const Sampler::Builder &builder) {
+    auto it = samplers.find(builder);
+    if (it != samplers.end() && it->second.expired()) {
+        samplers.erase(it);
+    }
+}
+
+uint32 SamplerCache::getReferenceCount() const {
+    uint32 count = 0;
+    for (const auto &pair : samplers) {
+        count += static_cast<uint32>(pair.second.use_count());
+    }
+    return count;
+}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Graphics/Texture.h"
+#include "Graphics/Internal/VulkanIncludes.h"
+
+
+namespace BZ {
+
+/*
+ * Shares Samplers created with identical parameters. The cache only holds weak references, the Sampler is destroyed
+ * when the last user releases it. Internal only, not exposed to upper layers.
+ */
+class SamplerCache {
+  public:
+    SamplerCache() = default;
+
+    BZ_NON_COPYABLE(SamplerCache);
+
+    void destroy();
+
+    Ref<Sampler> getSampler(const Sampler::Builder &builder);
+
+    // Called by the Sampler destructor.
+    void onSamplerDestroyed(const Sampler::Builder &builder);
+
+    uint32 getLiveSamplerCount() const { return static_cast<uint32>(samplers.size()); }
+
+    // Sum of all the references to the live Samplers.
+    uint32 getReferenceCount() const;
+
+  private:
+    std::unordered_map<Sampler::Builder, std::weak_ptr<Sampler>> samplers;
+};
+}
@@ -0,0 +1,152 @@
+#include "bzpch.h"
+
+#include "SubmitBatcher.h"
+
+#include "Graphics/Internal/Queue.h"
+
+
+namespace BZ {
+
+void SubmitBatcher::QueueBatch::clear() {
+    commandBuffers.clear();
+    waitSemaphores.clear();
+    waitStages.clear();
+    signalSemaphores.clear();
+    submits.clear();
+    openSubmit = 0;
+}
+
+void SubmitBatcher::enqueue(const Queue &queue, const VkCommandBuffer commandBuffers[], uint32 commandBufferCount,
+                            const VkSemaphore waitSemaphores[], const VkPipelineStageFlags waitStages[],
+                            uint32 waitSemaphoreCount, const VkSemaphore signalSemaphores[],
+                            uint32 signalSemaphoreCount) {
+    BZ_ASSERT_CORE(commandBufferCount > 0, "Invalid commandBufferCount!");
+
+    QueueBatch &batch = batches[&queue];
+    if (batch.submits.empty()) {
+        queueOrder.push_back(&queue);
+    }
+
+    for (uint32 i = 0; i < waitSemaphoreCount; ++i) {
+        auto it = pendingSignals.find(waitSemaphores[i]);
+        if (it != pendingSignals.end() && it->second != &queue) {
+            closeQueueSubmit(*it->second);
+        }
+    }
+
+    // Waits apply to the whole VkSubmitInfo and signals happen when all of it is done. So merging with the previous one
+    // is only possible when the new submission doesn't wait and the previous doesn't signal, and the previous one is
+    // not already closed.
+    bool canMerge = batch.openSubmit < batch.submits.size() && waitSemaphoreCount == 0 &&
+                    batch.submits.back().signalSemaphoreCount == 0;
+    if (!canMerge) {
+        PendingSubmit submit;
+        submit.firstCommandBuffer = static_cast<uint32>(batch.commandBuffers.size());
+        submit.commandBufferCount = 0;
+        submit.firstWaitSemaphore = static_cast<uint32>(batch.waitSemaphores.size());
+        submit.waitSemaphoreCount = waitSemaphoreCount;
+        submit.firstSignalSemaphore = static_cast<uint32>(batch.signalSemaphores.size());
+        submit.signalSemaphoreCount = 0;
+        batch.submits.push_back(submit);
+
+        batch.waitSemaphores.insert(batch.waitSemaphores.end(), waitSemaphores, waitSemaphores + waitSemaphoreCount);
+        batch.waitStages.insert(batch.waitStages.end(), waitStages, waitStages + waitSemaphoreCount);
+    }
+
+    // The merged submission is always the last one, so its arrays are contiguous at the end.
+    PendingSubmit &submit = batch.submits.back();
+    batch.commandBuffers.insert(batch.commandBuffers.end(), commandBuffers, commandBuffers + commandBufferCount);
+    submit.commandBufferCount += commandBufferCount;
+    batch.signalSemaphores.insert(batch.signalSemaphores.end(), signalSemaphores,
+                                  signalSemaphores + signalSemaphoreCount);
+    submit.signalSemaphoreCount += signalSemaphoreCount;
+
+    for (uint32 i = 0; i < signalSemaphoreCount; ++i) {
+        pendingSignals[signalSemaphores[i]] = &queue;
+    }
+}
+
+void SubmitBatcher::closeQueueSubmit(const Queue &queue) {
+    QueueBatch &batch = batches[&queue];
+    const uint32 submitCount = static_cast<uint32>(batch.submits.size());
+    if (batch.openSubmit == submitCount) {
+        return;
+    }
+
+    // The signals of the closed submits will be submitted before any later wait.
+    const uint32 firstSignal = batch.submits[batch.openSubmit].firstSignalSemaphore;
+    for (uint32 i = firstSignal; i < batch.signalSemaphores.size(); ++i) {
+        pendingSignals.erase(batch.signalSemaphores[i]);
+    }
+
+    closedQueueSubmits.push_back({ &queue, batch.openSubmit, submitCount - batch.openSubmit });
+    batch.openSubmit = submitCount;
+}
+
+void SubmitBatcher::getPendingQueueSubmits(std::vector<QueueSubmit> &outQueueSubmits) const {
+    outQueueSubmits = closedQueueSubmits;
+
+    // Nothing open waits on a signal of another open submit, the order between Queues doesn't matter.
+    for (const Queue *queue : queueOrder) {
+        const QueueBatch &batch = batches.at(queue);
+        const uint32 submitCount = static_cast<uint32>(batch.submits.size());
+        if (batch.openSubmit < submitCount) {
+            outQueueSubmits.push_back({ queue, batch.openSubmit, submitCount - batch.openSubmit });
+        }
+    }
+}
+
+uint32 SubmitBatcher::flush(const Queue *fenceQueue, VkFence fence) {
+    for (const Queue *queue : queueOrder) {
+        closeQueueSubmit(*queue);
+    }
+
+    uint32 fenceQueueSubmit = static_cast<uint32>(closedQueueSubmits.size());
+    for (uint32 i = 0; i < closedQueueSubmits.size(); ++i) {
+        if (closedQueueSubmits[i].queue == fenceQueue) {
+            fenceQueueSubmit = i;
+        }
+    }
+
+    for (uint32 i = 0; i < closedQueueSubmits.size(); ++i) {
+        const QueueSubmit &queueSubmit = closedQueueSubmits[i];
+        const QueueBatch &batch = batches[queueSubmit.queue];
+
+        submitInfos.resize(queueSubmit.submitInfoCount);
+        for (uint32 j = 0; j < queueSubmit.submitInfoCount; ++j) {
+            const PendingSubmit &submit = batch.submits[queueSubmit.firstSubmitInfo + j];
+
+            VkSubmitInfo &submitInfo = submitInfos[j];
+            submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.waitSemaphoreCount = submit.waitSemaphoreCount;
+            submitInfo.pWaitSemaphores = batch.waitSemaphores.data() + submit.firstWaitSemaphore;
+            submitInfo.pWaitDstStageMask = batch.waitStages.data() + submit.firstWaitSemaphore;
+            submitInfo.commandBufferCount = submit.commandBufferCount;
+            submitInfo.pCommandBuffers = batch.commandBuffers.data() + submit.firstCommandBuffer;
+            submitInfo.signalSemaphoreCount = submit.signalSemaphoreCount;
+            submitInfo.pSignalSemaphores = batch.signalSemaphores.data() + submit.firstSignalSemaphore;
+        }
+
+        BZ_ASSERT_VK(vkQueueSubmit(queueSubmit.queue->getHandle(), queueSubmit.submitInfoCount, submitInfos.data(),
+                                   i == fenceQueueSubmit ? fence : VK_NULL_HANDLE));
+    }
+    uint32 vkSubmitCount = static_cast<uint32>(closedQueueSubmits.size());
+
+    // Nothing was pending on fenceQueue, still need to signal the Fence.
+    if (fence != VK_NULL_HANDLE && fenceQueueSubmit == closedQueueSubmits.size()) {
+        BZ_ASSERT_CORE(fenceQueue, "Signaling a Fence without a Queue!");
+        BZ_ASSERT_VK(vkQueueSubmit(fenceQueue->getHandle(), 0, nullptr, fence));
+        vkSubmitCount++;
+    }
+
+    for (const Queue *queue : queueOrder) {
+        batches[queue].clear();
+    }
+    queueOrder.clear();
+    closedQueueSubmits.clear();
+    pendingSignals.clear();
+
+    return vkSubmitCount;
+}
+}
\ No newline at end of file
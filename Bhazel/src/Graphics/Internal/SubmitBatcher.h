@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Graphics/Internal/VulkanIncludes.h"
+
+
+namespace BZ {
+
+class Queue;
+
+/*
+ * Accumulates the submissions made during a frame, per Queue, and sends them with as few vkQueueSubmit calls as
+ * possible when flushed. Consecutive submissions without semaphores in between are merged into the same VkSubmitInfo.
+ * A semaphore signaled on a Queue and waited on another must be submitted for signaling first, so waiting on it ends
+ * the vkQueueSubmit of the signaling Queue, and the flush sends them in that order. Without cross Queue waits there's
+ * a single vkQueueSubmit per Queue.
+ * Needs to be flushed on the sync points: when signaling a Fence, before waiting on a Queue/Device and before
+ * presenting.
+ * Internal only, not exposed to upper layers.
+ */
+class SubmitBatcher {
+  public:
+    // A vkQueueSubmit with submitInfoCount VkSubmitInfos.
+    struct QueueSubmit {
+        const Queue *queue;
+        uint32 firstSubmitInfo;
+        uint32 submitInfoCount;
+    };
+
+    SubmitBatcher() = default;
+
+    BZ_NON_COPYABLE(SubmitBatcher);
+
+    void enqueue(const Queue &queue, const VkCommandBuffer commandBuffers[], uint32 commandBufferCount,
+                 const VkSemaphore waitSemaphores[], const VkPipelineStageFlags waitStages[], uint32 waitSemaphoreCount,
+                 const VkSemaphore signalSemaphores[], uint32 signalSemaphoreCount);
+
+    // Submits everything pending, on dependency order. The Fence, if any, will be signaled by the last submission of
+    // fenceQueue. Returns the number of vkQueueSubmit calls made.
+    uint32 flush(const Queue *fenceQueue = nullptr, VkFence fence = VK_NULL_HANDLE);
+
+    bool hasPendingSubmits() const { return !queueOrder.empty(); }
+
+    // The vkQueueSubmit calls that a flush would make now, on the order it would make them.
+    void getPendingQueueSubmits(std::vector<QueueSubmit> &outQueueSubmits) const;
+
+  private:
+    // Indices into the arrays of a QueueBatch.
+    struct PendingSubmit {
+        uint32 firstCommandBuffer;
+        uint32 commandBufferCount;
+        uint32 firstWaitSemaphore;
+        uint32 waitSemaphoreCount;
+        uint32 firstSignalSemaphore;
+        uint32 signalSemaphoreCount;
+    };
+
+    struct QueueBatch {
+        std::vector<VkCommandBuffer> commandBuffers;
+        std::vector<VkSemaphore> waitSemaphores;
+        std::vector<VkPipelineStageFlags> waitStages;
+        std::vector<VkSemaphore> signalSemaphores;
+        std::vector<PendingSubmit> submits;
+
+        // Submits from here on are not yet on a closed QueueSubmit.
+        uint32 openSubmit = 0;
+
+        void clear();
+    };
+
+    // Puts the open submits of the Queue on their own QueueSubmit, after the closed ones.
+    void closeQueueSubmit(const Queue &queue);
+
+    std::unordered_map<const Queue *, QueueBatch> batches;
+    std::vector<const Queue *> queueOrder;
+
+    // QueueSubmits that have to go before the open submits, on order.
+    std::vector<QueueSubmit> closedQueueSubmits;
+
+    // Semaphores signaled by open submits, and their Queue.
+    std::unordered_map<VkSemaphore, const Queue *> pendingSignals;
+
+    // Kept to avoid allocations on every flush.
+    std::vector<VkSubmitInfo> submitInfos;
+};
+}
\ No newline at end of file
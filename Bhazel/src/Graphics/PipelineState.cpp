@@ -48,6 +48,31 @@ PipelineLayout::~PipelineLayout() {
 }
 
 
+/*-------------------------------------------------------------------------------------------*/
+// Fills outInfo with the constants of one stage. outEntries and outValues need to outlive outInfo.
+static void fillSpecializationInfo(const std::vector<SpecializationConstant> &constants, VkShaderStageFlagBits stage,
+                                   std::vector<VkSpecializationMapEntry> &outEntries, std::vector<uint32> &outValues,
+                                   VkSpecializationInfo &outInfo) {
+    outEntries.clear();
+    outValues.clear();
+    for (const auto &constant : constants) {
+        if (BZ_FLAG_CHECK(constant.stageFlags, stage)) {
+            VkSpecializationMapEntry entry;
+            entry.constantID = constant.id;
+            entry.offset = static_cast<uint32>(outValues.size() * sizeof(uint32));
+            entry.size = sizeof(uint32);
+            outEntries.push_back(entry);
+            outValues.push_back(constant.value);
+        }
+    }
+
+    outInfo.mapEntryCount = static_cast<uint32>(outEntries.size());
+    outInfo.pMapEntries = outEntries.data();
+    outInfo.dataSize = outValues.size() * sizeof(uint32);
+    outInfo.pData = outValues.data();
+}
+
+
 /*-------------------------------------------------------------------------------------------*/
 PipelineStateData::PipelineStateData() {
     const auto WINDOW_DIMS_UINT = Engine::get().getWindow().getDimensions();
@@ -64,23 +89,28 @@ Ref<PipelineState> PipelineState::create(PipelineStateData &data) {
 PipelineState::PipelineState(PipelineStateData &inData) : data(inData) {
 
     BZ_ASSERT_CORE(data.shader, "PipelineState needs a shader!");
-    BZ_ASSERT_CORE(std::find(data.dynamicStates.begin(), data.dynamicStates.end(), VK_DYNAMIC_STATE_VIEWPORT) !=
-                           data.dynamicStates.end() ||
-                       !data.viewports.empty(),
-                   "PipelineState with no dynamic Viewport, needs at least one Viewport!");
-
-    BZ_ASSERT_CORE(
-        std::find(data.dynamicStates.begin(), data.dynamicStates.end(), VK_DYNAMIC_STATE_SCISSOR) !=
-                data.dynamicStates.end() ||
-            std::find(data.dynamicStates.begin(), data.dynamicStates.end(), VK_DYNAMIC_STATE_VIEWPORT) !=
-                data.dynamicStates.end() ||
-            data.scissorRects.size() == data.viewports.size(),
-        "With non-dynamic Scissor and Viewports the number of Viewports must match the number of ScissorsRects!");
-
-    BZ_ASSERT_CORE(data.renderPass, "PipelineState needs a RenderPass!");
-    BZ_ASSERT_CORE(data.renderPass->getColorAttachmentCount() == data.blendingState.attachmentBlendingStates.size(),
-                   "The number of color attachments defined on the RenderPass must match the number of BlendingStates "
-                   "on PipelineState!");
+    BZ_ASSERT_CORE(data.layout, "PipelineState needs a PipelineLayout!");
+
+    if (!isCompute()) {
+        BZ_ASSERT_CORE(std::find(data.dynamicStates.begin(), data.dynamicStates.end(), VK_DYNAMIC_STATE_VIEWPORT) !=
+                               data.dynamicStates.end() ||
+                           !data.viewports.empty(),
+                       "PipelineState with no dynamic Viewport, needs at least one Viewport!");
+
+        BZ_ASSERT_CORE(
+            std::find(data.dynamicStates.begin(), data.dynamicStates.end(), VK_DYNAMIC_STATE_SCISSOR) !=
+                    data.dynamicStates.end() ||
+                std::find(data.dynamicStates.begin(), data.dynamicStates.end(), VK_DYNAMIC_STATE_VIEWPORT) !=
+                    data.dynamicStates.end() ||
+                data.scissorRects.size() == data.viewports.size(),
+            "With non-dynamic Scissor and Viewports the number of Viewports must match the number of ScissorsRects!");
+
+        BZ_ASSERT_CORE(data.renderPass, "PipelineState needs a RenderPass!");
+        BZ_ASSERT_CORE(
+            data.renderPass->getColorAttachmentCount() == data.blendingState.attachmentBlendingStates.size(),
+            "The number of color attachments defined on the RenderPass must match the number of BlendingStates on "
+            "PipelineState!");
+    }
 
 #ifdef BZ_HOT_RELOAD_SHADERS
     Engine::get().getFileWatcher().registerPipelineState(*this);
@@ -101,7 +131,16 @@ void PipelineState::reload() {
     init();
 }
 
+bool PipelineState::isCompute() const {
+    return data.shader->getStageCount() == 1 && data.shader->getStageData(0).stageFlag == VK_SHADER_STAGE_COMPUTE_BIT;
+}
+
 void PipelineState::init() {
+    if (isCompute()) {
+        initCompute();
+        return;
+    }
+
     // Vertex input data format
     std::vector<VkVertexInputBindingDescription> bindingDescriptions;
     std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
@@ -233,12 +272,21 @@ void PipelineState::init() {
 
     // Shader setup
     std::array<VkPipelineShaderStageCreateInfo, MAX_SHADER_STAGE_COUNT> shaderStagesCreateInfos;
+    std::array<VkSpecializationInfo, MAX_SHADER_STAGE_COUNT> specializationInfos;
+    std::array<std::vector<VkSpecializationMapEntry>, MAX_SHADER_STAGE_COUNT> specializationEntries;
+    std::array<std::vector<uint32>, MAX_SHADER_STAGE_COUNT> specializationValues;
     for (uint32 i = 0; i < data.shader->getStageCount(); ++i) {
         VkPipelineShaderStageCreateInfo shaderCreateInfo = {};
         shaderCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         shaderCreateInfo.stage = data.shader->getStageData(i).stageFlag;
         shaderCreateInfo.module = data.shader->getHandle().modules[i];
         shaderCreateInfo.pName = "main";
+
+        fillSpecializationInfo(data.specializationConstants, shaderCreateInfo.stage, specializationEntries[i],
+                               specializationValues[i], specializationInfos[i]);
+        if (specializationInfos[i].mapEntryCount > 0) {
+            shaderCreateInfo.pSpecializationInfo = &specializationInfos[i];
+        }
         shaderStagesCreateInfos[i] = shaderCreateInfo;
     }
 
@@ -271,7 +319,70 @@ void PipelineState::init() {
         vkCreateGraphicsPipelines(BZ_GRAPHICS_DEVICE.getHandle(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &handle));
 }
 
+void PipelineState::initCompute() {
+    VkPipelineShaderStageCreateInfo shaderCreateInfo = {};
+    shaderCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderCreateInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    shaderCreateInfo.module = data.shader->getHandle().modules[0];
+    shaderCreateInfo.pName = "main";
+
+    VkSpecializationInfo specializationInfo;
+    std::vector<VkSpecializationMapEntry> specializationEntries;
+    std::vector<uint32> specializationValues;
+    fillSpecializationInfo(data.specializationConstants, VK_SHADER_STAGE_COMPUTE_BIT, specializationEntries,
+                           specializationValues, specializationInfo);
+    if (specializationInfo.mapEntryCount > 0) {
+        shaderCreateInfo.pSpecializationInfo = &specializationInfo;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = shaderCreateInfo;
+    pipelineInfo.layout = data.layout->getHandle();
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.basePipelineIndex = -1;
+
+    BZ_ASSERT_VK(
+        vkCreateComputePipelines(BZ_GRAPHICS_DEVICE.getHandle(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &handle));
+}
+
 void PipelineState::destroy() {
     vkDestroyPipeline(BZ_GRAPHICS_DEVICE.getHandle(), handle, nullptr);
 }
+
+
+/*-------------------------------------------------------------------------------------------*/
+void PipelineStatePermutations::init(const PipelineStateData &baseData, VkShaderStageFlags stageFlags,
+                                     uint32 constantCount, const char *debugName) {
+    BZ_ASSERT_CORE(constantCount <= 32, "The key only has 32 bits!");
+
+    this->baseData = std::make_unique<PipelineStateData>(baseData);
+    this->stageFlags = stageFlags;
+    this->constantCount = constantCount;
+    this->debugName = debugName;
+}
+
+void PipelineStatePermutations::destroy() {
+    permutations.clear();
+    baseData.reset();
+}
+
+const Ref<PipelineState> &PipelineStatePermutations::get(uint32 key) {
+    auto it = permutations.find(key);
+    if (it != permutations.end()) {
+        return it->second;
+    }
+
+    BZ_PROFILE_FUNCTION();
+
+    PipelineStateData data = *baseData;
+    for (uint32 id = 0; id < constantCount; ++id) {
+        const VkBool32 value = (key & (1u << id)) ? VK_TRUE : VK_FALSE;
+        data.specializationConstants.push_back({ stageFlags, id, value });
+    }
+
+    const Ref<PipelineState> &pipelineState = permutations[key] = PipelineState::create(data);
+    BZ_SET_PIPELINE_DEBUG_NAME(pipelineState, (debugName + " " + std::to_string(key)).c_str());
+    return pipelineState;
+}
 }
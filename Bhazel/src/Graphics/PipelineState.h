@@ -90,6 +90,16 @@ struct BlendingState {
     glm::vec4 blendingConstants = {};
 };
 
+// 32 bit constant for the shader stages on stageFlags, fixed when the pipeline is created. Booleans are VK_TRUE or
+// VK_FALSE.
+struct SpecializationConstant {
+    VkShaderStageFlags stageFlags;
+    uint32 id;
+    uint32 value;
+};
+
+// A compute PipelineState only uses the shader, with a single compute stage, the layout and the specialization
+// constants.
 struct PipelineStateData {
 
     PipelineStateData();
@@ -109,6 +119,7 @@ struct PipelineStateData {
     std::vector<VkDynamicState> dynamicStates;
     Ref<RenderPass> renderPass;
     uint32 subPassIndex = 0;
+    std::vector<SpecializationConstant> specializationConstants;
 };
 
 class PipelineState : public GpuObject<VkPipeline> {
@@ -122,13 +133,47 @@ class PipelineState : public GpuObject<VkPipeline> {
 
     const PipelineStateData &getData() const { return data; }
 
+    bool isCompute() const;
+
     // Used with the FileWatcher for Shader hot-reloading.
     void reload();
 
   private:
     void init();
+    void initCompute();
     void destroy();
 
     PipelineStateData data;
 };
+
+
+/*-------------------------------------------------------------------------------------------*/
+/*
+ * Permutations of a PipelineState that only differ on boolean specialization constants. Bit i of the key is the value
+ * of the constant with id i. Each permutation is created on its first use and then kept, so its creation cost is only
+ * paid once. Other constants on the base PipelineStateData are kept on every permutation, with ids after these.
+ */
+class PipelineStatePermutations {
+  public:
+    PipelineStatePermutations() = default;
+
+    BZ_NON_COPYABLE(PipelineStatePermutations);
+
+    // The constants go to the stages on stageFlags.
+    void init(const PipelineStateData &baseData, VkShaderStageFlags stageFlags, uint32 constantCount,
+              const char *debugName);
+    void destroy();
+
+    const Ref<PipelineState> &get(uint32 key);
+
+    uint32 getCount() const { return static_cast<uint32>(permutations.size()); }
+
+  private:
+    std::unique_ptr<PipelineStateData> baseData;
+    VkShaderStageFlags stageFlags;
+    uint32 constantCount;
+    std::string debugName;
+
+    std::unordered_map<uint32, Ref<PipelineState>> permutations;
+};
 }
@@ -26,14 +26,10 @@ static void generateMipmaps(CommandBuffer &comBuffer, const Texture &texture) {
     int mipWidth = texture.getDimensions().x;
     int mipHeight = texture.getDimensions().y;
 
-    uint32 i;
-    for (i = 1; i < texture.getMipLevels(); ++i) {
+    for (uint32 i = 1; i < texture.getMipLevels(); ++i) {
 
-        // Layout transition previous mipmap from DST_OPTIMAL to SRC_OPTIMAL.
-        comBuffer.pipelineBarrierTexture(texture, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
-                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                                         i - 1, 1);
+        // Previous mipmap from DST_OPTIMAL to SRC_OPTIMAL, sent together with the blit.
+        comBuffer.transitionTexture(texture, ResourceUsage::TransferSrc, i - 1, 1);
 
         VkImageBlit blit = {};
         blit.srcOffsets[0] = { 0, 0, 0 };
@@ -52,23 +48,14 @@ static void generateMipmaps(CommandBuffer &comBuffer, const Texture &texture) {
         comBuffer.blitTexture(texture, texture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &blit, 1, VK_FILTER_LINEAR);
 
-        // Layout transition previous mipmap from SRC_OPTIMAL to SHADER_READ_ONLY_OPTIMAL.
-        comBuffer.pipelineBarrierTexture(texture, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                         i - 1, 1);
-
         if (mipWidth > 1)
             mipWidth /= 2;
         if (mipHeight > 1)
             mipHeight /= 2;
     }
 
-    // Layout transition last mipmap from DST_OPTIMAL to SHADER_READ_ONLY_OPTIMAL.
-    comBuffer.pipelineBarrierTexture(texture, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                     VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                     i - 1, 1);
+    // All the mipmaps to SHADER_READ_ONLY_OPTIMAL, on a single barrier.
+    comBuffer.transitionTexture(texture, ResourceUsage::FragmentShaderRead);
 }
 
 static void copyBufferToImage(CommandBuffer &comBuffer, const Buffer &buffer, const Texture &texture,
@@ -389,6 +376,16 @@ Texture::~Texture() {
         vmaDestroyImage(BZ_MEM_ALLOCATOR, handle.imageHandle, handle.allocationHandle);
 }
 
+ResourceState &Texture::getSubresourceState(uint32 mipLevel, uint32 layer) const {
+    BZ_ASSERT_CORE(mipLevel < mipLevels, "Invalid mipLevel!");
+    BZ_ASSERT_CORE(layer < layers, "Invalid layer!");
+
+    if (subresourceStates.empty()) {
+        subresourceStates.resize(mipLevels * layers);
+    }
+    return subresourceStates[layer * mipLevels + mipLevel];
+}
+
 Texture::FileData Texture::loadFile(const char *path, int desiredChannels, bool flip, float isFloatingPoint) {
     stbi_set_flip_vertically_on_load(flip);
     int channelsInFile, width, height;
@@ -934,6 +931,11 @@ void TextureView::init(VkImageViewType viewType, uint32 baseLayer, uint32 layerC
     BZ_ASSERT_CORE(texture, "Invalid Texture!");
     BZ_ASSERT_CORE(format != VK_FORMAT_UNDEFINED, "Invalid Format!");
 
+    this->baseMip = baseMip;
+    this->mipCount = mipCount;
+    this->baseLayer = baseLayer;
+    this->layerCount = layerCount;
+
     VkImageViewCreateInfo imageViewCreateInfo = {};
     imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     imageViewCreateInfo.image = texture->getHandle().imageHandle;
@@ -963,10 +965,31 @@ void TextureView::init(VkImageViewType viewType, uint32 baseLayer, uint32 layerC
 
 
 Ref<Sampler> Sampler::Builder::build() const {
-    return MakeRef<Sampler>(*this);
+    return BZ_GRAPHICS_CTX.getSamplerCache().getSampler(*this);
+}
+
+bool Sampler::Builder::operator==(const Builder &other) const {
+    return minFilter == other.minFilter && magFilter == other.magFilter && mipmapFilter == other.mipmapFilter &&
+           minMipmap == other.minMipmap && maxMipmap == other.maxMipmap && addressModeU == other.addressModeU &&
+           addressModeV == other.addressModeV && addressModeW == other.addressModeW &&
+           anisotropyEnabled == other.anisotropyEnabled && maxAnisotropy == other.maxAnisotropy &&
+           unnormalizedCoordinatesEnabled == other.unnormalizedCoordinatesEnabled &&
+           compareEnabled == other.compareEnabled && compareOp == other.compareOp && borderColor == other.borderColor;
+}
+
+std::size_t Sampler::Builder::getHash() const {
+    std::size_t hash = std::hash<uint32>()(minFilter | (magFilter << 4) | (mipmapFilter << 8) | (addressModeU << 12) |
+                                           (addressModeV << 16) | (addressModeW << 20) | (compareOp << 24) |
+                                           (anisotropyEnabled << 28) | (unnormalizedCoordinatesEnabled << 29) |
+                                           (compareEnabled << 30));
+    hash = Utils::hashCombine(hash, std::hash<float>()(minMipmap));
+    hash = Utils::hashCombine(hash, std::hash<float>()(maxMipmap));
+    hash = Utils::hashCombine(hash, std::hash<float>()(maxAnisotropy));
+    hash = Utils::hashCombine(hash, std::hash<uint32>()(borderColor));
+    return hash;
 }
 
-Sampler::Sampler(const Builder &builder) {
+Sampler::Sampler(const Builder &builder) : builder(builder) {
     VkSamplerCreateInfo samplerInfo = {};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.minFilter = builder.minFilter;
@@ -990,5 +1013,6 @@ Sampler::Sampler(const Builder &builder) {
 
 Sampler::~Sampler() {
     vkDestroySampler(BZ_GRAPHICS_DEVICE.getHandle(), handle, nullptr);
+    BZ_GRAPHICS_CTX.getSamplerCache().onSamplerDestroyed(builder);
 }
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "PipelineState.h"
 
 #include "Graphics/GpuObject.h"
+#include "Graphics/Internal/ResourceState.h"
 #include "Graphics/Internal/VulkanIncludes.h"
 
 
@@ -80,6 +81,14 @@ class Texture : public GpuObject<TextureHandles> {
     uint32 mipLevels = 1;
 
     bool isWrapping = false;
+
+  private:
+    // Indexed by layer * mipLevels + mip. Created on first use, when the dimensions are already known.
+    mutable std::vector<ResourceState> subresourceStates;
+
+    ResourceState &getSubresourceState(uint32 mipLevel, uint32 layer) const;
+    friend class CommandBuffer;
+    friend class TextureAtlas;
 };
 
 
@@ -148,11 +157,21 @@ class TextureView : public GpuObject<VkImageView> {
     TextureFormat getTextureFormat() const { return texture->getFormat(); }
     Ref<Texture> getTexture() const { return texture; }
 
+    uint32 getBaseMipLevel() const { return baseMip; }
+    uint32 getMipLevelCount() const { return mipCount; }
+    uint32 getBaseLayer() const { return baseLayer; }
+    uint32 getLayerCount() const { return layerCount; }
+
   private:
     void init(VkImageViewType viewType, uint32 baseLayer, uint32 layerCount, uint32 baseMip, uint32 mipCount);
 
     Ref<Texture> texture;
     TextureFormat format;
+
+    uint32 baseMip;
+    uint32 mipCount;
+    uint32 baseLayer;
+    uint32 layerCount;
 };
 
 
@@ -191,8 +210,12 @@ class Sampler : public GpuObject<VkSampler> {
 
         void setBorderColor(VkBorderColor borderColor) { this->borderColor = borderColor; }
 
+        // Identical Builders will share the same Sampler.
         Ref<Sampler> build() const;
 
+        bool operator==(const Builder &other) const;
+        std::size_t getHash() const;
+
       private:
         VkFilter minFilter = VK_FILTER_LINEAR;
         VkFilter magFilter = VK_FILTER_LINEAR;
@@ -214,5 +237,13 @@ class Sampler : public GpuObject<VkSampler> {
 
     Sampler(const Builder &builder);
     ~Sampler();
+
+  private:
+    // Key on the SamplerCache.
+    Builder builder;
 };
-}
\ No newline at end of file
+}
+
+template <> struct std::hash<BZ::Sampler::Builder> {
+    size_t operator()(const BZ::Sampler::Builder &builder) const { return builder.getHash(); }
+};
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "bzpch.h"
+
+#include "TextureAtlas.h"
+
+#include "Core/Engine.h"
+
+
+namespace BZ {
+
+struct PackRect {
+    uint32 x, y, width, height;
+
+    bool contains(const PackRect &other) const {
+        return other.x >= x && other.y >= y && other.x + other.width <= x + width &&
+               other.y + other.height <= y + height;
+    }
+
+    bool intersects(const PackRect &other) const {
+        return other.x < x + width && other.x + other.width > x && other.y < y + height &&
+               other.y + other.height > y;
+    }
+};
+
+/*
+ * Free space of a page, as a list of maximal (possibly overlapping) free rectangles.
+ */
+class MaxRectsPage {
+  public:
+    MaxRectsPage(uint32 width, uint32 height) { freeRects.push_back({ 0, 0, width, height }); }
+
+    // Best Short Side Fit: choose the free rectangle where the smallest leftover side is minimal.
+    bool insert(uint32 width, uint32 height, PackRect &outRect) {
+        uint32 bestShortSide = std::numeric_limits<uint32>::max();
+        uint32 bestLongSide = std::numeric_limits<uint32>::max();
+        bool found = false;
+
+        for (const PackRect &freeRect : freeRects) {
+            if (freeRect.width >= width && freeRect.height >= height) {
+                uint32 leftoverX = freeRect.width - width;
+                uint32 leftoverY = freeRect.height - height;
+                uint32 shortSide = std::min(leftoverX, leftoverY);
+                uint32 longSide = std::max(leftoverX, leftoverY);
+                if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+                    outRect = { freeRect.x, freeRect.y, width, height };
+                    bestShortSide = shortSide;
+                    bestLongSide = longSide;
+                    found = true;
+                }
+            }
+        }
+
+        if (found) {
+            place(outRect);
+        }
+        return found;
+    }
+
+  private:
+    std::vector<PackRect> freeRects;
+
+    void place(const PackRect &usedRect) {
+        std::vector<PackRect> newFreeRects;
+
+        for (auto it = freeRects.begin(); it != freeRects.end();) {
+            if (it->intersects(usedRect)) {
+                split(*it, usedRect, newFreeRects);
+                it = freeRects.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        freeRects.insert(freeRects.end(), newFreeRects.begin(), newFreeRects.end());
+        prune();
+    }
+
+    // Up to four maximal rectangles around the used one.
+    static void split(const PackRect &freeRect, const PackRect &usedRect, std::vector<PackRect> &out) {
+        if (usedRect.x > freeRect.x) {
+            out.push_back({ freeRect.x, freeRect.y, usedRect.x - freeRect.x, freeRect.height });
+        }
+        if (usedRect.x + usedRect.width < freeRect.x + freeRect.width) {
+            uint32 x = usedRect.x + usedRect.width;
+            out.push_back({ x, freeRect.y, freeRect.x + freeRect.width - x, freeRect.height });
+        }
+        if (usedRect.y > freeRect.y) {
+            out.push_back({ freeRect.x, freeRect.y, freeRect.width, usedRect.y - freeRect.y });
+        }
+        if (usedRect.y + usedRect.height < freeRect.y + freeRect.height) {
+            uint32 y = usedRect.y + usedRect.height;
+            out.push_back({ freeRect.x, y, freeRect.width, freeRect.y + freeRect.height - y });
+        }
+    }
+
+    // Remove rectangles fully contained on others.
+    void prune() {
+        for (uint32 i = 0; i < freeRects.size(); ++i) {
+            for (uint32 j = i + 1; j < freeRects.size();) {
+                if (freeRects[i].contains(freeRects[j])) {
+                    freeRects.erase(freeRects.begin() + j);
+                }
+                else if (freeRects[j].contains(freeRects[i])) {
+                    freeRects.erase(freeRects.begin() + i);
+                    --i;
+                    break;
+                }
+                else {
+                    ++j;
+                }
+            }
+        }
+    }
+};
+
+static uint32 alignUp(uint32 value, uint32 alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+void TextureAtlas::Builder::addImage(const std::string &name, const char *path) {
+    auto &assetsPath = Engine::get().getAssetsPath();
+
+    // Flipped, like the images loaded by Texture2D.
+    const Texture::FileData fileData = Texture::loadFile((assetsPath + path).c_str(), 4, true, false);
+    addImage(name, fileData.data, fileData.width, fileData.height);
+    Texture::freeData(fileData);
+}
+
+void TextureAtlas::Builder::addImage(const std::string &name, const byte *data, uint32 width, uint32 height) {
+    BZ_ASSERT_CORE(data, "Invalid image data!");
+    BZ_ASSERT_CORE(width > 0 && height > 0, "Invalid image dimensions!");
+
+    Image image;
+    image.name = name;
+    image.data.assign(data, data + width * height * 4);
+    image.width = width;
+    image.height = height;
+    images.push_back(std::move(image));
+}
+
+Ref<TextureAtlas> TextureAtlas::Builder::build() const {
+    return MakeRef<TextureAtlas>(*this);
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+TextureAtlas::TextureAtlas(const Builder &builder) {
+    BZ_PROFILE_FUNCTION();
+
+    const uint32 PADDING = builder.padding;
+    const uint32 PAGE_W = builder.pageDimensions.x;
+    const uint32 PAGE_H = builder.pageDimensions.y;
+
+    BZ_ASSERT_CORE(PADDING > 0 && (PADDING & (PADDING - 1)) == 0, "Padding needs to be a power of two!");
+    BZ_ASSERT_CORE(PAGE_W % PADDING == 0 && PAGE_H % PADDING == 0,
+                   "Page dimensions need to be a multiple of the padding!");
+    BZ_ASSERT_CORE(builder.format.getChannelCount() == 4 && builder.format.getSizePerTexel() == 4,
+                   "TextureAtlas only supports 4 channel, 8 bits per channel formats!");
+
+    // Larger images first pack better.
+    std::vector<uint32> order(builder.images.size());
+    for (uint32 i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&builder](uint32 a, uint32 b) {
+        const Builder::Image &imgA = builder.images[a];
+        const Builder::Image &imgB = builder.images[b];
+        return std::max(imgA.width, imgA.height) > std::max(imgB.width, imgB.height);
+    });
+
+    std::vector<MaxRectsPage> packers;
+    std::vector<std::vector<byte>> pageDatas;
+    uint64 usedTexels = 0;
+
+    struct Placement {
+        uint32 page;
+        uint32 x, y;
+    };
+    std::vector<Placement> placements(builder.images.size());
+
+    for (uint32 imageIdx : order) {
+        const Builder::Image &image = builder.images[imageIdx];
+
+        // Aligning the sizes keeps all the positions aligned to the padding.
+        const uint32 w = alignUp(image.width + PADDING * 2, PADDING);
+        const uint32 h = alignUp(image.height + PADDING * 2, PADDING);
+        BZ_CRITICAL_ERROR_CORE(w <= PAGE_W && h <= PAGE_H, "Image '{}' does not fit on a TextureAtlas page!",
+                               image.name);
+
+        PackRect rect;
+        uint32 pageIdx = 0;
+        while (pageIdx < packers.size() && !packers[pageIdx].insert(w, h, rect)) {
+            pageIdx++;
+        }
+        if (pageIdx == packers.size()) {
+            packers.emplace_back(PAGE_W, PAGE_H);
+            pageDatas.emplace_back(PAGE_W * PAGE_H * 4, 0);
+            packers.back().insert(w, h, rect);
+        }
+
+        // Copy the image and extend its edges over the gutter.
+        std::vector<byte> &pageData = pageDatas[pageIdx];
+        for (uint32 y = 0; y < h; ++y) {
+            int srcY = glm::clamp(static_cast<int>(y - PADDING), 0, static_cast<int>(image.height) - 1);
+            for (uint32 x = 0; x < w; ++x) {
+                int srcX = glm::clamp(static_cast<int>(x - PADDING), 0, static_cast<int>(image.width) - 1);
+                const byte *src = &image.data[(srcY * image.width + srcX) * 4];
+                byte *dst = &pageData[((rect.y + y) * PAGE_W + rect.x + x) * 4];
+                memcpy(dst, src, 4);
+            }
+        }
+
+        placements[imageIdx] = { pageIdx, rect.x + PADDING, rect.y + PADDING };
+        usedTexels += image.width * image.height;
+    }
+
+    const MipmapData mipmapData =
+        builder.mipmapsEnabled ? MipmapData::Options::Generate : MipmapData::Options::DoNothing;
+    for (const auto &pageData : pageDatas) {
+        pages.push_back(Texture2D::create(pageData.data(), PAGE_W, PAGE_H, builder.format, mipmapData));
+        BZ_SET_TEXTURE_DEBUG_NAME(pages.back(), "TextureAtlas Page");
+    }
+
+    const glm::vec2 PAGE_DIMS_F = builder.pageDimensions;
+    for (uint32 i = 0; i < builder.images.size(); ++i) {
+        const Builder::Image &image = builder.images[i];
+        const Placement &placement = placements[i];
+
+        TextureAtlasRegion region;
+        region.texture = pages[placement.page];
+        region.texCoordRect = glm::vec4(placement.x / PAGE_DIMS_F.x, placement.y / PAGE_DIMS_F.y,
+                                        (placement.x + image.width) / PAGE_DIMS_F.x,
+                                        (placement.y + image.height) / PAGE_DIMS_F.y);
+        region.dimensions = glm::vec2(image.width, image.height);
+
+        BZ_ASSERT_CORE(regions.find(image.name) == regions.end(), "Repeated image name '{}' on TextureAtlas!",
+                       image.name);
+        regions.emplace(image.name, region);
+    }
+
+    if (!pages.empty()) {
+        packingEfficiency = static_cast<float>(usedTexels) / (static_cast<float>(PAGE_W) * PAGE_H * pages.size());
+    }
+
+    BZ_LOG_CORE_INFO("TextureAtlas: packed {} images into {} pages. Packing efficiency: {:.1f}%.",
+                     builder.images.size(), pages.size(), packingEfficiency * 100.0f);
+}
+
+const TextureAtlasRegion &TextureAtlas::getRegion(const std::string &name) const {
+    auto it = regions.find(name);
+    BZ_ASSERT_CORE(it != regions.end(), "Region '{}' does not exist on the TextureAtlas!", name);
+    return it->second;
+}
+}
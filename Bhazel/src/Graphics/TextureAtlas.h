@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Graphics/Texture.h"
+
+
+namespace BZ {
+
+// A packed image on an atlas page.
+struct TextureAtlasRegion {
+    Ref<Texture2D> texture;
+
+    // Min UVs on xy, max UVs on zw.
+    glm::vec4 texCoordRect;
+
+    // Of the original image, in texels.
+    glm::vec2 dimensions;
+};
+
+
+/*
+ * Packs many images into shared texture pages using the MaxRects algorithm (Best Short Side Fit), so that Renderer2D
+ * can batch Sprites using different images on a single draw call.
+ * Images are surrounded by a gutter of edge texels and placed on positions aligned to the gutter size, so filtering and
+ * the first log2(padding) mips don't bleed between neighbours.
+ */
+class TextureAtlas {
+  public:
+    class Builder {
+      public:
+        // Dimensions of each page. Needs to be a multiple of the padding.
+        void setPageDimensions(uint32 width, uint32 height) { pageDimensions = { width, height }; }
+
+        // Gutter texels around each image. Needs to be a power of two.
+        void setPadding(uint32 padding) { this->padding = padding; }
+
+        // Needs to be a 4 channel, 8 bits per channel format.
+        void setFormat(TextureFormat format) { this->format = format; }
+
+        void setMipmapsEnabled(bool enabled) { mipmapsEnabled = enabled; }
+
+        // Images are copied, the data can be freed after this call.
+        void addImage(const std::string &name, const char *path);
+        void addImage(const std::string &name, const byte *data, uint32 width, uint32 height);
+
+        Ref<TextureAtlas> build() const;
+
+      private:
+        struct Image {
+            std::string name;
+            std::vector<byte> data;
+            uint32 width;
+            uint32 height;
+        };
+
+        std::vector<Image> images;
+        glm::uvec2 pageDimensions = { 1024, 1024 };
+        uint32 padding = 4;
+        TextureFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+        bool mipmapsEnabled = true;
+
+        friend class TextureAtlas;
+    };
+
+    explicit TextureAtlas(const Builder &builder);
+
+    BZ_NON_COPYABLE(TextureAtlas);
+
+    const TextureAtlasRegion &getRegion(const std::string &name) const;
+    bool hasRegion(const std::string &name) const { return regions.find(name) != regions.end(); }
+
+    uint32 getPageCount() const { return static_cast<uint32>(pages.size()); }
+    const Ref<Texture2D> &getPage(uint32 index) const { return pages[index]; }
+
+    // Texels occupied by images, excluding gutters, over the total texels of all the pages.
+    float getPackingEfficiency() const { return packingEfficiency; }
+
+  private:
+    std::vector<Ref<Texture2D>> pages;
+    std::unordered_map<std::string, TextureAtlasRegion> regions;
+    float packingEfficiency = 0.0f;
+};
+}
@@ -16,6 +16,8 @@ class Layer {
     virtual void onAttachToEngine() {}
     virtual void onDetach() {}
 
+    // Only with Application::Settings::fixedTimestep. Called before onUpdate, zero or more times per frame.
+    virtual void onFixedUpdate(const FrameTiming &frameTiming) {}
     virtual void onUpdate(const FrameTiming &frameTiming) {}
     virtual void onImGuiRender(const FrameTiming &frameTiming) {}
 
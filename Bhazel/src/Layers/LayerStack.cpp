@@ -52,6 +52,12 @@ void LayerStack::onAttachToEngine() {
     }
 }
 
+void LayerStack::onFixedUpdate(const FrameTiming &frameTiming) {
+    for (Layer *layer : layers) {
+        layer->onFixedUpdate(frameTiming);
+    }
+}
+
 void LayerStack::onUpdate(const FrameTiming &frameTiming) {
     for (Layer *layer : layers) {
         layer->onUpdate(frameTiming);
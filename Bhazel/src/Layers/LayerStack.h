@@ -19,6 +19,7 @@ class LayerStack {
     void clear();
 
     void onAttachToEngine();
+    void onFixedUpdate(const FrameTiming &frameTiming);
     void onUpdate(const FrameTiming &frameTiming);
     void onImGuiRender(const FrameTiming &frameTiming);
     void onEvent(Event &event);
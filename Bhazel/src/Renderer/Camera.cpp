@@ -6,6 +6,31 @@
 
 namespace BZ {
 
+Ray Camera::screenPointToRay(const glm::vec2 &screenPosition, const glm::vec2 &screenDimensions) const {
+    // Vulkan clip space, y is down and z goes from 0 to 1.
+    const glm::vec2 ndc = { screenPosition.x / screenDimensions.x * 2.0f - 1.0f,
+                            1.0f - screenPosition.y / screenDimensions.y * 2.0f };
+    const glm::mat4 invViewProjection = glm::inverse(projectionMatrix * getViewMatrix());
+
+    glm::vec4 nearPoint = invViewProjection * glm::vec4(ndc, 0.0f, 1.0f);
+    glm::vec4 farPoint = invViewProjection * glm::vec4(ndc, 1.0f, 1.0f);
+    nearPoint /= nearPoint.w;
+    farPoint /= farPoint.w;
+
+    return Ray(glm::vec3(nearPoint), glm::normalize(glm::vec3(farPoint - nearPoint)));
+}
+
+const Frustum &Camera::getFrustum() const {
+    if (frustumDirty || frustumTransformVersion != transform.getVersion()) {
+        frustum = Frustum(projectionMatrix * getViewMatrix());
+        frustumTransformVersion = transform.getVersion();
+        frustumDirty = false;
+    }
+    return frustum;
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
 OrthographicCamera::OrthographicCamera(float left, float right, float bottom, float top, float near, float far) {
     parameters.left = left;
     parameters.right = right;
@@ -19,6 +44,7 @@ OrthographicCamera::OrthographicCamera(float left, float right, float bottom, fl
 void OrthographicCamera::computeProjectionMatrix() {
     projectionMatrix = Utils::ortho(parameters.left, parameters.right, parameters.bottom, parameters.top,
                                     parameters.near, parameters.far);
+    frustumDirty = true;
 }
 
 
@@ -31,51 +57,8 @@ PerspectiveCamera::PerspectiveCamera(float fovy, float aspectRatio, float near,
     computeProjectionMatrix();
 }
 
-/*const glm::vec3* PerspectiveCamera::getFrustumCornerPoints() const {
-    float tg = glm::tan(glm::radians(parameters.fovy * 0.5f));
-
-    glm::vec2 nearDims = { tg * parameters.near * 2.0f * parameters.aspectRatio, tg * parameters.near * 2.0f };
-    frustumCornerPoints[0].x = -nearDims.x * 0.5f;
-    frustumCornerPoints[0].y = -nearDims.y * 0.5f;
-    frustumCornerPoints[0].z = -parameters.near;
-
-    frustumCornerPoints[1].x = nearDims.x * 0.5f;
-    frustumCornerPoints[1].y = -nearDims.y * 0.5f;
-    frustumCornerPoints[1].z = -parameters.near;
-
-    frustumCornerPoints[2].x = -nearDims.x * 0.5f;
-    frustumCornerPoints[2].y = nearDims.y * 0.5f;
-    frustumCornerPoints[2].z = -parameters.near;
-
-    frustumCornerPoints[3].x = nearDims.x * 0.5f;
-    frustumCornerPoints[3].y = nearDims.y * 0.5f;
-    frustumCornerPoints[3].z = -parameters.near;
-
-    glm::vec2 farDims = { tg * parameters.far * 2.0f * parameters.aspectRatio, tg * parameters.far * 2.0f };
-    frustumCornerPoints[4].x = -farDims.x * 0.5f;
-    frustumCornerPoints[4].y = -farDims.y * 0.5f;
-    frustumCornerPoints[4].z = -parameters.far;
-
-    frustumCornerPoints[5].x = farDims.x * 0.5f;
-    frustumCornerPoints[5].y = -farDims.y * 0.5f;
-    frustumCornerPoints[5].z = -parameters.far;
-
-    frustumCornerPoints[6].x = -farDims.x * 0.5f;
-    frustumCornerPoints[6].y = farDims.y * 0.5f;
-    frustumCornerPoints[6].z = -parameters.far;
-
-    frustumCornerPoints[7].x = farDims.x * 0.5f;
-    frustumCornerPoints[7].y = farDims.y * 0.5f;
-    frustumCornerPoints[7].z = -parameters.far;
-
-    for (int i = 0; i < 8; ++i) {
-        frustumCornerPoints[i] = transform.getLocalToParentMatrix() * glm::vec4(frustumCornerPoints[i], 1.0f);
-    }
-
-    return frustumCornerPoints;
-}*/
-
 void PerspectiveCamera::computeProjectionMatrix() {
     projectionMatrix = Utils::perspective(parameters.fovy, parameters.aspectRatio, parameters.near, parameters.far);
+    frustumDirty = true;
 }
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 
 #include "Transform.h"
 
+#include "Collisions/Frustum.h"
+#include "Collisions/Ray.h"
+
 
 namespace BZ {
 
@@ -21,11 +24,25 @@ class Camera {
     float getExposure() const { return exposure; };
     void setExposure(float exposure) { this->exposure = exposure; };
 
+    // World space Ray through a point on the screen, from the near to the far plane, with a normalized direction.
+    // The position is in pixels from the bottom left corner, as given by Input::getMousePosition().
+    Ray screenPointToRay(const glm::vec2 &screenPosition, const glm::vec2 &screenDimensions) const;
+
+    // In world space. Cached until the transform or the projection changes.
+    const Frustum &getFrustum() const;
+
   protected:
     Transform transform;
     glm::mat4 projectionMatrix;
 
     float exposure = 1.0f;
+
+    // To be set when the projection matrix changes.
+    mutable bool frustumDirty = true;
+
+  private:
+    mutable Frustum frustum;
+    mutable uint32 frustumTransformVersion = 0;
 };
 
 
@@ -72,12 +89,8 @@ class PerspectiveCamera : public Camera {
         computeProjectionMatrix();
     }
 
-    // Near left bottom, near right bottom, near left top, near right top, ...
-    // const glm::vec3* getFrustumCornerPoints() const;
-
   private:
     Parameters parameters;
-    // mutable glm::vec3 frustumCornerPoints[8];
 
     void computeProjectionMatrix();
 };
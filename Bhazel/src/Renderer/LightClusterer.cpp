@@ -0,0 +1,220 @@
+#include "bzpch.h"
+
+#include "LightClusterer.h"
+
+#include "Core/Engine.h"
+#include "Graphics/DescriptorSet.h"
+#include "Graphics/GraphicsContext.h"
+#include "Renderer/Camera.h"
+#include "Renderer/Scene.h"
+
+#include "Collisions/CollisionUtils.h"
+#include "Collisions/Frustum.h"
+
+
+namespace BZ {
+
+void LightClusterer::init() {
+    // The storage buffer offset alignment is at most 256 bytes.
+    static_assert(LIGHTS_SIZE % GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN == 0, "Misaligned binding offset.");
+    static_assert(CLUSTERS_SIZE % GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN == 0, "Misaligned binding offset.");
+    static_assert(LIGHT_INDICES_SIZE % GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN == 0,
+                  "Misaligned replica offset.");
+
+    buffer = Buffer::create(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, LIGHTS_SIZE + CLUSTERS_SIZE + LIGHT_INDICES_SIZE,
+                            MemoryType::CpuToGpu);
+    BZ_SET_BUFFER_DEBUG_NAME(buffer, "LightClusterer Buffer");
+
+    lightsPtr = buffer->map(0);
+    clustersPtr = lightsPtr + LIGHTS_SIZE;
+    lightIndicesPtr = clustersPtr + CLUSTERS_SIZE;
+
+    clusterAABBs.resize(CLUSTER_COUNT);
+    viewSpheres.reserve(Renderer::MAX_LOCAL_LIGHTS_PER_SCENE);
+    sliceRanges.reserve(Renderer::MAX_LOCAL_LIGHTS_PER_SCENE);
+}
+
+void LightClusterer::destroy() {
+    buffer.reset();
+    clusterAABBs.clear();
+    viewSpheres.clear();
+    sliceRanges.clear();
+    for (uint32 slice = 0; slice < CLUSTER_COUNT_Z; ++slice) {
+        sliceLights[slice].clear();
+        sliceIndices[slice].clear();
+    }
+}
+
+void LightClusterer::cluster(const Scene &scene, const glm::vec2 &framebufferDimensions) {
+    BZ_PROFILE_FUNCTION();
+
+    const PerspectiveCamera &camera = static_cast<const PerspectiveCamera &>(scene.getCamera());
+    if (camera.getProjectionMatrix() != clusterProjectionMatrix) {
+        updateClusterAABBs(camera);
+    }
+    clusterScalesAndBiases.x = CLUSTER_COUNT_X / framebufferDimensions.x;
+    clusterScalesAndBiases.y = CLUSTER_COUNT_Y / framebufferDimensions.y;
+
+    visibleLightCount = 0;
+    viewSpheres.clear();
+    sliceRanges.clear();
+    for (const PointLight &light : scene.getPointLights()) {
+        addLight(light.position, glm::vec3(0.0f), light.color, light.intensity, light.radius, 0.0f, 0.0f, camera);
+    }
+    for (const SpotLight &light : scene.getSpotLights()) {
+        addLight(light.position, light.getDirection(), light.color, light.intensity, light.radius, light.innerAngle,
+                 light.outerAngle, camera);
+    }
+
+    GpuCluster *clusters = reinterpret_cast<GpuCluster *>(static_cast<byte *>(clustersPtr));
+    lightIndexCount = 0;
+    if (visibleLightCount == 0) {
+        memset(clusters, 0, CLUSTERS_SIZE);
+        return;
+    }
+
+    Engine::get().getJobSystem().parallelFor(CLUSTER_COUNT_Z, 1, [this](uint32 begin, uint32 end) {
+        for (uint32 slice = begin; slice < end; ++slice) {
+            clusterSlice(slice);
+        }
+    });
+
+    // Pack the slices one after the other. Slices are ordered by depth, so on overflow the farthest lose lights.
+    uint32 *lightIndices = reinterpret_cast<uint32 *>(static_cast<byte *>(lightIndicesPtr));
+    for (uint32 slice = 0; slice < CLUSTER_COUNT_Z; ++slice) {
+        const uint32 sliceCount =
+            glm::min(static_cast<uint32>(sliceIndices[slice].size()), MAX_LIGHT_INDICES - lightIndexCount);
+        memcpy(lightIndices + lightIndexCount, sliceIndices[slice].data(), sliceCount * sizeof(uint32));
+
+        for (uint32 i = 0; i < CLUSTERS_PER_SLICE; ++i) {
+            const GpuCluster &sliceCluster = sliceClusters[slice][i];
+            const uint32 offset = glm::min(sliceCluster.offset, sliceCount);
+            GpuCluster &cluster = clusters[slice * CLUSTERS_PER_SLICE + i];
+            cluster.offset = lightIndexCount + offset;
+            cluster.count = glm::min(sliceCluster.count, sliceCount - offset);
+        }
+        lightIndexCount += sliceCount;
+    }
+}
+
+void LightClusterer::setStorageBuffers(DescriptorSet &descriptorSet, uint32 firstBinding) const {
+    descriptorSet.setStorageBuffer(buffer, firstBinding, 0, LIGHTS_SIZE);
+    descriptorSet.setStorageBuffer(buffer, firstBinding + 1, LIGHTS_SIZE, CLUSTERS_SIZE);
+    descriptorSet.setStorageBuffer(buffer, firstBinding + 2, LIGHTS_SIZE + CLUSTERS_SIZE, LIGHT_INDICES_SIZE);
+}
+
+void LightClusterer::updateClusterAABBs(const PerspectiveCamera &camera) {
+    BZ_PROFILE_FUNCTION();
+
+    const PerspectiveCamera::Parameters &cameraParams = camera.getParameters();
+    const float logDepthRange = std::log(cameraParams.far / cameraParams.near);
+    clusterScalesAndBiases.z = CLUSTER_COUNT_Z / logDepthRange;
+    clusterScalesAndBiases.w = -CLUSTER_COUNT_Z * std::log(cameraParams.near) / logDepthRange;
+
+    float sliceDepths[CLUSTER_COUNT_Z + 1];
+    for (uint32 slice = 0; slice <= CLUSTER_COUNT_Z; ++slice) {
+        const float exponent = static_cast<float>(slice) / CLUSTER_COUNT_Z;
+        sliceDepths[slice] = cameraParams.near * std::pow(cameraParams.far / cameraParams.near, exponent);
+    }
+
+    const glm::mat4 inverseProjection = glm::inverse(camera.getProjectionMatrix());
+    for (uint32 y = 0; y < CLUSTER_COUNT_Y; ++y) {
+        for (uint32 x = 0; x < CLUSTER_COUNT_X; ++x) {
+            // Directions of the tile corners, scaled to be at a view space depth of 1. On Vulkan NDC the y = -1 edge
+            // is the top of the framebuffer, like the rows of gl_FragCoord.
+            glm::vec3 cornerDirections[4];
+            for (uint32 i = 0; i < 4; ++i) {
+                const glm::vec2 ndc(-1.0f + 2.0f * (x + (i & 1)) / CLUSTER_COUNT_X,
+                                    -1.0f + 2.0f * (y + (i >> 1)) / CLUSTER_COUNT_Y);
+                const glm::vec4 nearPoint = inverseProjection * glm::vec4(ndc, 0.0f, 1.0f);
+                cornerDirections[i] = glm::vec3(nearPoint) / -nearPoint.z;
+            }
+
+            for (uint32 slice = 0; slice < CLUSTER_COUNT_Z; ++slice) {
+                glm::vec3 corners[8];
+                for (uint32 i = 0; i < 4; ++i) {
+                    corners[i] = cornerDirections[i] * sliceDepths[slice];
+                    corners[i + 4] = cornerDirections[i] * sliceDepths[slice + 1];
+                }
+                clusterAABBs[slice * CLUSTERS_PER_SLICE + y * CLUSTER_COUNT_X + x] = AABB(corners, 8);
+            }
+        }
+    }
+    clusterProjectionMatrix = camera.getProjectionMatrix();
+}
+
+void LightClusterer::addLight(const glm::vec3 &position, const glm::vec3 &direction, const glm::vec3 &color,
+                              float intensity, float radius, float innerAngle, float outerAngle,
+                              const PerspectiveCamera &camera) {
+    if (visibleLightCount == Renderer::MAX_LOCAL_LIGHTS_PER_SCENE) {
+        return;
+    }
+
+    // Point Lights have no direction. For the Spot Lights, bound only the cone when it's narrower than a hemisphere.
+    const bool isSpot = glm::dot(direction, direction) > 0.0f;
+    BoundingSphere sphere(position, radius);
+    if (isSpot && outerAngle < glm::half_pi<float>()) {
+        const float cosAngle = glm::cos(outerAngle);
+        if (outerAngle > glm::quarter_pi<float>()) {
+            sphere = BoundingSphere(position + direction * (cosAngle * radius), glm::sin(outerAngle) * radius);
+        }
+        else {
+            const float sphereRadius = radius / (2.0f * cosAngle);
+            sphere = BoundingSphere(position + direction * sphereRadius, sphereRadius);
+        }
+    }
+
+    if (!camera.getFrustum().overlaps(sphere)) {
+        return;
+    }
+
+    // The cone falloff is saturate(cos * scale + offset). A scale of 0 and an offset of 1 light all directions.
+    float spotScale = 0.0f;
+    float spotOffset = 1.0f;
+    if (isSpot) {
+        const float cosOuter = glm::cos(outerAngle);
+        spotScale = 1.0f / glm::max(glm::cos(innerAngle) - cosOuter, 0.001f);
+        spotOffset = -cosOuter * spotScale;
+    }
+
+    GpuLight *lights = reinterpret_cast<GpuLight *>(static_cast<byte *>(lightsPtr));
+    GpuLight &light = lights[visibleLightCount++];
+    light.positionAndRadius = glm::vec4(position, radius);
+    light.colorAndSpotOffset = glm::vec4(color * intensity, spotOffset);
+    light.directionAndSpotScale = glm::vec4(direction, spotScale);
+
+    const glm::vec3 viewCenter = glm::vec3(camera.getViewMatrix() * glm::vec4(sphere.getCenter(), 1.0f));
+    const float viewDepth = -viewCenter.z;
+    viewSpheres.emplace_back(viewCenter, sphere.getRadius());
+    sliceRanges.emplace_back(getSlice(viewDepth - sphere.getRadius()), getSlice(viewDepth + sphere.getRadius()));
+}
+
+void LightClusterer::clusterSlice(uint32 slice) {
+    std::vector<uint32> &lights = sliceLights[slice];
+    lights.clear();
+    for (uint32 i = 0; i < visibleLightCount; ++i) {
+        if (sliceRanges[i].x <= slice && slice <= sliceRanges[i].y) {
+            lights.push_back(i);
+        }
+    }
+
+    std::vector<uint32> &indices = sliceIndices[slice];
+    indices.clear();
+    for (uint32 i = 0; i < CLUSTERS_PER_SLICE; ++i) {
+        const AABB &clusterAABB = clusterAABBs[slice * CLUSTERS_PER_SLICE + i];
+        GpuCluster &cluster = sliceClusters[slice][i];
+        cluster.offset = static_cast<uint32>(indices.size());
+        for (uint32 lightIdx : lights) {
+            if (CollisionUtils::overlaps(clusterAABB, viewSpheres[lightIdx])) {
+                indices.push_back(lightIdx);
+            }
+        }
+        cluster.count = static_cast<uint32>(indices.size()) - cluster.offset;
+    }
+}
+
+uint32 LightClusterer::getSlice(float viewDepth) const {
+    const float slice = std::log(glm::max(viewDepth, 1e-4f)) * clusterScalesAndBiases.z + clusterScalesAndBiases.w;
+    return static_cast<uint32>(glm::clamp(slice, 0.0f, static_cast<float>(CLUSTER_COUNT_Z - 1)));
+}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Graphics/Buffer.h"
+#include "Renderer/Renderer.h"
+
+#include "Collisions/AABB.h"
+#include "Collisions/BoundingSphere.h"
+
+
+namespace BZ {
+
+class DescriptorSet;
+class PerspectiveCamera;
+class Scene;
+
+/*
+ * Clustered forward shading for the Point and Spot Lights. The view frustum is split in a grid of froxels, with
+ * exponential depth slices. Each frame the lights are culled against the Camera Frustum, and the survivors binned into
+ * the froxels they touch, one depth slice per job on the JobSystem. The fragment shader finds its froxel and walks only
+ * the lights listed there.
+ * The results go on three storage buffers, replicated per frame in flight: the lights, one (offset, count) pair per
+ * froxel, and the light indices referenced by those pairs.
+ */
+class LightClusterer {
+  public:
+    static constexpr uint32 CLUSTER_COUNT_X = 16;
+    static constexpr uint32 CLUSTER_COUNT_Y = 9;
+    static constexpr uint32 CLUSTER_COUNT_Z = 24;
+    static constexpr uint32 CLUSTER_COUNT = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+
+    // Over all the froxels. When full, the froxels of the farthest slices lose lights.
+    static constexpr uint32 MAX_LIGHT_INDICES = CLUSTER_COUNT * 64;
+
+    LightClusterer() = default;
+
+    BZ_NON_COPYABLE(LightClusterer);
+
+    void init();
+    void destroy();
+
+    // Culls and bins the Point and Spot Lights of the Scene, for a color pass of the given dimensions.
+    void cluster(const Scene &scene, const glm::vec2 &framebufferDimensions);
+
+    // Fills the three storage buffer bindings, starting on firstBinding.
+    void setStorageBuffers(DescriptorSet &descriptorSet, uint32 firstBinding) const;
+
+    // xy: from framebuffer pixels to froxel coordinates. zw: scale and bias from log(view depth) to the depth slice.
+    const glm::vec4 &getClusterScalesAndBiases() const { return clusterScalesAndBiases; }
+
+    uint32 getVisibleLightCount() const { return visibleLightCount; }
+    uint32 getLightIndexCount() const { return lightIndexCount; }
+
+  private:
+    static constexpr uint32 CLUSTERS_PER_SLICE = CLUSTER_COUNT_X * CLUSTER_COUNT_Y;
+
+    // Matches the LocalLight struct on the shaders, std430.
+    struct GpuLight {
+        glm::vec4 positionAndRadius; // World space
+        glm::vec4 colorAndSpotOffset;
+        glm::vec4 directionAndSpotScale; // World space
+    };
+
+    struct GpuCluster {
+        uint32 offset;
+        uint32 count;
+    };
+
+    static constexpr uint32 LIGHTS_SIZE = sizeof(GpuLight) * Renderer::MAX_LOCAL_LIGHTS_PER_SCENE;
+    static constexpr uint32 CLUSTERS_SIZE = sizeof(GpuCluster) * CLUSTER_COUNT;
+    static constexpr uint32 LIGHT_INDICES_SIZE = sizeof(uint32) * MAX_LIGHT_INDICES;
+
+    Ref<Buffer> buffer;
+    BufferPtr lightsPtr;
+    BufferPtr clustersPtr;
+    BufferPtr lightIndicesPtr;
+
+    // View space bounds of the froxels, rebuilt when the projection changes.
+    std::vector<AABB> clusterAABBs;
+    glm::mat4 clusterProjectionMatrix = glm::mat4(0.0f);
+    glm::vec4 clusterScalesAndBiases;
+
+    // View space bounding spheres of the visible lights and the depth slices they touch.
+    std::vector<BoundingSphere> viewSpheres;
+    std::vector<glm::uvec2> sliceRanges;
+
+    // Per depth slice, written by its own job before being packed into the buffers.
+    std::vector<uint32> sliceLights[CLUSTER_COUNT_Z];
+    std::vector<uint32> sliceIndices[CLUSTER_COUNT_Z];
+    GpuCluster sliceClusters[CLUSTER_COUNT_Z][CLUSTERS_PER_SLICE];
+
+    uint32 visibleLightCount = 0;
+    uint32 lightIndexCount = 0;
+
+    void updateClusterAABBs(const PerspectiveCamera &camera);
+    void addLight(const glm::vec3 &position, const glm::vec3 &direction, const glm::vec3 &color, float intensity,
+                  float radius, float innerAngle, float outerAngle, const PerspectiveCamera &camera);
+    void clusterSlice(uint32 slice);
+    uint32 getSlice(float viewDepth) const;
+};
+}
@@ -29,8 +29,10 @@ Material::Material(Ref<Texture2D> &albedoTexture, Ref<Texture2D> &normalTexture,
         aoTextureView = TextureView::create(aoTexture);
 
     init();
+    initBindless();
 }
 
+// Cube maps don't go to the BindlessTextureTable, they are always used through the DescriptorSet.
 Material::Material(Ref<TextureCube> &albedoTexture) : albedoTextureView(TextureView::create(albedoTexture)) {
     init();
 }
@@ -78,13 +80,14 @@ Material::Material(const char *albedoTexturePath, const char *normalTexturePath,
     }
 
     init();
+    initBindless();
 }
 
 void Material::init() {
     const Ref<Sampler> &sampler =
         anisotropicSampler ? Renderer::getDefaultAnisotropicSampler() : Renderer::getDefaultSampler();
 
-    descriptorSet = &Renderer::createMaterialDescriptorSet();
+    descriptorSet = Renderer::createMaterialDescriptorSet();
     descriptorSet->setCombinedTextureSampler(albedoTextureView, sampler, 1);
 
     if (normalTextureView)
@@ -113,6 +116,29 @@ void Material::init() {
         descriptorSet->setCombinedTextureSampler(albedoTextureView, sampler, 6);
 }
 
+void Material::initBindless() {
+    if (!BZ_GRAPHICS_CTX.isBindlessTexturesEnabled())
+        return;
+
+    const Ref<Sampler> &sampler =
+        anisotropicSampler ? Renderer::getDefaultAnisotropicSampler() : Renderer::getDefaultSampler();
+    BindlessTextureTable &table = BZ_GRAPHICS_CTX.getBindlessTextureTable();
+
+    const Ref<TextureView> *textureViews[] = { &albedoTextureView,    &normalTextureView, &metallicTextureView,
+                                               &roughnessTextureView, &heightTextureView, &aoTextureView };
+    for (uint32 i = 0; i < 6; ++i) {
+        const Ref<TextureView> &texView = *textureViews[i] ? *textureViews[i] : albedoTextureView;
+        bindlessTextureIndices[i] = table.registerTexture(texView, sampler);
+    }
+    bindless = true;
+}
+
+uint32 Material::getFeatureBits() const {
+    return (hasNormalTexture() ? NORMAL_TEXTURE_BIT : 0) | (hasMetallicTexture() ? METALLIC_TEXTURE_BIT : 0) |
+           (hasRoughnessTexture() ? ROUGHNESS_TEXTURE_BIT : 0) | (hasParallaxOcclusion() ? HEIGHT_TEXTURE_BIT : 0) |
+           (hasAOTexture() ? AO_TEXTURE_BIT : 0);
+}
+
 bool Material::operator==(const Material &other) const {
     return albedoTextureView == other.albedoTextureView && normalTextureView == other.normalTextureView &&
            metallicTextureView == other.metallicTextureView && roughnessTextureView == other.roughnessTextureView &&
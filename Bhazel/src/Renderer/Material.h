@@ -44,6 +44,16 @@ class Material {
     bool hasHeightTexture() const { return static_cast<bool>(heightTextureView); }
     bool hasAOTexture() const { return static_cast<bool>(aoTextureView); }
 
+    // One bit per optional texture, in the order of the specialization constants of the Renderer fragment shaders.
+    static constexpr uint32 NORMAL_TEXTURE_BIT = 1 << 0;
+    static constexpr uint32 METALLIC_TEXTURE_BIT = 1 << 1;
+    static constexpr uint32 ROUGHNESS_TEXTURE_BIT = 1 << 2;
+    static constexpr uint32 HEIGHT_TEXTURE_BIT = 1 << 3;
+    static constexpr uint32 AO_TEXTURE_BIT = 1 << 4;
+    static constexpr uint32 FEATURE_BIT_COUNT = 5;
+
+    uint32 getFeatureBits() const;
+
     float getMetallic() const { return metallic; }
     void setMetallic(float met) { metallic = met; }
 
@@ -53,8 +63,21 @@ class Material {
     float getParallaxOcclusionScale() const { return parallaxOcclusionScale; }
     void setParallaxOcclusionScale(float scale) { parallaxOcclusionScale = scale; }
 
+    // A height texture with a scale of 0 would not move the texture coordinates.
+    bool hasParallaxOcclusion() const { return hasHeightTexture() && parallaxOcclusionScale > 0.0f; }
+
     bool useAnisotropicSampler() const { return anisotropicSampler; }
 
+    // If the textures are on the BindlessTextureTable. Indices are only valid in that case and missing textures will
+    // point to the albedo one.
+    bool isBindless() const { return bindless; }
+    uint32 getAlbedoTextureIndex() const { return bindlessTextureIndices[0]; }
+    uint32 getNormalTextureIndex() const { return bindlessTextureIndices[1]; }
+    uint32 getMetallicTextureIndex() const { return bindlessTextureIndices[2]; }
+    uint32 getRoughnessTextureIndex() const { return bindlessTextureIndices[3]; }
+    uint32 getHeightTextureIndex() const { return bindlessTextureIndices[4]; }
+    uint32 getAOTextureIndex() const { return bindlessTextureIndices[5]; }
+
     const glm::vec2 &getUvScale() const { return uvScale; }
     void setUvScale(float u, float v) {
         uvScale.x = u;
@@ -74,7 +97,12 @@ class Material {
     Ref<TextureView> heightTextureView;
     Ref<TextureView> aoTextureView;
 
-    DescriptorSet *descriptorSet = nullptr;
+    // Shared by the copies of this Material.
+    Ref<DescriptorSet> descriptorSet;
+
+    // Albedo, Normal, Metallic, Roughness, Height and AO.
+    bool bindless = false;
+    uint32 bindlessTextureIndices[6] = {};
 
     // Valid if no respective textures are present.
     float metallic = 1.0f;
@@ -84,6 +112,7 @@ class Material {
     glm::vec2 uvScale = { 1.0f, 1.0f };
 
     void init();
+    void initBindless();
 };
 }
 
@@ -3,10 +3,14 @@
 #include "Core/Engine.h"
 #include "Core/Utils.h"
 #include "Mesh.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
 #include "Renderer.h"
 
 #include "Graphics/Buffer.h"
 
+#include "Collisions/TriangleMesh.h"
+
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
@@ -270,6 +274,9 @@ Mesh::Mesh(const char *path, const Material &material) {
         submesh.vertexCount = shapeVxCount;
         submesh.indexOffset = idxOffset;
         submesh.indexCount = shapeIdxCount;
+        submesh.lods[0] = { idxOffset, shapeIdxCount };
+        submesh.meshletOffset = 0;
+        submesh.meshletCount = 0;
 
         vxOffset += shapeVxCount;
         idxOffset += shapeIdxCount;
@@ -307,15 +314,23 @@ Mesh::Mesh(const char *path, const Material &material) {
         BZ_LOG_CORE_WARN("Not computing tangents for mesh: {}. There are no texcoords or no normals.", path);
     }
 
+    generateMeshlets(vertices, indices);
+    generateLods(vertices, indices);
+    const uint32 allLodsIndexCount = static_cast<uint32>(indices.size());
+
     vertexBuffer = Buffer::create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                   sizeof(Vertex) * vertexCount, MemoryType::GpuOnly, Renderer::getVertexDataLayout());
-    indexBuffer = Buffer::create(VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                 sizeof(uint32) * indexCount, MemoryType::GpuOnly, Renderer::getIndexDataLayout());
+    indexBuffer =
+        Buffer::create(VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                       sizeof(uint32) * allLodsIndexCount, MemoryType::GpuOnly, Renderer::getIndexDataLayout());
     BZ_SET_BUFFER_DEBUG_NAME(vertexBuffer, "Mesh Vertex Buffer");
     BZ_SET_BUFFER_DEBUG_NAME(indexBuffer, "Mesh Index Buffer");
 
     vertexBuffer->setData(vertices.data(), sizeof(Vertex) * vertexCount, 0);
-    indexBuffer->setData(indices.data(), sizeof(uint32) * indexCount, 0);
+    indexBuffer->setData(indices.data(), sizeof(uint32) * allLodsIndexCount, 0);
+
+    computeAABB(vertices.data(), vertexCount);
+    keepTriangleMeshData(vertices.data(), vertexCount, indices.data(), indexCount);
 }
 
 Mesh::Mesh(Vertex vertices[], uint32 vertexCount, const Material &material) : vertexCount(vertexCount), indexCount(0) {
@@ -324,12 +339,17 @@ Mesh::Mesh(Vertex vertices[], uint32 vertexCount, const Material &material) : ve
     BZ_SET_BUFFER_DEBUG_NAME(vertexBuffer, "Mesh Vertex Buffer");
 
     vertexBuffer->setData(vertices, sizeof(Vertex) * vertexCount, 0);
+    computeAABB(vertices, vertexCount);
+    keepTriangleMeshData(vertices, vertexCount, nullptr, 0);
 
     SubMesh submesh;
     submesh.vertexOffset = 0;
     submesh.vertexCount = vertexCount;
     submesh.indexOffset = 0;
     submesh.indexCount = 0;
+    submesh.lods[0] = { 0, 0 };
+    submesh.meshletOffset = 0;
+    submesh.meshletCount = 0;
     submesh.material = material;
     submeshes.push_back(submesh);
 }
@@ -345,16 +365,63 @@ Mesh::Mesh(Vertex vertices[], uint32 vertexCount, uint32 indices[], uint32 index
 
     vertexBuffer->setData(vertices, sizeof(Vertex) * vertexCount, 0);
     indexBuffer->setData(indices, sizeof(uint32) * indexCount, 0);
+    computeAABB(vertices, vertexCount);
+    keepTriangleMeshData(vertices, vertexCount, indices, indexCount);
 
     SubMesh submesh;
     submesh.vertexOffset = 0;
     submesh.vertexCount = vertexCount;
     submesh.indexOffset = 0;
     submesh.indexCount = indexCount;
+    submesh.lods[0] = { 0, indexCount };
+    submesh.meshletOffset = 0;
+    submesh.meshletCount = 0;
     submesh.material = material;
     submeshes.push_back(submesh);
 }
 
+void Mesh::computeAABB(const Vertex vertices[], uint32 vertexCount) {
+    aabb.empty();
+    for (uint32 i = 0; i < vertexCount; ++i) {
+        aabb.enclose(vertices[i].position);
+    }
+}
+
+Ref<TriangleMesh> Mesh::getTriangleMesh() const {
+    if (!lazyTriangleMesh) {
+        return nullptr;
+    }
+
+    LazyTriangleMesh &lazy = *lazyTriangleMesh;
+    std::call_once(lazy.builtFlag, [&lazy]() {
+        BZ_PROFILE_SCOPE("Mesh::getTriangleMesh build");
+
+        // Non indexed Meshes are a plain list of triangles.
+        if (lazy.indices.empty()) {
+            lazy.indices.resize(lazy.positions.size());
+            for (uint32 i = 0; i < lazy.indices.size(); ++i) {
+                lazy.indices[i] = i;
+            }
+        }
+
+        lazy.triangleMesh = MakeRef<TriangleMesh>(lazy.positions.data(), lazy.indices.data(),
+                                                  static_cast<uint32>(lazy.indices.size()));
+        lazy.positions = {};
+        lazy.indices = {};
+    });
+    return lazy.triangleMesh;
+}
+
+void Mesh::keepTriangleMeshData(const Vertex vertices[], uint32 vertexCount, const uint32 indices[],
+                                uint32 indexCount) {
+    lazyTriangleMesh = MakeRef<LazyTriangleMesh>();
+    lazyTriangleMesh->positions.resize(vertexCount);
+    for (uint32 i = 0; i < vertexCount; ++i) {
+        lazyTriangleMesh->positions[i] = vertices[i].position;
+    }
+    lazyTriangleMesh->indices.assign(indices, indices + indexCount);
+}
+
 void Mesh::computeTangents(std::vector<Vertex> &vertices, const std::vector<uint32> &indices) {
     BZ_ASSERT(!vertices.empty() && !indices.empty(), "Vertices and Indices are needed to compute tangents!");
 
@@ -419,4 +486,97 @@ void Mesh::computeTangents(std::vector<Vertex> &vertices, const std::vector<uint
         // v.bitangent = glm::normalize(bitangent);
     }
 }
+
+void Mesh::generateMeshlets(const std::vector<Vertex> &vertices, std::vector<uint32> &indices) {
+    BZ_PROFILE_FUNCTION();
+
+    // Each SubMesh has its indices reordered in place, grouped by meshlet.
+    std::vector<std::vector<Meshlet>> submeshMeshlets(submeshes.size());
+    Engine::get().getJobSystem().parallelFor(
+        static_cast<uint32>(submeshes.size()), 1,
+        [this, &vertices, &indices, &submeshMeshlets](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i) {
+                const SubMesh &submesh = submeshes[i];
+                uint32 *submeshIndices = indices.data() + submesh.indexOffset;
+
+                MeshletBuilder builder(vertices.data(), submeshIndices, submesh.indexCount);
+                const std::vector<uint32> &builderIndices = builder.getIndices();
+                std::copy(builderIndices.begin(), builderIndices.end(), submeshIndices);
+
+                submeshMeshlets[i] = builder.getMeshlets();
+                for (Meshlet &meshlet : submeshMeshlets[i]) {
+                    meshlet.indexOffset += submesh.indexOffset;
+                }
+            }
+        });
+
+    for (uint32 i = 0; i < submeshes.size(); ++i) {
+        submeshes[i].meshletOffset = static_cast<uint32>(meshlets.size());
+        submeshes[i].meshletCount = static_cast<uint32>(submeshMeshlets[i].size());
+        meshlets.insert(meshlets.end(), submeshMeshlets[i].begin(), submeshMeshlets[i].end());
+    }
+}
+
+void Mesh::generateLods(const std::vector<Vertex> &vertices, std::vector<uint32> &indices) {
+    BZ_PROFILE_FUNCTION();
+
+    // Smaller SubMeshes are not worth simplifying.
+    constexpr uint32 MIN_INDEX_COUNT = 64 * 3;
+
+    struct SubMeshLods {
+        std::vector<uint32> indices[MAX_LOD_COUNT];
+        float errors[MAX_LOD_COUNT] = {};
+        uint32 count = 1;
+    };
+    std::vector<SubMeshLods> submeshLods(submeshes.size());
+
+    // Each LOD aims for half the triangles of the previous one. A SubMesh chain ends when a level removes less than 10%
+    // of them, usually because everything left is on a border.
+    Engine::get().getJobSystem().parallelFor(
+        static_cast<uint32>(submeshes.size()), 1,
+        [this, &vertices, &indices, &submeshLods](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i) {
+                const SubMesh &submesh = submeshes[i];
+                if (submesh.indexCount < MIN_INDEX_COUNT) {
+                    continue;
+                }
+
+                SubMeshLods &lods = submeshLods[i];
+                MeshSimplifier simplifier(vertices.data(), indices.data() + submesh.indexOffset, submesh.indexCount);
+                uint32 previousIndexCount = submesh.indexCount;
+                for (uint32 lod = 1; lod < MAX_LOD_COUNT; ++lod) {
+                    lods.errors[lod] = simplifier.simplify(submesh.indexCount >> lod);
+                    const uint32 lodIndexCount = simplifier.getIndexCount();
+                    if (lodIndexCount == 0 || lodIndexCount * 10 > previousIndexCount * 9) {
+                        break;
+                    }
+                    simplifier.getIndices(lods.indices[lod]);
+                    lods.count = lod + 1;
+                    previousIndexCount = lodIndexCount;
+                }
+            }
+        });
+
+    for (const SubMeshLods &lods : submeshLods) {
+        lodCount = glm::max(lodCount, lods.count);
+    }
+
+    for (uint32 i = 0; i < submeshes.size(); ++i) {
+        SubMesh &submesh = submeshes[i];
+        const SubMeshLods &lods = submeshLods[i];
+        for (uint32 lod = 1; lod < lodCount; ++lod) {
+            // SubMeshes with a shorter chain repeat their last level.
+            if (lod < lods.count) {
+                submesh.lods[lod].indexOffset = static_cast<uint32>(indices.size());
+                submesh.lods[lod].indexCount = static_cast<uint32>(lods.indices[lod].size());
+                indices.insert(indices.end(), lods.indices[lod].begin(), lods.indices[lod].end());
+                lodErrors[lod] = glm::max(lodErrors[lod], lods.errors[lod]);
+            }
+            else {
+                submesh.lods[lod] = submesh.lods[lod - 1];
+                lodErrors[lod] = glm::max(lodErrors[lod], lods.errors[lods.count - 1]);
+            }
+        }
+    }
+}
 }
\ No newline at end of file
@@ -3,12 +3,17 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
 
+#include <mutex>
+
 #include "Material.h"
 
+#include "Collisions/AABB.h"
+
 
 namespace BZ {
 
 class Buffer;
+class TriangleMesh;
 
 class Mesh {
   public:
@@ -21,12 +26,45 @@ class Mesh {
         bool operator==(const Vertex &other) const { return memcmp(this, &other, sizeof(Vertex)) == 0; }
     };
 
+    static constexpr uint32 MAX_LOD_COUNT = 4;
+
+    // Index range of a simplified version of a SubMesh, over the same vertices.
+    struct Lod {
+        uint32 indexOffset;
+        uint32 indexCount;
+    };
+
     struct SubMesh {
         Material material;
         uint32 vertexOffset;
         uint32 vertexCount;
         uint32 indexOffset;
         uint32 indexCount;
+
+        // Level 0 is the full detail range above. Valid up to the Mesh LOD count.
+        Lod lods[MAX_LOD_COUNT];
+
+        // Partition of the full detail LOD, on the Mesh meshlets.
+        uint32 meshletOffset;
+        uint32 meshletCount;
+    };
+
+    static constexpr uint32 MESHLET_MAX_VERTICES = 64;
+    static constexpr uint32 MESHLET_MAX_TRIANGLES = 124;
+
+    // Cluster of neighbouring triangles of a SubMesh, as a contiguous range of its indices.
+    struct Meshlet {
+        uint32 indexOffset;
+        uint32 indexCount;
+
+        // Model space bounding sphere.
+        glm::vec3 center;
+        float radius;
+
+        // Bounds the normals of all the triangles. The whole Meshlet is back facing when seen from a point p with
+        // dot(center - p, coneAxis) >= coneCutoff * distance(center, p) + radius. Never true with a cutoff of 1.
+        glm::vec3 coneAxis;
+        float coneCutoff;
     };
 
     static Mesh createUnitCube(const Material &material = Material());
@@ -43,8 +81,26 @@ class Mesh {
     const Ref<Buffer> &getIndexBuffer() const { return indexBuffer; }
 
     uint32 getVertexCount() const { return vertexCount; }
+
+    // Of the full detail LOD.
     uint32 getIndexCount() const { return indexCount; }
 
+    // Meshes loaded from files get simplified LODs, sharing the vertex buffer and appended to the index buffer.
+    uint32 getLodCount() const { return lodCount; }
+
+    // Model space geometric error of a LOD, over all the SubMeshes. Grows with the level, 0 on the full detail one.
+    float getLodError(uint32 lod) const {
+        BZ_ASSERT_CORE(lod < lodCount, "Invalid LOD!");
+        return lodErrors[lod];
+    }
+
+    // Of all the vertices, in model space.
+    const AABB &getAABB() const { return aabb; }
+
+    // CPU copy of the triangles, in model space, for ray casts. Built on the first call, as most Meshes are never
+    // picked, and shared by the copies of the Mesh. Can be called from multiple threads.
+    Ref<TriangleMesh> getTriangleMesh() const;
+
     bool isValid() const { return vertexCount > 0 && static_cast<bool>(vertexBuffer) && !submeshes.empty(); }
     bool hasIndices() const { return indexCount > 0; }
 
@@ -60,6 +116,9 @@ class Mesh {
     const std::vector<SubMesh> &getSubmeshes() const { return submeshes; }
     std::vector<SubMesh> &getSubmeshes() { return submeshes; }
 
+    // Only Meshes loaded from files have them.
+    const std::vector<Meshlet> &getMeshlets() const { return meshlets; }
+
   private:
     uint32 vertexCount;
     uint32 indexCount;
@@ -68,8 +127,27 @@ class Mesh {
     Ref<Buffer> indexBuffer;
 
     std::vector<SubMesh> submeshes;
+    std::vector<Meshlet> meshlets;
+    uint32 lodCount = 1;
+    float lodErrors[MAX_LOD_COUNT] = {};
+
+    AABB aabb;
+
+    // The positions and indices are kept until the TriangleMesh is built.
+    struct LazyTriangleMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32> indices;
+
+        std::once_flag builtFlag;
+        Ref<TriangleMesh> triangleMesh;
+    };
+    Ref<LazyTriangleMesh> lazyTriangleMesh;
 
+    void computeAABB(const Vertex vertices[], uint32 vertexCount);
+    void keepTriangleMeshData(const Vertex vertices[], uint32 vertexCount, const uint32 indices[], uint32 indexCount);
     void computeTangents(std::vector<Vertex> &vertices, const std::vector<uint32> &indices);
+    void generateMeshlets(const std::vector<Vertex> &vertices, std::vector<uint32> &indices);
+    void generateLods(const std::vector<Vertex> &vertices, std::vector<uint32> &indices);
 };
 }
 
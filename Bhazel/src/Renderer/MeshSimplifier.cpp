@@ -0,0 +1,332 @@
+#include "bzpch.h"
+
+#include "MeshSimplifier.h"
+
+
+namespace BZ {
+
+void MeshSimplifier::Quadric::addPlane(const glm::dvec4 &plane) {
+    m[0] += plane.x * plane.x;
+    m[1] += plane.x * plane.y;
+    m[2] += plane.x * plane.z;
+    m[3] += plane.x * plane.w;
+    m[4] += plane.y * plane.y;
+    m[5] += plane.y * plane.z;
+    m[6] += plane.y * plane.w;
+    m[7] += plane.z * plane.z;
+    m[8] += plane.z * plane.w;
+    m[9] += plane.w * plane.w;
+}
+
+MeshSimplifier::Quadric &MeshSimplifier::Quadric::operator+=(const Quadric &other) {
+    for (uint32 i = 0; i < 10; ++i) {
+        m[i] += other.m[i];
+    }
+    return *this;
+}
+
+double MeshSimplifier::Quadric::evaluate(const glm::vec3 &point) const {
+    const double x = point.x;
+    const double y = point.y;
+    const double z = point.z;
+    return m[0] * x * x + 2.0 * (m[1] * x * y + m[2] * x * z + m[3] * x) + m[4] * y * y +
+           2.0 * (m[5] * y * z + m[6] * y) + m[7] * z * z + 2.0 * m[8] * z + m[9];
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+MeshSimplifier::MeshSimplifier(const Mesh::Vertex vertices[], const uint32 indices[], uint32 indexCount) :
+    vertices(vertices) {
+    uint32 maxIndex = 0;
+    for (uint32 i = 0; i < indexCount; ++i) {
+        maxIndex = glm::max(maxIndex, indices[i]);
+    }
+    originalToWelded.assign(maxIndex + 1, INVALID_INDEX);
+
+    std::unordered_map<glm::vec3, uint32> positionToWelded;
+    for (uint32 i = 0; i < indexCount; ++i) {
+        const uint32 original = indices[i];
+        if (originalToWelded[original] != INVALID_INDEX) {
+            continue;
+        }
+
+        const glm::vec3 &position = vertices[original].position;
+        auto it = positionToWelded.find(position);
+        uint32 welded;
+        if (it == positionToWelded.end()) {
+            welded = static_cast<uint32>(weldedPositions.size());
+            positionToWelded.emplace(position, welded);
+            weldedPositions.push_back(position);
+            weldedToOriginals.emplace_back();
+        }
+        else {
+            welded = it->second;
+        }
+        originalToWelded[original] = welded;
+        weldedToOriginals[welded].push_back(original);
+    }
+
+    const uint32 weldedCount = static_cast<uint32>(weldedPositions.size());
+    quadrics.resize(weldedCount);
+    lockedVertices.assign(weldedCount, 0);
+    vertexVersions.assign(weldedCount, 0);
+    vertexTriangles.resize(weldedCount);
+
+    // Triangles per undirected edge. Edges with a single one are on a border.
+    std::unordered_map<uint64, uint32> edgeTriangleCounts;
+
+    triangles.reserve(indexCount / 3);
+    for (uint32 i = 0; i + 2 < indexCount; i += 3) {
+        Triangle triangle;
+        for (uint32 k = 0; k < 3; ++k) {
+            triangle.originalCorners[k] = indices[i + k];
+            triangle.corners[k] = originalToWelded[indices[i + k]];
+        }
+        triangle.alive = true;
+
+        const uint32 *corners = triangle.corners;
+        if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0]) {
+            continue;
+        }
+
+        const glm::dvec3 a(weldedPositions[corners[0]]);
+        const glm::dvec3 b(weldedPositions[corners[1]]);
+        const glm::dvec3 c(weldedPositions[corners[2]]);
+        glm::dvec3 normal = glm::cross(b - a, c - a);
+        const double length = glm::length(normal);
+        if (length > 0.0) {
+            normal /= length;
+            Quadric quadric;
+            quadric.addPlane(glm::dvec4(normal, -glm::dot(normal, a)));
+            for (uint32 k = 0; k < 3; ++k) {
+                quadrics[corners[k]] += quadric;
+            }
+        }
+
+        const uint32 triangleIdx = static_cast<uint32>(triangles.size());
+        for (uint32 k = 0; k < 3; ++k) {
+            vertexTriangles[corners[k]].push_back(triangleIdx);
+
+            const uint32 v0 = glm::min(corners[k], corners[(k + 1) % 3]);
+            const uint32 v1 = glm::max(corners[k], corners[(k + 1) % 3]);
+            edgeTriangleCounts[(static_cast<uint64>(v0) << 32) | v1]++;
+        }
+        triangles.push_back(triangle);
+    }
+    aliveTriangleCount = static_cast<uint32>(triangles.size());
+
+    for (const auto &edge : edgeTriangleCounts) {
+        if (edge.second == 1) {
+            lockedVertices[static_cast<uint32>(edge.first >> 32)] = 1;
+            lockedVertices[static_cast<uint32>(edge.first & 0xffffffff)] = 1;
+        }
+    }
+
+    for (const Triangle &triangle : triangles) {
+        for (uint32 k = 0; k < 3; ++k) {
+            pushCollapse(triangle.corners[k], triangle.corners[(k + 1) % 3]);
+            pushCollapse(triangle.corners[(k + 1) % 3], triangle.corners[k]);
+        }
+    }
+}
+
+float MeshSimplifier::simplify(uint32 targetIndexCount) {
+    while (getIndexCount() > targetIndexCount && !collapseHeap.empty()) {
+        std::pop_heap(collapseHeap.begin(), collapseHeap.end());
+        const Collapse candidate = collapseHeap.back();
+        collapseHeap.pop_back();
+
+        // Stale, one of the vertices changed since this was pushed.
+        if (vertexVersions[candidate.from] != candidate.fromVersion ||
+            vertexVersions[candidate.to] != candidate.toVersion) {
+            continue;
+        }
+
+        if (isCollapseValid(candidate.from, candidate.to)) {
+            collapse(candidate.from, candidate.to);
+            maxCost = glm::max(maxCost, candidate.cost);
+        }
+    }
+    return static_cast<float>(std::sqrt(maxCost));
+}
+
+void MeshSimplifier::getIndices(std::vector<uint32> &outIndices) const {
+    outIndices.reserve(outIndices.size() + getIndexCount());
+    for (const Triangle &triangle : triangles) {
+        if (triangle.alive) {
+            for (uint32 k = 0; k < 3; ++k) {
+                const uint32 welded = triangle.corners[k];
+                const uint32 original = triangle.originalCorners[k];
+                outIndices.push_back(originalToWelded[original] == welded ? original
+                                                                          : findClosestOriginal(original, welded));
+            }
+        }
+    }
+}
+
+void MeshSimplifier::pushCollapse(uint32 from, uint32 to) {
+    if (lockedVertices[from]) {
+        return;
+    }
+
+    Quadric quadric = quadrics[from];
+    quadric += quadrics[to];
+
+    Collapse collapse;
+    collapse.cost = glm::max(quadric.evaluate(weldedPositions[to]), 0.0);
+    collapse.from = from;
+    collapse.to = to;
+    collapse.fromVersion = vertexVersions[from];
+    collapse.toVersion = vertexVersions[to];
+    collapseHeap.push_back(collapse);
+    std::push_heap(collapseHeap.begin(), collapseHeap.end());
+}
+
+void MeshSimplifier::pushVertexCollapses(uint32 vertex) {
+    for (uint32 triangleIdx : vertexTriangles[vertex]) {
+        const Triangle &triangle = triangles[triangleIdx];
+        for (uint32 k = 0; k < 3; ++k) {
+            if (triangle.corners[k] != vertex) {
+                pushCollapse(vertex, triangle.corners[k]);
+                pushCollapse(triangle.corners[k], vertex);
+            }
+        }
+    }
+}
+
+bool MeshSimplifier::isCollapseValid(uint32 from, uint32 to) const {
+    if (!isLinkConditionMet(from, to)) {
+        return false;
+    }
+
+    for (uint32 triangleIdx : vertexTriangles[from]) {
+        const Triangle &triangle = triangles[triangleIdx];
+        if (!triangle.alive) {
+            continue;
+        }
+
+        // Triangles on the collapsing edge will be removed.
+        const uint32 *corners = triangle.corners;
+        if (corners[0] == to || corners[1] == to || corners[2] == to) {
+            continue;
+        }
+
+        glm::vec3 positions[3];
+        uint32 fromCorner = 0;
+        for (uint32 k = 0; k < 3; ++k) {
+            positions[k] = weldedPositions[corners[k]];
+            if (corners[k] == from) {
+                fromCorner = k;
+            }
+        }
+
+        const glm::vec3 oldNormal = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+        if (glm::dot(oldNormal, oldNormal) == 0.0f) {
+            continue;
+        }
+
+        positions[fromCorner] = weldedPositions[to];
+        const glm::vec3 newNormal = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+        if (glm::dot(oldNormal, newNormal) <= 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MeshSimplifier::isLinkConditionMet(uint32 from, uint32 to) const {
+    // Neighbours of from, and the ones opposite to the edge on the triangles sharing it.
+    std::vector<uint32> fromNeighbours;
+    std::vector<uint32> edgeOpposites;
+    for (uint32 triangleIdx : vertexTriangles[from]) {
+        const Triangle &triangle = triangles[triangleIdx];
+        if (!triangle.alive) {
+            continue;
+        }
+
+        const uint32 *corners = triangle.corners;
+        const bool onEdge = corners[0] == to || corners[1] == to || corners[2] == to;
+        for (uint32 k = 0; k < 3; ++k) {
+            if (corners[k] != from && corners[k] != to) {
+                fromNeighbours.push_back(corners[k]);
+                if (onEdge) {
+                    edgeOpposites.push_back(corners[k]);
+                }
+            }
+        }
+    }
+
+    // Any other shared neighbour would leave two triangles on the same three vertices, or an edge shared by more than
+    // two, pinching the surface.
+    for (uint32 triangleIdx : vertexTriangles[to]) {
+        const Triangle &triangle = triangles[triangleIdx];
+        if (!triangle.alive) {
+            continue;
+        }
+
+        for (uint32 k = 0; k < 3; ++k) {
+            const uint32 corner = triangle.corners[k];
+            if (corner != to && corner != from &&
+                std::find(fromNeighbours.begin(), fromNeighbours.end(), corner) != fromNeighbours.end() &&
+                std::find(edgeOpposites.begin(), edgeOpposites.end(), corner) == edgeOpposites.end()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void MeshSimplifier::collapse(uint32 from, uint32 to) {
+    quadrics[to] += quadrics[from];
+
+    std::vector<uint32> &toTriangles = vertexTriangles[to];
+    for (uint32 triangleIdx : vertexTriangles[from]) {
+        Triangle &triangle = triangles[triangleIdx];
+        if (!triangle.alive) {
+            continue;
+        }
+
+        uint32 *corners = triangle.corners;
+        if (corners[0] == to || corners[1] == to || corners[2] == to) {
+            triangle.alive = false;
+            aliveTriangleCount--;
+        }
+        else {
+            for (uint32 k = 0; k < 3; ++k) {
+                if (corners[k] == from) {
+                    corners[k] = to;
+                }
+            }
+            toTriangles.push_back(triangleIdx);
+        }
+    }
+    vertexTriangles[from].clear();
+    toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(),
+                                     [this](uint32 triangleIdx) { return !triangles[triangleIdx].alive; }),
+                      toTriangles.end());
+
+    vertexVersions[from]++;
+    vertexVersions[to]++;
+    pushVertexCollapses(to);
+}
+
+uint32 MeshSimplifier::findClosestOriginal(uint32 original, uint32 welded) const {
+    constexpr float SHORT_MAX_FLOAT = static_cast<float>(0xffff);
+    const Mesh::Vertex &vertex = vertices[original];
+    const glm::vec2 texCoord(vertex.texCoord[0], vertex.texCoord[1]);
+
+    uint32 closest = weldedToOriginals[welded][0];
+    float closestDistance = std::numeric_limits<float>::max();
+    for (uint32 candidate : weldedToOriginals[welded]) {
+        const Mesh::Vertex &other = vertices[candidate];
+        const glm::vec3 normalDelta = other.normal - vertex.normal;
+        const glm::vec2 texCoordDelta = (glm::vec2(other.texCoord[0], other.texCoord[1]) - texCoord) / SHORT_MAX_FLOAT;
+        const float distance = glm::dot(normalDelta, normalDelta) + glm::dot(texCoordDelta, texCoordDelta);
+        if (distance < closestDistance) {
+            closest = candidate;
+            closestDistance = distance;
+        }
+    }
+    return closest;
+}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Renderer/Mesh.h"
+
+
+namespace BZ {
+
+/*
+ * Quadric error metric simplification (Garland and Heckbert) of an indexed triangle list, to build Mesh LODs.
+ * Edges are collapsed cheapest first, always onto one of their two vertices, so every result is a new index list over
+ * the original vertices and can share their vertex buffer. Vertices are welded by position, so texture seams don't stop
+ * the collapses. A collapsed corner then takes the duplicate of its target closest in normal and texture coordinates.
+ * Vertices on open borders are never moved. Collapses that would flip a triangle, or that break the link condition
+ * (the edge vertices sharing a neighbour not on the edge triangles) and so change the topology, are rejected.
+ */
+class MeshSimplifier {
+  public:
+    MeshSimplifier(const Mesh::Vertex vertices[], const uint32 indices[], uint32 indexCount);
+
+    BZ_NON_COPYABLE(MeshSimplifier);
+
+    // Collapses edges until there are at most targetIndexCount indices left, or no valid collapse remains. Can be
+    // called again with smaller targets, to simplify the previous result further.
+    // Returns the model space error so far, as the square root of the largest quadric error of a collapse.
+    float simplify(uint32 targetIndexCount);
+
+    uint32 getIndexCount() const { return aliveTriangleCount * 3; }
+
+    // Appends the current triangles, indexing the original vertices.
+    void getIndices(std::vector<uint32> &outIndices) const;
+
+  private:
+    static constexpr uint32 INVALID_INDEX = 0xffffffff;
+
+    // Symmetric 4x4 matrix, the upper triangle row by row.
+    struct Quadric {
+        double m[10] = {};
+
+        void addPlane(const glm::dvec4 &plane);
+        Quadric &operator+=(const Quadric &other);
+        double evaluate(const glm::vec3 &point) const;
+    };
+
+    struct Triangle {
+        uint32 corners[3]; // Welded vertices
+        uint32 originalCorners[3];
+        bool alive;
+    };
+
+    struct Collapse {
+        double cost;
+        uint32 from;
+        uint32 to;
+        uint32 fromVersion;
+        uint32 toVersion;
+
+        // For a min heap.
+        bool operator<(const Collapse &other) const { return cost > other.cost; }
+    };
+
+    const Mesh::Vertex *vertices;
+
+    std::vector<uint32> originalToWelded;
+    std::vector<glm::vec3> weldedPositions;
+    std::vector<std::vector<uint32>> weldedToOriginals;
+
+    std::vector<Quadric> quadrics;
+    std::vector<uint8> lockedVertices;
+    std::vector<uint32> vertexVersions;
+    std::vector<std::vector<uint32>> vertexTriangles;
+
+    std::vector<Triangle> triangles;
+    uint32 aliveTriangleCount = 0;
+
+    std::vector<Collapse> collapseHeap;
+    double maxCost = 0.0;
+
+    void pushCollapse(uint32 from, uint32 to);
+    void pushVertexCollapses(uint32 vertex);
+    bool isCollapseValid(uint32 from, uint32 to) const;
+    bool isLinkConditionMet(uint32 from, uint32 to) const;
+    void collapse(uint32 from, uint32 to);
+    uint32 findClosestOriginal(uint32 original, uint32 welded) const;
+};
+}
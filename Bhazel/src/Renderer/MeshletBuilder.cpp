@@ -0,0 +1,186 @@
+#include "bzpch.h"
+
+#include "MeshletBuilder.h"
+
+
+namespace BZ {
+
+MeshletBuilder::MeshletBuilder(const Mesh::Vertex vertices[], const uint32 indices[], uint32 indexCount) :
+    vertices(vertices), sourceIndices(indices) {
+    const uint32 triangleCount = indexCount / 3;
+    buildAdjacency(indexCount);
+
+    frontierMeshlets.assign(triangleCount, INVALID_INDEX);
+    usedTriangles.assign(triangleCount, 0);
+    this->indices.reserve(triangleCount * 3);
+
+    // Unused triangles adjacent to the meshlet being built.
+    std::vector<uint32> frontier;
+
+    uint32 seed = 0;
+    while (true) {
+        while (seed < triangleCount && usedTriangles[seed]) {
+            seed++;
+        }
+        if (seed == triangleCount) {
+            break;
+        }
+
+        Mesh::Meshlet meshlet;
+        meshlet.indexOffset = static_cast<uint32>(this->indices.size());
+
+        uint32 meshletVertexCount = 0;
+        uint32 meshletTriangleCount = 1;
+        frontier.clear();
+        addTriangle(seed, meshletVertexCount, frontier);
+
+        while (meshletTriangleCount < Mesh::MESHLET_MAX_TRIANGLES) {
+            uint32 best = INVALID_INDEX;
+            uint32 bestNewVertexCount = 4;
+            for (uint32 i = 0; i < frontier.size();) {
+                const uint32 candidate = frontier[i];
+                if (usedTriangles[candidate]) {
+                    frontier[i] = frontier.back();
+                    frontier.pop_back();
+                    continue;
+                }
+
+                const uint32 newVertexCount = countNewVertices(candidate);
+                if (meshletVertexCount + newVertexCount <= Mesh::MESHLET_MAX_VERTICES &&
+                    newVertexCount < bestNewVertexCount) {
+                    best = candidate;
+                    bestNewVertexCount = newVertexCount;
+                    if (newVertexCount == 0) {
+                        break;
+                    }
+                }
+                ++i;
+            }
+
+            if (best == INVALID_INDEX) {
+                break;
+            }
+            addTriangle(best, meshletVertexCount, frontier);
+            meshletTriangleCount++;
+        }
+
+        meshlet.indexCount = static_cast<uint32>(this->indices.size()) - meshlet.indexOffset;
+        computeBounds(meshlet);
+        meshlets.push_back(meshlet);
+    }
+}
+
+void MeshletBuilder::buildAdjacency(uint32 indexCount) {
+    const uint32 triangleIndexCount = indexCount / 3 * 3;
+
+    uint32 maxIndex = 0;
+    for (uint32 i = 0; i < triangleIndexCount; ++i) {
+        maxIndex = glm::max(maxIndex, sourceIndices[i]);
+    }
+    vertexMeshlets.assign(maxIndex + 1, INVALID_INDEX);
+
+    vertexTriangleOffsets.assign(maxIndex + 2, 0);
+    for (uint32 i = 0; i < triangleIndexCount; ++i) {
+        vertexTriangleOffsets[sourceIndices[i] + 1]++;
+    }
+    for (uint32 i = 1; i < vertexTriangleOffsets.size(); ++i) {
+        vertexTriangleOffsets[i] += vertexTriangleOffsets[i - 1];
+    }
+
+    vertexTriangles.resize(triangleIndexCount);
+    std::vector<uint32> cursors(vertexTriangleOffsets.begin(), vertexTriangleOffsets.end() - 1);
+    for (uint32 i = 0; i < triangleIndexCount; ++i) {
+        vertexTriangles[cursors[sourceIndices[i]]++] = i / 3;
+    }
+}
+
+void MeshletBuilder::addTriangle(uint32 triangle, uint32 &vertexCount, std::vector<uint32> &frontier) {
+    const uint32 meshletIdx = static_cast<uint32>(meshlets.size());
+    usedTriangles[triangle] = 1;
+
+    for (uint32 k = 0; k < 3; ++k) {
+        const uint32 vertex = sourceIndices[triangle * 3 + k];
+        indices.push_back(vertex);
+
+        if (vertexMeshlets[vertex] != meshletIdx) {
+            vertexMeshlets[vertex] = meshletIdx;
+            vertexCount++;
+        }
+
+        for (uint32 i = vertexTriangleOffsets[vertex]; i < vertexTriangleOffsets[vertex + 1]; ++i) {
+            const uint32 neighbour = vertexTriangles[i];
+            if (!usedTriangles[neighbour] && frontierMeshlets[neighbour] != meshletIdx) {
+                frontierMeshlets[neighbour] = meshletIdx;
+                frontier.push_back(neighbour);
+            }
+        }
+    }
+}
+
+uint32 MeshletBuilder::countNewVertices(uint32 triangle) const {
+    const uint32 meshletIdx = static_cast<uint32>(meshlets.size());
+    uint32 count = 0;
+    for (uint32 k = 0; k < 3; ++k) {
+        if (vertexMeshlets[sourceIndices[triangle * 3 + k]] != meshletIdx) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void MeshletBuilder::computeBounds(Mesh::Meshlet &meshlet) const {
+    const uint32 *meshletIndices = &indices[meshlet.indexOffset];
+
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(std::numeric_limits<float>::lowest());
+    for (uint32 i = 0; i < meshlet.indexCount; ++i) {
+        const glm::vec3 &position = vertices[meshletIndices[i]].position;
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+    }
+
+    meshlet.center = (min + max) * 0.5f;
+    meshlet.radius = 0.0f;
+    for (uint32 i = 0; i < meshlet.indexCount; ++i) {
+        meshlet.radius = glm::max(meshlet.radius, glm::distance(meshlet.center, vertices[meshletIndices[i]].position));
+    }
+
+    // The cone axis is the average of the triangle normals, and the cutoff comes from the widest of them.
+    glm::vec3 normalSum(0.0f);
+    for (uint32 i = 0; i < meshlet.indexCount; i += 3) {
+        const glm::vec3 &a = vertices[meshletIndices[i]].position;
+        const glm::vec3 normal = glm::cross(vertices[meshletIndices[i + 1]].position - a,
+                                            vertices[meshletIndices[i + 2]].position - a);
+        const float length = glm::length(normal);
+        if (length > 0.0f) {
+            normalSum += normal / length;
+        }
+    }
+
+    meshlet.coneAxis = glm::vec3(0.0f);
+    meshlet.coneCutoff = 1.0f;
+
+    const float normalSumLength = glm::length(normalSum);
+    if (normalSumLength == 0.0f) {
+        return;
+    }
+    const glm::vec3 axis = normalSum / normalSumLength;
+
+    float minDot = 1.0f;
+    for (uint32 i = 0; i < meshlet.indexCount; i += 3) {
+        const glm::vec3 &a = vertices[meshletIndices[i]].position;
+        const glm::vec3 normal = glm::cross(vertices[meshletIndices[i + 1]].position - a,
+                                            vertices[meshletIndices[i + 2]].position - a);
+        const float length = glm::length(normal);
+        if (length > 0.0f) {
+            minDot = glm::min(minDot, glm::dot(axis, normal / length));
+        }
+    }
+
+    // Normals spreading near or past a hemisphere leave no direction where all triangles are back facing.
+    if (minDot > 0.1f) {
+        meshlet.coneAxis = axis;
+        meshlet.coneCutoff = glm::sqrt(1.0f - minDot * minDot);
+    }
+}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Renderer/Mesh.h"
+
+
+namespace BZ {
+
+/*
+ * Partitions an indexed triangle list into meshlets, small clusters of neighbouring triangles to be culled on their
+ * own. Meshlets grow greedily from a seed triangle, always taking the adjacent triangle that adds the fewest new
+ * vertices, until they reach the vertex or triangle limits or run out of neighbours.
+ * The triangles are reordered so each meshlet is a contiguous index range. Each one gets a bounding sphere and a cone
+ * bounding the normals of its triangles, for back face culling of the whole cluster.
+ */
+class MeshletBuilder {
+  public:
+    MeshletBuilder(const Mesh::Vertex vertices[], const uint32 indices[], uint32 indexCount);
+
+    BZ_NON_COPYABLE(MeshletBuilder);
+
+    // The same triangles, grouped by meshlet.
+    const std::vector<uint32> &getIndices() const { return indices; }
+
+    // With index offsets relative to the start of getIndices().
+    const std::vector<Mesh::Meshlet> &getMeshlets() const { return meshlets; }
+
+  private:
+    static constexpr uint32 INVALID_INDEX = 0xffffffff;
+
+    const Mesh::Vertex *vertices;
+    const uint32 *sourceIndices;
+
+    // Triangles using each vertex, as ranges on vertexTriangles.
+    std::vector<uint32> vertexTriangleOffsets;
+    std::vector<uint32> vertexTriangles;
+
+    // Stamped with the meshlet that last took them, to avoid clearing between meshlets.
+    std::vector<uint32> vertexMeshlets;
+    std::vector<uint32> frontierMeshlets;
+    std::vector<uint8> usedTriangles;
+
+    std::vector<uint32> indices;
+    std::vector<Mesh::Meshlet> meshlets;
+
+    void buildAdjacency(uint32 indexCount);
+    void addTriangle(uint32 triangle, uint32 &vertexCount, std::vector<uint32> &frontier);
+    uint32 countNewVertices(uint32 triangle) const;
+    void computeBounds(Mesh::Meshlet &meshlet) const;
+};
+}
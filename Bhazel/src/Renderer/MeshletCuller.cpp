@@ -0,0 +1,308 @@
+#include "bzpch.h"
+
+#include "MeshletCuller.h"
+
+#include "Core/Engine.h"
+#include "Graphics/CommandBuffer.h"
+#include "Graphics/DescriptorSet.h"
+#include "Graphics/GraphicsContext.h"
+#include "Graphics/PipelineState.h"
+#include "Graphics/Shader.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/Scene.h"
+
+#include "Collisions/AABB.h"
+#include "Collisions/BoundingSphere.h"
+#include "Collisions/Frustum.h"
+
+
+namespace BZ {
+
+// Offsets on the GPU input buffer.
+constexpr uint32 GPU_SLOTS_OFFSET = GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN;
+
+struct ModelSpaceView {
+    glm::vec3 cameraPosition;
+    float scale; // Largest of the model matrix, for the bounding spheres.
+    bool testCones;
+};
+
+static ModelSpaceView getModelSpaceView(const glm::mat4 &modelMatrix, const glm::vec3 &cameraPosition) {
+    ModelSpaceView view;
+    view.scale = glm::max(glm::length(glm::vec3(modelMatrix[0])),
+                          glm::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+
+    // The side of a plane the camera is on doesn't change with affine transforms, so the cone is tested in model space.
+    // Mirroring transforms flip the winding on screen, so the rasterizer culls the other faces. Skip the test then.
+    view.cameraPosition = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(cameraPosition, 1.0f));
+    view.testCones = glm::determinant(glm::mat3(modelMatrix)) > 0.0f;
+    return view;
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+void MeshletCuller::init() {
+    constexpr uint32 BUFFER_SIZE = MAX_DRAW_COMMANDS * sizeof(VkDrawIndexedIndirectCommand);
+    static_assert(BUFFER_SIZE % GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN == 0, "Misaligned replica offset.");
+
+    buffer = Buffer::create(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, BUFFER_SIZE, MemoryType::CpuToGpu);
+    BZ_SET_BUFFER_DEBUG_NAME(buffer, "MeshletCuller Buffer");
+
+    commandsPtr = buffer->map(0);
+
+    multiDrawIndirect = BZ_GRAPHICS_DEVICE.isMultiDrawIndirectEnabled();
+
+    constexpr uint32 GPU_MESHLETS_OFFSET = GPU_SLOTS_OFFSET + MAX_GPU_SLOTS * sizeof(GpuSlot);
+    constexpr uint32 GPU_INPUT_BUFFER_SIZE = GPU_MESHLETS_OFFSET + MAX_DRAW_COMMANDS * sizeof(GpuMeshlet);
+    static_assert(sizeof(GpuCullData) <= GPU_SLOTS_OFFSET, "GpuCullData overlaps the GpuSlots.");
+    static_assert(sizeof(GpuSlot) == 96 && sizeof(GpuMeshlet) == 48, "Not matching the std430 layout.");
+    static_assert(GPU_MESHLETS_OFFSET % GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN == 0 &&
+                      GPU_INPUT_BUFFER_SIZE % GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN == 0,
+                  "Misaligned offsets.");
+
+    gpuInputBuffer = Buffer::create(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                    GPU_INPUT_BUFFER_SIZE, MemoryType::CpuToGpu);
+    gpuCommandsBuffer = Buffer::create(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                       BUFFER_SIZE, MemoryType::GpuOnly);
+    BZ_SET_BUFFER_DEBUG_NAME(gpuInputBuffer, "MeshletCuller GPU Input Buffer");
+    BZ_SET_BUFFER_DEBUG_NAME(gpuCommandsBuffer, "MeshletCuller GPU Commands Buffer");
+
+    gpuInputPtr = gpuInputBuffer->map(0);
+
+    gpuDescriptorSetLayout =
+        DescriptorSetLayout::create({ { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT, 1 },
+                                      { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT, 1 },
+                                      { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT, 1 },
+                                      { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1 } });
+    gpuPipelineLayout = PipelineLayout::create({ gpuDescriptorSetLayout });
+
+    PipelineStateData pipelineStateData;
+    pipelineStateData.layout = gpuPipelineLayout;
+    pipelineStateData.shader =
+        Shader::create({ { "Bhazel/shaders/bin/MeshletCullComp.spv", VK_SHADER_STAGE_COMPUTE_BIT } });
+    gpuPipelineState = PipelineState::create(pipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(gpuPipelineState, "MeshletCuller Pipeline");
+
+    gpuDescriptorSet = &DescriptorSet::get(gpuDescriptorSetLayout);
+    gpuDescriptorSet->setConstantBuffer(gpuInputBuffer, 0, 0, sizeof(GpuCullData));
+    gpuDescriptorSet->setStorageBuffer(gpuInputBuffer, 1, GPU_SLOTS_OFFSET, MAX_GPU_SLOTS * sizeof(GpuSlot));
+    gpuDescriptorSet->setStorageBuffer(gpuInputBuffer, 2, GPU_MESHLETS_OFFSET, MAX_DRAW_COMMANDS * sizeof(GpuMeshlet));
+    gpuDescriptorSet->setStorageBuffer(gpuCommandsBuffer, 3, 0, BUFFER_SIZE);
+}
+
+void MeshletCuller::destroy() {
+    buffer.reset();
+    gpuInputBuffer.reset();
+    gpuCommandsBuffer.reset();
+    gpuPipelineState.reset();
+    gpuPipelineLayout.reset();
+    gpuDescriptorSetLayout.reset();
+    gpuDescriptorSet = nullptr;
+    slots.clear();
+    slotCommands.clear();
+}
+
+void MeshletCuller::begin() {
+    slots.clear();
+    meshletCount = 0;
+    visibleMeshletCount = 0;
+    drawCommandCount = 0;
+}
+
+uint32 MeshletCuller::addSubMesh(uint32 entityIndex, uint32 submeshIndex) {
+    Slot slot = {};
+    slot.entityIndex = entityIndex;
+    slot.submeshIndex = submeshIndex;
+    slots.push_back(slot);
+    return static_cast<uint32>(slots.size() - 1);
+}
+
+void MeshletCuller::cull(const Scene &scene, const OcclusionCuller *occlusionCuller, bool onGpu) {
+    BZ_PROFILE_FUNCTION();
+
+    culledOnGpu = onGpu;
+    if (onGpu) {
+        gatherForGpu(scene);
+        return;
+    }
+
+    if (slotCommands.size() < slots.size()) {
+        slotCommands.resize(slots.size());
+    }
+
+    const Frustum &frustum = scene.getCamera().getFrustum();
+    const glm::vec3 &cameraPosition = scene.getCamera().getTransform().getTranslation();
+
+    std::atomic<uint32> visibleCount{ 0 };
+    Engine::get().getJobSystem().parallelFor(
+        static_cast<uint32>(slots.size()), 1,
+        [this, &scene, &frustum, &cameraPosition, occlusionCuller, &visibleCount](uint32 begin, uint32 end) {
+            uint32 visible = 0;
+            for (uint32 i = begin; i < end; ++i) {
+                visible += cullSlot(scene, frustum, cameraPosition, occlusionCuller, i);
+            }
+            visibleCount += visible;
+        });
+    visibleMeshletCount = visibleCount;
+
+    VkDrawIndexedIndirectCommand *commands =
+        reinterpret_cast<VkDrawIndexedIndirectCommand *>(static_cast<byte *>(commandsPtr));
+    for (uint32 i = 0; i < slots.size(); ++i) {
+        Slot &slot = slots[i];
+        const std::vector<VkDrawIndexedIndirectCommand> &commandsToPack = slotCommands[i];
+        meshletCount += scene.getEntities()[slot.entityIndex].mesh.getSubMeshIdx(slot.submeshIndex).meshletCount;
+
+        slot.overflow = drawCommandCount + commandsToPack.size() > MAX_DRAW_COMMANDS;
+        if (!slot.overflow) {
+            slot.firstCommand = drawCommandCount;
+            slot.commandCount = static_cast<uint32>(commandsToPack.size());
+            memcpy(commands + drawCommandCount, commandsToPack.data(),
+                   commandsToPack.size() * sizeof(VkDrawIndexedIndirectCommand));
+            drawCommandCount += slot.commandCount;
+        }
+    }
+}
+
+void MeshletCuller::dispatch(CommandBuffer &commandBuffer) const {
+    if (!culledOnGpu || drawCommandCount == 0) {
+        return;
+    }
+
+    commandBuffer.transitionBuffer(gpuCommandsBuffer, ResourceUsage::ComputeShaderWrite);
+    commandBuffer.bindPipelineState(gpuPipelineState);
+    commandBuffer.bindDescriptorSet(*gpuDescriptorSet, gpuPipelineLayout, 0, nullptr, 0,
+                                    VK_PIPELINE_BIND_POINT_COMPUTE);
+    commandBuffer.dispatch((drawCommandCount + GPU_GROUP_SIZE - 1) / GPU_GROUP_SIZE, 1, 1);
+    commandBuffer.transitionBuffer(gpuCommandsBuffer, ResourceUsage::IndirectBuffer);
+}
+
+uint32 MeshletCuller::draw(CommandBuffer &commandBuffer, const Scene &scene, uint32 slotIdx) const {
+    const Slot &slot = slots[slotIdx];
+    if (slot.overflow) {
+        const Mesh::SubMesh &submesh = scene.getEntities()[slot.entityIndex].mesh.getSubMeshIdx(slot.submeshIndex);
+        commandBuffer.drawIndexed(submesh.indexCount, 1, submesh.indexOffset, 0, 0);
+        return submesh.indexCount / 3;
+    }
+
+    const Ref<Buffer> &commandsBuffer = culledOnGpu ? gpuCommandsBuffer : buffer;
+    if (multiDrawIndirect) {
+        if (slot.commandCount > 0) {
+            commandBuffer.drawIndexedIndirect(commandsBuffer, slot.firstCommand * sizeof(VkDrawIndexedIndirectCommand),
+                                              slot.commandCount, sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+    else {
+        for (uint32 i = 0; i < slot.commandCount; ++i) {
+            commandBuffer.drawIndexedIndirect(commandsBuffer,
+                                              (slot.firstCommand + i) * sizeof(VkDrawIndexedIndirectCommand), 1,
+                                              sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+    return slot.triangleCount;
+}
+
+void MeshletCuller::gatherForGpu(const Scene &scene) {
+    const glm::vec3 &cameraPosition = scene.getCamera().getTransform().getTranslation();
+
+    byte *inputPtr = gpuInputPtr;
+    GpuSlot *gpuSlots = reinterpret_cast<GpuSlot *>(inputPtr + GPU_SLOTS_OFFSET);
+    GpuMeshlet *gpuMeshlets =
+        reinterpret_cast<GpuMeshlet *>(inputPtr + GPU_SLOTS_OFFSET + MAX_GPU_SLOTS * sizeof(GpuSlot));
+
+    for (uint32 i = 0; i < slots.size(); ++i) {
+        Slot &slot = slots[i];
+        const Entity &entity = scene.getEntities()[slot.entityIndex];
+        const Mesh::SubMesh &submesh = entity.mesh.getSubMeshIdx(slot.submeshIndex);
+        meshletCount += submesh.meshletCount;
+
+        slot.overflow = i >= MAX_GPU_SLOTS || drawCommandCount + submesh.meshletCount > MAX_DRAW_COMMANDS;
+        if (slot.overflow) {
+            continue;
+        }
+
+        const glm::mat4 &modelMatrix = scene.getTransformHierarchy().getLocalToWorldMatrix(entity.transformNode);
+        const ModelSpaceView view = getModelSpaceView(modelMatrix, cameraPosition);
+
+        GpuSlot &gpuSlot = gpuSlots[i];
+        gpuSlot.modelMatrix = modelMatrix;
+        gpuSlot.modelCameraPositionAndScale = glm::vec4(view.cameraPosition, view.scale);
+        gpuSlot.testCones = view.testCones ? 1 : 0;
+
+        // Commands end up at the same index as their Meshlets, contiguous per Slot.
+        for (uint32 m = 0; m < submesh.meshletCount; ++m) {
+            const Mesh::Meshlet &meshlet = entity.mesh.getMeshlets()[submesh.meshletOffset + m];
+            GpuMeshlet &gpuMeshlet = gpuMeshlets[drawCommandCount + m];
+            gpuMeshlet.centerAndRadius = glm::vec4(meshlet.center, meshlet.radius);
+            gpuMeshlet.coneAxisAndCutoff = glm::vec4(meshlet.coneAxis, meshlet.coneCutoff);
+            gpuMeshlet.indexOffset = meshlet.indexOffset;
+            gpuMeshlet.indexCount = meshlet.indexCount;
+            gpuMeshlet.slot = i;
+        }
+
+        slot.firstCommand = drawCommandCount;
+        slot.commandCount = submesh.meshletCount;
+        slot.triangleCount = submesh.indexCount / 3;
+        drawCommandCount += submesh.meshletCount;
+    }
+
+    GpuCullData cullData;
+    memcpy(cullData.frustumPlanes, scene.getCamera().getFrustum().getPlanes(), sizeof(cullData.frustumPlanes));
+    cullData.meshletCount = drawCommandCount;
+    memcpy(inputPtr, &cullData, sizeof(GpuCullData));
+}
+
+uint32 MeshletCuller::cullSlot(const Scene &scene, const Frustum &frustum, const glm::vec3 &cameraPosition,
+                               const OcclusionCuller *occlusionCuller, uint32 slotIdx) {
+    Slot &slot = slots[slotIdx];
+    const Entity &entity = scene.getEntities()[slot.entityIndex];
+    const Mesh &mesh = entity.mesh;
+    const Mesh::SubMesh &submesh = mesh.getSubMeshIdx(slot.submeshIndex);
+
+    const glm::mat4 &modelMatrix = scene.getTransformHierarchy().getLocalToWorldMatrix(entity.transformNode);
+    const ModelSpaceView view = getModelSpaceView(modelMatrix, cameraPosition);
+
+    std::vector<VkDrawIndexedIndirectCommand> &commands = slotCommands[slotIdx];
+    commands.clear();
+    slot.triangleCount = 0;
+
+    uint32 visibleCount = 0;
+    for (uint32 i = 0; i < submesh.meshletCount; ++i) {
+        const Mesh::Meshlet &meshlet = mesh.getMeshlets()[submesh.meshletOffset + i];
+
+        const glm::vec3 toCenter = meshlet.center - view.cameraPosition;
+        if (view.testCones &&
+            glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius) {
+            continue;
+        }
+
+        const BoundingSphere sphere(glm::vec3(modelMatrix * glm::vec4(meshlet.center, 1.0f)),
+                                    meshlet.radius * view.scale);
+        if (!frustum.overlaps(sphere)) {
+            continue;
+        }
+
+        if (occlusionCuller &&
+            occlusionCuller->isOccluded(AABB(sphere.getCenter(), glm::vec3(sphere.getRadius() * 2.0f)))) {
+            continue;
+        }
+
+        visibleCount++;
+        slot.triangleCount += meshlet.indexCount / 3;
+
+        // Meshlets are contiguous on the index buffer, so runs of visible ones become a single command.
+        if (!commands.empty() && commands.back().firstIndex + commands.back().indexCount == meshlet.indexOffset) {
+            commands.back().indexCount += meshlet.indexCount;
+        }
+        else {
+            VkDrawIndexedIndirectCommand command;
+            command.indexCount = meshlet.indexCount;
+            command.instanceCount = 1;
+            command.firstIndex = meshlet.indexOffset;
+            command.vertexOffset = 0;
+            command.firstInstance = 0;
+            commands.push_back(command);
+        }
+    }
+    return visibleCount;
+}
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Graphics/Buffer.h"
+
+
+namespace BZ {
+
+class CommandBuffer;
+class DescriptorSet;
+class DescriptorSetLayout;
+class Frustum;
+class OcclusionCuller;
+class PipelineLayout;
+class PipelineState;
+class Scene;
+
+/*
+ * Meshlet level culling for the color pass. SubMeshes are added for a frame, then each of their Meshlets is tested
+ * against its normal cone for back facing clusters, the Camera Frustum and optionally the OcclusionCuller depth
+ * pyramid. The SubMeshes are culled in parallel on the JobSystem.
+ * The surviving Meshlets are merged into contiguous index ranges and written as VkDrawIndexedIndirectCommands on a
+ * buffer replicated per frame in flight, so each SubMesh is drawn with a single indirect draw. Without
+ * multiDrawIndirect support there's one indirect draw per command instead.
+ * Optionally the tests run on the GPU instead, on a compute pass writing the same VkDrawIndexedIndirectCommand layout.
+ * It writes one command per Meshlet, with no indices when culled, and skips the occlusion test.
+ */
+class MeshletCuller {
+  public:
+    // Over all the SubMeshes of a frame. Once full, the remaining SubMeshes are drawn whole.
+    static constexpr uint32 MAX_DRAW_COMMANDS = 64 * 1024;
+
+    MeshletCuller() = default;
+
+    BZ_NON_COPYABLE(MeshletCuller);
+
+    void init();
+    void destroy();
+
+    // Forgets the SubMeshes of the previous frame.
+    void begin();
+
+    // Entity SubMesh to be drawn on full detail. Returns the slot to cull and draw it.
+    uint32 addSubMesh(uint32 entityIndex, uint32 submeshIndex);
+
+    // On the GPU the Meshlets are only gathered here, and tested by the compute pass recorded on dispatch().
+    void cull(const Scene &scene, const OcclusionCuller *occlusionCuller, bool onGpu);
+
+    // Records the compute pass of a GPU cull, outside of any RenderPass. Does nothing after a CPU cull.
+    void dispatch(CommandBuffer &commandBuffer) const;
+
+    // Expects the Mesh index buffer bound. Returns the number of triangles drawn, all of them when culled on the GPU.
+    uint32 draw(CommandBuffer &commandBuffer, const Scene &scene, uint32 slot) const;
+
+    bool isCulledOnGpu() const { return culledOnGpu; }
+
+    uint32 getMeshletCount() const { return meshletCount; }
+    // Only known when culled on the CPU.
+    uint32 getVisibleMeshletCount() const { return visibleMeshletCount; }
+    uint32 getDrawCommandCount() const { return drawCommandCount; }
+
+  private:
+    // The GPU path has one Slot per SubMesh and one command per Meshlet.
+    static constexpr uint32 MAX_GPU_SLOTS = 16 * 1024;
+    static constexpr uint32 GPU_GROUP_SIZE = 64;
+
+    // std140 and std430, match MeshletCullComp.glsl.
+    struct GpuCullData {
+        glm::vec4 frustumPlanes[6];
+        uint32 meshletCount;
+    };
+
+    struct GpuSlot {
+        glm::mat4 modelMatrix;
+        glm::vec4 modelCameraPositionAndScale;
+        uint32 testCones;
+        uint32 padding[3];
+    };
+
+    struct GpuMeshlet {
+        glm::vec4 centerAndRadius;
+        glm::vec4 coneAxisAndCutoff;
+        uint32 indexOffset;
+        uint32 indexCount;
+        uint32 slot;
+        uint32 padding;
+    };
+
+    struct Slot {
+        uint32 entityIndex;
+        uint32 submeshIndex;
+
+        // On the buffer, after packing.
+        uint32 firstCommand;
+        uint32 commandCount;
+        uint32 triangleCount;
+        bool overflow;
+    };
+
+    Ref<Buffer> buffer;
+    BufferPtr commandsPtr;
+
+    std::vector<Slot> slots;
+
+    // Per slot, written by the culling jobs before being packed into the buffer.
+    std::vector<std::vector<VkDrawIndexedIndirectCommand>> slotCommands;
+
+    // GpuCullData, GpuSlots and GpuMeshlets, replicated per frame in flight, and the commands written by the GPU.
+    Ref<Buffer> gpuInputBuffer;
+    BufferPtr gpuInputPtr;
+    Ref<Buffer> gpuCommandsBuffer;
+
+    Ref<DescriptorSetLayout> gpuDescriptorSetLayout;
+    Ref<PipelineLayout> gpuPipelineLayout;
+    Ref<PipelineState> gpuPipelineState;
+    DescriptorSet *gpuDescriptorSet = nullptr;
+
+    uint32 meshletCount = 0;
+    uint32 visibleMeshletCount = 0;
+    uint32 drawCommandCount = 0;
+
+    bool multiDrawIndirect = false;
+    bool culledOnGpu = false;
+
+    void gatherForGpu(const Scene &scene);
+    uint32 cullSlot(const Scene &scene, const Frustum &frustum, const glm::vec3 &cameraPosition,
+                    const OcclusionCuller *occlusionCuller, uint32 slotIdx);
+};
+}
@@ -0,0 +1,320 @@
+#include "bzpch.h"
+
+#include "OcclusionBuffer.h"
+
+#include "Collisions/AABB.h"
+#include "Collisions/TriangleMesh.h"
+
+
+namespace BZ {
+
+// Horizontal extent of a convex polygon on the line at y, which must be inside its vertical range.
+static void getSpan(const glm::vec2 vertices[], uint32 vertexCount, float y, float &outLeft, float &outRight) {
+    outLeft = std::numeric_limits<float>::max();
+    outRight = std::numeric_limits<float>::lowest();
+    for (uint32 i = 0; i < vertexCount; ++i) {
+        const glm::vec2 &a = vertices[i];
+        const glm::vec2 &b = vertices[(i + 1) % vertexCount];
+        if (glm::min(a.y, b.y) > y || glm::max(a.y, b.y) < y) {
+            continue;
+        }
+        if (a.y == b.y) {
+            outLeft = glm::min(outLeft, glm::min(a.x, b.x));
+            outRight = glm::max(outRight, glm::max(a.x, b.x));
+        }
+        else {
+            const float x = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+            outLeft = glm::min(outLeft, x);
+            outRight = glm::max(outRight, x);
+        }
+    }
+}
+
+static float cross(const glm::vec2 &a, const glm::vec2 &b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+static bool isConvex(const glm::vec2 vertices[4]) {
+    bool anyPositive = false;
+    bool anyNegative = false;
+    for (uint32 i = 0; i < 4; ++i) {
+        const glm::vec2 &a = vertices[i];
+        const glm::vec2 &b = vertices[(i + 1) % 4];
+        const glm::vec2 &c = vertices[(i + 2) % 4];
+        const float turn = cross(b - a, c - b);
+        anyPositive |= turn > 0.0f;
+        anyNegative |= turn < 0.0f;
+    }
+    return !(anyPositive && anyNegative);
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+void OcclusionBuffer::init(uint32 width, uint32 height) {
+    this->width = width;
+    this->height = height;
+
+    glm::uvec2 dimensions(width, height);
+    while (true) {
+        levelDimensions.push_back(dimensions);
+        depthPyramid.emplace_back(dimensions.x * dimensions.y, 1.0f);
+        if (dimensions.x == 1 && dimensions.y == 1) {
+            break;
+        }
+        dimensions = (dimensions + 1u) / 2u;
+    }
+}
+
+void OcclusionBuffer::destroy() {
+    occluderCount = 0;
+    occluderPolygons.clear();
+    depthPyramid.clear();
+    levelDimensions.clear();
+}
+
+void OcclusionBuffer::begin(const glm::mat4 &viewProjection, uint32 occluderCount) {
+    this->viewProjection = viewProjection;
+    this->occluderCount = occluderCount;
+
+    if (occluderPolygons.size() < occluderCount) {
+        occluderPolygons.resize(occluderCount);
+    }
+    for (uint32 i = 0; i < occluderCount; ++i) {
+        occluderPolygons[i].clear();
+    }
+    std::fill(depthPyramid[0].begin(), depthPyramid[0].end(), 1.0f);
+}
+
+void OcclusionBuffer::setupOccluder(uint32 occluderIdx, const TriangleMesh &triangleMesh,
+                                    const glm::mat4 &modelMatrix) {
+    BZ_ASSERT_CORE(occluderIdx < occluderCount, "Invalid occluder index!");
+
+    std::vector<ScreenPolygon> &polygons = occluderPolygons[occluderIdx];
+    const glm::mat4 modelViewProjection = viewProjection * modelMatrix;
+    const uint32 triangleCount = triangleMesh.getTriangleCount();
+
+    uint32 triangle = 0;
+    while (triangle < triangleCount) {
+        glm::vec3 vertices[3];
+        triangleMesh.getTriangle(triangle, vertices);
+
+        const glm::vec4 clipVertices[3] = { modelViewProjection * glm::vec4(vertices[0], 1.0f),
+                                            modelViewProjection * glm::vec4(vertices[1], 1.0f),
+                                            modelViewProjection * glm::vec4(vertices[2], 1.0f) };
+
+        glm::vec4 quad[4];
+        if (triangle + 1 < triangleCount &&
+            mergeQuad(triangleMesh, triangle + 1, vertices, clipVertices, modelViewProjection, quad)) {
+            addPolygon(quad, 4, polygons);
+            triangle += 2;
+        }
+        else {
+            addPolygon(clipVertices, 3, polygons);
+            triangle++;
+        }
+    }
+}
+
+void OcclusionBuffer::rasterizeRows(uint32 beginRow, uint32 endRow) {
+    std::vector<float> &depthBuffer = depthPyramid[0];
+
+    for (uint32 occluderIdx = 0; occluderIdx < occluderCount; ++occluderIdx) {
+        for (const ScreenPolygon &polygon : occluderPolygons[occluderIdx]) {
+            // Rows with all their height inside the vertical range of the polygon.
+            const float firstRow = glm::ceil(polygon.minY);
+            const float lastRow = glm::floor(polygon.maxY);
+            const uint32 rowBegin = static_cast<uint32>(glm::clamp(firstRow, static_cast<float>(beginRow),
+                                                                   static_cast<float>(endRow)));
+            const uint32 rowEnd = static_cast<uint32>(glm::clamp(lastRow, static_cast<float>(beginRow),
+                                                                 static_cast<float>(endRow)));
+
+            for (uint32 row = rowBegin; row < rowEnd; ++row) {
+                // The polygon is convex, so the narrowest extent over the row is on its top or bottom edge.
+                float topLeft, topRight, bottomLeft, bottomRight;
+                getSpan(polygon.vertices, polygon.vertexCount, static_cast<float>(row), topLeft, topRight);
+                getSpan(polygon.vertices, polygon.vertexCount, static_cast<float>(row + 1), bottomLeft, bottomRight);
+
+                // Texels with all their width inside.
+                const float left = glm::ceil(glm::max(topLeft, bottomLeft));
+                const float right = glm::floor(glm::min(topRight, bottomRight));
+                const uint32 spanBegin = static_cast<uint32>(glm::clamp(left, 0.0f, static_cast<float>(width)));
+                const uint32 spanEnd = static_cast<uint32>(glm::clamp(right, 0.0f, static_cast<float>(width)));
+
+                float *rowDepths = &depthBuffer[row * width];
+                const float depth = polygon.depth;
+                for (uint32 x = spanBegin; x < spanEnd; ++x) {
+                    rowDepths[x] = glm::min(rowDepths[x], depth);
+                }
+            }
+        }
+    }
+}
+
+void OcclusionBuffer::end() {
+    buildPyramid();
+}
+
+bool OcclusionBuffer::isOccluded(const AABB &aabb) const {
+    if (occluderCount == 0) {
+        return false;
+    }
+
+    const glm::vec3 &min = aabb.getMin();
+    const glm::vec3 &max = aabb.getMax();
+
+    glm::vec2 minScreen(std::numeric_limits<float>::max());
+    glm::vec2 maxScreen(std::numeric_limits<float>::lowest());
+    float minDepth = 1.0f;
+    for (uint32 i = 0; i < 8; ++i) {
+        const glm::vec3 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+        const glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+
+        // Crossing the near plane, so it can't be projected. Assume it's visible.
+        if (clip.z < 0.0f) {
+            return false;
+        }
+
+        const glm::vec2 screen = toScreen(clip);
+        minScreen = glm::min(minScreen, screen);
+        maxScreen = glm::max(maxScreen, screen);
+        minDepth = glm::min(minDepth, clip.z / clip.w);
+    }
+
+    // Off screen. Not for this test to decide.
+    if (maxScreen.x < 0.0f || maxScreen.y < 0.0f || minScreen.x >= width || minScreen.y >= height) {
+        return false;
+    }
+
+    // Every pixel touched by the rectangle, even if only partially.
+    const glm::uvec2 minPixel(glm::max(minScreen, 0.0f));
+    const glm::uvec2 maxPixel(glm::min(maxScreen, glm::vec2(width - 1, height - 1)));
+
+    uint32 level = 0;
+    while (level + 1 < depthPyramid.size() && ((maxPixel.x >> level) - (minPixel.x >> level) > 1 ||
+                                                (maxPixel.y >> level) - (minPixel.y >> level) > 1)) {
+        level++;
+    }
+
+    const glm::uvec2 &dimensions = levelDimensions[level];
+    const std::vector<float> &depths = depthPyramid[level];
+    float maxDepth = 0.0f;
+    for (uint32 y = minPixel.y >> level; y <= maxPixel.y >> level; ++y) {
+        for (uint32 x = minPixel.x >> level; x <= maxPixel.x >> level; ++x) {
+            maxDepth = glm::max(maxDepth, depths[y * dimensions.x + x]);
+        }
+    }
+    return minDepth > maxDepth;
+}
+
+uint32 OcclusionBuffer::getPolygonCount() const {
+    uint32 count = 0;
+    for (uint32 i = 0; i < occluderCount; ++i) {
+        count += static_cast<uint32>(occluderPolygons[i].size());
+    }
+    return count;
+}
+
+glm::vec2 OcclusionBuffer::toScreen(const glm::vec4 &clipVertex) const {
+    const glm::vec2 ndc = glm::vec2(clipVertex) / clipVertex.w;
+    return (ndc * 0.5f + 0.5f) * glm::vec2(width, height);
+}
+
+bool OcclusionBuffer::mergeQuad(const TriangleMesh &triangleMesh, uint32 nextTriangle, const glm::vec3 vertices[3],
+                                const glm::vec4 clipVertices[3], const glm::mat4 &modelViewProjection,
+                                glm::vec4 outQuad[4]) const {
+    glm::vec3 nextVertices[3];
+    triangleMesh.getTriangle(nextTriangle, nextVertices);
+
+    for (uint32 edge = 0; edge < 3; ++edge) {
+        const glm::vec3 &a = vertices[edge];
+        const glm::vec3 &b = vertices[(edge + 1) % 3];
+
+        // With the same winding, the shared edge goes the other way on the next triangle.
+        for (uint32 nextEdge = 0; nextEdge < 3; ++nextEdge) {
+            if (nextVertices[nextEdge] != b || nextVertices[(nextEdge + 1) % 3] != a) {
+                continue;
+            }
+
+            // Around both triangles: a, the vertex of the next one across the edge, b and the last one of this one.
+            outQuad[0] = clipVertices[edge];
+            outQuad[1] = modelViewProjection * glm::vec4(nextVertices[(nextEdge + 2) % 3], 1.0f);
+            outQuad[2] = clipVertices[(edge + 1) % 3];
+            outQuad[3] = clipVertices[(edge + 2) % 3];
+
+            // Only if it's the same area as the two triangles, which needs it convex on the screen.
+            glm::vec2 screenQuad[4];
+            for (uint32 i = 0; i < 4; ++i) {
+                if (outQuad[i].z < 0.0f) {
+                    return false;
+                }
+                screenQuad[i] = toScreen(outQuad[i]);
+            }
+            return isConvex(screenQuad);
+        }
+    }
+    return false;
+}
+
+void OcclusionBuffer::addPolygon(const glm::vec4 clipVertices[], uint32 vertexCount,
+                                 std::vector<ScreenPolygon> &outPolygons) const {
+    // Clip against the near plane (z >= 0), adding at most one vertex. Past it w is positive.
+    glm::vec4 clipped[MAX_POLYGON_VERTICES];
+    uint32 count = 0;
+    for (uint32 i = 0; i < vertexCount; ++i) {
+        const glm::vec4 &current = clipVertices[i];
+        const glm::vec4 &next = clipVertices[(i + 1) % vertexCount];
+        if (current.z >= 0.0f) {
+            clipped[count++] = current;
+        }
+        if ((current.z >= 0.0f) != (next.z >= 0.0f)) {
+            clipped[count++] = glm::mix(current, next, current.z / (current.z - next.z));
+        }
+    }
+
+    if (count < 3) {
+        return;
+    }
+
+    ScreenPolygon polygon;
+    polygon.vertexCount = count;
+    polygon.depth = 0.0f;
+    glm::vec2 minScreen(std::numeric_limits<float>::max());
+    glm::vec2 maxScreen(std::numeric_limits<float>::lowest());
+    for (uint32 i = 0; i < count; ++i) {
+        polygon.vertices[i] = toScreen(clipped[i]);
+        polygon.depth = glm::max(polygon.depth, clipped[i].z / clipped[i].w);
+        minScreen = glm::min(minScreen, polygon.vertices[i]);
+        maxScreen = glm::max(maxScreen, polygon.vertices[i]);
+    }
+
+    if (maxScreen.x < 0.0f || maxScreen.y < 0.0f || minScreen.x > width || minScreen.y > height) {
+        return;
+    }
+
+    polygon.minY = minScreen.y;
+    polygon.maxY = maxScreen.y;
+    outPolygons.push_back(polygon);
+}
+
+void OcclusionBuffer::buildPyramid() {
+    BZ_PROFILE_FUNCTION();
+
+    for (uint32 level = 1; level < depthPyramid.size(); ++level) {
+        const glm::uvec2 &srcDimensions = levelDimensions[level - 1];
+        const glm::uvec2 &dstDimensions = levelDimensions[level];
+        const std::vector<float> &src = depthPyramid[level - 1];
+        std::vector<float> &dst = depthPyramid[level];
+
+        for (uint32 y = 0; y < dstDimensions.y; ++y) {
+            const uint32 y0 = y * 2 * srcDimensions.x;
+            const uint32 y1 = glm::min(y * 2 + 1, srcDimensions.y - 1) * srcDimensions.x;
+            for (uint32 x = 0; x < dstDimensions.x; ++x) {
+                const uint32 x0 = x * 2;
+                const uint32 x1 = glm::min(x * 2 + 1, srcDimensions.x - 1);
+                dst[y * dstDimensions.x + x] =
+                    glm::max(glm::max(src[y0 + x0], src[y0 + x1]), glm::max(src[y1 + x0], src[y1 + x1]));
+            }
+        }
+    }
+}
+}
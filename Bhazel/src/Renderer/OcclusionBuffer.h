@@ -0,0 +1,84 @@
+#pragma once
+
+
+namespace BZ {
+
+class AABB;
+class TriangleMesh;
+
+/*
+ * Software depth buffer for occlusion culling. Knows nothing about Scenes or threads, the OcclusionCuller drives it.
+ * Occluder triangles are projected, clipped against the near plane and rasterized with inner-conservative coverage: a
+ * texel is only written when a polygon covers all of it. Gaps narrower than a texel are never filled, so whatever is
+ * seen through them is never culled. The price is losing the texels along the seams between polygons. To keep those
+ * to a minimum, two consecutive triangles sharing an edge are rasterized as one quad when it's convex on the screen,
+ * as the two halves of a wall usually are.
+ * Each polygon is written with the depth of its farthest vertex, so occluders are never seen closer than they are.
+ * Over the depth buffer goes a pyramid of max depths, where occludees are tested on the level where their screen
+ * rectangle covers at most 2x2 texels. An occludee is only culled when it's behind every occluder it overlaps.
+ * Depths are the Vulkan clip space ones, from 0 on the near plane to 1 on the far one.
+ *
+ * Each frame: begin(), setupOccluder() for every occluder, rasterizeRows() over all the rows and end(). Different
+ * occluders can be set up in parallel, and then different rows rasterized in parallel.
+ */
+class OcclusionBuffer {
+  public:
+    OcclusionBuffer() = default;
+
+    BZ_NON_COPYABLE(OcclusionBuffer);
+
+    void init(uint32 width, uint32 height);
+    void destroy();
+
+    void begin(const glm::mat4 &viewProjection, uint32 occluderCount);
+    void setupOccluder(uint32 occluderIdx, const TriangleMesh &triangleMesh, const glm::mat4 &modelMatrix);
+    void rasterizeRows(uint32 beginRow, uint32 endRow);
+    void end();
+
+    // World space AABB, against the last end(). Safe to call from many threads.
+    bool isOccluded(const AABB &aabb) const;
+
+    // Row 0 is the top one. 1 where no occluder was written.
+    float getDepth(uint32 x, uint32 y) const { return depthPyramid[0][y * width + x]; }
+
+    uint32 getWidth() const { return width; }
+    uint32 getHeight() const { return height; }
+
+    uint32 getOccluderCount() const { return occluderCount; }
+
+    // Triangles, or quads from merged triangle pairs.
+    uint32 getPolygonCount() const;
+
+  private:
+    // A quad clipped by the near plane.
+    static constexpr uint32 MAX_POLYGON_VERTICES = 5;
+
+    // Convex.
+    struct ScreenPolygon {
+        // In pixels, from the top left corner.
+        glm::vec2 vertices[MAX_POLYGON_VERTICES];
+        uint32 vertexCount;
+        float minY;
+        float maxY;
+        float depth;
+    };
+
+    uint32 width = 0;
+    uint32 height = 0;
+
+    glm::mat4 viewProjection;
+    uint32 occluderCount = 0;
+    std::vector<std::vector<ScreenPolygon>> occluderPolygons;
+
+    // Level 0 is the depth buffer. Each next one has half the dimensions, with the max of 2x2 texels.
+    std::vector<std::vector<float>> depthPyramid;
+    std::vector<glm::uvec2> levelDimensions;
+
+    glm::vec2 toScreen(const glm::vec4 &clipVertex) const;
+    bool mergeQuad(const TriangleMesh &triangleMesh, uint32 nextTriangle, const glm::vec3 vertices[3],
+                   const glm::vec4 clipVertices[3], const glm::mat4 &modelViewProjection, glm::vec4 outQuad[4]) const;
+    void addPolygon(const glm::vec4 clipVertices[], uint32 vertexCount,
+                    std::vector<ScreenPolygon> &outPolygons) const;
+    void buildPyramid();
+};
+}
@@ -0,0 +1,54 @@
+#include "bzpch.h"
+
+#include "OcclusionCuller.h"
+
+#include "Core/Engine.h"
+#include "Renderer/Scene.h"
+
+#include "Collisions/TriangleMesh.h"
+
+
+namespace BZ {
+
+void OcclusionCuller::init() {
+    buffer.init(WIDTH, HEIGHT);
+}
+
+void OcclusionCuller::destroy() {
+    occluders.clear();
+    buffer.destroy();
+}
+
+void OcclusionCuller::render(const Scene &scene) {
+    BZ_PROFILE_FUNCTION();
+
+    const Camera &camera = scene.getCamera();
+
+    occluders.clear();
+    const auto &entities = scene.getEntities();
+    scene.queryFrustum(camera.getFrustum(), [this, &entities](uint32 entityIndex) {
+        if (entities[entityIndex].occluder) {
+            occluders.push_back(entityIndex);
+        }
+        return true;
+    });
+
+    buffer.begin(camera.getProjectionMatrix() * camera.getViewMatrix(), static_cast<uint32>(occluders.size()));
+    if (!occluders.empty()) {
+        JobSystem &jobSystem = Engine::get().getJobSystem();
+        jobSystem.parallelFor(static_cast<uint32>(occluders.size()), 1, [this, &scene](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i) {
+                const Entity &entity = scene.getEntities()[occluders[i]];
+                const Ref<TriangleMesh> triangleMesh = entity.mesh.getTriangleMesh();
+                if (triangleMesh) {
+                    buffer.setupOccluder(i, *triangleMesh,
+                                         scene.getTransformHierarchy().getLocalToWorldMatrix(entity.transformNode));
+                }
+            }
+        });
+        jobSystem.parallelFor(HEIGHT, ROWS_PER_JOB,
+                              [this](uint32 begin, uint32 end) { buffer.rasterizeRows(begin, end); });
+    }
+    buffer.end();
+}
+}
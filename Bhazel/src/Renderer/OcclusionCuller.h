@@ -0,0 +1,46 @@
+#pragma once
+
+#include "OcclusionBuffer.h"
+
+
+namespace BZ {
+
+class AABB;
+class Scene;
+
+/*
+ * CPU occlusion culling. The occluder Entities of a Scene are rasterized into a small OcclusionBuffer: they are set up
+ * in parallel over the JobSystem workers, and then rasterized in bands of rows, also in parallel.
+ */
+class OcclusionCuller {
+  public:
+    static constexpr uint32 WIDTH = 256;
+    static constexpr uint32 HEIGHT = 128;
+
+    OcclusionCuller() = default;
+
+    BZ_NON_COPYABLE(OcclusionCuller);
+
+    void init();
+    void destroy();
+
+    // Rasterizes the occluder Entities inside the Camera Frustum.
+    void render(const Scene &scene);
+
+    // World space AABB, against the last render(). Safe to call from many threads.
+    bool isOccluded(const AABB &aabb) const { return buffer.isOccluded(aabb); }
+
+    uint32 getOccluderCount() const { return static_cast<uint32>(occluders.size()); }
+
+    // Rasterized polygons: triangles, or quads from merged triangle pairs.
+    uint32 getOccluderPolygonCount() const { return buffer.getPolygonCount(); }
+
+  private:
+    static constexpr uint32 ROWS_PER_JOB = 8;
+
+    OcclusionBuffer buffer;
+
+    // Entity indices.
+    std::vector<uint32> occluders;
+};
+}
@@ -0,0 +1,129 @@
+#include "bzpch.h"
+
+#include "ParticlePool2D.h"
+
+
+namespace BZ {
+
+void ParticlePool2D::init(uint32 particleBudget) {
+    BZ_ASSERT_CORE(particleBudget > 0, "Invalid particleBudget!");
+
+    const uint32 blockCount = (particleBudget + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    particles.resize(blockCount * BLOCK_SIZE);
+    blockOwners.resize(blockCount, nullptr);
+
+    // Popped from the back, so the first blocks go first.
+    freeBlocks.reserve(blockCount);
+    for (uint32 i = 0; i < blockCount; ++i) {
+        freeBlocks.push_back(blockCount - 1 - i);
+    }
+
+    BZ_LOG_CORE_INFO("ParticlePool2D: budget of {} particles on {} blocks.", particles.size(), blockCount);
+}
+
+void ParticlePool2D::destroy() {
+    BZ_ASSERT_CORE(freeBlocks.size() == blockOwners.size(), "Destroying ParticlePool2D with blocks in use!");
+
+    particles.clear();
+    freeBlocks.clear();
+    blockOwners.clear();
+}
+
+Particle2D *ParticlePool2D::acquireBlock(ParticleBlockList2D &owner) {
+    uint32 blockIdx;
+
+    if (!freeBlocks.empty()) {
+        blockIdx = freeBlocks.back();
+        freeBlocks.pop_back();
+    }
+    else {
+        // Over budget, take from the lowest priority list below the requester, if any.
+        ParticleBlockList2D *victim = nullptr;
+        for (ParticleBlockList2D *blockOwner : blockOwners) {
+            if (blockOwner->priority < owner.priority && (!victim || blockOwner->priority < victim->priority)) {
+                victim = blockOwner;
+            }
+        }
+        if (!victim) {
+            return nullptr;
+        }
+
+        uint32 culledCount;
+        Particle2D *block = victim->removeLastBlock(culledCount);
+        culledParticleCount += culledCount;
+        blockIdx = static_cast<uint32>((block - particles.data()) / BLOCK_SIZE);
+    }
+
+    blockOwners[blockIdx] = &owner;
+    return &particles[blockIdx * BLOCK_SIZE];
+}
+
+void ParticlePool2D::releaseBlock(Particle2D *block) {
+    const uint32 blockIdx = static_cast<uint32>((block - particles.data()) / BLOCK_SIZE);
+    BZ_ASSERT_CORE(blockOwners[blockIdx], "Releasing a free block!");
+
+    blockOwners[blockIdx] = nullptr;
+    freeBlocks.push_back(blockIdx);
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+ParticleBlockList2D::~ParticleBlockList2D() {
+    clear();
+}
+
+void ParticleBlockList2D::setCapacity(uint32 capacity) {
+    clear();
+    this->capacity = capacity;
+    blocks.reserve((capacity + ParticlePool2D::BLOCK_SIZE - 1) / ParticlePool2D::BLOCK_SIZE);
+}
+
+bool ParticleBlockList2D::push(const Particle2D &particle) {
+    if (count == capacity) {
+        return false;
+    }
+
+    if (count == blocks.size() * ParticlePool2D::BLOCK_SIZE) {
+        Particle2D *block = pool.acquireBlock(*this);
+        if (!block) {
+            return false;
+        }
+        blocks.push_back(block);
+    }
+
+    (*this)[count++] = particle;
+    return true;
+}
+
+void ParticleBlockList2D::swapAndPop(uint32 index) {
+    BZ_ASSERT_CORE(index < count, "Invalid index!");
+
+    count--;
+    if (index != count) {
+        (*this)[index] = (*this)[count];
+    }
+
+    if (count == (blocks.size() - 1) * ParticlePool2D::BLOCK_SIZE) {
+        pool.releaseBlock(blocks.back());
+        blocks.pop_back();
+    }
+}
+
+void ParticleBlockList2D::clear() {
+    for (Particle2D *block : blocks) {
+        pool.releaseBlock(block);
+    }
+    blocks.clear();
+    count = 0;
+}
+
+Particle2D *ParticleBlockList2D::removeLastBlock(uint32 &outCulledCount) {
+    Particle2D *block = blocks.back();
+    blocks.pop_back();
+
+    const uint32 newCount = static_cast<uint32>(blocks.size()) * ParticlePool2D::BLOCK_SIZE;
+    outCulledCount = count - newCount;
+    count = newCount;
+    return block;
+}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+
+namespace BZ {
+
+struct Particle2D {
+    // Don't use Sprite. We don't need a Texture for all Particlesm they share the Emitter texture.
+    glm::vec2 position;
+    glm::vec2 dimensions;
+    float rotationDeg;
+    glm::vec4 tintAndAlpha;
+    float originalAlpha;
+
+    float timeToLiveSecs;
+    float totalLifeSecs;
+    glm::vec2 velocity;
+    float angularVelocity;
+    glm::vec2 acceleration;
+};
+
+class ParticleBlockList2D;
+
+
+/*
+ * Engine-wide storage for the Emitter2D particles. Preallocated for a global particle budget and handed out on fixed
+ * capacity blocks, so emitting and killing particles never allocates.
+ * When the budget is exhausted, a list can take the last block of the lowest priority list below its own. The particles
+ * on that block are culled.
+ */
+class ParticlePool2D {
+  public:
+    static constexpr uint32 BLOCK_SIZE = 256;
+
+    ParticlePool2D() = default;
+
+    BZ_NON_COPYABLE(ParticlePool2D);
+
+    // The budget is rounded up to a multiple of BLOCK_SIZE.
+    void init(uint32 particleBudget);
+    void destroy();
+
+    uint32 getBlockCount() const { return static_cast<uint32>(blockOwners.size()); }
+    uint32 getFreeBlockCount() const { return static_cast<uint32>(freeBlocks.size()); }
+
+    // Particles lost to lower priority lists since the start.
+    uint64 getCulledParticleCount() const { return culledParticleCount; }
+
+  private:
+    std::vector<Particle2D> particles;
+    std::vector<uint32> freeBlocks;
+    std::vector<ParticleBlockList2D *> blockOwners;
+    uint64 culledParticleCount = 0;
+
+    // Returns nullptr if over budget and there's nothing to take from lower priority lists.
+    Particle2D *acquireBlock(ParticleBlockList2D &owner);
+    void releaseBlock(Particle2D *block);
+
+    friend class ParticleBlockList2D;
+};
+
+
+/*
+ * Contiguous list of particles stored on ParticlePool2D blocks. Index i lives on block i / BLOCK_SIZE. Blocks are taken
+ * as the list grows and returned as soon as they are empty.
+ */
+class ParticleBlockList2D {
+  public:
+    explicit ParticleBlockList2D(ParticlePool2D &pool) : pool(pool) {}
+    ~ParticleBlockList2D();
+
+    BZ_NON_COPYABLE(ParticleBlockList2D);
+
+    // Allocates the bookkeeping for the given capacity. Meant to be called before use, not while updating.
+    void setCapacity(uint32 capacity);
+
+    // Returns false if the particle was culled, because of the capacity or of the global budget.
+    bool push(const Particle2D &particle);
+
+    // Moves the last particle into index.
+    void swapAndPop(uint32 index);
+
+    void clear();
+
+    Particle2D &operator[](uint32 index) {
+        return blocks[index / ParticlePool2D::BLOCK_SIZE][index % ParticlePool2D::BLOCK_SIZE];
+    }
+    const Particle2D &operator[](uint32 index) const {
+        return blocks[index / ParticlePool2D::BLOCK_SIZE][index % ParticlePool2D::BLOCK_SIZE];
+    }
+
+    uint32 getCount() const { return count; }
+    uint32 getCapacity() const { return capacity; }
+
+    // Higher priority lists can take blocks from lower priority ones when over budget.
+    uint32 priority = 0;
+
+  private:
+    ParticlePool2D &pool;
+    std::vector<Particle2D *> blocks;
+    uint32 count = 0;
+    uint32 capacity = 0;
+
+    // The pool took the last block. Returns it.
+    Particle2D *removeLastBlock(uint32 &outCulledCount);
+
+    friend class ParticlePool2D;
+};
+}
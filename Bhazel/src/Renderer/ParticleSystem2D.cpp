@@ -1,7 +1,10 @@
 #include "bzpch.h"
 
 #include "Core/Engine.h"
+#include "Graphics/Buffer.h"
+#include "Graphics/DescriptorSet.h"
 #include "Graphics/Texture.h"
+#include "Graphics/TextureAtlas.h"
 #include "ParticleSystem2D.h"
 
 
@@ -22,32 +25,39 @@ Emitter2D::Emitter2D(ParticleSystem2D &parent, const glm::vec2 &positionOffset,
     parent(parent),
     positionOffset(positionOffset), particlesPerSec(particlesPerSec), secsPerParticle(1.0f / particlesPerSec),
     secsUntilNextEmission(1.0f / particlesPerSec), totalLifeSecs(totalLifeSecs), secsToLive(totalLifeSecs),
-    texture(texture), ranges(ranges) {
+    texture(texture), ranges(ranges),
+    activeParticles(std::make_unique<ParticleBlockList2D>(Engine::get().getParticlePool2D())) {
+    maxParticles = std::max(static_cast<uint32>(std::ceil(particlesPerSec * ranges.lifeSecsRange.max)), 1u);
 }
 
-void Emitter2D::start() {
+void Emitter2D::start(uint32 randomSeed) {
+    this->randomSeed = randomSeed;
     secsUntilNextEmission = 1.0f / particlesPerSec;
     secsToLive = totalLifeSecs;
-    activeParticles.clear();
+    activeParticles->setCapacity(maxParticles);
+    activeParticles->priority = priority;
 }
 
 void Emitter2D::onUpdate(const FrameTiming &frameTiming) {
-    // Update lifetimes
-    for (auto &particle : activeParticles) {
-        particle.timeToLiveSecs -= frameTiming.deltaTime.asSeconds();
-    }
+    const float deltaSecs = frameTiming.deltaTime.asSeconds();
+
+    ParticleBlockList2D &particles = *activeParticles;
+    for (uint32 i = 0; i < particles.getCount();) {
+        Particle2D &particle = particles[i];
 
-    auto it = std::remove_if(activeParticles.begin(), activeParticles.end(),
-                             [](const Particle2D &particle) { return particle.timeToLiveSecs <= 0.0f; });
-    activeParticles.erase(it, activeParticles.end());
+        // Update lifetime. Dead particles are replaced by the last one, which is updated next.
+        particle.timeToLiveSecs -= deltaSecs;
+        if (particle.timeToLiveSecs <= 0.0f) {
+            particles.swapAndPop(i);
+            continue;
+        }
 
-    // Update current active particles
-    for (auto &particle : activeParticles) {
-        particle.velocity += particle.acceleration * frameTiming.deltaTime.asSeconds();
-        particle.position += particle.velocity * frameTiming.deltaTime.asSeconds();
-        particle.rotationDeg += particle.angularVelocity * frameTiming.deltaTime.asSeconds();
-        particle.timeToLiveSecs -= frameTiming.deltaTime.asSeconds();
+        particle.velocity += particle.acceleration * deltaSecs;
+        particle.position += particle.velocity * deltaSecs;
+        particle.rotationDeg += particle.angularVelocity * deltaSecs;
+        particle.timeToLiveSecs -= deltaSecs;
         particle.tintAndAlpha.a = particle.originalAlpha * (particle.timeToLiveSecs / particle.totalLifeSecs);
+        ++i;
     }
 
     // If not immortal (negative totalLife) and not dead, decrement life
@@ -62,8 +72,11 @@ void Emitter2D::onUpdate(const FrameTiming &frameTiming) {
             uint32 countToEmit = static_cast<uint32>(-secsUntilNextEmission / secsPerParticle);
             if (countToEmit > 0) {
                 // BZ_LOG_DEBUG("emitting {}", countToEmit);
+                // Seeded like the invocations of the GpuEmitter2D emit shader.
+                const uint32 stepSeed = ParticleRandom2D::hash(randomSeed++);
                 for (uint32 i = 0; i < countToEmit; ++i) {
-                    emitParticle();
+                    ParticleRandom2D random(ParticleRandom2D::hash(stepSeed + i));
+                    emitParticle(random);
                 }
 
                 // TODO: find out the correct operation
@@ -74,19 +87,69 @@ void Emitter2D::onUpdate(const FrameTiming &frameTiming) {
     }
 }
 
-void Emitter2D::emitParticle() {
+// Same order of random values as on Particles2DEmitComp.glsl.
+void Emitter2D::emitParticle(ParticleRandom2D &random) {
     Particle2D particle;
-    particle.position = parent.getPosition() + positionOffset + ranges.positionRange.getValue();
-    particle.dimensions = ranges.dimensionRange.getValue();
-    particle.rotationDeg = ranges.rotationRange.getValue();
-    particle.tintAndAlpha = ranges.tintAndAlphaRange.getValue();
+    particle.position = parent.getPosition() + positionOffset + ranges.positionRange.getValue(random);
+    particle.dimensions = ranges.dimensionRange.getValue(random);
+    particle.rotationDeg = ranges.rotationRange.getValue(random);
+    particle.tintAndAlpha = ranges.tintAndAlphaRange.getValue(random);
     particle.originalAlpha = particle.tintAndAlpha.a;
-    particle.totalLifeSecs = ranges.lifeSecsRange.getValue();
+    particle.totalLifeSecs = ranges.lifeSecsRange.getValue(random);
     particle.timeToLiveSecs = particle.totalLifeSecs;
-    particle.velocity = ranges.velocityRange.getValue();
-    particle.angularVelocity = ranges.angularVelocityRange.getValue();
-    particle.acceleration = ranges.accelerationRange.getValue();
-    activeParticles.push_back(particle);
+    particle.velocity = ranges.velocityRange.getValue(random);
+    particle.angularVelocity = ranges.angularVelocityRange.getValue(random);
+    particle.acceleration = ranges.accelerationRange.getValue(random);
+
+    // May be culled, because of maxParticles or the global budget.
+    activeParticles->push(particle);
+}
+
+
+/*-------------------------------------------------------------------------------------------*/
+GpuEmitter2D::GpuEmitter2D(ParticleSystem2D &parent, const glm::vec2 &positionOffset, uint32 particlesPerSec,
+                           float totalLifeSecs, Particle2DRanges &ranges, const Ref<Texture2D> &texture,
+                           uint32 maxParticles) :
+    parent(parent),
+    positionOffset(positionOffset), particlesPerSec(particlesPerSec), secsPerParticle(1.0f / particlesPerSec),
+    secsUntilNextEmission(1.0f / particlesPerSec), totalLifeSecs(totalLifeSecs), secsToLive(totalLifeSecs),
+    texture(texture), ranges(ranges), maxParticles(maxParticles) {
+    BZ_ASSERT_CORE(maxParticles > 0, "Invalid maxParticles!");
+}
+
+GpuEmitter2D::~GpuEmitter2D() {
+    if (descriptorSet) {
+        DescriptorSet::release(*descriptorSet);
+    }
+}
+
+void GpuEmitter2D::start(uint32 randomSeed) {
+    this->randomSeed = randomSeed;
+    secsUntilNextEmission = 1.0f / particlesPerSec;
+    secsToLive = totalLifeSecs;
+    pendingDeltaSecs = 0.0f;
+    pendingEmitCount = 0;
+    resetPending = true;
+}
+
+// Same emission timing as Emitter2D. The particles themselves are only touched on the GPU.
+void GpuEmitter2D::onUpdate(const FrameTiming &frameTiming) {
+    pendingDeltaSecs += frameTiming.deltaTime.asSeconds();
+
+    if (totalLifeSecs >= 0.0f && secsToLive >= 0.0f) {
+        secsToLive -= frameTiming.deltaTime.asSeconds();
+    }
+
+    if (totalLifeSecs < 0.0f || secsToLive >= 0.0f) {
+        secsUntilNextEmission -= frameTiming.deltaTime.asSeconds();
+        if (secsUntilNextEmission < 0.0f) {
+            uint32 countToEmit = static_cast<uint32>(-secsUntilNextEmission / secsPerParticle);
+            if (countToEmit > 0) {
+                pendingEmitCount = std::min(pendingEmitCount + countToEmit, maxParticles);
+                secsUntilNextEmission = secsPerParticle;
+            }
+        }
+    }
 }
 
 
@@ -100,11 +163,47 @@ ParticleSystem2D::ParticleSystem2D(const glm::vec2 &position) : position(positio
 void ParticleSystem2D::addEmitter(const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
                                   Particle2DRanges &ranges, const Ref<Texture2D> &texture) {
     emitters.emplace_back(*this, positionOffset, particlesPerSec, totalLifeSecs, ranges, texture);
+
+    // With the seed it would have got from the last start().
+    if (isStarted) {
+        const uint32 index = static_cast<uint32>(emitters.size() - 1);
+        emitters.back().start(ParticleRandom2D::hash(startedRandomSeed + index));
+    }
+}
+
+void ParticleSystem2D::addEmitter(const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
+                                  Particle2DRanges &ranges, const TextureAtlasRegion &atlasRegion) {
+    addEmitter(positionOffset, particlesPerSec, totalLifeSecs, ranges, atlasRegion.texture);
+    emitters.back().texCoordRect = atlasRegion.texCoordRect;
+}
+
+void ParticleSystem2D::addGpuEmitter(const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
+                                     Particle2DRanges &ranges, const Ref<Texture2D> &texture, uint32 maxParticles) {
+    gpuEmitters.push_back(std::make_unique<GpuEmitter2D>(*this, positionOffset, particlesPerSec, totalLifeSecs, ranges,
+                                                         texture, maxParticles));
+
+    if (isStarted) {
+        const uint32 index = static_cast<uint32>(gpuEmitters.size() - 1);
+        gpuEmitters.back()->start(ParticleRandom2D::hash(startedRandomSeed + index));
+    }
+}
+
+void ParticleSystem2D::addGpuEmitter(const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
+                                     Particle2DRanges &ranges, const TextureAtlasRegion &atlasRegion,
+                                     uint32 maxParticles) {
+    addGpuEmitter(positionOffset, particlesPerSec, totalLifeSecs, ranges, atlasRegion.texture, maxParticles);
+    gpuEmitters.back()->texCoordRect = atlasRegion.texCoordRect;
 }
 
 void ParticleSystem2D::start() {
-    for (auto &emitter : emitters) {
-        emitter.start();
+    startedRandomSeed = randomSeed++;
+
+    // The n-th Emitter2D and the n-th GpuEmitter2D get the same seed.
+    for (uint32 i = 0; i < emitters.size(); ++i) {
+        emitters[i].start(ParticleRandom2D::hash(startedRandomSeed + i));
+    }
+    for (uint32 i = 0; i < gpuEmitters.size(); ++i) {
+        gpuEmitters[i]->start(ParticleRandom2D::hash(startedRandomSeed + i));
     }
     isStarted = true;
 }
@@ -114,6 +213,9 @@ void ParticleSystem2D::onUpdate(const FrameTiming &frameTiming) {
         for (auto &emitter : emitters) {
             emitter.onUpdate(frameTiming);
         }
+        for (auto &gpuEmitter : gpuEmitters) {
+            gpuEmitter->onUpdate(frameTiming);
+        }
     }
 }
 }
\ No newline at end of file
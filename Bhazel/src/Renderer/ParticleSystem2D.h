@@ -1,10 +1,47 @@
 #pragma once
 
-#include <glm/gtc/random.hpp>
+#include "Renderer/ParticlePool2D.h"
+#include "Renderer/Renderer2D.h"
 
 
 namespace BZ {
 
+/*
+ * PCG hash generator, the same as random() on Particles2DCommon.glsl. Emitter2D and GpuEmitter2D seed it the same way
+ * and draw the particle values in the same order, so an effect gives the same particles on the CPU and on the GPU.
+ */
+class ParticleRandom2D {
+  public:
+    explicit ParticleRandom2D(uint32 state) : state(state) {}
+
+    static uint32 hash(uint32 value) {
+        const uint32 pcgState = value * 747796405u + 2891336453u;
+        const uint32 word = ((pcgState >> ((pcgState >> 28u) + 4u)) ^ pcgState) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+
+    // On [0, 1]. Vector components are drawn in order.
+    template <typename T> T next();
+
+  private:
+    uint32 state;
+};
+
+template <> inline float ParticleRandom2D::next<float>() {
+    state = hash(state);
+    return static_cast<float>(state) / 4294967295.0f;
+}
+
+template <> inline glm::vec2 ParticleRandom2D::next<glm::vec2>() {
+    const float x = next<float>();
+    return glm::vec2(x, next<float>());
+}
+
+template <> inline glm::vec4 ParticleRandom2D::next<glm::vec4>() {
+    const glm::vec2 xy = next<glm::vec2>();
+    return glm::vec4(xy, next<glm::vec2>());
+}
+
 template <typename T> struct Range {
     T min;
     T max;
@@ -17,7 +54,7 @@ template <typename T> struct Range {
         max = v;
     }
 
-    T getValue() { return glm::linearRand(min, max); }
+    T getValue(ParticleRandom2D &random) const { return glm::mix(min, max, random.next<T>()); }
 };
 
 struct Particle2DRanges {
@@ -33,26 +70,11 @@ struct Particle2DRanges {
     Particle2DRanges();
 };
 
-struct Particle2D {
-    // Don't use Sprite. We don't need a Texture for all Particlesm they share the Emitter texture.
-    glm::vec2 position;
-    glm::vec2 dimensions;
-    float rotationDeg;
-    glm::vec4 tintAndAlpha;
-    float originalAlpha;
-
-    float timeToLiveSecs;
-    float totalLifeSecs;
-    glm::vec2 velocity;
-    float angularVelocity;
-    glm::vec2 acceleration;
-};
-
-
 /*-------------------------------------------------------------------------------------------*/
 class ParticleSystem2D;
 struct FrameTiming;
 class Texture2D;
+struct TextureAtlasRegion;
 
 
 class Emitter2D {
@@ -60,10 +82,72 @@ class Emitter2D {
     Emitter2D(ParticleSystem2D &parent, const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
               Particle2DRanges &ranges, const Ref<Texture2D> &texture);
 
-    void start();
+    void start(uint32 randomSeed);
+    void onUpdate(const FrameTiming &frameTiming);
+
+    const ParticleBlockList2D &getActiveParticles() const { return *activeParticles; }
+
+    uint32 particlesPerSec;
+    float totalLifeSecs;
+
+    Particle2DRanges ranges;
+    Ref<Texture2D> texture;
+
+    // Min UVs on xy, max UVs on zw.
+    glm::vec4 texCoordRect = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+    uint8 layer = 0;
+    SpriteBlendMode blendMode = SpriteBlendMode::Alpha;
+
+    // Applied on start(). Defaults to the most particles alive at once for the emission rate and the life range.
+    uint32 maxParticles;
+
+    // Applied on start(). Over the global particle budget, higher priority emitters take particles from lower ones.
+    uint32 priority = 0;
+
+  private:
+    ParticleSystem2D &parent;
+
+    glm::vec2 positionOffset; // Relative to parent ParticleSystem
+    float secsToLive;
+    float secsPerParticle;
+    float secsUntilNextEmission;
+
+    // Changes every step that emits, like on GpuEmitter2D.
+    uint32 randomSeed = 0;
+
+    // On the heap, the ParticlePool2D keeps its address.
+    std::unique_ptr<ParticleBlockList2D> activeParticles;
+
+    void emitParticle(ParticleRandom2D &random);
+};
+
+
+/*-------------------------------------------------------------------------------------------*/
+class Buffer;
+class DescriptorSet;
+
+/*
+ * Emitter whose particles live on GPU storage buffers. Emission and simulation run on compute shaders when the
+ * ParticleSystem2D is rendered, and the alive particles are drawn with a single indirect instanced draw. Takes the same
+ * Particle2DRanges as Emitter2D, so effects can switch between both.
+ * The particles are sorted with the sprites as a whole, where the first particle of an Emitter2D on the same layer,
+ * blend mode and texture would be.
+ * Random values come from ParticleRandom2D on both. The particles are the same as with an Emitter2D as long as every
+ * update is rendered, otherwise the emissions of several updates are merged into one step.
+ */
+class GpuEmitter2D {
+  public:
+    GpuEmitter2D(ParticleSystem2D &parent, const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
+                 Particle2DRanges &ranges, const Ref<Texture2D> &texture, uint32 maxParticles);
+    ~GpuEmitter2D();
+
+    BZ_NON_COPYABLE(GpuEmitter2D);
+
+    void start(uint32 randomSeed);
     void onUpdate(const FrameTiming &frameTiming);
 
-    const std::vector<Particle2D> &getActiveParticles() const { return activeParticles; }
+    uint32 getMaxParticles() const { return maxParticles; }
 
     uint32 particlesPerSec;
     float totalLifeSecs;
@@ -71,6 +155,12 @@ class Emitter2D {
     Particle2DRanges ranges;
     Ref<Texture2D> texture;
 
+    // Min UVs on xy, max UVs on zw.
+    glm::vec4 texCoordRect = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+    uint8 layer = 0;
+    SpriteBlendMode blendMode = SpriteBlendMode::Alpha;
+
   private:
     ParticleSystem2D &parent;
 
@@ -78,11 +168,28 @@ class Emitter2D {
     float secsToLive;
     float secsPerParticle;
     float secsUntilNextEmission;
+    uint32 maxParticles;
+
+    // Accumulated since the last simulation step on the GPU.
+    float pendingDeltaSecs = 0.0f;
+    uint32 pendingEmitCount = 0;
+    bool resetPending = true;
+
+    // Changes every simulation step that emits, so the same sequence of random values is generated on every run.
+    uint32 randomSeed = 0;
 
-    std::vector<Particle2D> activeParticles;
-    // std::vector<Particle2D> inactiveParticles;
+    // Which of the two alive lists holds the particles of the last step.
+    uint32 currentAliveList = 0;
 
-    void emitParticle();
+    // Created by Renderer2D when first rendered.
+    Ref<Buffer> particlesBuffer;
+    Ref<Buffer> aliveListsBuffer;
+    Ref<Buffer> deadListBuffer;
+    Ref<Buffer> countersBuffer;
+    Ref<Buffer> dataBuffer;
+    DescriptorSet *descriptorSet = nullptr;
+
+    friend class Renderer2D;
 };
 
 
@@ -96,9 +203,19 @@ class ParticleSystem2D {
     ParticleSystem2D();
     explicit ParticleSystem2D(const glm::vec2 &position);
 
+    // Emitters added after start() are started right away.
     void addEmitter(const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
                     Particle2DRanges &ranges, const Ref<Texture2D> &texture);
+    void addEmitter(const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
+                    Particle2DRanges &ranges, const TextureAtlasRegion &atlasRegion);
+    void addGpuEmitter(const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
+                       Particle2DRanges &ranges, const Ref<Texture2D> &texture, uint32 maxParticles);
+    void addGpuEmitter(const glm::vec2 &positionOffset, uint32 particlesPerSec, float totalLifeSecs,
+                       Particle2DRanges &ranges, const TextureAtlasRegion &atlasRegion, uint32 maxParticles);
+
+    // Each start takes the next seed, so restarts look different but every run is the same.
     void start();
+    void setRandomSeed(uint32 seed) { randomSeed = seed; }
 
     void setPosition(const glm::vec2 &position) { this->position = position; }
     const glm::vec2 &getPosition() const { return position; }
@@ -106,11 +223,17 @@ class ParticleSystem2D {
     std::vector<Emitter2D> &getEmitters() { return emitters; }
     const std::vector<Emitter2D> &getEmitters() const { return emitters; }
 
+    std::vector<std::unique_ptr<GpuEmitter2D>> &getGpuEmitters() { return gpuEmitters; }
+    const std::vector<std::unique_ptr<GpuEmitter2D>> &getGpuEmitters() const { return gpuEmitters; }
+
     void onUpdate(const FrameTiming &frameTiming);
 
   private:
     std::vector<Emitter2D> emitters;
+    std::vector<std::unique_ptr<GpuEmitter2D>> gpuEmitters;
     glm::vec2 position;
+    uint32 randomSeed = 0;
+    uint32 startedRandomSeed = 0;
     bool isStarted = false;
 };
 }
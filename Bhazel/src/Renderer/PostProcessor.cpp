@@ -29,10 +29,12 @@ void Bloom::init() {
     const uint32 H = INPUT_DIMENSIONS.y / 2;
 
     tex1 = Texture2D::createRenderTarget(W, H, 1, BLOOM_TEXTURE_MIPS, postProcessor.getInputTextureFormat(),
-                                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+                                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                             VK_IMAGE_USAGE_STORAGE_BIT);
     BZ_SET_TEXTURE_DEBUG_NAME(tex1, "Bloom Aux Texture 1");
 
-    tex2 = Texture2D::createRenderTarget(W, H, 1, BLOOM_TEXTURE_MIPS, postProcessor.getInputTextureFormat());
+    tex2 = Texture2D::createRenderTarget(W, H, 1, BLOOM_TEXTURE_MIPS, postProcessor.getInputTextureFormat(),
+                                         VK_IMAGE_USAGE_STORAGE_BIT);
     BZ_SET_TEXTURE_DEBUG_NAME(tex2, "Bloom Aux Texture 2");
 
     for (uint32 i = 0; i < BLOOM_TEXTURE_MIPS; ++i) {
@@ -43,7 +45,8 @@ void Bloom::init() {
     intensity = 0.05f;
 
     initBlurPass();
-    initFinalPass();
+    initComputePasses();
+    initResultDescriptorSets();
 }
 
 void Bloom::destroy() {
@@ -62,27 +65,37 @@ void Bloom::destroy() {
     blurRenderPass.reset();
     blurDescriptorSetLayout.reset();
 
-    finalDescriptorSetLayout.reset();
-    finalPipelineLayout.reset();
-    finalPipelineState.reset();
-    finalRenderPass.reset();
-    finalFramebuffer.reset();
+    computeDownsamplePipelineLayout.reset();
+    computeDownsamplePipelineState.reset();
+    computeDownsampleDescriptorSetLayout.reset();
+    computeBlurPipelineLayout.reset();
+    computeBlurPipelineState.reset();
+    computeBlurDescriptorSetLayout.reset();
+
+    resultDescriptorSetLayout.reset();
 }
 
 void Bloom::render(CommandBuffer &commandBuffer) {
-    BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "Downsample Pass");
-    downsamplePass(commandBuffer);
+    if (computePath) {
+        BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "Compute Downsample Pass");
+        computeDownsamplePass(commandBuffer);
 
-    BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "Blur Pass");
-    blurPass(commandBuffer);
+        BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "Compute Blur Pass");
+        computeBlurPass(commandBuffer);
+    }
+    else {
+        BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "Downsample Pass");
+        downsamplePass(commandBuffer);
 
-    BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "Final Pass");
-    finalPass(commandBuffer);
+        BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "Blur Pass");
+        blurPass(commandBuffer);
+    }
 }
 
 void Bloom::onImGuiRender(const FrameTiming &frameTiming) {
     ImGui::Text("Bloom:");
     ImGui::Checkbox("Enabled", &enabled);
+    ImGui::Checkbox("Compute Path", &computePath);
     ImGui::DragFloat("Intensity", &intensity, 0.001f, 0.0f, 0.5f);
 
     for (uint32 i = 0; i < BLOOM_TEXTURE_MIPS; ++i) {
@@ -99,26 +112,18 @@ void Bloom::downsamplePass(CommandBuffer &commandBuffer) {
     uint32 w = INPUT_DIMENSIONS.x;
     uint32 h = INPUT_DIMENSIONS.y;
 
-    // Populate tex1 with blits from the input image.
-    uint32 i;
-    for (i = 0; i < BLOOM_TEXTURE_MIPS; ++i) {
+    const Ref<Texture> inputTex = postProcessor.getInputTexView()->getTexture();
 
-        Ref<Texture> src = i == 0 ? postProcessor.getInputTexView()->getTexture() : tex1;
+    // Populate tex1 with blits from the input image. Each blit reads the result of the previous one, so the only
+    // barrier needed per mip is the one sent together with the blit.
+    for (uint32 i = 0; i < BLOOM_TEXTURE_MIPS; ++i) {
+
+        Ref<Texture> src = i == 0 ? inputTex : tex1;
         uint32 srcMip = i == 0 ? 0 : i - 1;
         uint32 dstMip = i;
-        VkImageLayout srcLayout =
-            i == 0 ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-
-        // Layout transition to SRC_OPTIMAL.
-        commandBuffer.pipelineBarrierTexture(src, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                             VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, srcLayout,
-                                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, srcMip, 1);
 
-
-        // Layout transition to DST_OPTIMAL.
-        commandBuffer.pipelineBarrierTexture(
-            tex1, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
-            VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, dstMip, 1);
+        commandBuffer.transitionTexture(src, ResourceUsage::TransferSrc, srcMip, 1);
+        commandBuffer.transitionTexture(tex1, ResourceUsage::TransferDst, dstMip, 1);
 
         VkImageBlit blit = {};
         blit.srcOffsets[0] = { 0, 0, 0 };
@@ -137,21 +142,13 @@ void Bloom::downsamplePass(CommandBuffer &commandBuffer) {
         commandBuffer.blitTexture(src, tex1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                   &blit, 1, VK_FILTER_LINEAR);
 
-        // Layout transition from SRC_OPTIMAL to SHADER_READ_ONLY_OPTIMAL.
-        commandBuffer.pipelineBarrierTexture(src, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                             VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, srcMip, 1);
-
         w /= 2;
         h /= 2;
     }
 
-    // Layout transition last mipmap from DST_OPTIMAL to SHADER_READ_ONLY_OPTIMAL.
-    commandBuffer.pipelineBarrierTexture(tex1, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
-                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                         i - 1, 1);
+    // Everything back to SHADER_READ_ONLY_OPTIMAL, on a single barrier sent before the blur pass.
+    commandBuffer.transitionTexture(inputTex, ResourceUsage::FragmentShaderRead, 0, 1);
+    commandBuffer.transitionTexture(tex1, ResourceUsage::FragmentShaderRead);
 }
 
 void Bloom::initBlurPass() {
@@ -249,6 +246,19 @@ void Bloom::blurPass(CommandBuffer &commandBuffer) {
     for (uint32 blurPass = 0; blurPass < 2; ++blurPass) {
 
         for (int mip = BLOOM_TEXTURE_MIPS - 1; mip >= 0; --mip) {
+            // Declare what will be sampled. Horizontal pass mips read the downsample results, which are already
+            // available, so they may run concurrently. The vertical pass mips need to wait for the horizontal pass and
+            // for the previous vertical mip, to sum the results into itself.
+            if (blurPass == 0) {
+                commandBuffer.transitionTexture(tex1, ResourceUsage::FragmentShaderRead, mip, 1);
+            }
+            else {
+                commandBuffer.transitionTexture(tex2, ResourceUsage::FragmentShaderRead, mip, 1);
+                if (mip < static_cast<int>(BLOOM_TEXTURE_MIPS) - 1) {
+                    commandBuffer.transitionTexture(tex1, ResourceUsage::FragmentShaderRead, mip + 1, 1);
+                }
+            }
+
             uint32 push[] = { blurPass, static_cast<uint32>(mip) };
             commandBuffer.bindDescriptorSet(blurPass ? *blurDescriptorSets2[mip] : *blurDescriptorSets1[mip],
                                             blurPipelineLayout, 1, nullptr, 0);
@@ -257,106 +267,162 @@ void Bloom::blurPass(CommandBuffer &commandBuffer) {
             commandBuffer.setPushConstants(blurPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, &push, 0, sizeof(push));
             commandBuffer.draw(3, 1, 0, 0);
             commandBuffer.endRenderPass();
-
-            // Vertical pass mip must wait for the previous mip to be done to sum the results into itself.
-            // Horizontal pass mips may run concurrently.
-            if (blurPass == 1) {
-                commandBuffer.pipelineBarrierMemory(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                                    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
-            }
         }
+    }
+}
 
-        // Vertical pass must wait for horizontal pass.
-        if (blurPass == 0) {
-            commandBuffer.pipelineBarrierMemory(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
-        }
+void Bloom::initComputePasses() {
+    // Downsample.
+    computeDownsampleDescriptorSetLayout = DescriptorSetLayout::create(
+        { { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT, 1 },
+          { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, BLOOM_TEXTURE_MIPS } });
+
+    computeDownsamplePipelineLayout = PipelineLayout::create({ computeDownsampleDescriptorSetLayout });
+
+    PipelineStateData downsamplePipelineStateData;
+    downsamplePipelineStateData.shader =
+        Shader::create({ { "Bhazel/shaders/bin/BloomDownsampleComp.spv", VK_SHADER_STAGE_COMPUTE_BIT } });
+    downsamplePipelineStateData.layout = computeDownsamplePipelineLayout;
+    computeDownsamplePipelineState = PipelineState::create(downsamplePipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(computeDownsamplePipelineState, "Bloom Compute Downsample Pipeline");
+
+    computeDownsampleDescriptorSet = &DescriptorSet::get(computeDownsampleDescriptorSetLayout);
+    computeDownsampleDescriptorSet->setCombinedTextureSampler(postProcessor.getInputTexView(),
+                                                              postProcessor.getSamplerLinear(), 0);
+    computeDownsampleDescriptorSet->setStorageTextures(tex1MipViews, BLOOM_TEXTURE_MIPS, 0, 1);
+
+    // Blur. The weights go on the push constants, the PostProcessor DescriptorSet is only visible to fragment shaders.
+    computeBlurDescriptorSetLayout =
+        DescriptorSetLayout::create({ { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT, 1 },
+                                      { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT, 1 },
+                                      { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1 } });
+
+    computeBlurPipelineLayout = PipelineLayout::create({ computeBlurDescriptorSetLayout },
+                                                       { { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32) * 2 } });
+
+    PipelineStateData blurPipelineStateData;
+    blurPipelineStateData.shader =
+        Shader::create({ { "Bhazel/shaders/bin/BloomBlurComp.spv", VK_SHADER_STAGE_COMPUTE_BIT } });
+    blurPipelineStateData.layout = computeBlurPipelineLayout;
+    computeBlurPipelineState = PipelineState::create(blurPipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(computeBlurPipelineState, "Bloom Compute Blur Pipeline");
+
+    for (uint32 i = 0; i < BLOOM_TEXTURE_MIPS; ++i) {
+        computeBlurDescriptorSets[i] = &DescriptorSet::get(computeBlurDescriptorSetLayout);
+        computeBlurDescriptorSets[i]->setCombinedTextureSampler(tex1MipViews[i], postProcessor.getSamplerNearest(), 0);
+        // Previous mip (smaller), if exists. If not, send a dummy.
+        computeBlurDescriptorSets[i]->setCombinedTextureSampler(
+            i < BLOOM_TEXTURE_MIPS - 1 ? tex2MipViews[i + 1] : tex1MipViews[i], postProcessor.getSamplerLinear(), 1);
+        computeBlurDescriptorSets[i]->setStorageTexture(tex2MipViews[i], 2);
     }
 }
 
-void Bloom::initFinalPass() {
+void Bloom::computeDownsamplePass(CommandBuffer &commandBuffer) {
+    const auto INPUT_DIMENSIONS = postProcessor.getInputTextureDimensions();
 
-    BlendingStateAttachment blendingStateAttachment;
-    blendingStateAttachment.enableBlending = true;
-    blendingStateAttachment.srcColorBlendingFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    blendingStateAttachment.dstColorBlendingFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    blendingStateAttachment.colorBlendingOperation = VK_BLEND_OP_ADD;
-    // blendingStateAttachment.srcAlphaBlendingFactor = VK_BLEND_FACTOR_ZERO;
-    // blendingStateAttachment.dstAlphaBlendingFactor = VK_BLEND_FACTOR_ONE;
-    // blendingStateAttachment.alphaBlendingOperation = VK_BLEND_OP_ADD;
-    blendingStateAttachment.writeMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT;
+    commandBuffer.transitionTexture(postProcessor.getInputTexView()->getTexture(), ResourceUsage::ComputeShaderRead, 0,
+                                    1);
+    commandBuffer.transitionTexture(tex1, ResourceUsage::ComputeShaderWrite);
 
-    BlendingState blendingState;
-    blendingState.attachmentBlendingStates = { blendingStateAttachment };
+    // Each workgroup reduces a 64x64 tile of the input into all the mips.
+    commandBuffer.bindPipelineState(computeDownsamplePipelineState);
+    commandBuffer.bindDescriptorSet(*computeDownsampleDescriptorSet, computeDownsamplePipelineLayout, 0, nullptr, 0,
+                                    VK_PIPELINE_BIND_POINT_COMPUTE);
+    commandBuffer.dispatch((INPUT_DIMENSIONS.x + 63) / 64, (INPUT_DIMENSIONS.y + 63) / 64, 1);
+}
+
+void Bloom::computeBlurPass(CommandBuffer &commandBuffer) {
+    commandBuffer.transitionTexture(tex1, ResourceUsage::ComputeShaderRead);
+    commandBuffer.transitionTexture(tex2, ResourceUsage::ComputeShaderWrite);
+
+    commandBuffer.bindPipelineState(computeBlurPipelineState);
+
+    // From the smallest mip up, each one summing the upsampled result of the previous.
+    for (int mip = BLOOM_TEXTURE_MIPS - 1; mip >= 0; --mip) {
+        if (mip < static_cast<int>(BLOOM_TEXTURE_MIPS) - 1) {
+            commandBuffer.transitionTexture(tex2, ResourceUsage::ComputeShaderRead, mip + 1, 1);
+        }
+
+        struct {
+            uint32 currentMip;
+            float blurWeight;
+        } push = { static_cast<uint32>(mip), blurWeights[mip] };
+
+        commandBuffer.bindDescriptorSet(*computeBlurDescriptorSets[mip], computeBlurPipelineLayout, 0, nullptr, 0,
+                                        VK_PIPELINE_BIND_POINT_COMPUTE);
+        commandBuffer.setPushConstants(computeBlurPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, &push, 0, sizeof(push));
+        uint32 w = glm::max(tex2->getWidth() >> mip, 1u);
+        uint32 h = glm::max(tex2->getHeight() >> mip, 1u);
+        commandBuffer.dispatch((w + 15) / 16, (h + 15) / 16, 1);
+    }
+}
 
-    finalDescriptorSetLayout =
+void Bloom::initResultDescriptorSets() {
+    resultDescriptorSetLayout =
         DescriptorSetLayout::create({ { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1 } });
 
-    // Create the RenderPass.
-    AttachmentDescription colorAttachmentDesc;
-    colorAttachmentDesc.format = postProcessor.getInputTextureFormat();
-    colorAttachmentDesc.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachmentDesc.loadOperatorColorAndDepth = VK_ATTACHMENT_LOAD_OP_LOAD;
-    colorAttachmentDesc.storeOperatorColorAndDepth = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachmentDesc.loadOperatorStencil = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachmentDesc.storeOperatorStencil = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachmentDesc.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    colorAttachmentDesc.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    resultDescriptorSet = &DescriptorSet::get(resultDescriptorSetLayout);
+    resultDescriptorSet->setCombinedTextureSampler(tex1MipViews[0], postProcessor.getSamplerLinear(), 0);
 
-    SubPassDescription subPassDesc;
-    subPassDesc.colorAttachmentsRefs = { { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL } };
+    resultComputeDescriptorSet = &DescriptorSet::get(resultDescriptorSetLayout);
+    resultComputeDescriptorSet->setCombinedTextureSampler(tex2MipViews[0], postProcessor.getSamplerLinear(), 0);
+}
 
-    // Wait on blur pass.
-    SubPassDependency dependencyBefore;
-    dependencyBefore.srcSubPassIndex = VK_SUBPASS_EXTERNAL;
-    dependencyBefore.dstSubPassIndex = 0;
-    dependencyBefore.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependencyBefore.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    dependencyBefore.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    dependencyBefore.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    dependencyBefore.dependencyFlags = 0;
 
-    finalRenderPass = RenderPass::create({ colorAttachmentDesc }, { subPassDesc }, { dependencyBefore });
+/*-------------------------------------------------------------------------------------------*/
+void ColorGrading::init() {
+    // Identity LUT, until one is set.
+    constexpr uint32 W = LUT_SIZE * LUT_SIZE;
+    constexpr uint32 H = LUT_SIZE;
+    std::vector<byte> data(W * H * 4);
+    for (uint32 y = 0; y < H; ++y) {
+        for (uint32 x = 0; x < W; ++x) {
+            byte *texel = &data[(y * W + x) * 4];
+            texel[0] = static_cast<byte>((x % LUT_SIZE) * 255 / (LUT_SIZE - 1));
+            texel[1] = static_cast<byte>(y * 255 / (LUT_SIZE - 1));
+            texel[2] = static_cast<byte>((x / LUT_SIZE) * 255 / (LUT_SIZE - 1));
+            texel[3] = 255;
+        }
+    }
+
+    auto lutTex = Texture2D::create(data.data(), W, H, VK_FORMAT_R8G8B8A8_UNORM, MipmapData::Options::DoNothing);
+    BZ_SET_TEXTURE_DEBUG_NAME(lutTex, "ColorGrading Identity LUT");
 
-    finalPipelineLayout = PipelineLayout::create({ postProcessor.getDescriptorSetLayout(), finalDescriptorSetLayout });
+    descriptorSetLayout =
+        DescriptorSetLayout::create({ { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1 } });
 
-    const auto INPUT_DIMENSIONS = postProcessor.getInputTextureDimensions();
-    const auto INPUT_DIMENSIONS_F = postProcessor.getInputTextureDimensionsFloat();
+    setLut(TextureView::create(lutTex));
+    enabled = false;
+}
 
-    PipelineStateData finalPipelineStateData;
-    finalPipelineStateData.shader =
-        Shader::create({ { "Bhazel/shaders/bin/FullScreenVert.spv", VK_SHADER_STAGE_VERTEX_BIT },
-                         { "Bhazel/shaders/bin/BloomFinalFrag.spv", VK_SHADER_STAGE_FRAGMENT_BIT } });
-    finalPipelineStateData.layout = finalPipelineLayout;
-    finalPipelineStateData.blendingState = blendingState;
-    finalPipelineStateData.viewports = { { 0.0f, 0.0f, INPUT_DIMENSIONS_F.x, INPUT_DIMENSIONS_F.y } };
-    finalPipelineStateData.scissorRects = { { 0, 0, INPUT_DIMENSIONS.x, INPUT_DIMENSIONS.y } };
-    finalPipelineStateData.renderPass = finalRenderPass;
-    finalPipelineStateData.subPassIndex = 0;
-    finalPipelineState = PipelineState::create(finalPipelineStateData);
-    BZ_SET_PIPELINE_DEBUG_NAME(finalPipelineState, "Bloom Final Pass Pipeline");
-
-    finalFramebuffer = Framebuffer::create(finalRenderPass, { postProcessor.getInputTexView() },
-                                           { INPUT_DIMENSIONS.x, INPUT_DIMENSIONS.y, 1 });
-
-    finalDescriptorSet = &DescriptorSet::get(finalDescriptorSetLayout);
-    finalDescriptorSet->setCombinedTextureSampler(tex1MipViews[0], postProcessor.getSamplerLinear(), 0);
+void ColorGrading::destroy() {
+    lutTexView.reset();
+    descriptorSetLayout.reset();
 }
 
-void Bloom::finalPass(CommandBuffer &commandBuffer) {
-    commandBuffer.beginRenderPass(finalRenderPass, finalFramebuffer);
-    commandBuffer.bindPipelineState(finalPipelineState);
-    commandBuffer.bindDescriptorSet(postProcessor.getDescriptorSet(), finalPipelineLayout, 0, nullptr, 0);
-    commandBuffer.bindDescriptorSet(*finalDescriptorSet, finalPipelineLayout, 1, nullptr, 0);
-    commandBuffer.draw(3, 1, 0, 0);
-    commandBuffer.endRenderPass();
+void ColorGrading::setLut(const Ref<TextureView> &lutTexView) {
+    BZ_ASSERT_CORE(lutTexView->getTexture()->getWidth() == LUT_SIZE * LUT_SIZE &&
+                       lutTexView->getTexture()->getHeight() == LUT_SIZE,
+                   "Invalid LUT dimensions!");
+
+    // The previous DescriptorSet may be in use by frames in flight. It won't be reused until they are done.
+    if (descriptorSet) {
+        DescriptorSet::release(*descriptorSet);
+    }
+    descriptorSet = &DescriptorSet::get(descriptorSetLayout);
+
+    this->lutTexView = lutTexView;
+    descriptorSet->setCombinedTextureSampler(lutTexView, postProcessor.getSamplerLinear(), 0);
+}
+
+void ColorGrading::onImGuiRender(const FrameTiming &frameTiming) {
+    ImGui::Text("Color Grading:");
+    ImGui::Checkbox("Enabled", &enabled);
 }
 
 
 /*-------------------------------------------------------------------------------------------*/
-void ToneMap::init() {
+void UberPass::init(const Bloom &bloom, const ColorGrading &colorGrading) {
     const auto INPUT_DIMENSIONS = postProcessor.getInputTextureDimensions();
     const auto INPUT_DIMENSIONS_F = postProcessor.getInputTextureDimensionsFloat();
 
@@ -364,35 +430,63 @@ void ToneMap::init() {
     BlendingStateAttachment blendingStateAttachment;
     blendingState.attachmentBlendingStates = { blendingStateAttachment };
 
+    pipelineLayout = PipelineLayout::create({ postProcessor.getDescriptorSetLayout(),
+                                              bloom.getResultDescriptorSetLayout(),
+                                              colorGrading.getDescriptorSetLayout() });
+
     PipelineStateData pipelineStateData;
     pipelineStateData.shader =
         Shader::create({ { "Bhazel/shaders/bin/FullScreenVert.spv", VK_SHADER_STAGE_VERTEX_BIT },
-                         { "Bhazel/shaders/bin/ToneMapFrag.spv", VK_SHADER_STAGE_FRAGMENT_BIT } });
-    pipelineStateData.layout = postProcessor.getPipelineLayout();
+                         { "Bhazel/shaders/bin/PostProcessUberFrag.spv", VK_SHADER_STAGE_FRAGMENT_BIT } });
+    pipelineStateData.layout = pipelineLayout;
     pipelineStateData.viewports = { { 0.0f, 0.0f, INPUT_DIMENSIONS_F.x, INPUT_DIMENSIONS_F.y, 0.0f, 1.0f } };
     pipelineStateData.scissorRects = { { 0u, 0u, INPUT_DIMENSIONS.x, INPUT_DIMENSIONS.y } };
     pipelineStateData.blendingState = blendingState;
     pipelineStateData.renderPass = Engine::get().getGraphicsContext().getSwapchainRenderPass();
     pipelineStateData.subPassIndex = 0;
-    pipelineState = PipelineState::create(pipelineStateData);
-    BZ_SET_PIPELINE_DEBUG_NAME(pipelineState, "ToneMap Pipeline");
+    pipelineStates.init(pipelineStateData, VK_SHADER_STAGE_FRAGMENT_BIT, EFFECT_FLAG_COUNT,
+                        "PostProcess Uber Pipeline");
+
+    // Few enough to create them all now, so toggling effects doesn't stall a frame.
+    for (uint32 flags = 0; flags < (1u << EFFECT_FLAG_COUNT); ++flags) {
+        pipelineStates.get(flags);
+    }
 }
 
-void ToneMap::destroy() {
-    pipelineState.reset();
+void UberPass::destroy() {
+    pipelineStates.destroy();
+    pipelineLayout.reset();
 }
 
-void ToneMap::render(CommandBuffer &commandBuffer, const Ref<RenderPass> &renderPass,
-                     const Ref<Framebuffer> &framebuffer) {
+void UberPass::render(CommandBuffer &commandBuffer, const Ref<RenderPass> &renderPass,
+                      const Ref<Framebuffer> &framebuffer, const Bloom &bloom, const ColorGrading &colorGrading) {
+    uint32 flags = 0;
+    fusedEffectCount = 1; // Tone mapping always runs.
+    if (bloom.isEnabled()) {
+        flags |= BLOOM_FLAG;
+        fusedEffectCount++;
+    }
+    if (colorGrading.isEnabled()) {
+        flags |= COLOR_GRADING_FLAG;
+        fusedEffectCount++;
+    }
+
+    // The bloom result is bound even when disabled, so it needs to be on a valid layout.
+    commandBuffer.transitionTexture(bloom.getResultTexView()->getTexture(), ResourceUsage::FragmentShaderRead, 0, 1);
+
     commandBuffer.beginRenderPass(renderPass, framebuffer);
-    commandBuffer.bindPipelineState(pipelineState);
+    commandBuffer.bindPipelineState(pipelineStates.get(flags));
+    commandBuffer.bindDescriptorSet(postProcessor.getDescriptorSet(), pipelineLayout, 0, nullptr, 0);
+    commandBuffer.bindDescriptorSet(bloom.getResultDescriptorSet(), pipelineLayout, 1, nullptr, 0);
+    commandBuffer.bindDescriptorSet(colorGrading.getDescriptorSet(), pipelineLayout, 2, nullptr, 0);
     commandBuffer.draw(3, 1, 0, 0);
     commandBuffer.endRenderPass();
 }
 
-void ToneMap::onImGuiRender(const FrameTiming &frameTiming) {
+void UberPass::onImGuiRender(const FrameTiming &frameTiming) {
     ImGui::Text("Tone Mapping:");
     ImGui::Text("Check camera exposure.");
+    ImGui::Text("Fused Effect Count: %d.", fusedEffectCount);
 }
 
 
@@ -448,7 +542,7 @@ void FXAA::onImGuiRender(const FrameTiming &frameTiming) {
 
 
 /*-------------------------------------------------------------------------------------------*/
-PostProcessor::PostProcessor() : bloom(*this), toneMap(*this), fxaa(*this) {
+PostProcessor::PostProcessor() : bloom(*this), colorGrading(*this), uberPass(*this), fxaa(*this) {
 }
 
 void PostProcessor::init(const Ref<TextureView> &colorTexView, const Ref<Buffer> &constantBuffer, uint32 bufferOffset) {
@@ -506,7 +600,8 @@ void PostProcessor::init(const Ref<TextureView> &colorTexView, const Ref<Buffer>
     descriptorSet->setConstantBuffer(constantBuffer, 1, bufferOffset, sizeof(PostProcessConstantBufferData));
 
     bloom.init();
-    toneMap.init();
+    colorGrading.init();
+    uberPass.init(bloom, colorGrading);
     fxaa.init(swapchainReplicaTexView);
 }
 
@@ -521,11 +616,17 @@ void PostProcessor::destroy() {
     descriptorSetLayout.reset();
     pipelineLayout.reset();
 
-    toneMap.destroy();
+    uberPass.destroy();
+    colorGrading.destroy();
     fxaa.destroy();
     bloom.destroy();
 }
 
+void PostProcessor::setColorGradingLut(const Ref<TextureView> &lutTexView) {
+    colorGrading.setLut(lutTexView);
+    colorGrading.setEnabled(true);
+}
+
 void PostProcessor::fillData(const BufferPtr &ptr, const Scene &scene) {
     PostProcessConstantBufferData data;
     data.cameraExposureAndBloomIntensity.x = scene.getCamera().getExposure();
@@ -552,10 +653,11 @@ void PostProcessor::render(const Ref<RenderPass> &finalRenderPass, const Ref<Fra
         BZ_CB_END_DEBUG_LABEL(commandBuffer);
     }
 
-    BZ_CB_BEGIN_DEBUG_LABEL(commandBuffer, "ToneMapping");
+    // Bloom composite, tone mapping and color grading on a single pass.
+    BZ_CB_BEGIN_DEBUG_LABEL(commandBuffer, "UberPass");
     addBarrier(commandBuffer);
-    toneMap.render(commandBuffer, fxaa.isEnabled() ? swapchainReplicaRenderPass : finalRenderPass,
-                   fxaa.isEnabled() ? swapchainReplicaFramebuffer : finalFramebuffer);
+    uberPass.render(commandBuffer, fxaa.isEnabled() ? swapchainReplicaRenderPass : finalRenderPass,
+                    fxaa.isEnabled() ? swapchainReplicaFramebuffer : finalFramebuffer, bloom, colorGrading);
     BZ_CB_END_DEBUG_LABEL(commandBuffer);
 
     if (fxaa.isEnabled()) {
@@ -578,12 +680,18 @@ void PostProcessor::onImGuiRender(const FrameTiming &frameTiming) {
         ImGui::Separator();
 
         ImGui::PushID(2);
-        toneMap.onImGuiRender(frameTiming);
+        uberPass.onImGuiRender(frameTiming);
         ImGui::PopID();
 
         ImGui::Separator();
 
         ImGui::PushID(3);
+        colorGrading.onImGuiRender(frameTiming);
+        ImGui::PopID();
+
+        ImGui::Separator();
+
+        ImGui::PushID(4);
         fxaa.onImGuiRender(frameTiming);
         ImGui::PopID();
     }
@@ -28,6 +28,7 @@ class PostProcessEffect {
 
     explicit PostProcessEffect(const PostProcessor &postProcessor) : postProcessor(postProcessor) {}
     bool isEnabled() const { return enabled; }
+    void setEnabled(bool enabled) { this->enabled = enabled; }
 
   protected:
     const PostProcessor &postProcessor;
@@ -52,17 +53,32 @@ class Bloom : public PostProcessEffect {
     float getIntensity() const { return intensity; }
     const float *getBlurWeights() const { return blurWeights; }
 
+    // The blurred result, to be composited by the UberPass.
+    const Ref<TextureView> &getResultTexView() const { return computePath ? tex2MipViews[0] : tex1MipViews[0]; }
+    const Ref<DescriptorSetLayout> &getResultDescriptorSetLayout() const { return resultDescriptorSetLayout; }
+    const DescriptorSet &getResultDescriptorSet() const {
+        return computePath ? *resultComputeDescriptorSet : *resultDescriptorSet;
+    }
+
   private:
     float intensity;
     float blurWeights[BLOOM_TEXTURE_MIPS];
 
+    // Compute path: single pass downsample of all mips and a shared memory separable blur with upsampling.
+    // Fragment path: chained blits and a render pass per mip and blur direction.
+    // Off by default until the compute output is verified to match the fragment one. Can be toggled on ImGui.
+    bool computePath = false;
+
     void downsamplePass(CommandBuffer &commandBuffer);
 
     void initBlurPass();
     void blurPass(CommandBuffer &commandBuffer);
 
-    void initFinalPass();
-    void finalPass(CommandBuffer &commandBuffer);
+    void initComputePasses();
+    void computeDownsamplePass(CommandBuffer &commandBuffer);
+    void computeBlurPass(CommandBuffer &commandBuffer);
+
+    void initResultDescriptorSets();
 
     // Aux textures, mipmapped.
     Ref<Texture2D> tex1;
@@ -87,29 +103,73 @@ class Bloom : public PostProcessEffect {
     DescriptorSet *blurDescriptorSets1[BLOOM_TEXTURE_MIPS];
     DescriptorSet *blurDescriptorSets2[BLOOM_TEXTURE_MIPS];
 
-    Ref<PipelineLayout> finalPipelineLayout;
-    Ref<PipelineState> finalPipelineState;
-    Ref<RenderPass> finalRenderPass;
-    Ref<Framebuffer> finalFramebuffer;
+    Ref<PipelineLayout> computeDownsamplePipelineLayout;
+    Ref<PipelineState> computeDownsamplePipelineState;
+    Ref<DescriptorSetLayout> computeDownsampleDescriptorSetLayout;
+    DescriptorSet *computeDownsampleDescriptorSet;
+
+    // The compute blur writes the results into tex2.
+    Ref<PipelineLayout> computeBlurPipelineLayout;
+    Ref<PipelineState> computeBlurPipelineState;
+    Ref<DescriptorSetLayout> computeBlurDescriptorSetLayout;
+    DescriptorSet *computeBlurDescriptorSets[BLOOM_TEXTURE_MIPS];
 
-    Ref<DescriptorSetLayout> finalDescriptorSetLayout;
-    DescriptorSet *finalDescriptorSet;
+    Ref<DescriptorSetLayout> resultDescriptorSetLayout;
+    DescriptorSet *resultDescriptorSet;
+    DescriptorSet *resultComputeDescriptorSet;
 };
 
 
 /*-------------------------------------------------------------------------------------------*/
-class ToneMap : public PostProcessEffect {
+class ColorGrading : public PostProcessEffect {
   public:
-    explicit ToneMap(const PostProcessor &postProcessor) : PostProcessEffect(postProcessor) {}
+    explicit ColorGrading(const PostProcessor &postProcessor) : PostProcessEffect(postProcessor) {}
 
     void init();
     void destroy();
 
-    void render(CommandBuffer &commandBuffer, const Ref<RenderPass> &renderPass, const Ref<Framebuffer> &framebuffer);
     void onImGuiRender(const FrameTiming &frameTiming);
 
+    // The LUT is a 2D strip with the blue slices side by side: LUT_SIZE * LUT_SIZE wide and LUT_SIZE high.
+    // Can be called with frames in flight, they keep using the previous LUT.
+    void setLut(const Ref<TextureView> &lutTexView);
+
+    static constexpr uint32 LUT_SIZE = 16u;
+
+    const Ref<DescriptorSetLayout> &getDescriptorSetLayout() const { return descriptorSetLayout; }
+    const DescriptorSet &getDescriptorSet() const { return *descriptorSet; }
+
   private:
-    Ref<PipelineState> pipelineState;
+    Ref<TextureView> lutTexView;
+    Ref<DescriptorSetLayout> descriptorSetLayout;
+    DescriptorSet *descriptorSet = nullptr;
+};
+
+
+/*-------------------------------------------------------------------------------------------*/
+/*
+ * Single full screen pass running all the per pixel effects: bloom composite, exposure and tone mapping and color
+ * grading. Each combination of enabled effects is a PipelineState permutation, with the disabled ones compiled out
+ * through specialization constants. Neighbourhood effects like FXAA need their own pass.
+ */
+class UberPass : public PostProcessEffect {
+  public:
+    explicit UberPass(const PostProcessor &postProcessor) : PostProcessEffect(postProcessor) {}
+
+    void init(const Bloom &bloom, const ColorGrading &colorGrading);
+    void destroy();
+
+    void render(CommandBuffer &commandBuffer, const Ref<RenderPass> &renderPass, const Ref<Framebuffer> &framebuffer,
+                const Bloom &bloom, const ColorGrading &colorGrading);
+    void onImGuiRender(const FrameTiming &frameTiming);
+
+  private:
+    // Bit i is the specialization constant with id i on PostProcessUberFrag.glsl.
+    enum EffectFlags : uint32 { BLOOM_FLAG = 1u << 0, COLOR_GRADING_FLAG = 1u << 1, EFFECT_FLAG_COUNT = 2 };
+
+    Ref<PipelineLayout> pipelineLayout;
+    PipelineStatePermutations pipelineStates;
+    uint32 fusedEffectCount = 0;
 };
 
 
@@ -155,6 +215,9 @@ class PostProcessor {
                 bool waitForImageAvailable, bool signalFrameEnd);
     void onImGuiRender(const FrameTiming &frameTiming);
 
+    // Sets the LUT and enables color grading.
+    void setColorGradingLut(const Ref<TextureView> &lutTexView);
+
     const Ref<TextureView> &getInputTexView() const { return inputTexView; }
     const Ref<Sampler> &getSamplerNearest() const { return samplerNearest; }
     const Ref<Sampler> &getSamplerLinear() const { return samplerLinear; }
@@ -182,7 +245,8 @@ class PostProcessor {
     DescriptorSet *descriptorSet;
 
     Bloom bloom;
-    ToneMap toneMap;
+    ColorGrading colorGrading;
+    UberPass uberPass;
     FXAA fxaa;
 };
 }
\ No newline at end of file
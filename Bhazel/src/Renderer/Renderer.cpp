@@ -18,12 +18,17 @@
 #include "Core/Window.h"
 
 #include "Renderer/Camera.h"
+#include "Renderer/LightClusterer.h"
 #include "Renderer/Material.h"
 #include "Renderer/Mesh.h"
+#include "Renderer/MeshletCuller.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/PostProcessor.h"
 #include "Renderer/Scene.h"
 #include "Renderer/Transform.h"
 
+#include "Collisions/CollisionUtils.h"
+
 #include <imgui.h>
 
 
@@ -34,11 +39,17 @@ constexpr uint32 RENDERER_SCENE_DESCRIPTOR_SET_IDX = 1;
 constexpr uint32 RENDERER_PASS_DESCRIPTOR_SET_IDX = 2;
 constexpr uint32 RENDERER_MATERIAL_DESCRIPTOR_SET_IDX = 3;
 constexpr uint32 RENDERER_ENTITY_DESCRIPTOR_SET_IDX = 4;
-constexpr uint32 APP_FIRST_DESCRIPTOR_SET_IDX = 5;
+constexpr uint32 RENDERER_BINDLESS_DESCRIPTOR_SET_IDX = 5;
+constexpr uint32 APP_FIRST_DESCRIPTOR_SET_IDX = 6;
 
 constexpr uint32 SHADOW_MAP_SIZE = 1024;
 constexpr uint32 SHADOW_MAPPING_CASCADE_COUNT = 4;
 
+constexpr uint32 INVALID_MESHLET_SLOT = 0xffffffff;
+
+// Height map samples per ray on the parallax occlusion mapping, a specialization constant of the color pass.
+constexpr uint32 PARALLAX_OCCLUSION_LAYER_COUNT = 10;
+
 constexpr uint32 MAX_PASSES_PER_FRAME =
     Renderer::MAX_DIR_LIGHTS_PER_SCENE * SHADOW_MAPPING_CASCADE_COUNT + 1; // Depth Passes + Color Pass
 
@@ -48,6 +59,7 @@ struct alignas(GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN) SceneConstantBu
     glm::vec4 dirLightDirectionsAndIntensities[Renderer::MAX_DIR_LIGHTS_PER_SCENE];
     glm::vec4 dirLightColors[Renderer::MAX_DIR_LIGHTS_PER_SCENE]; // vec4 to simplify alignments
     glm::vec4 cascadeSplits;                                      // TODO: Hardcoded to 4.
+    glm::vec4 clusterScalesAndBiases;                             // See LightClusterer.
     float dirLightCount;
 };
 
@@ -63,6 +75,18 @@ struct alignas(GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN) MaterialConstan
     glm::vec4 heightAndUvScale;
 };
 
+// On bindless mode the Material data goes on push constants, no DescriptorSet binds between Materials.
+struct BindlessMaterialPushConstants {
+    glm::vec4 normalMetallicRoughnessAndAO;
+    glm::vec4 heightAndUvScale;
+    glm::uvec4 albedoNormalMetallicRoughnessIndices;
+    glm::uvec4 heightAndAOIndices;
+};
+
+// Present on all the PipelineLayouts, even if not on bindless mode, for them to stay compatible between each other.
+static const VkPushConstantRange materialPushConstantRange = { VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                                                               sizeof(BindlessMaterialPushConstants) };
+
 struct alignas(GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN) EntityConstantBufferData {
     glm::mat4 modelMatrix;  // Model to world space
     glm::mat4 normalMatrix; // Model to world space, appropriate to transform vectors, mat4 to simplify alignments
@@ -93,7 +117,27 @@ struct RendererStats {
     uint32 vertexCount;
     uint32 triangleCount;
     uint32 drawCallCount;
+    uint32 descriptorSetBindCount;
     uint32 materialCount;
+    uint32 pipelineBindCount;
+
+    uint32 frustumCulledEntityCount;
+    uint32 occludedEntityCount;
+    uint32 occluderPolygonCount;
+    TimeDuration cullingTime;
+
+    // Visible Entities on each LOD.
+    uint32 lodEntityCounts[Mesh::MAX_LOD_COUNT];
+
+    uint32 meshletCount;
+    uint32 visibleMeshletCount;
+    uint32 meshletDrawCommandCount;
+    TimeDuration meshletCullingTime;
+
+    uint32 localLightCount;
+    uint32 visibleLocalLightCount;
+    uint32 clusteredLightIndexCount;
+    TimeDuration lightClusteringTime;
 };
 
 static struct RendererData {
@@ -125,7 +169,8 @@ static struct RendererData {
     Ref<Sampler> shadowSampler;
 
     Ref<PipelineLayout> shadowPassPipelineLayout;
-    Ref<PipelineState> colorPassPipelineState;
+    // Keyed by Material::getFeatureBits().
+    PipelineStatePermutations colorPassPipelineStates;
     Ref<PipelineState> skyBoxPipelineState;
     Ref<PipelineState> shadowPassPipelineState;
 
@@ -133,6 +178,19 @@ static struct RendererData {
 
     std::unordered_map<Material, uint32> materialOffsetMap;
 
+    // Color pass draws of the visible Entities, sorted to bind each pipeline permutation once.
+    struct ColorPassDraw {
+        uint32 featureBits;
+        uint32 entityIndex;
+        uint32 submeshIndex;
+        uint32 meshletSlot; // On the MeshletCuller, if culled by meshlet.
+    };
+    std::vector<ColorPassDraw> colorPassDraws;
+
+    // Materials will reference textures by index on the BindlessTextureTable.
+    bool bindless;
+    const Material *lastPushedMaterial;
+
     Ref<RenderPass> shadowRenderPass;
     Ref<RenderPass> colorRenderPass;
 
@@ -142,6 +200,23 @@ static struct RendererData {
 
     const Scene *sceneToRender;
 
+    // Indexed by Entity, set by cullEntities() for the color pass.
+    OcclusionCuller occlusionCuller;
+    std::vector<uint8> entityVisibility;
+    bool occlusionCulling = true;
+
+    // Indexed by Entity, kept between frames for the LOD hysteresis.
+    std::vector<uint8> entityLods;
+    bool meshLods = true;
+    float lodErrorThreshold = 1.0f; // Pixels
+
+    // SubMeshes drawn on full detail are culled by meshlet.
+    MeshletCuller meshletCuller;
+    bool meshletCulling = true;
+    bool gpuMeshletCulling = false;
+
+    LightClusterer lightClusterer;
+
     // ConstantFactor, clamp and slopeFactor
     glm::vec3 depthBiasData = { 1.0f, 0.0f, 2.5f };
 
@@ -158,6 +233,7 @@ void Renderer::init() {
     BZ_PROFILE_FUNCTION();
 
     rendererData.sceneToRender = nullptr;
+    rendererData.bindless = BZ_GRAPHICS_CTX.isBindlessTexturesEnabled();
 
     rendererData.constantBuffer =
         Buffer::create(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
@@ -180,7 +256,11 @@ void Renderer::init() {
         { { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_ALL, 1 },
           { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1 },
           { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1 },
-          { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, MAX_DIR_LIGHTS_PER_SCENE } });
+          { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, MAX_DIR_LIGHTS_PER_SCENE },
+          // Point and Spot Lights, froxels and light indices.
+          { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_FRAGMENT_BIT, 1 },
+          { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_FRAGMENT_BIT, 1 },
+          { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_FRAGMENT_BIT, 1 } });
 
     rendererData.passDescriptorSetLayout =
         DescriptorSetLayout::create({ { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
@@ -200,10 +280,21 @@ void Renderer::init() {
         DescriptorSetLayout::create({ { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                                         VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_GEOMETRY_BIT, 1 } });
 
-    rendererData.pipelineLayout =
-        PipelineLayout::create({ rendererData.globalDescriptorSetLayout, rendererData.sceneDescriptorSetLayout,
-                                 rendererData.passDescriptorSetLayout, rendererData.materialDescriptorSetLayout,
-                                 rendererData.entityDescriptorSetLayout });
+    if (rendererData.bindless) {
+        rendererData.pipelineLayout = PipelineLayout::create(
+            { rendererData.globalDescriptorSetLayout, rendererData.sceneDescriptorSetLayout,
+              rendererData.passDescriptorSetLayout, rendererData.materialDescriptorSetLayout,
+              rendererData.entityDescriptorSetLayout,
+              BZ_GRAPHICS_CTX.getBindlessTextureTable().getDescriptorSetLayout() },
+            { materialPushConstantRange });
+    }
+    else {
+        rendererData.pipelineLayout =
+            PipelineLayout::create({ rendererData.globalDescriptorSetLayout, rendererData.sceneDescriptorSetLayout,
+                                     rendererData.passDescriptorSetLayout, rendererData.materialDescriptorSetLayout,
+                                     rendererData.entityDescriptorSetLayout },
+                                   { materialPushConstantRange });
+    }
 
     rendererData.entityDescriptorSet = &DescriptorSet::get(rendererData.entityDescriptorSetLayout);
     rendererData.entityDescriptorSet->setConstantBuffer(rendererData.constantBuffer, 0, ENTITY_CONSTANT_BUFFER_OFFSET,
@@ -222,6 +313,9 @@ void Renderer::init() {
 
     rendererData.postProcessor.init(rendererData.colorTexView, rendererData.constantBuffer,
                                     POST_PROCESS_CONSTANT_BUFFER_OFFSET);
+    rendererData.occlusionCuller.init();
+    rendererData.lightClusterer.init();
+    rendererData.meshletCuller.init();
 }
 
 void Renderer::initShadowPassData() {
@@ -272,7 +366,8 @@ void Renderer::initShadowPassData() {
     rendererData.shadowPassPipelineLayout =
         PipelineLayout::create({ rendererData.globalDescriptorSetLayout, rendererData.sceneDescriptorSetLayout,
                                  rendererData.passDescriptorSetLayoutForShadowPass,
-                                 rendererData.materialDescriptorSetLayout, rendererData.entityDescriptorSetLayout });
+                                 rendererData.materialDescriptorSetLayout, rendererData.entityDescriptorSetLayout },
+                               { materialPushConstantRange });
     DepthStencilState depthStencilState;
     depthStencilState.enableDepthTest = true;
     depthStencilState.enableDepthWrite = true;
@@ -391,17 +486,21 @@ void Renderer::initColorPassData() {
 
     PipelineStateData pipelineStateData;
     pipelineStateData.dataLayout = vertexDataLayout;
-    pipelineStateData.shader =
-        Shader::create({ { "Bhazel/shaders/bin/RendererVert.spv", VK_SHADER_STAGE_VERTEX_BIT },
-                         { "Bhazel/shaders/bin/RendererFrag.spv", VK_SHADER_STAGE_FRAGMENT_BIT } });
+    const char *fragShaderPath =
+        rendererData.bindless ? "Bhazel/shaders/bin/RendererBindlessFrag.spv" : "Bhazel/shaders/bin/RendererFrag.spv";
+    pipelineStateData.shader = Shader::create({ { "Bhazel/shaders/bin/RendererVert.spv", VK_SHADER_STAGE_VERTEX_BIT },
+                                                { fragShaderPath, VK_SHADER_STAGE_FRAGMENT_BIT } });
     pipelineStateData.layout = rendererData.pipelineLayout;
     pipelineStateData.rasterizerState = rasterizerState;
     pipelineStateData.depthStencilState = depthStencilState;
     pipelineStateData.blendingState = blendingState;
     pipelineStateData.renderPass = rendererData.colorRenderPass;
     pipelineStateData.subPassIndex = 0;
-    rendererData.colorPassPipelineState = PipelineState::create(pipelineStateData);
-    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.colorPassPipelineState, "Renderer Color Pass Pipeline");
+    pipelineStateData.specializationConstants = {
+        { VK_SHADER_STAGE_FRAGMENT_BIT, Material::FEATURE_BIT_COUNT, PARALLAX_OCCLUSION_LAYER_COUNT }
+    };
+    rendererData.colorPassPipelineStates.init(pipelineStateData, VK_SHADER_STAGE_FRAGMENT_BIT,
+                                              Material::FEATURE_BIT_COUNT, "Renderer Color Pass Pipeline");
 
     const auto WINDOW_DIMS_INT = Engine::get().getWindow().getDimensions();
 
@@ -481,7 +580,7 @@ void Renderer::destroy() {
     rendererData.entityDescriptorSetLayout.reset();
     rendererData.pipelineLayout.reset();
 
-    rendererData.colorPassPipelineState.reset();
+    rendererData.colorPassPipelineStates.destroy();
     rendererData.skyBoxPipelineState.reset();
     rendererData.shadowPassPipelineState.reset();
     rendererData.shadowPassPipelineLayout.reset();
@@ -492,6 +591,8 @@ void Renderer::destroy() {
     rendererData.shadowSampler.reset();
 
     rendererData.materialOffsetMap.clear();
+    rendererData.colorPassDraws.clear();
+    rendererData.entityLods.clear();
 
     rendererData.brdfLookupTexture.reset();
 
@@ -505,6 +606,9 @@ void Renderer::destroy() {
     rendererData.colorFramebuffer.reset();
 
     rendererData.postProcessor.destroy();
+    rendererData.occlusionCuller.destroy();
+    rendererData.lightClusterer.destroy();
+    rendererData.meshletCuller.destroy();
 }
 
 void Renderer::renderScene(const Scene &scene) {
@@ -523,6 +627,7 @@ void Renderer::shadowPass(const Scene &scene) {
                                     RENDERER_GLOBAL_DESCRIPTOR_SET_IDX, 0, 0);
     commandBuffer.bindDescriptorSet(rendererData.sceneToRender->getDescriptorSet(), rendererData.pipelineLayout,
                                     RENDERER_SCENE_DESCRIPTOR_SET_IDX, 0, 0);
+    rendererData.stats.descriptorSetBindCount += 2;
 
     commandBuffer.bindPipelineState(rendererData.shadowPassPipelineState);
     commandBuffer.setDepthBias(rendererData.depthBiasData.x, rendererData.depthBiasData.y,
@@ -538,9 +643,10 @@ void Renderer::shadowPass(const Scene &scene) {
         commandBuffer.bindDescriptorSet(*rendererData.passDescriptorSetForShadowPass,
                                         rendererData.shadowPassPipelineLayout, RENDERER_PASS_DESCRIPTOR_SET_IDX,
                                         lightOffsetArr, SHADOW_MAPPING_CASCADE_COUNT);
+        rendererData.stats.descriptorSetBindCount++;
 
         commandBuffer.beginRenderPass(rendererData.shadowRenderPass, dirLight.shadowMapFramebuffer);
-        drawEntities(commandBuffer, scene, true);
+        drawShadowCasters(commandBuffer, scene);
         commandBuffer.endRenderPass();
         lightIdx++;
     }
@@ -552,9 +658,15 @@ void Renderer::shadowPass(const Scene &scene) {
 void Renderer::colorPass(const Scene &scene) {
     BZ_PROFILE_FUNCTION();
 
+    prepareVisibleEntities(scene);
+
     CommandBuffer &commandBuffer = CommandBuffer::getAndBegin(QueueProperty::Graphics);
     BZ_CB_BEGIN_DEBUG_LABEL(commandBuffer, "Color Pass");
 
+    if (rendererData.meshletCulling) {
+        rendererData.meshletCuller.dispatch(commandBuffer);
+    }
+
     commandBuffer.bindDescriptorSet(*rendererData.globalDescriptorSet, rendererData.pipelineLayout,
                                     RENDERER_GLOBAL_DESCRIPTOR_SET_IDX, 0, 0);
     commandBuffer.bindDescriptorSet(rendererData.sceneToRender->getDescriptorSet(), rendererData.pipelineLayout,
@@ -564,15 +676,21 @@ void Renderer::colorPass(const Scene &scene) {
         PASS_CONSTANT_BUFFER_SIZE - sizeof(PassConstantBufferData); // Color pass is the last (after the Depth passes).
     commandBuffer.bindDescriptorSet(*rendererData.passDescriptorSet, rendererData.pipelineLayout,
                                     RENDERER_PASS_DESCRIPTOR_SET_IDX, &colorPassOffset, 1);
+    rendererData.stats.descriptorSetBindCount += 3;
 
-    commandBuffer.beginRenderPass(rendererData.colorRenderPass, rendererData.colorFramebuffer);
-    commandBuffer.bindPipelineState(rendererData.colorPassPipelineState);
+    if (rendererData.bindless) {
+        commandBuffer.bindDescriptorSet(BZ_GRAPHICS_CTX.getBindlessTextureTable().getDescriptorSet(),
+                                        rendererData.pipelineLayout, RENDERER_BINDLESS_DESCRIPTOR_SET_IDX, 0, 0);
+        rendererData.stats.descriptorSetBindCount++;
+        rendererData.lastPushedMaterial = nullptr;
+    }
 
-    drawEntities(commandBuffer, scene, false);
+    commandBuffer.beginRenderPass(rendererData.colorRenderPass, rendererData.colorFramebuffer);
+    drawVisibleEntities(commandBuffer, scene);
 
     if (scene.hasSkyBox()) {
         commandBuffer.bindPipelineState(rendererData.skyBoxPipelineState);
-        drawMesh(commandBuffer, scene.getSkyBox().mesh, Material(), false);
+        drawMesh(commandBuffer, scene.getSkyBox().mesh, Material(), false, 0);
     }
 
     commandBuffer.endRenderPass();
@@ -580,26 +698,122 @@ void Renderer::colorPass(const Scene &scene) {
     commandBuffer.endAndSubmit(false, false);
 }
 
-void Renderer::drawEntities(CommandBuffer &commandBuffer, const Scene &scene, bool shadowPass) {
+void Renderer::drawShadowCasters(CommandBuffer &commandBuffer, const Scene &scene) {
     BZ_PROFILE_FUNCTION();
 
-    uint32 entityIndex = 0;
-    for (const auto &entity : scene.getEntities()) {
-        if (!shadowPass || entity.castShadow) {
-            uint32 entityOffset = entityIndex * sizeof(EntityConstantBufferData);
-            commandBuffer.bindDescriptorSet(*rendererData.entityDescriptorSet,
-                                            shadowPass ? rendererData.shadowPassPipelineLayout :
-                                                         rendererData.pipelineLayout,
-                                            RENDERER_ENTITY_DESCRIPTOR_SET_IDX, &entityOffset, 1);
-
-            drawMesh(commandBuffer, entity.mesh, entity.overrideMaterial, shadowPass);
-            entityIndex++;
+    const auto &entities = scene.getEntities();
+    for (uint32 entityIndex = 0; entityIndex < entities.size(); ++entityIndex) {
+        const Entity &entity = entities[entityIndex];
+        if (entity.castShadow) {
+            bindEntity(commandBuffer, entityIndex, rendererData.shadowPassPipelineLayout);
+            drawMesh(commandBuffer, entity.mesh, entity.overrideMaterial, true, rendererData.entityLods[entityIndex]);
+        }
+    }
+}
+
+void Renderer::prepareVisibleEntities(const Scene &scene) {
+    BZ_PROFILE_FUNCTION();
+
+    const auto &entities = scene.getEntities();
+    auto &draws = rendererData.colorPassDraws;
+    draws.clear();
+    for (uint32 entityIndex = 0; entityIndex < entities.size(); ++entityIndex) {
+        if (rendererData.entityVisibility[entityIndex]) {
+            const Entity &entity = entities[entityIndex];
+            for (uint32 submeshIndex = 0; submeshIndex < entity.mesh.getSubMeshCount(); ++submeshIndex) {
+                const Material &material = entity.overrideMaterial.isValid() ?
+                                               entity.overrideMaterial :
+                                               entity.mesh.getSubMeshIdx(submeshIndex).material;
+                draws.push_back({ material.getFeatureBits(), entityIndex, submeshIndex, INVALID_MESHLET_SLOT });
+            }
+        }
+    }
+
+    // Stable, to keep the Entity order inside each permutation.
+    std::stable_sort(draws.begin(), draws.end(),
+                     [](const RendererData::ColorPassDraw &a, const RendererData::ColorPassDraw &b) {
+                         return a.featureBits < b.featureBits;
+                     });
+
+    if (rendererData.meshletCulling) {
+        cullMeshlets(scene);
+    }
+}
+
+void Renderer::drawVisibleEntities(CommandBuffer &commandBuffer, const Scene &scene) {
+    BZ_PROFILE_FUNCTION();
+
+    const auto &entities = scene.getEntities();
+    const PipelineState *boundPipelineState = nullptr;
+    uint32 boundEntityIndex = std::numeric_limits<uint32>::max();
+    for (const auto &draw : rendererData.colorPassDraws) {
+        const Ref<PipelineState> &pipelineState = rendererData.colorPassPipelineStates.get(draw.featureBits);
+        if (pipelineState.get() != boundPipelineState) {
+            commandBuffer.bindPipelineState(pipelineState);
+            boundPipelineState = pipelineState.get();
+            rendererData.stats.pipelineBindCount++;
+        }
+
+        const Entity &entity = entities[draw.entityIndex];
+        if (draw.entityIndex != boundEntityIndex) {
+            bindEntity(commandBuffer, draw.entityIndex, rendererData.pipelineLayout);
+            commandBuffer.bindBuffer(entity.mesh.getVertexBuffer(), 0);
+            if (entity.mesh.hasIndices())
+                commandBuffer.bindBuffer(entity.mesh.getIndexBuffer(), 0);
+            boundEntityIndex = draw.entityIndex;
+        }
+
+        const Material &submeshMaterial = entity.mesh.getSubMeshIdx(draw.submeshIndex).material;
+        bindMaterial(commandBuffer, entity.overrideMaterial.isValid() ? entity.overrideMaterial : submeshMaterial);
+        if (draw.meshletSlot != INVALID_MESHLET_SLOT) {
+            const uint32 triangleCount = rendererData.meshletCuller.draw(commandBuffer, scene, draw.meshletSlot);
+            if (triangleCount > 0) {
+                rendererData.stats.triangleCount += triangleCount;
+                rendererData.stats.vertexCount += entity.mesh.getSubMeshIdx(draw.submeshIndex).vertexCount;
+                rendererData.stats.drawCallCount++;
+            }
+        }
+        else {
+            drawSubmesh(commandBuffer, entity.mesh, draw.submeshIndex, rendererData.entityLods[draw.entityIndex]);
+        }
+    }
+}
+
+void Renderer::cullMeshlets(const Scene &scene) {
+    BZ_PROFILE_FUNCTION();
+
+    Timer meshletCullingTimer;
+    meshletCullingTimer.start();
+
+    MeshletCuller &meshletCuller = rendererData.meshletCuller;
+    meshletCuller.begin();
+
+    // Simplified LODs are drawn whole, they have no meshlets.
+    const auto &entities = scene.getEntities();
+    for (auto &draw : rendererData.colorPassDraws) {
+        const Mesh &mesh = entities[draw.entityIndex].mesh;
+        if (rendererData.entityLods[draw.entityIndex] == 0 && mesh.getSubMeshIdx(draw.submeshIndex).meshletCount > 0) {
+            draw.meshletSlot = meshletCuller.addSubMesh(draw.entityIndex, draw.submeshIndex);
         }
     }
+    meshletCuller.cull(scene, rendererData.occlusionCulling ? &rendererData.occlusionCuller : nullptr,
+                       rendererData.gpuMeshletCulling);
+
+    rendererData.stats.meshletCount = meshletCuller.getMeshletCount();
+    rendererData.stats.visibleMeshletCount = meshletCuller.getVisibleMeshletCount();
+    rendererData.stats.meshletDrawCommandCount = meshletCuller.getDrawCommandCount();
+    rendererData.stats.meshletCullingTime = meshletCullingTimer.getCountedTime();
+}
+
+void Renderer::bindEntity(CommandBuffer &commandBuffer, uint32 entityIndex, const Ref<PipelineLayout> &layout) {
+    uint32 entityOffset = entityIndex * sizeof(EntityConstantBufferData);
+    commandBuffer.bindDescriptorSet(*rendererData.entityDescriptorSet, layout, RENDERER_ENTITY_DESCRIPTOR_SET_IDX,
+                                    &entityOffset, 1);
+    rendererData.stats.descriptorSetBindCount++;
 }
 
 void Renderer::drawMesh(CommandBuffer &commandBuffer, const Mesh &mesh, const Material &overrideMaterial,
-                        bool shadowPass) {
+                        bool shadowPass, uint32 lod) {
     BZ_PROFILE_FUNCTION();
 
     commandBuffer.bindBuffer(mesh.getVertexBuffer(), 0);
@@ -607,27 +821,52 @@ void Renderer::drawMesh(CommandBuffer &commandBuffer, const Mesh &mesh, const Ma
     if (mesh.hasIndices())
         commandBuffer.bindBuffer(mesh.getIndexBuffer(), 0);
 
-    for (const auto &submesh : mesh.getSubmeshes()) {
+    for (uint32 submeshIndex = 0; submeshIndex < mesh.getSubMeshCount(); ++submeshIndex) {
         if (!shadowPass) {
-            const Material &materialToUse = overrideMaterial.isValid() ? overrideMaterial : submesh.material;
-
-            uint32 materialOffset = rendererData.materialOffsetMap[materialToUse];
-            commandBuffer.bindDescriptorSet(materialToUse.getDescriptorSet(),
-                                            shadowPass ? rendererData.shadowPassPipelineLayout :
-                                                         rendererData.pipelineLayout,
-                                            RENDERER_MATERIAL_DESCRIPTOR_SET_IDX, &materialOffset, 1);
+            const Material &submeshMaterial = mesh.getSubMeshIdx(submeshIndex).material;
+            bindMaterial(commandBuffer, overrideMaterial.isValid() ? overrideMaterial : submeshMaterial);
         }
+        drawSubmesh(commandBuffer, mesh, submeshIndex, lod);
+    }
+}
 
-        if (mesh.hasIndices())
-            commandBuffer.drawIndexed(submesh.indexCount, 1, submesh.indexOffset, 0, 0);
-        else
-            commandBuffer.draw(submesh.vertexCount, 1, submesh.vertexOffset, 1);
-
-        rendererData.stats.drawCallCount++;
+void Renderer::bindMaterial(CommandBuffer &commandBuffer, const Material &material) {
+    if (rendererData.bindless && material.isBindless()) {
+        if (rendererData.lastPushedMaterial != &material) {
+            BindlessMaterialPushConstants pushConstants;
+            getMaterialConstants(material, pushConstants.normalMetallicRoughnessAndAO, pushConstants.heightAndUvScale);
+            pushConstants.albedoNormalMetallicRoughnessIndices =
+                glm::uvec4(material.getAlbedoTextureIndex(), material.getNormalTextureIndex(),
+                           material.getMetallicTextureIndex(), material.getRoughnessTextureIndex());
+            pushConstants.heightAndAOIndices =
+                glm::uvec4(material.getHeightTextureIndex(), material.getAOTextureIndex(), 0, 0);
+
+            commandBuffer.setPushConstants(rendererData.pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, &pushConstants,
+                                           0, sizeof(BindlessMaterialPushConstants));
+            rendererData.lastPushedMaterial = &material;
+        }
+    }
+    else {
+        uint32 materialOffset = rendererData.materialOffsetMap[material];
+        commandBuffer.bindDescriptorSet(material.getDescriptorSet(), rendererData.pipelineLayout,
+                                        RENDERER_MATERIAL_DESCRIPTOR_SET_IDX, &materialOffset, 1);
+        rendererData.stats.descriptorSetBindCount++;
     }
+}
 
-    rendererData.stats.vertexCount += mesh.getVertexCount();
-    rendererData.stats.triangleCount += (mesh.hasIndices() ? mesh.getIndexCount() : mesh.getVertexCount()) / 3;
+void Renderer::drawSubmesh(CommandBuffer &commandBuffer, const Mesh &mesh, uint32 submeshIndex, uint32 lod) {
+    const Mesh::SubMesh &submesh = mesh.getSubMeshIdx(submeshIndex);
+    if (mesh.hasIndices()) {
+        const Mesh::Lod &submeshLod = submesh.lods[lod];
+        commandBuffer.drawIndexed(submeshLod.indexCount, 1, submeshLod.indexOffset, 0, 0);
+        rendererData.stats.triangleCount += submeshLod.indexCount / 3;
+    }
+    else {
+        commandBuffer.draw(submesh.vertexCount, 1, submesh.vertexOffset, 1);
+        rendererData.stats.triangleCount += submesh.vertexCount / 3;
+    }
+    rendererData.stats.vertexCount += submesh.vertexCount;
+    rendererData.stats.drawCallCount++;
 }
 
 void Renderer::fillConstants(const Scene &scene) {
@@ -644,26 +883,24 @@ void Renderer::fillConstants(const Scene &scene) {
     computeCascadedShadowMappingSplits(cascadeSplits, SHADOW_MAPPING_CASCADE_COUNT, cameraParams.near,
                                        cameraParams.far);
 
+    const Frustum &cameraFrustum = camera.getFrustum();
+    const float depthRange = cameraParams.far - cameraParams.near;
+
     uint32 matrixIndex = 0;
     for (auto &dirLight : scene.getDirectionalLights()) {
 
         for (uint32 cascadeIdx = 0; cascadeIdx < SHADOW_MAPPING_CASCADE_COUNT; ++cascadeIdx) {
-            const float cascadeNear = cascadeIdx == 0 ? cameraParams.near : cascadeSplits[cascadeIdx];
-            const float cascadeFar = cascadeIdx == 0 ? cascadeSplits[0] : cascadeSplits[cascadeIdx + 1];
+            // The splits are negative view space depths, where each cascade ends.
+            const float cascadeNear = cascadeIdx == 0 ? cameraParams.near : -cascadeSplits[cascadeIdx - 1];
+            const float cascadeFar = -cascadeSplits[cascadeIdx];
+            const Frustum cascadeFrustum = cameraFrustum.getSlice((cascadeNear - cameraParams.near) / depthRange,
+                                                                  (cascadeFar - cameraParams.near) / depthRange);
 
-            // Compute Sphere that enconpasses the frustum, in camera space.
             // The sphere is useful to have the shadow frustum to be always the same size regardless of the camera
             // orientation, leading to no shadow flickering.
-            float t = glm::tan(glm::radians(cameraParams.aspectRatio * cameraParams.fovy * 0.5f));
-            glm::vec3 n(t * cascadeNear, 0.0f, cascadeNear);
-            glm::vec3 f(t * cascadeFar, 0.0f, cascadeFar);
-
-            // Solve the equation |f-center|=|n-center|, knowing that the sphere center is (0, 0, centerZ).
-            float centerZ = ((f.x * f.x + f.z * f.z) - (n.x * n.x + n.z * n.z)) / (2.0f * f.z - 2.0f * n.z);
-            float r = glm::distance(glm::vec3(0.0f, 0.0f, centerZ), n);
-
-            glm::vec3 sphereCenterWorld =
-                camera.getTransform().getLocalToParentMatrix() * glm::vec4(0.0f, 0.0f, centerZ, 1.0f);
+            const BoundingSphere sphere = cascadeFrustum.getBoundingSphere();
+            const glm::vec3 sphereCenterWorld = sphere.getCenter();
+            const float r = sphere.getRadius();
 
             // Units of view space per shadow map texel (and world space, assuming no scaling between the two spaces).
             const float Q = glm::ceil(r * 2.0f) / static_cast<float>(SHADOW_MAP_SIZE);
@@ -714,6 +951,7 @@ void Renderer::fillScene(const Scene &scene, const glm::mat4 *lightMatrices, con
         sceneConstantBufferData.dirLightColors[lightIdx].b = dirLight.color.b;
         lightIdx++;
     }
+    sceneConstantBufferData.clusterScalesAndBiases = rendererData.lightClusterer.getClusterScalesAndBiases();
     sceneConstantBufferData.dirLightCount = static_cast<float>(lightIdx);
     memcpy(rendererData.sceneConstantBufferPtr, &sceneConstantBufferData, sizeof(SceneConstantBufferData));
 }
@@ -790,19 +1028,9 @@ void Renderer::fillMaterial(const Material &material) {
 
     // If it's the first time this Material is used on a Scene set the correspondent data.
     if (storedMaterialIt == rendererData.materialOffsetMap.end()) {
-        const auto &uvScale = material.getUvScale();
         MaterialConstantBufferData materialConstantBufferData;
-        materialConstantBufferData.normalMetallicRoughnessAndAO.x = material.hasNormalTexture() ? 1.0f : 0.0f;
-        materialConstantBufferData.normalMetallicRoughnessAndAO.y =
-            material.hasMetallicTexture() ? -1.0f : material.getMetallic();
-        materialConstantBufferData.normalMetallicRoughnessAndAO.z =
-            material.hasRoughnessTexture() ? -1.0f : material.getRoughness();
-        materialConstantBufferData.normalMetallicRoughnessAndAO.w = material.hasAOTexture() ? 1.0f : 0.0f;
-
-        materialConstantBufferData.heightAndUvScale.x =
-            material.hasHeightTexture() ? material.getParallaxOcclusionScale() : -1.0f;
-        materialConstantBufferData.heightAndUvScale.y = uvScale.x;
-        materialConstantBufferData.heightAndUvScale.z = uvScale.y;
+        getMaterialConstants(material, materialConstantBufferData.normalMetallicRoughnessAndAO,
+                             materialConstantBufferData.heightAndUvScale);
 
         uint32 materialOffset =
             static_cast<uint32>(rendererData.materialOffsetMap.size()) * sizeof(EntityConstantBufferData);
@@ -813,14 +1041,32 @@ void Renderer::fillMaterial(const Material &material) {
     }
 }
 
+void Renderer::getMaterialConstants(const Material &material, glm::vec4 &outNormalMetallicRoughnessAndAO,
+                                    glm::vec4 &outHeightAndUvScale) {
+    const auto &uvScale = material.getUvScale();
+    outNormalMetallicRoughnessAndAO.x = material.hasNormalTexture() ? 1.0f : 0.0f;
+    outNormalMetallicRoughnessAndAO.y = material.hasMetallicTexture() ? -1.0f : material.getMetallic();
+    outNormalMetallicRoughnessAndAO.z = material.hasRoughnessTexture() ? -1.0f : material.getRoughness();
+    outNormalMetallicRoughnessAndAO.w = material.hasAOTexture() ? 1.0f : 0.0f;
+
+    outHeightAndUvScale.x = material.hasParallaxOcclusion() ? material.getParallaxOcclusionScale() : -1.0f;
+    outHeightAndUvScale.y = uvScale.x;
+    outHeightAndUvScale.z = uvScale.y;
+    outHeightAndUvScale.w = 0.0f;
+}
+
 void Renderer::fillEntities(const Scene &scene) {
     BZ_PROFILE_FUNCTION();
 
+    // One pass over the whole hierarchy before reading it.
+    const TransformHierarchy &transformHierarchy = scene.getTransformHierarchy();
+    transformHierarchy.updateWorldMatrices();
+
     uint32 entityIndex = 0;
     for (const auto &entity : scene.getEntities()) {
         EntityConstantBufferData entityConstantBufferData;
-        entityConstantBufferData.modelMatrix = entity.transform.getLocalToParentMatrix();
-        entityConstantBufferData.normalMatrix = entity.transform.getNormalMatrix();
+        entityConstantBufferData.modelMatrix = transformHierarchy.getLocalToWorldMatrix(entity.transformNode);
+        entityConstantBufferData.normalMatrix = transformHierarchy.getNormalMatrix(entity.transformNode);
 
         uint32 entityOffset = entityIndex * sizeof(EntityConstantBufferData);
         memcpy(rendererData.entityConstantBufferPtr + entityOffset, &entityConstantBufferData,
@@ -830,12 +1076,129 @@ void Renderer::fillEntities(const Scene &scene) {
     BZ_ASSERT_CORE(entityIndex <= MAX_ENTITIES_PER_SCENE, "Reached the max number of Entities!");
 }
 
+void Renderer::cullEntities(const Scene &scene) {
+    BZ_PROFILE_FUNCTION();
+
+    Timer cullingTimer;
+    cullingTimer.start();
+
+    const auto &entities = scene.getEntities();
+    const uint32 entityCount = static_cast<uint32>(entities.size());
+
+    uint32 visibleCount = 0;
+    rendererData.entityVisibility.assign(entityCount, 0);
+    scene.queryFrustum(scene.getCamera().getFrustum(), [&visibleCount](uint32 entityIndex) {
+        rendererData.entityVisibility[entityIndex] = 1;
+        visibleCount++;
+        return true;
+    });
+    rendererData.stats.frustumCulledEntityCount = entityCount - visibleCount;
+
+    if (rendererData.occlusionCulling) {
+        OcclusionCuller &occlusionCuller = rendererData.occlusionCuller;
+        occlusionCuller.render(scene);
+
+        if (occlusionCuller.getOccluderCount() > 0) {
+            constexpr uint32 ENTITIES_PER_JOB = 16;
+            std::atomic<uint32> occludedCount{ 0 };
+            Engine::get().getJobSystem().parallelFor(
+                entityCount, ENTITIES_PER_JOB, [&scene, &occlusionCuller, &occludedCount](uint32 begin, uint32 end) {
+                    uint32 occluded = 0;
+                    for (uint32 i = begin; i < end; ++i) {
+                        if (rendererData.entityVisibility[i] && occlusionCuller.isOccluded(scene.getEntityAABB(i))) {
+                            rendererData.entityVisibility[i] = 0;
+                            occluded++;
+                        }
+                    }
+                    occludedCount += occluded;
+                });
+            rendererData.stats.occludedEntityCount = occludedCount;
+        }
+        rendererData.stats.occluderPolygonCount = occlusionCuller.getOccluderPolygonCount();
+    }
+
+    rendererData.stats.cullingTime = cullingTimer.getCountedTime();
+}
+
+void Renderer::selectLods(const Scene &scene) {
+    BZ_PROFILE_FUNCTION();
+
+    // To switch to a coarser LOD its error must be this fraction of the threshold, so Entities near a transition
+    // distance don't pop back and forth.
+    constexpr float LOD_HYSTERESIS = 0.75f;
+
+    const auto &entities = scene.getEntities();
+    const uint32 entityCount = static_cast<uint32>(entities.size());
+    if (rendererData.entityLods.size() != entityCount) {
+        rendererData.entityLods.assign(entityCount, 0);
+    }
+
+    const Camera &camera = scene.getCamera();
+    const glm::vec3 &cameraPosition = camera.getTransform().getTranslation();
+
+    // From a world space length at a view distance of 1 to pixels on the color pass.
+    const float pixelsPerUnit = 0.5f * rendererData.colorTexView->getTexture()->getDimensionsFloat().y *
+                                glm::abs(camera.getProjectionMatrix()[1][1]);
+
+    for (uint32 entityIndex = 0; entityIndex < entityCount; ++entityIndex) {
+        const Entity &entity = entities[entityIndex];
+        const uint32 lodCount = rendererData.meshLods ? entity.mesh.getLodCount() : 1;
+
+        uint32 lod = glm::min(static_cast<uint32>(rendererData.entityLods[entityIndex]), lodCount - 1);
+        if (lodCount > 1) {
+            const glm::mat4 &modelMatrix = scene.getTransformHierarchy().getLocalToWorldMatrix(entity.transformNode);
+            const float scale = glm::max(glm::length(glm::vec3(modelMatrix[0])),
+                                         glm::max(glm::length(glm::vec3(modelMatrix[1])),
+                                                  glm::length(glm::vec3(modelMatrix[2]))));
+
+            // Distance to the closest point of the bounds, 0 from inside, which keeps the full detail.
+            const AABB aabb = scene.getEntityAABB(entityIndex);
+            const float distance =
+                glm::distance(cameraPosition, CollisionUtils::findClosestPointOnAABB(aabb, cameraPosition));
+            const float errorToPixels = scale * pixelsPerUnit / glm::max(distance, 1e-4f);
+
+            const float threshold = rendererData.lodErrorThreshold;
+            while (lod > 0 && entity.mesh.getLodError(lod) * errorToPixels > threshold) {
+                lod--;
+            }
+            while (lod + 1 < lodCount &&
+                   entity.mesh.getLodError(lod + 1) * errorToPixels <= threshold * LOD_HYSTERESIS) {
+                lod++;
+            }
+        }
+        rendererData.entityLods[entityIndex] = static_cast<uint8>(lod);
+
+        if (rendererData.entityVisibility[entityIndex]) {
+            rendererData.stats.lodEntityCounts[lod]++;
+        }
+    }
+}
+
+void Renderer::clusterLights(const Scene &scene) {
+    BZ_PROFILE_FUNCTION();
+
+    Timer clusteringTimer;
+    clusteringTimer.start();
+
+    LightClusterer &lightClusterer = rendererData.lightClusterer;
+    lightClusterer.cluster(scene, rendererData.colorTexView->getTexture()->getDimensionsFloat());
+
+    rendererData.stats.localLightCount =
+        static_cast<uint32>(scene.getPointLights().size() + scene.getSpotLights().size());
+    rendererData.stats.visibleLocalLightCount = lightClusterer.getVisibleLightCount();
+    rendererData.stats.clusteredLightIndexCount = lightClusterer.getLightIndexCount();
+    rendererData.stats.lightClusteringTime = clusteringTimer.getCountedTime();
+}
+
 void Renderer::render(const Ref<RenderPass> &finalRenderPass, const Ref<Framebuffer> &finalFramebuffer,
                       bool waitForImageAvailable, bool signalFrameEnd) {
     BZ_PROFILE_FUNCTION();
 
     if (rendererData.sceneToRender) {
+        clusterLights(*rendererData.sceneToRender);
         fillConstants(*rendererData.sceneToRender);
+        cullEntities(*rendererData.sceneToRender);
+        selectLods(*rendererData.sceneToRender);
 
         shadowPass(*rendererData.sceneToRender);
         colorPass(*rendererData.sceneToRender);
@@ -874,7 +1237,46 @@ void Renderer::onImGuiRender(const FrameTiming &frameTiming) {
         ImGui::Text("Vertex Count: %d.", rendererData.visibleStats.vertexCount);
         ImGui::Text("Triangle Count: %d.", rendererData.visibleStats.triangleCount);
         ImGui::Text("Draw Call Count: %d.", rendererData.visibleStats.drawCallCount);
+        ImGui::Text("Descriptor Set Bind Count: %d.", rendererData.visibleStats.descriptorSetBindCount);
+        ImGui::Text("Bindless: %s.", rendererData.bindless ? "On" : "Off");
         ImGui::Text("Material Count: %d.", rendererData.visibleStats.materialCount);
+        ImGui::Text("Pipeline Bind Count: %d.", rendererData.visibleStats.pipelineBindCount);
+        ImGui::Text("Pipeline Permutation Count: %d.", rendererData.colorPassPipelineStates.getCount());
+        ImGui::Separator();
+
+        ImGui::Checkbox("Occlusion Culling", &rendererData.occlusionCulling);
+        ImGui::Text("Frustum Culled Entity Count: %d.", rendererData.visibleStats.frustumCulledEntityCount);
+        ImGui::Text("Occluded Entity Count: %d.", rendererData.visibleStats.occludedEntityCount);
+        ImGui::Text("Occluder Polygon Count: %d.", rendererData.visibleStats.occluderPolygonCount);
+        ImGui::Text("Culling Time: %.3f ms.", rendererData.visibleStats.cullingTime.asMillisecondsFloat());
+        ImGui::Separator();
+
+        ImGui::Checkbox("Mesh LODs", &rendererData.meshLods);
+        ImGui::DragFloat("LOD Error Threshold (px)", &rendererData.lodErrorThreshold, 0.05f, 0.1f, 16.0f);
+        for (uint32 lod = 0; lod < Mesh::MAX_LOD_COUNT; ++lod) {
+            ImGui::Text("LOD %d Entity Count: %d.", lod, rendererData.visibleStats.lodEntityCounts[lod]);
+        }
+        ImGui::Separator();
+
+        ImGui::Checkbox("Meshlet Culling", &rendererData.meshletCulling);
+        ImGui::Checkbox("Meshlet Culling on GPU (no occlusion)", &rendererData.gpuMeshletCulling);
+        ImGui::Text("Meshlet Count: %d.", rendererData.visibleStats.meshletCount);
+        if (rendererData.gpuMeshletCulling) {
+            ImGui::Text("Visible Meshlet Count: unknown on GPU.");
+        }
+        else {
+            ImGui::Text("Visible Meshlet Count: %d.", rendererData.visibleStats.visibleMeshletCount);
+        }
+        ImGui::Text("Meshlet Draw Command Count: %d.", rendererData.visibleStats.meshletDrawCommandCount);
+        ImGui::Text("Meshlet Culling Time: %.3f ms.",
+                    rendererData.visibleStats.meshletCullingTime.asMillisecondsFloat());
+        ImGui::Separator();
+
+        ImGui::Text("Point and Spot Light Count: %d.", rendererData.visibleStats.localLightCount);
+        ImGui::Text("Visible Light Count: %d.", rendererData.visibleStats.visibleLocalLightCount);
+        ImGui::Text("Clustered Light Index Count: %d.", rendererData.visibleStats.clusteredLightIndexCount);
+        ImGui::Text("Light Clustering Time: %.3f ms.",
+                    rendererData.visibleStats.lightClusteringTime.asMillisecondsFloat());
         ImGui::Separator();
 
         ImGui::Text("Refresh period ms");
@@ -901,17 +1303,18 @@ const DataLayout &Renderer::getIndexDataLayout() {
     return indexDataLayout;
 }
 
-DescriptorSet &Renderer::createSceneDescriptorSet() {
-    auto &descriptorSet = DescriptorSet::get(rendererData.sceneDescriptorSetLayout);
-    descriptorSet.setConstantBuffer(rendererData.constantBuffer, 0, SCENE_CONSTANT_BUFFER_OFFSET,
-                                    sizeof(SceneConstantBufferData));
+Ref<DescriptorSet> Renderer::createSceneDescriptorSet() {
+    auto descriptorSet = DescriptorSet::getShared(rendererData.sceneDescriptorSetLayout);
+    descriptorSet->setConstantBuffer(rendererData.constantBuffer, 0, SCENE_CONSTANT_BUFFER_OFFSET,
+                                     sizeof(SceneConstantBufferData));
+    rendererData.lightClusterer.setStorageBuffers(*descriptorSet, 4);
     return descriptorSet;
 }
 
-DescriptorSet &Renderer::createMaterialDescriptorSet() {
-    auto &descriptorSet = DescriptorSet::get(rendererData.materialDescriptorSetLayout);
-    descriptorSet.setConstantBuffer(rendererData.constantBuffer, 0, MATERIAL_CONSTANT_BUFFER_OFFSET,
-                                    sizeof(MaterialConstantBufferData));
+Ref<DescriptorSet> Renderer::createMaterialDescriptorSet() {
+    auto descriptorSet = DescriptorSet::getShared(rendererData.materialDescriptorSetLayout);
+    descriptorSet->setConstantBuffer(rendererData.constantBuffer, 0, MATERIAL_CONSTANT_BUFFER_OFFSET,
+                                     sizeof(MaterialConstantBufferData));
     return descriptorSet;
 }
 
@@ -936,4 +1339,8 @@ const Ref<Sampler> &Renderer::getDefaultAnisotropicSampler() {
 const Ref<Sampler> &Renderer::getShadowSampler() {
     return rendererData.shadowSampler;
 }
+
+void Renderer::setColorGradingLut(const Ref<TextureView> &lutTexView) {
+    rendererData.postProcessor.setColorGradingLut(lutTexView);
+}
 }
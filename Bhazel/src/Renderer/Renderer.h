@@ -8,6 +8,7 @@ class Mesh;
 class Material;
 class Scene;
 class PipelineState;
+class PipelineLayout;
 class DataLayout;
 class DescriptorSetLayout;
 class Buffer;
@@ -25,12 +26,15 @@ class Renderer {
   public:
     static void renderScene(const Scene &scene);
 
+    // Enables color grading with the LUT, a 2D strip with the 16 blue slices side by side (256x16).
+    static void setColorGradingLut(const Ref<TextureView> &lutTexView);
+
     static const DataLayout &getVertexDataLayout();
     static const DataLayout &getIndexDataLayout();
 
     // Pre-filled DescriptorSets to be used on Scenes and Materials. They will fill the remaining bindings.
-    static DescriptorSet &createSceneDescriptorSet();
-    static DescriptorSet &createMaterialDescriptorSet();
+    static Ref<DescriptorSet> createSceneDescriptorSet();
+    static Ref<DescriptorSet> createMaterialDescriptorSet();
     static Ref<Framebuffer> createShadowMapFramebuffer();
 
     static const Ref<Sampler> &getDefaultSampler();
@@ -38,6 +42,7 @@ class Renderer {
     static const Ref<Sampler> &getShadowSampler();
 
     constexpr static uint32 MAX_DIR_LIGHTS_PER_SCENE = 2;
+    constexpr static uint32 MAX_LOCAL_LIGHTS_PER_SCENE = 4096; // Point and Spot Lights together.
     constexpr static uint32 MAX_ENTITIES_PER_SCENE = 64;
     constexpr static uint32 MAX_MATERIALS_PER_SCENE = 64;
 
@@ -55,9 +60,20 @@ class Renderer {
     static void shadowPass(const Scene &scene);
     static void colorPass(const Scene &scene);
 
-    static void drawEntities(CommandBuffer &commandBuffer, const Scene &scene, bool shadowPass);
+    static void drawShadowCasters(CommandBuffer &commandBuffer, const Scene &scene);
+
+    // Gathers the color pass draws, grouped by the pipeline permutation of each Material, and culls their meshlets.
+    static void prepareVisibleEntities(const Scene &scene);
+    static void drawVisibleEntities(CommandBuffer &commandBuffer, const Scene &scene);
+
+    // Of the color pass draws on full detail, setting their MeshletCuller slots.
+    static void cullMeshlets(const Scene &scene);
+
+    static void bindEntity(CommandBuffer &commandBuffer, uint32 entityIndex, const Ref<PipelineLayout> &layout);
     static void drawMesh(CommandBuffer &commandBuffer, const Mesh &mesh, const Material &overrideMaterial,
-                         bool shadowPass);
+                         bool shadowPass, uint32 lod);
+    static void bindMaterial(CommandBuffer &commandBuffer, const Material &material);
+    static void drawSubmesh(CommandBuffer &commandBuffer, const Mesh &mesh, uint32 submeshIndex, uint32 lod);
 
     static void fillConstants(const Scene &scene);
     static void fillScene(const Scene &scene, const glm::mat4 *lightMatrices, const glm::mat4 *lightProjectionMatrices,
@@ -66,8 +82,19 @@ class Renderer {
                            const glm::mat4 *lightProjectionMatrices);
     static void fillMaterials(const Scene &scene);
     static void fillMaterial(const Material &material);
+    static void getMaterialConstants(const Material &material, glm::vec4 &outNormalMetallicRoughnessAndAO,
+                                     glm::vec4 &outHeightAndUvScale);
     static void fillEntities(const Scene &scene);
 
+    // Frustum and occlusion culling of the Entities for the color pass.
+    static void cullEntities(const Scene &scene);
+
+    // Per Entity, from the projected screen space error of the Mesh LODs. Run after cullEntities().
+    static void selectLods(const Scene &scene);
+
+    // Bins the Point and Spot Lights into the froxels of the LightClusterer.
+    static void clusterLights(const Scene &scene);
+
     static void render(const Ref<RenderPass> &finalRenderPass, const Ref<Framebuffer> &finalFramebuffer,
                        bool waitForImageAvailable, bool signalFrameEnd);
     static void onImGuiRender(const FrameTiming &frameTiming);
@@ -10,11 +10,14 @@
 #include "Graphics/RenderPass.h"
 #include "Graphics/Shader.h"
 #include "Graphics/Texture.h"
+#include "Graphics/TextureAtlas.h"
 
 #include "Core/Engine.h"
 #include "Core/Utils.h"
 
 #include "Renderer/ParticleSystem2D.h"
+#include "Renderer/Renderer2DVertices.h"
+#include "Renderer/SpriteGrid.h"
 
 #include "Camera.h"
 
@@ -25,64 +28,103 @@ namespace BZ {
 
 struct Renderer2DStats {
     uint32 spriteCount;
+    uint32 culledSpriteCount;
     uint32 drawCallCount;
     uint32 descriptorSetBindCount;
+    uint32 pipelineBindCount;
+    TimeDuration sortTime;
+    TimeDuration vertexGenerationTime;
+    uint32 gpuEmitterCount;
     // uint32 tintPushCount;
 };
 
 constexpr uint32 MAX_RENDERER2D_SPRITES = 100'000;
 
+constexpr uint32 GPU_PARTICLES_GROUP_SIZE = 64;
+
+// std430 Particle struct on Particles2DCommon.glsl.
+constexpr uint32 GPU_PARTICLE_SIZE = 80;
+
+// VkDrawIndirectCommand followed by the alive and dead counts.
+constexpr uint32 GPU_PARTICLE_COUNTERS_SIZE = 32;
+
+// std140, matches the EmitterData uniform on Particles2DCommon.glsl.
+struct GpuEmitterData {
+    glm::vec4 positionRange; // Min on xy, max on zw.
+    glm::vec4 dimensionRange;
+    glm::vec4 velocityRange;
+    glm::vec4 accelerationRange;
+    glm::vec4 rotationAndLifeRange; // Rotation min and max on xy, life min and max on zw.
+    glm::vec4 angularVelocityRange; // Min and max on xy.
+    glm::vec4 tintAndAlphaMin;
+    glm::vec4 tintAndAlphaMax;
+    glm::vec4 texCoordRect;
+    glm::vec2 emitterPosition;
+    float deltaSecs;
+    uint32 emitCount;
+    uint32 maxParticles;
+    uint32 seed;
+    uint32 currentAliveListOffset;
+    uint32 nextAliveListOffset;
+    uint32 textureIndex;
+    uint32 reset;
+};
+static_assert(sizeof(GpuEmitterData) <= GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN,
+              "GpuEmitterData does not fit on the buffer!");
+
 static DataLayout vertexLayout = {
     { DataType::Float32, DataElements::Vec2 },
     { DataType::Uint16, DataElements::Vec2, true },
     { DataType::Uint32, DataElements::Scalar },
+    { DataType::Uint32, DataElements::Scalar },
 };
 
 static DataLayout indexLayout = {
     { DataType::Uint32, DataElements::Scalar },
 };
 
-struct VertexData {
-    float pos[2];
-    uint16 texCoord[2];
-    uint32 colorAndAlpha;
-};
-
-constexpr uint16 UINT16_MAX_VALUE = 0xffff;
-static VertexData quadVertices[4] = { { { -0.5f, -0.5f }, { 0, 0 }, 0 },
-                                      { { 0.5f, -0.5f }, { UINT16_MAX_VALUE, 0 }, 0 },
-                                      { { 0.5f, 0.5f }, { UINT16_MAX_VALUE, UINT16_MAX_VALUE }, 0 },
-                                      { { -0.5f, 0.5f }, { 0, UINT16_MAX_VALUE }, 0 } };
-
 static uint32 quadIndices[6] = { 0, 1, 2, 2, 3, 0 };
 
-struct InternalSprite {
-    glm::vec2 position;
-    glm::vec2 dimensions;
-    float rotationDeg;
-    glm::vec4 tintAndAlpha;
-    uint64 textureHash;
-    uint64 sortKey;
+// The index is the count of sprites submitted before the emitter.
+struct GpuEmitterEntry {
+    Utils::SortKeyIndex sortEntry;
+    GpuEmitter2D *emitter;
 };
 
 struct TexData {
     Ref<TextureView> textureView;
-    DescriptorSet *descriptorSet;
+    DescriptorSet *descriptorSet; // Not used on bindless mode.
+    uint32 bindlessIndex;
+    uint32 sortId; // Sequential, small enough for the sort key.
 };
 
+// From the most to the least significant bits: layer (8), blend mode (2), inverted depth (22), texture (32).
+static uint64 makeSortKey(uint8 layer, SpriteBlendMode blendMode, float depth, uint32 textureSortId) {
+    constexpr uint32 DEPTH_BITS = 22;
+    constexpr float DEPTH_MAX = static_cast<float>((1u << DEPTH_BITS) - 1);
+
+    // Higher depths are farther away and are drawn first.
+    uint64 depthBits = static_cast<uint64>((1.0f - glm::clamp(depth, 0.0f, 1.0f)) * DEPTH_MAX);
+    return (static_cast<uint64>(layer) << 56) | (static_cast<uint64>(blendMode) << 54) | (depthBits << 32) |
+           textureSortId;
+}
+
 static struct Renderer2DData {
     const OrthographicCamera *camera;
 
+    // World space camera view bounds. Min on xy, max on zw.
+    glm::vec4 viewRect;
+    bool cullingEnabled = true;
+
     Ref<Buffer> vertexBuffer;
     Ref<Buffer> indexBuffer;
     Ref<Buffer> constantBuffer;
 
     BufferPtr vertexBufferPtr;
-    BufferPtr indexBufferPtr;
     BufferPtr constantBufferPtr;
 
     Ref<PipelineLayout> pipelineLayout;
-    Ref<PipelineState> pipelineState;
+    Ref<PipelineState> pipelineStates[static_cast<uint32>(SpriteBlendMode::Count)];
     Ref<Texture2D> whiteTexture;
     Ref<Sampler> sampler;
 
@@ -90,11 +132,30 @@ static struct Renderer2DData {
     Ref<DescriptorSetLayout> textureDescriptorSetLayout;
     DescriptorSet *constantsDescriptorSet;
 
+    // All the textures are on the BindlessTextureTable, referenced by index on the vertices. No batch breaks when
+    // changing textures.
+    bool bindless;
+
     std::unordered_map<uint64, TexData> texDataStorage;
 
-    InternalSprite sprites[MAX_RENDERER2D_SPRITES + 1];
+    Renderer2DSprite sprites[MAX_RENDERER2D_SPRITES];
     uint32 nextSprite;
 
+    // Sorted instead of the sprites, which are much larger. The extra entry is used to end the last batch.
+    Utils::SortKeyIndex sortEntries[MAX_RENDERER2D_SPRITES + 1];
+    Utils::SortKeyIndex sortTempEntries[MAX_RENDERER2D_SPRITES];
+
+    // Submitted this frame and simulated before the sprites. Drawn between them, at the position of their sort entry.
+    std::vector<GpuEmitterEntry> gpuEmitters;
+
+    Ref<DescriptorSetLayout> gpuParticlesDescriptorSetLayout;
+    Ref<PipelineLayout> gpuParticlesComputePipelineLayout;
+    Ref<PipelineState> gpuParticlesPreparePipelineState;
+    Ref<PipelineState> gpuParticlesSimulatePipelineState;
+    Ref<PipelineState> gpuParticlesEmitPipelineState;
+    Ref<PipelineLayout> gpuParticlesPipelineLayout;
+    Ref<PipelineState> gpuParticlesPipelineStates[static_cast<uint32>(SpriteBlendMode::Count)];
+
     // Stats
     Renderer2DStats stats;
     Renderer2DStats visibleStats;
@@ -104,31 +165,120 @@ static struct Renderer2DData {
 } rendererData;
 
 
-static uint64 initTexture(const Ref<Texture2D> &texture) {
+void Sprite::setAtlasRegion(const TextureAtlasRegion &region) {
+    texture = region.texture;
+    texCoordRect = region.texCoordRect;
+}
+
+static const TexData &initTexture(const Ref<Texture2D> &texture, uint64 &outHash) {
     uint64 hash = reinterpret_cast<uint64>(texture.get()); // TODO: something better
-    if (rendererData.texDataStorage.find(hash) == rendererData.texDataStorage.end()) {
-        auto texViewRef = TextureView::create(texture, 0, 1, 0, -1);
-        auto descSetRef = &DescriptorSet::get(rendererData.textureDescriptorSetLayout);
-        descSetRef->setCombinedTextureSampler(texViewRef, rendererData.sampler, 0);
-        rendererData.texDataStorage.emplace(hash, TexData{ texViewRef, descSetRef });
+    outHash = hash;
+
+    auto it = rendererData.texDataStorage.find(hash);
+    if (it == rendererData.texDataStorage.end()) {
+        TexData texData;
+        texData.textureView = TextureView::create(texture, 0, 1, 0, -1);
+        texData.descriptorSet = nullptr;
+        texData.bindlessIndex = 0;
+        texData.sortId = static_cast<uint32>(rendererData.texDataStorage.size());
+
+        if (rendererData.bindless) {
+            texData.bindlessIndex =
+                BZ_GRAPHICS_CTX.getBindlessTextureTable().registerTexture(texData.textureView, rendererData.sampler);
+        }
+        else {
+            texData.descriptorSet = &DescriptorSet::get(rendererData.textureDescriptorSetLayout);
+            texData.descriptorSet->setCombinedTextureSampler(texData.textureView, rendererData.sampler, 0);
+        }
+        it = rendererData.texDataStorage.emplace(hash, texData).first;
     }
-    return hash;
+    return it->second;
+}
+
+static void initGpuParticles(const Ref<DescriptorSetLayout> &textureSetLayout, const BlendingState &blendingState,
+                             const BlendingState &additiveBlendingState) {
+    constexpr VkShaderStageFlags STAGES = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    rendererData.gpuParticlesDescriptorSetLayout =
+        DescriptorSetLayout::create({ { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, STAGES, 1 },
+                                      { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, STAGES, 1 },
+                                      { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, STAGES, 1 },
+                                      { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, STAGES, 1 },
+                                      { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, STAGES, 1 } });
+
+    rendererData.gpuParticlesComputePipelineLayout =
+        PipelineLayout::create({ rendererData.gpuParticlesDescriptorSetLayout });
+
+    PipelineStateData computePipelineStateData;
+    computePipelineStateData.layout = rendererData.gpuParticlesComputePipelineLayout;
+
+    computePipelineStateData.shader =
+        Shader::create({ { "Bhazel/shaders/bin/Particles2DPrepareComp.spv", VK_SHADER_STAGE_COMPUTE_BIT } });
+    rendererData.gpuParticlesPreparePipelineState = PipelineState::create(computePipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.gpuParticlesPreparePipelineState, "Renderer2D Particles Prepare Pipeline");
+
+    computePipelineStateData.shader =
+        Shader::create({ { "Bhazel/shaders/bin/Particles2DSimulateComp.spv", VK_SHADER_STAGE_COMPUTE_BIT } });
+    rendererData.gpuParticlesSimulatePipelineState = PipelineState::create(computePipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.gpuParticlesSimulatePipelineState,
+                               "Renderer2D Particles Simulate Pipeline");
+
+    computePipelineStateData.shader =
+        Shader::create({ { "Bhazel/shaders/bin/Particles2DEmitComp.spv", VK_SHADER_STAGE_COMPUTE_BIT } });
+    rendererData.gpuParticlesEmitPipelineState = PipelineState::create(computePipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.gpuParticlesEmitPipelineState, "Renderer2D Particles Emit Pipeline");
+
+    // Set 0 and 1 are compatible with the sprites PipelineLayout.
+    rendererData.gpuParticlesPipelineLayout = PipelineLayout::create(
+        { rendererData.constantsDescriptorSetLayout, textureSetLayout, rendererData.gpuParticlesDescriptorSetLayout });
+
+    // The quads are generated on the vertex shader, there's no vertex buffer.
+    PipelineStateData pipelineStateData;
+    pipelineStateData.dataLayout = {};
+    const char *fragmentShaderPath = rendererData.bindless ? "Bhazel/shaders/bin/Renderer2DBindlessFrag.spv" :
+                                                             "Bhazel/shaders/bin/Renderer2DFrag.spv";
+    pipelineStateData.shader =
+        Shader::create({ { "Bhazel/shaders/bin/Particles2DVert.spv", VK_SHADER_STAGE_VERTEX_BIT },
+                         { fragmentShaderPath, VK_SHADER_STAGE_FRAGMENT_BIT } });
+    pipelineStateData.layout = rendererData.gpuParticlesPipelineLayout;
+    pipelineStateData.blendingState = blendingState;
+    pipelineStateData.renderPass = Engine::get().getGraphicsContext().getSwapchainRenderPass();
+    pipelineStateData.subPassIndex = 0;
+    rendererData.gpuParticlesPipelineStates[static_cast<uint32>(SpriteBlendMode::Alpha)] =
+        PipelineState::create(pipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.gpuParticlesPipelineStates[static_cast<uint32>(SpriteBlendMode::Alpha)],
+                               "Renderer2D Particles Alpha Pipeline");
+
+    pipelineStateData.blendingState = additiveBlendingState;
+    rendererData.gpuParticlesPipelineStates[static_cast<uint32>(SpriteBlendMode::Additive)] =
+        PipelineState::create(pipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.gpuParticlesPipelineStates[static_cast<uint32>(SpriteBlendMode::Additive)],
+                               "Renderer2D Particles Additive Pipeline");
 }
 
 void Renderer2D::init() {
     BZ_PROFILE_FUNCTION();
 
+    rendererData.bindless = BZ_GRAPHICS_CTX.isBindlessTexturesEnabled();
+
     rendererData.vertexBuffer =
-        Buffer::create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 4 * sizeof(VertexData) * MAX_RENDERER2D_SPRITES,
+        Buffer::create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 4 * sizeof(Renderer2DVertex) * MAX_RENDERER2D_SPRITES,
                        MemoryType::CpuToGpu, vertexLayout);
-    rendererData.indexBuffer =
-        Buffer::create(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 6 * sizeof(uint32) * MAX_RENDERER2D_SPRITES,
-                       MemoryType::CpuToGpu, indexLayout);
+    rendererData.indexBuffer = Buffer::create(VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                              6 * sizeof(uint32) * MAX_RENDERER2D_SPRITES, MemoryType::GpuOnly,
+                                              indexLayout);
     BZ_SET_BUFFER_DEBUG_NAME(rendererData.vertexBuffer, "Renderer2D Vertex Buffer");
     BZ_SET_BUFFER_DEBUG_NAME(rendererData.indexBuffer, "Renderer2D Index Buffer");
 
     rendererData.vertexBufferPtr = rendererData.vertexBuffer->map(0);
-    rendererData.indexBufferPtr = rendererData.indexBuffer->map(0);
+
+    // Every sprite is a quad on the same place of the vertex buffer, so the indices never change.
+    std::vector<uint32> indices(6 * MAX_RENDERER2D_SPRITES);
+    for (uint32 spriteIdx = 0; spriteIdx < MAX_RENDERER2D_SPRITES; ++spriteIdx) {
+        for (uint32 i = 0; i < 6; ++i) {
+            indices[spriteIdx * 6 + i] = quadIndices[i] + spriteIdx * 4;
+        }
+    }
+    rendererData.indexBuffer->setData(indices.data(), static_cast<uint32>(indices.size() * sizeof(uint32)), 0);
 
     Sampler::Builder samplerBuilder;
     samplerBuilder.setAddressModeAll(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
@@ -156,8 +306,16 @@ void Renderer2D::init() {
     blendingStateAttachment.alphaBlendingOperation = VK_BLEND_OP_ADD;
     blendingState.attachmentBlendingStates = { blendingStateAttachment };
 
+    BlendingState additiveBlendingState;
+    blendingStateAttachment.dstColorBlendingFactor = VK_BLEND_FACTOR_ONE;
+    blendingStateAttachment.dstAlphaBlendingFactor = VK_BLEND_FACTOR_ONE;
+    additiveBlendingState.attachmentBlendingStates = { blendingStateAttachment };
+
+    const Ref<DescriptorSetLayout> &textureSetLayout =
+        rendererData.bindless ? BZ_GRAPHICS_CTX.getBindlessTextureTable().getDescriptorSetLayout() :
+                                rendererData.textureDescriptorSetLayout;
     rendererData.pipelineLayout =
-        PipelineLayout::create({ rendererData.constantsDescriptorSetLayout, rendererData.textureDescriptorSetLayout });
+        PipelineLayout::create({ rendererData.constantsDescriptorSetLayout, textureSetLayout });
 
     // Push constants are used to pass tint and alpha values
     // PushConstantDesc pushConstantDesc;
@@ -167,15 +325,31 @@ void Renderer2D::init() {
 
     PipelineStateData pipelineStateData;
     pipelineStateData.dataLayout = vertexLayout;
-    pipelineStateData.shader =
-        Shader::create({ { "Bhazel/shaders/bin/Renderer2DVert.spv", VK_SHADER_STAGE_VERTEX_BIT },
-                         { "Bhazel/shaders/bin/Renderer2DFrag.spv", VK_SHADER_STAGE_FRAGMENT_BIT } });
+    if (rendererData.bindless) {
+        pipelineStateData.shader =
+            Shader::create({ { "Bhazel/shaders/bin/Renderer2DBindlessVert.spv", VK_SHADER_STAGE_VERTEX_BIT },
+                             { "Bhazel/shaders/bin/Renderer2DBindlessFrag.spv", VK_SHADER_STAGE_FRAGMENT_BIT } });
+    }
+    else {
+        pipelineStateData.shader =
+            Shader::create({ { "Bhazel/shaders/bin/Renderer2DVert.spv", VK_SHADER_STAGE_VERTEX_BIT },
+                             { "Bhazel/shaders/bin/Renderer2DFrag.spv", VK_SHADER_STAGE_FRAGMENT_BIT } });
+    }
     pipelineStateData.layout = rendererData.pipelineLayout;
     pipelineStateData.blendingState = blendingState;
     pipelineStateData.renderPass = Engine::get().getGraphicsContext().getSwapchainRenderPass();
     pipelineStateData.subPassIndex = 0;
-    rendererData.pipelineState = PipelineState::create(pipelineStateData);
-    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.pipelineState, "Renderer2D Pipeline");
+    rendererData.pipelineStates[static_cast<uint32>(SpriteBlendMode::Alpha)] = PipelineState::create(pipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.pipelineStates[static_cast<uint32>(SpriteBlendMode::Alpha)],
+                               "Renderer2D Alpha Pipeline");
+
+    pipelineStateData.blendingState = additiveBlendingState;
+    rendererData.pipelineStates[static_cast<uint32>(SpriteBlendMode::Additive)] =
+        PipelineState::create(pipelineStateData);
+    BZ_SET_PIPELINE_DEBUG_NAME(rendererData.pipelineStates[static_cast<uint32>(SpriteBlendMode::Additive)],
+                               "Renderer2D Additive Pipeline");
+
+    initGpuParticles(textureSetLayout, blendingState, additiveBlendingState);
 
     rendererData.constantBuffer = Buffer::create(
         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN, MemoryType::CpuToGpu);
@@ -194,15 +368,53 @@ void Renderer2D::destroy() {
     rendererData.indexBuffer.reset();
     rendererData.constantBuffer.reset();
 
+    for (auto &texDataPair : rendererData.texDataStorage) {
+        if (texDataPair.second.descriptorSet) {
+            DescriptorSet::release(*texDataPair.second.descriptorSet);
+        }
+    }
     rendererData.texDataStorage.clear();
 
     rendererData.pipelineLayout.reset();
-    rendererData.pipelineState.reset();
+    for (auto &pipelineState : rendererData.pipelineStates) {
+        pipelineState.reset();
+    }
     rendererData.sampler.reset();
     rendererData.whiteTexture.reset();
 
     rendererData.constantsDescriptorSetLayout.reset();
     rendererData.textureDescriptorSetLayout.reset();
+
+    rendererData.gpuEmitters.clear();
+    rendererData.gpuParticlesDescriptorSetLayout.reset();
+    rendererData.gpuParticlesComputePipelineLayout.reset();
+    rendererData.gpuParticlesPreparePipelineState.reset();
+    rendererData.gpuParticlesSimulatePipelineState.reset();
+    rendererData.gpuParticlesEmitPipelineState.reset();
+    rendererData.gpuParticlesPipelineLayout.reset();
+    for (auto &pipelineState : rendererData.gpuParticlesPipelineStates) {
+        pipelineState.reset();
+    }
+}
+
+// Bounds of the (possibly rotated) view rectangle, in world space.
+static glm::vec4 computeViewRect(const OrthographicCamera &camera) {
+    const OrthographicCamera::Parameters &params = camera.getParameters();
+    const glm::mat4 &cameraToWorld = camera.getTransform().getLocalToParentMatrix();
+
+    const glm::vec2 corners[4] = { { params.left, params.bottom },
+                                   { params.right, params.bottom },
+                                   { params.right, params.top },
+                                   { params.left, params.top } };
+
+    glm::vec2 min(std::numeric_limits<float>::max());
+    glm::vec2 max(std::numeric_limits<float>::lowest());
+    for (const glm::vec2 &corner : corners) {
+        const glm::vec2 worldCorner = cameraToWorld * glm::vec4(corner, 0.0f, 1.0f);
+        min = glm::min(min, worldCorner);
+        max = glm::max(max, worldCorner);
+    }
+    return glm::vec4(min, max);
 }
 
 void Renderer2D::begin(const OrthographicCamera &camera) {
@@ -210,142 +422,197 @@ void Renderer2D::begin(const OrthographicCamera &camera) {
 
     rendererData.nextSprite = 0;
     rendererData.camera = &camera;
+    rendererData.viewRect = computeViewRect(camera);
 }
 
 void Renderer2D::end() {
     BZ_PROFILE_FUNCTION();
 
-    if (rendererData.nextSprite > 0) {
-        // Sort objects to minimize state changes when rendering. Sorted by Texture and then by
-        // tint.
-        std::sort(rendererData.sprites, rendererData.sprites + rendererData.nextSprite,
-                  [](const InternalSprite &a, const InternalSprite &b) { return a.sortKey < b.sortKey; });
+    // Sort to respect the draw order and to minimize state changes when rendering. On bindless mode the texture bits
+    // don't matter, but the order still does.
+    Timer sortTimer;
+    sortTimer.start();
+    Utils::radixSort(rendererData.sortEntries, rendererData.sortTempEntries, rendererData.nextSprite);
+    rendererData.stats.sortTime = sortTimer.getCountedTime();
+
+    rendererData.sortEntries[rendererData.nextSprite] = { 0, 0 };
+
+    // Few enough to not need the radix sort. Ties keep the submission order, as on the stable sprite sort.
+    std::stable_sort(rendererData.gpuEmitters.begin(), rendererData.gpuEmitters.end(),
+              [](const GpuEmitterEntry &a, const GpuEmitterEntry &b) {
+                  return a.sortEntry.key < b.sortEntry.key ||
+                         (a.sortEntry.key == b.sortEntry.key && a.sortEntry.index < b.sortEntry.index);
+              });
+}
+
+static void addSprite(const glm::vec2 &position, const glm::vec2 &dimensions, float rotationDeg,
+                      const Ref<Texture2D> &texture, const glm::vec4 &texCoordRect, const glm::vec4 &tintAndAlpha,
+                      uint8 layer, float depth, SpriteBlendMode blendMode) {
+    if (rendererData.cullingEnabled) {
+        // Rotated sprites use their bounding circle, avoiding any trigonometry here.
+        const glm::vec2 absDimensions = glm::abs(dimensions);
+        const glm::vec2 halfExtents =
+            rotationDeg == 0.0f ? absDimensions * 0.5f : glm::vec2(glm::length(absDimensions) * 0.5f);
+
+        const glm::vec4 &viewRect = rendererData.viewRect;
+        if (position.x + halfExtents.x < viewRect.x || position.x - halfExtents.x > viewRect.z ||
+            position.y + halfExtents.y < viewRect.y || position.y - halfExtents.y > viewRect.w) {
+            rendererData.stats.culledSpriteCount++;
+            return;
+        }
     }
+
+    BZ_ASSERT_CORE(rendererData.nextSprite < MAX_RENDERER2D_SPRITES, "nextSprite exceeded MAX_RENDERER2D_SPRITES!");
+
+    uint32 spriteIdx = rendererData.nextSprite++;
+    Renderer2DSprite &spr = rendererData.sprites[spriteIdx];
+    spr.position = position;
+    spr.dimensions = dimensions;
+    spr.rotationDeg = rotationDeg;
+    spr.tintAndAlpha = tintAndAlpha;
+    spr.texCoordRect = texCoordRect;
+    spr.blendMode = blendMode;
+
+    const TexData &texData = initTexture(texture, spr.textureHash);
+    spr.textureIndex = texData.bindlessIndex;
+
+    rendererData.sortEntries[spriteIdx] = { makeSortKey(layer, blendMode, depth, texData.sortId), spriteIdx };
 }
 
 void Renderer2D::renderSprite(const Sprite &sprite) {
     BZ_PROFILE_FUNCTION();
 
-    renderQuad(sprite.position, sprite.dimensions, sprite.rotationDeg, sprite.texture, sprite.tintAndAlpha);
+    addSprite(sprite.position, sprite.dimensions, sprite.rotationDeg, sprite.texture, sprite.texCoordRect,
+              sprite.tintAndAlpha, sprite.layer, sprite.depth, sprite.blendMode);
 }
 
 void Renderer2D::renderQuad(const glm::vec2 &position, const glm::vec2 &dimensions, float rotationDeg,
                             const glm::vec4 &colorAndAlpha) {
     BZ_PROFILE_FUNCTION();
 
-    renderQuad(position, dimensions, rotationDeg, rendererData.whiteTexture, colorAndAlpha);
+    addSprite(position, dimensions, rotationDeg, rendererData.whiteTexture, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+              colorAndAlpha, 0, 0.0f, SpriteBlendMode::Alpha);
 }
 
 void Renderer2D::renderQuad(const glm::vec2 &position, const glm::vec2 &dimensions, float rotationDeg,
                             const Ref<Texture2D> &texture, const glm::vec4 &tintAndAlpha) {
     BZ_PROFILE_FUNCTION();
 
-    BZ_ASSERT_CORE(rendererData.nextSprite < MAX_RENDERER2D_SPRITES, "nextSprite exceeded MAX_RENDERER2D_SPRITES!");
+    addSprite(position, dimensions, rotationDeg, texture, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), tintAndAlpha, 0, 0.0f,
+              SpriteBlendMode::Alpha);
+}
 
-    InternalSprite &spr = rendererData.sprites[rendererData.nextSprite++];
-    spr.position = position;
-    spr.dimensions = dimensions;
-    spr.rotationDeg = rotationDeg;
-    spr.textureHash = initTexture(texture);
-    spr.tintAndAlpha = tintAndAlpha;
+void Renderer2D::renderQuad(const glm::vec2 &position, const glm::vec2 &dimensions, float rotationDeg,
+                            const Ref<Texture2D> &texture, const glm::vec4 &texCoordRect,
+                            const glm::vec4 &tintAndAlpha) {
+    BZ_PROFILE_FUNCTION();
 
-    // Sort by Texture and then by tint
-    // std::hash<double> hasher;
-    // size_t tintHash =
-    // Utils::hashCombine(Utils::hashCombine(Utils::hashCombine(hasher(tintAndAlpha.r),
-    // hasher(tintAndAlpha.g)), hasher(tintAndAlpha.b)), hasher(tintAndAlpha.a)); spr.sortKey =
-    // (spr.textureHash << 32) | (tintHash >> 32);
-    spr.sortKey = spr.textureHash;
+    addSprite(position, dimensions, rotationDeg, texture, texCoordRect, tintAndAlpha, 0, 0.0f, SpriteBlendMode::Alpha);
 }
 
 void Renderer2D::renderParticleSystem2D(const ParticleSystem2D &particleSystem) {
     BZ_PROFILE_FUNCTION();
 
     for (const auto &emitter : particleSystem.getEmitters()) {
-        for (const auto &particle : emitter.getActiveParticles()) {
-            renderQuad(particle.position, particle.dimensions, particle.rotationDeg, emitter.texture,
-                       particle.tintAndAlpha);
+        const ParticleBlockList2D &particles = emitter.getActiveParticles();
+        for (uint32 i = 0; i < particles.getCount(); ++i) {
+            const Particle2D &particle = particles[i];
+            addSprite(particle.position, particle.dimensions, particle.rotationDeg, emitter.texture,
+                      emitter.texCoordRect, particle.tintAndAlpha, emitter.layer, 0.0f, emitter.blendMode);
         }
     }
+
+    // Sorted like the first particle of an Emitter2D would be, before the sprites submitted after it.
+    for (const auto &gpuEmitter : particleSystem.getGpuEmitters()) {
+        uint64 textureHash;
+        const TexData &texData = initTexture(gpuEmitter->texture, textureHash);
+        const uint64 sortKey = makeSortKey(gpuEmitter->layer, gpuEmitter->blendMode, 0.0f, texData.sortId);
+        rendererData.gpuEmitters.push_back({ { sortKey, rendererData.nextSprite }, gpuEmitter.get() });
+    }
 }
 
-void Renderer2D::render(const Ref<RenderPass> &finalRenderPass, const Ref<Framebuffer> &finalFramebuffer,
-                        bool waitForImageAvailable, bool signalFrameEnd) {
+void Renderer2D::renderSpriteGrid(const SpriteGrid &spriteGrid) {
     BZ_PROFILE_FUNCTION();
 
-    rendererData.stats.spriteCount = rendererData.nextSprite;
-
-    if (rendererData.nextSprite > 0) {
-        CommandBuffer &commandBuffer = CommandBuffer::getAndBegin(QueueProperty::Graphics);
-        BZ_CB_BEGIN_DEBUG_LABEL(commandBuffer, "Renderer2D");
-
-        // Wait for the memcpyied index/vertex data to be available before doing actual rendering.
-        commandBuffer.pipelineBarrierMemory(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
-                                            VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    const glm::uvec4 cellRange = rendererData.cullingEnabled
+                                     ? spriteGrid.getCellRange(rendererData.viewRect)
+                                     : glm::uvec4(glm::uvec2(0), spriteGrid.getCellCount());
+
+    uint32 visitedSpriteCount = 0;
+    for (uint32 y = cellRange.y; y < cellRange.w; ++y) {
+        for (uint32 x = cellRange.x; x < cellRange.z; ++x) {
+            const std::vector<Sprite> &cell = spriteGrid.getCell(x, y);
+            for (const Sprite &sprite : cell) {
+                addSprite(sprite.position, sprite.dimensions, sprite.rotationDeg, sprite.texture, sprite.texCoordRect,
+                          sprite.tintAndAlpha, sprite.layer, sprite.depth, sprite.blendMode);
+            }
+            visitedSpriteCount += static_cast<uint32>(cell.size());
+        }
+    }
 
-        commandBuffer.beginRenderPass(finalRenderPass, finalFramebuffer);
+    rendererData.stats.culledSpriteCount += spriteGrid.getSpriteCount() - visitedSpriteCount;
+}
 
-        glm::mat4 viewProjMatrix = rendererData.camera->getProjectionMatrix() * rendererData.camera->getViewMatrix();
-        memcpy(rendererData.constantBufferPtr, &viewProjMatrix[0][0], sizeof(glm::mat4));
-        commandBuffer.bindDescriptorSet(*rendererData.constantsDescriptorSet, rendererData.pipelineLayout, 0, nullptr,
-                                        0);
+static void generateVertices(uint32 begin, uint32 end) {
+    Renderer2DVertex *vertices =
+        reinterpret_cast<Renderer2DVertex *>(static_cast<byte *>(rendererData.vertexBufferPtr));
+    Renderer2DVertices::generate(rendererData.sprites, rendererData.sortEntries, begin, end, vertices);
+}
 
-        commandBuffer.bindBuffer(rendererData.vertexBuffer, 0);
-        commandBuffer.bindBuffer(rendererData.indexBuffer, 0);
-        commandBuffer.bindPipelineState(rendererData.pipelineState);
-
-        uint32 spritesInBatch = 0;
-        uint32 nextBatchOffset = 0;
-        uint64 currentBoundTexHash = -1;
-        // glm::vec4 currentActiveTint = glm::vec4(-1.0f);
-        uint64 currentBatchTexHash = rendererData.sprites[0].textureHash;
-        // glm::vec4 currentBatchTint = rendererData.sprites[0].tintAndAlpha;
-
-        // Generate vertex and index buffers and record commands
-        for (uint32 objIdx = 0; objIdx <= rendererData.nextSprite; ++objIdx) {
-            const InternalSprite &spr = rendererData.sprites[objIdx];
-
-            // We iterate past last object to finish the current batch on that case.
-            bool isLastIteration = objIdx == rendererData.nextSprite;
-
-            if (!isLastIteration) {
-                // Buffer generation
-                float c = glm::cos(glm::radians(spr.rotationDeg));
-                float s = glm::sin(glm::radians(spr.rotationDeg));
-
-                VertexData vertices[4];
-                uint32 indices[6];
-                uint32 packedColor = Utils::packColor(spr.tintAndAlpha);
-                for (int i = 0; i < 4; ++i) {
-                    vertices[i].pos[0] = quadVertices[i].pos[0] * spr.dimensions.x * c +
-                                         quadVertices[i].pos[1] * spr.dimensions.y * -s + spr.position.x;
-                    vertices[i].pos[1] = quadVertices[i].pos[0] * spr.dimensions.x * s +
-                                         quadVertices[i].pos[1] * spr.dimensions.y * c + spr.position.y;
-                    vertices[i].texCoord[0] = quadVertices[i].texCoord[0];
-                    vertices[i].texCoord[1] = quadVertices[i].texCoord[1];
-                    vertices[i].colorAndAlpha = packedColor;
-                }
+// GpuEmitter2Ds go before the sprites with a larger key, or with the same key and submitted after them.
+static bool isGpuEmitterBefore(const GpuEmitterEntry &gpuEmitter, const Utils::SortKeyIndex &spriteEntry) {
+    return gpuEmitter.sortEntry.key < spriteEntry.key ||
+           (gpuEmitter.sortEntry.key == spriteEntry.key && gpuEmitter.sortEntry.index <= spriteEntry.index);
+}
 
-                for (int i = 0; i < 6; ++i) {
-                    indices[i] = quadIndices[i] + (objIdx * 4);
+void Renderer2D::renderSprites(CommandBuffer &commandBuffer) {
+    commandBuffer.bindBuffer(rendererData.vertexBuffer, 0);
+    commandBuffer.bindBuffer(rendererData.indexBuffer, 0);
+
+    uint32 spritesInBatch = 0;
+    uint32 nextBatchOffset = 0;
+    uint32 nextGpuEmitter = 0;
+    uint64 currentBoundTexHash = -1;
+    const PipelineState *currentBoundPipelineState = nullptr;
+    // glm::vec4 currentActiveTint = glm::vec4(-1.0f);
+    const Renderer2DSprite &firstSpr = rendererData.sprites[rendererData.sortEntries[0].index];
+    uint64 currentBatchTexHash = firstSpr.textureHash;
+    SpriteBlendMode currentBatchBlendMode = firstSpr.blendMode;
+    // glm::vec4 currentBatchTint = rendererData.sprites[0].tintAndAlpha;
+
+    // Batches are found serially, the vertices were already generated on the sorted order.
+    for (uint32 objIdx = 0; objIdx <= rendererData.nextSprite; ++objIdx) {
+        const Utils::SortKeyIndex &sortEntry = rendererData.sortEntries[objIdx];
+        const Renderer2DSprite &spr = rendererData.sprites[sortEntry.index];
+
+        // We iterate past last object to finish the current batch on that case.
+        bool isLastIteration = objIdx == rendererData.nextSprite;
+
+        // Command recording
+        bool texChanged = !rendererData.bindless && currentBatchTexHash != spr.textureHash;
+        bool blendModeChanged = currentBatchBlendMode != spr.blendMode;
+        // bool tintChanged = currentBatchTint != spr.tintAndAlpha;
+
+        // The remaining GpuEmitter2Ds go after the last sprite.
+        bool gpuEmitterPending = nextGpuEmitter < rendererData.gpuEmitters.size() &&
+                                 (isLastIteration ||
+                                  isGpuEmitterBefore(rendererData.gpuEmitters[nextGpuEmitter], sortEntry));
+
+        // Batch finishes on these cases. Issue draw call.
+        if (texChanged || blendModeChanged || isLastIteration || gpuEmitterPending) {
+            if (spritesInBatch > 0) {
+                const Ref<PipelineState> &pipelineState =
+                    rendererData.pipelineStates[static_cast<uint32>(currentBatchBlendMode)];
+                if (currentBoundPipelineState != pipelineState.get()) {
+                    commandBuffer.bindPipelineState(pipelineState);
+                    currentBoundPipelineState = pipelineState.get();
+                    rendererData.stats.pipelineBindCount++;
                 }
 
-                uint32 offset = objIdx * sizeof(vertices);
-                memcpy(rendererData.vertexBufferPtr + offset, &vertices, sizeof(vertices));
-
-                offset = objIdx * sizeof(indices);
-                memcpy(rendererData.indexBufferPtr + offset, &indices, sizeof(indices));
-            }
-
-            // Command recording
-            bool texChanged = currentBatchTexHash != spr.textureHash;
-            // bool tintChanged = currentBatchTint != spr.tintAndAlpha;
-
-            // Batch finishes on these cases. Issue draw call.
-            if (texChanged || isLastIteration) {
-                if (currentBoundTexHash != currentBatchTexHash) {
+                if (!rendererData.bindless && currentBoundTexHash != currentBatchTexHash) {
                     const TexData &texData = rendererData.texDataStorage[currentBatchTexHash];
-                    commandBuffer.bindDescriptorSet(*texData.descriptorSet, rendererData.pipelineLayout, 1, nullptr, 0);
+                    commandBuffer.bindDescriptorSet(*texData.descriptorSet, rendererData.pipelineLayout, 1, nullptr,
+                                                    0);
                     currentBoundTexHash = currentBatchTexHash;
                     rendererData.stats.descriptorSetBindCount++;
                 }
@@ -358,17 +625,212 @@ void Renderer2D::render(const Ref<RenderPass> &finalRenderPass, const Ref<Frameb
                 //}
 
                 commandBuffer.drawIndexed(spritesInBatch * 6, 1, nextBatchOffset * 6, 0, 0);
-                nextBatchOffset = objIdx;
-                spritesInBatch = 0;
+                rendererData.stats.drawCallCount++;
+            }
+            nextBatchOffset = objIdx;
+            spritesInBatch = 0;
 
-                currentBatchTexHash = spr.textureHash;
-                // currentBatchTint = spr.tintAndAlpha;
+            currentBatchTexHash = spr.textureHash;
+            currentBatchBlendMode = spr.blendMode;
+            // currentBatchTint = spr.tintAndAlpha;
+        }
 
-                rendererData.stats.drawCallCount++;
+        if (gpuEmitterPending) {
+            BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "GPU Particles");
+            while (nextGpuEmitter < rendererData.gpuEmitters.size() &&
+                   (isLastIteration || isGpuEmitterBefore(rendererData.gpuEmitters[nextGpuEmitter], sortEntry))) {
+                renderGpuEmitter(commandBuffer, *rendererData.gpuEmitters[nextGpuEmitter++].emitter);
             }
-            spritesInBatch++;
+
+            // The GpuEmitter2Ds bind their own pipelines and textures.
+            currentBoundPipelineState = nullptr;
+            currentBoundTexHash = -1;
+        }
+        spritesInBatch++;
+    }
+}
+
+static void initGpuEmitterResources(GpuEmitter2D &emitter) {
+    const uint32 maxParticles = emitter.getMaxParticles();
+
+    emitter.particlesBuffer =
+        Buffer::create(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, GPU_PARTICLE_SIZE * maxParticles, MemoryType::GpuOnly);
+    emitter.aliveListsBuffer =
+        Buffer::create(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 2 * sizeof(uint32) * maxParticles, MemoryType::GpuOnly);
+    emitter.deadListBuffer =
+        Buffer::create(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(uint32) * maxParticles, MemoryType::GpuOnly);
+    emitter.countersBuffer =
+        Buffer::create(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                       GPU_PARTICLE_COUNTERS_SIZE, MemoryType::GpuOnly);
+    emitter.dataBuffer = Buffer::create(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                        GraphicsContext::MIN_UNIFORM_BUFFER_OFFSET_ALIGN, MemoryType::CpuToGpu);
+    BZ_SET_BUFFER_DEBUG_NAME(emitter.particlesBuffer, "GpuEmitter2D Particles Buffer");
+    BZ_SET_BUFFER_DEBUG_NAME(emitter.aliveListsBuffer, "GpuEmitter2D Alive Lists Buffer");
+    BZ_SET_BUFFER_DEBUG_NAME(emitter.deadListBuffer, "GpuEmitter2D Dead List Buffer");
+    BZ_SET_BUFFER_DEBUG_NAME(emitter.countersBuffer, "GpuEmitter2D Counters Buffer");
+    BZ_SET_BUFFER_DEBUG_NAME(emitter.dataBuffer, "GpuEmitter2D Data Buffer");
+
+    emitter.descriptorSet = &DescriptorSet::get(rendererData.gpuParticlesDescriptorSetLayout);
+    emitter.descriptorSet->setConstantBuffer(emitter.dataBuffer, 0, 0, sizeof(GpuEmitterData));
+    emitter.descriptorSet->setStorageBuffer(emitter.particlesBuffer, 1, 0, GPU_PARTICLE_SIZE * maxParticles);
+    emitter.descriptorSet->setStorageBuffer(emitter.aliveListsBuffer, 2, 0, 2 * sizeof(uint32) * maxParticles);
+    emitter.descriptorSet->setStorageBuffer(emitter.deadListBuffer, 3, 0, sizeof(uint32) * maxParticles);
+    emitter.descriptorSet->setStorageBuffer(emitter.countersBuffer, 4, 0, GPU_PARTICLE_COUNTERS_SIZE);
+
+    // Everything is initialized by the first step.
+    emitter.resetPending = true;
+}
+
+static uint32 getGpuParticlesGroupCount(uint32 count) {
+    return (count + GPU_PARTICLES_GROUP_SIZE - 1) / GPU_PARTICLES_GROUP_SIZE;
+}
+
+void Renderer2D::simulateGpuEmitters(CommandBuffer &commandBuffer) {
+    for (const GpuEmitterEntry &entry : rendererData.gpuEmitters) {
+        GpuEmitter2D *emitter = entry.emitter;
+        if (!emitter->descriptorSet) {
+            initGpuEmitterResources(*emitter);
+        }
+
+        uint64 textureHash;
+        const TexData &texData = initTexture(emitter->texture, textureHash);
+
+        const Particle2DRanges &ranges = emitter->ranges;
+        const uint32 emitCount = emitter->pendingEmitCount;
+        const bool reset = emitter->resetPending;
+
+        GpuEmitterData data;
+        data.positionRange = glm::vec4(ranges.positionRange.min, ranges.positionRange.max);
+        data.dimensionRange = glm::vec4(ranges.dimensionRange.min, ranges.dimensionRange.max);
+        data.velocityRange = glm::vec4(ranges.velocityRange.min, ranges.velocityRange.max);
+        data.accelerationRange = glm::vec4(ranges.accelerationRange.min, ranges.accelerationRange.max);
+        data.rotationAndLifeRange = glm::vec4(ranges.rotationRange.min, ranges.rotationRange.max,
+                                              ranges.lifeSecsRange.min, ranges.lifeSecsRange.max);
+        data.angularVelocityRange =
+            glm::vec4(ranges.angularVelocityRange.min, ranges.angularVelocityRange.max, 0.0f, 0.0f);
+        data.tintAndAlphaMin = ranges.tintAndAlphaRange.min;
+        data.tintAndAlphaMax = ranges.tintAndAlphaRange.max;
+        data.texCoordRect = emitter->texCoordRect;
+        data.emitterPosition = emitter->parent.getPosition() + emitter->positionOffset;
+        data.deltaSecs = emitter->pendingDeltaSecs;
+        data.emitCount = emitCount;
+        data.maxParticles = emitter->getMaxParticles();
+        data.seed = emitter->randomSeed;
+        data.currentAliveListOffset = emitter->currentAliveList * emitter->getMaxParticles();
+        data.nextAliveListOffset = (1 - emitter->currentAliveList) * emitter->getMaxParticles();
+        data.textureIndex = texData.bindlessIndex;
+        data.reset = reset ? 1 : 0;
+        memcpy(emitter->dataBuffer->map(0), &data, sizeof(GpuEmitterData));
+        emitter->dataBuffer->unmap();
+
+        // Only steps that emit take a seed, as on Emitter2D.
+        if (emitCount > 0) {
+            emitter->randomSeed++;
+        }
+        emitter->pendingDeltaSecs = 0.0f;
+        emitter->pendingEmitCount = 0;
+        emitter->resetPending = false;
+        emitter->currentAliveList = 1 - emitter->currentAliveList;
+
+        commandBuffer.transitionBuffer(emitter->deadListBuffer, ResourceUsage::ComputeShaderReadWrite);
+        commandBuffer.transitionBuffer(emitter->countersBuffer, ResourceUsage::ComputeShaderReadWrite);
+        commandBuffer.bindPipelineState(rendererData.gpuParticlesPreparePipelineState);
+        commandBuffer.bindDescriptorSet(*emitter->descriptorSet, rendererData.gpuParticlesComputePipelineLayout, 0,
+                                        nullptr, 0, VK_PIPELINE_BIND_POINT_COMPUTE);
+        commandBuffer.dispatch(reset ? getGpuParticlesGroupCount(emitter->getMaxParticles()) : 1, 1, 1);
+
+        // Reset leaves no particles to simulate.
+        if (!reset) {
+            commandBuffer.transitionBuffer(emitter->particlesBuffer, ResourceUsage::ComputeShaderReadWrite);
+            commandBuffer.transitionBuffer(emitter->aliveListsBuffer, ResourceUsage::ComputeShaderReadWrite);
+            commandBuffer.transitionBuffer(emitter->deadListBuffer, ResourceUsage::ComputeShaderReadWrite);
+            commandBuffer.transitionBuffer(emitter->countersBuffer, ResourceUsage::ComputeShaderReadWrite);
+            commandBuffer.bindPipelineState(rendererData.gpuParticlesSimulatePipelineState);
+            commandBuffer.dispatch(getGpuParticlesGroupCount(emitter->getMaxParticles()), 1, 1);
+        }
+
+        if (emitCount > 0) {
+            commandBuffer.transitionBuffer(emitter->particlesBuffer, ResourceUsage::ComputeShaderReadWrite);
+            commandBuffer.transitionBuffer(emitter->aliveListsBuffer, ResourceUsage::ComputeShaderReadWrite);
+            commandBuffer.transitionBuffer(emitter->deadListBuffer, ResourceUsage::ComputeShaderReadWrite);
+            commandBuffer.transitionBuffer(emitter->countersBuffer, ResourceUsage::ComputeShaderReadWrite);
+            commandBuffer.bindPipelineState(rendererData.gpuParticlesEmitPipelineState);
+            commandBuffer.dispatch(getGpuParticlesGroupCount(emitCount), 1, 1);
+        }
+
+        commandBuffer.transitionBuffer(emitter->particlesBuffer, ResourceUsage::VertexShaderRead);
+        commandBuffer.transitionBuffer(emitter->aliveListsBuffer, ResourceUsage::VertexShaderRead);
+        commandBuffer.transitionBuffer(emitter->countersBuffer, ResourceUsage::IndirectBuffer);
+    }
+}
+
+void Renderer2D::renderGpuEmitter(CommandBuffer &commandBuffer, const GpuEmitter2D &emitter) {
+    commandBuffer.bindPipelineState(rendererData.gpuParticlesPipelineStates[static_cast<uint32>(emitter.blendMode)]);
+    rendererData.stats.pipelineBindCount++;
+
+    if (!rendererData.bindless) {
+        uint64 textureHash;
+        const TexData &texData = initTexture(emitter.texture, textureHash);
+        commandBuffer.bindDescriptorSet(*texData.descriptorSet, rendererData.gpuParticlesPipelineLayout, 1, nullptr,
+                                        0);
+        rendererData.stats.descriptorSetBindCount++;
+    }
+    commandBuffer.bindDescriptorSet(*emitter.descriptorSet, rendererData.gpuParticlesPipelineLayout, 2, nullptr, 0);
+    rendererData.stats.descriptorSetBindCount++;
+
+    // The instance count is the number of alive particles, only known by the GPU.
+    commandBuffer.drawIndirect(emitter.countersBuffer, 0, 1, sizeof(VkDrawIndirectCommand));
+    rendererData.stats.drawCallCount++;
+}
+
+void Renderer2D::render(const Ref<RenderPass> &finalRenderPass, const Ref<Framebuffer> &finalFramebuffer,
+                        bool waitForImageAvailable, bool signalFrameEnd) {
+    BZ_PROFILE_FUNCTION();
+
+    rendererData.stats.spriteCount = rendererData.nextSprite;
+    rendererData.stats.gpuEmitterCount = static_cast<uint32>(rendererData.gpuEmitters.size());
+
+    if (rendererData.nextSprite > 0 || !rendererData.gpuEmitters.empty()) {
+        if (rendererData.nextSprite > 0) {
+            // Each job writes the vertices of a contiguous range of sorted sprites, which is a disjoint range of the
+            // mapped vertex buffer.
+            Timer vertexTimer;
+            vertexTimer.start();
+            Engine::get().getJobSystem().parallelFor(rendererData.nextSprite, Renderer2DVertices::SPRITES_PER_JOB,
+                                                     generateVertices);
+            rendererData.stats.vertexGenerationTime = vertexTimer.getCountedTime();
         }
 
+        CommandBuffer &commandBuffer = CommandBuffer::getAndBegin(QueueProperty::Graphics);
+        BZ_CB_BEGIN_DEBUG_LABEL(commandBuffer, "Renderer2D");
+
+        // Compute work needs to happen outside of the RenderPass.
+        if (!rendererData.gpuEmitters.empty()) {
+            BZ_CB_INSERT_DEBUG_LABEL(commandBuffer, "GPU Particles Simulation");
+            simulateGpuEmitters(commandBuffer);
+        }
+
+        // The memcpyied vertex data is made visible by the submission itself and the indices were uploaded on init, so
+        // these are skipped unless the buffers were written on the GPU.
+        commandBuffer.transitionBuffer(rendererData.vertexBuffer, ResourceUsage::VertexBuffer);
+        commandBuffer.transitionBuffer(rendererData.indexBuffer, ResourceUsage::IndexBuffer);
+
+        commandBuffer.beginRenderPass(finalRenderPass, finalFramebuffer);
+
+        glm::mat4 viewProjMatrix = rendererData.camera->getProjectionMatrix() * rendererData.camera->getViewMatrix();
+        memcpy(rendererData.constantBufferPtr, &viewProjMatrix[0][0], sizeof(glm::mat4));
+        commandBuffer.bindDescriptorSet(*rendererData.constantsDescriptorSet, rendererData.pipelineLayout, 0, nullptr,
+                                        0);
+
+        if (rendererData.bindless) {
+            commandBuffer.bindDescriptorSet(BZ_GRAPHICS_CTX.getBindlessTextureTable().getDescriptorSet(),
+                                            rendererData.pipelineLayout, 1, nullptr, 0);
+            rendererData.stats.descriptorSetBindCount++;
+        }
+
+        renderSprites(commandBuffer);
+        rendererData.gpuEmitters.clear();
+
         commandBuffer.endRenderPass();
         BZ_CB_END_DEBUG_LABEL(commandBuffer);
         commandBuffer.endAndSubmit(waitForImageAvailable, signalFrameEnd);
@@ -394,11 +856,26 @@ void Renderer2D::onImGuiRender(const FrameTiming &frameTiming) {
         }
         ImGui::Text("Stats:");
         ImGui::Text("Sprite Count: %d.", rendererData.visibleStats.spriteCount);
+        ImGui::Text("Culled Sprite Count: %d.", rendererData.visibleStats.culledSpriteCount);
         ImGui::Text("Draw Call Count: %d.", rendererData.visibleStats.drawCallCount);
         ImGui::Text("Descriptor Set Bind Count: %d.", rendererData.visibleStats.descriptorSetBindCount);
+        ImGui::Text("Pipeline Bind Count: %d.", rendererData.visibleStats.pipelineBindCount);
+        ImGui::Text("Sort Time: %.3f ms.", rendererData.visibleStats.sortTime.asMillisecondsFloat());
+        ImGui::Text("Vertex Generation Time: %.3f ms.",
+                    rendererData.visibleStats.vertexGenerationTime.asMillisecondsFloat());
+        ImGui::Text("Worker Thread Count: %d.", Engine::get().getJobSystem().getWorkerCount());
+        ImGui::Text("GPU Emitter Count: %d.", rendererData.visibleStats.gpuEmitterCount);
+
+        const ParticlePool2D &particlePool = Engine::get().getParticlePool2D();
+        ImGui::Text("Particle Pool Blocks: %d/%d.", particlePool.getBlockCount() - particlePool.getFreeBlockCount(),
+                    particlePool.getBlockCount());
+        ImGui::Text("Culled Particle Count: %llu.", particlePool.getCulledParticleCount());
         // ImGui::Text("Tint Push Count: %d", visibleFrameStats.tintPushCount);
         ImGui::Separator();
 
+        ImGui::Checkbox("Culling", &rendererData.cullingEnabled);
+        ImGui::Separator();
+
         ImGui::Text("Refresh period ms");
         ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.95f);
         ImGui::SliderInt("##slider", reinterpret_cast<int *>(&rendererData.statsRefreshPeriodMs), 0, 1000);
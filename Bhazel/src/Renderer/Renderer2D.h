@@ -4,11 +4,17 @@
 namespace BZ {
 
 class ParticleSystem2D;
+class GpuEmitter2D;
 class OrthographicCamera;
 class Texture2D;
 struct FrameTiming;
 class RenderPass;
 class Framebuffer;
+struct TextureAtlasRegion;
+class SpriteGrid;
+class CommandBuffer;
+
+enum class SpriteBlendMode : uint8 { Alpha, Additive, Count };
 
 struct Sprite {
     glm::vec2 position;
@@ -16,11 +22,21 @@ struct Sprite {
     float rotationDeg;
     glm::vec4 tintAndAlpha;
     Ref<Texture2D> texture;
+
+    // Min UVs on xy, max UVs on zw. A subregion of the texture, usually from a TextureAtlas.
+    glm::vec4 texCoordRect = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+    // Sprites are drawn by ascending layer, then by blend mode and then by descending depth, on [0, 1].
+    uint8 layer = 0;
+    float depth = 0.0f;
+    SpriteBlendMode blendMode = SpriteBlendMode::Alpha;
+
+    void setAtlasRegion(const TextureAtlasRegion &region);
 };
 
 
 /*
- * Batch renderer for 2D geometry.
+ * Batch renderer for 2D geometry. Sprites outside the camera view rectangle are rejected when submitted.
  */
 class Renderer2D {
   public:
@@ -33,9 +49,17 @@ class Renderer2D {
                            const glm::vec4 &colorAndAlpha);
     static void renderQuad(const glm::vec2 &position, const glm::vec2 &dimensions, float rotationDeg,
                            const Ref<Texture2D> &texture, const glm::vec4 &tintAndAlpha);
+    static void renderQuad(const glm::vec2 &position, const glm::vec2 &dimensions, float rotationDeg,
+                           const Ref<Texture2D> &texture, const glm::vec4 &texCoordRect,
+                           const glm::vec4 &tintAndAlpha);
 
+    // GpuEmitter2Ds are simulated on the GPU when rendered. They are sorted with the sprites by layer, blend mode and
+    // texture, and drawn after the sprites of the same key submitted before them.
     static void renderParticleSystem2D(const ParticleSystem2D &particleSystem);
 
+    // Only the Sprites on the grid cells overlapping the view rectangle are considered.
+    static void renderSpriteGrid(const SpriteGrid &spriteGrid);
+
   private:
     friend class RendererCoordinator;
     friend class Engine;
@@ -46,5 +70,9 @@ class Renderer2D {
     static void render(const Ref<RenderPass> &finalRenderPass, const Ref<Framebuffer> &finalFramebuffer,
                        bool waitForImageAvailable, bool signalFrameEnd);
     static void onImGuiRender(const FrameTiming &frameTiming);
+
+    static void simulateGpuEmitters(CommandBuffer &commandBuffer);
+    static void renderSprites(CommandBuffer &commandBuffer);
+    static void renderGpuEmitter(CommandBuffer &commandBuffer, const GpuEmitter2D &emitter);
 };
 }
@@ -0,0 +1,129 @@
+#include "bzpch.h"
+
+#include "Renderer2DVertices.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BZ_VERTICES_SSE
+#endif
+
+
+namespace BZ::Renderer2DVertices {
+
+constexpr uint16 UINT16_MAX_VALUE = 0xffff;
+static const Renderer2DVertex quadVertices[4] = { { { -0.5f, -0.5f }, { 0, 0 }, 0, 0 },
+                                                  { { 0.5f, -0.5f }, { UINT16_MAX_VALUE, 0 }, 0, 0 },
+                                                  { { 0.5f, 0.5f }, { UINT16_MAX_VALUE, UINT16_MAX_VALUE }, 0, 0 },
+                                                  { { -0.5f, 0.5f }, { 0, UINT16_MAX_VALUE }, 0, 0 } };
+
+// Sprites whose rotations are converted at once, small enough to live on the stack.
+constexpr uint32 GROUP_SIZE = 64;
+
+constexpr float DEGREES_TO_RADIANS = glm::pi<float>() / 180.0f;
+
+// Minimax polynomials on [-pi/4, pi/4], the angle is first reduced to the nearest multiple of 90 degrees.
+constexpr float SIN_C1 = -1.6666654611e-1f;
+constexpr float SIN_C2 = 8.3321608736e-3f;
+constexpr float SIN_C3 = -1.9515295891e-4f;
+constexpr float COS_C1 = -0.5f;
+constexpr float COS_C2 = 4.166664568298827e-2f;
+constexpr float COS_C3 = -1.388731625493765e-3f;
+constexpr float COS_C4 = 2.443315711809948e-5f;
+
+static void sinCosDegrees(float degrees, float &outSin, float &outCos) {
+    const float quadrantFloat = std::nearbyint(degrees * (1.0f / 90.0f));
+    const int32 quadrant = static_cast<int32>(quadrantFloat);
+    const float x = (degrees - quadrantFloat * 90.0f) * DEGREES_TO_RADIANS;
+    const float x2 = x * x;
+    const float sinX = x * (1.0f + x2 * (SIN_C1 + x2 * (SIN_C2 + x2 * SIN_C3)));
+    const float cosX = 1.0f + x2 * (COS_C1 + x2 * (COS_C2 + x2 * (COS_C3 + x2 * COS_C4)));
+
+    // Odd quadrants swap sine and cosine, and the sign follows the quadrant.
+    const bool swap = (quadrant & 1) != 0;
+    const float sinValue = swap ? cosX : sinX;
+    const float cosValue = swap ? sinX : cosX;
+    outSin = (quadrant & 2) ? -sinValue : sinValue;
+    outCos = ((quadrant + 1) & 2) ? -cosValue : cosValue;
+}
+
+void sinCosDegrees(const float degrees[], uint32 count, float outSines[], float outCosines[]) {
+    uint32 i = 0;
+#ifdef BZ_VERTICES_SSE
+    // Same math as the scalar version. The conversion rounds to nearest even, as std::nearbyint does.
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 angles = _mm_loadu_ps(&degrees[i]);
+        const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(angles, _mm_set1_ps(1.0f / 90.0f)));
+        const __m128 quadrantFloat = _mm_cvtepi32_ps(quadrant);
+        const __m128 x = _mm_mul_ps(_mm_sub_ps(angles, _mm_mul_ps(quadrantFloat, _mm_set1_ps(90.0f))),
+                                    _mm_set1_ps(DEGREES_TO_RADIANS));
+        const __m128 x2 = _mm_mul_ps(x, x);
+
+        __m128 sinX = _mm_add_ps(_mm_set1_ps(SIN_C2), _mm_mul_ps(x2, _mm_set1_ps(SIN_C3)));
+        sinX = _mm_add_ps(_mm_set1_ps(SIN_C1), _mm_mul_ps(x2, sinX));
+        sinX = _mm_mul_ps(x, _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, sinX)));
+
+        __m128 cosX = _mm_add_ps(_mm_set1_ps(COS_C3), _mm_mul_ps(x2, _mm_set1_ps(COS_C4)));
+        cosX = _mm_add_ps(_mm_set1_ps(COS_C2), _mm_mul_ps(x2, cosX));
+        cosX = _mm_add_ps(_mm_set1_ps(COS_C1), _mm_mul_ps(x2, cosX));
+        cosX = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, cosX));
+
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+        const __m128 sinValue = _mm_or_ps(_mm_and_ps(swap, cosX), _mm_andnot_ps(swap, sinX));
+        const __m128 cosValue = _mm_or_ps(_mm_and_ps(swap, sinX), _mm_andnot_ps(swap, cosX));
+
+        // Bit 1 of the quadrant moved to the sign bit.
+        const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+        const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+        _mm_storeu_ps(&outSines[i], _mm_xor_ps(sinValue, sinSign));
+        _mm_storeu_ps(&outCosines[i], _mm_xor_ps(cosValue, cosSign));
+    }
+#endif
+    for (; i < count; ++i) {
+        sinCosDegrees(degrees[i], outSines[i], outCosines[i]);
+    }
+}
+
+void generate(const Renderer2DSprite sprites[], const Utils::SortKeyIndex sortedEntries[], uint32 begin, uint32 end,
+              Renderer2DVertex outVertices[]) {
+    float rotations[GROUP_SIZE];
+    float sines[GROUP_SIZE];
+    float cosines[GROUP_SIZE];
+
+    for (uint32 groupBegin = begin; groupBegin < end; groupBegin += GROUP_SIZE) {
+        const uint32 groupCount = glm::min(end - groupBegin, GROUP_SIZE);
+
+        // Unrotated sprites go through too, it's cheaper than branching and the result is exact.
+        for (uint32 i = 0; i < groupCount; ++i) {
+            rotations[i] = sprites[sortedEntries[groupBegin + i].index].rotationDeg;
+        }
+        sinCosDegrees(rotations, groupCount, sines, cosines);
+
+        for (uint32 i = 0; i < groupCount; ++i) {
+            const uint32 objIdx = groupBegin + i;
+            const Renderer2DSprite &spr = sprites[sortedEntries[objIdx].index];
+
+            const glm::vec2 axisX = glm::vec2(cosines[i], sines[i]) * spr.dimensions.x;
+            const glm::vec2 axisY = glm::vec2(-sines[i], cosines[i]) * spr.dimensions.y;
+            const uint32 packedColor = Utils::packColor(spr.tintAndAlpha);
+            // Offset by half, so the truncation below rounds to the nearest.
+            const glm::vec4 texCoordRect = spr.texCoordRect * static_cast<float>(UINT16_MAX_VALUE) + 0.5f;
+
+            Renderer2DVertex *vertices = outVertices + objIdx * 4;
+            for (int v = 0; v < 4; ++v) {
+                vertices[v].pos[0] =
+                    quadVertices[v].pos[0] * axisX.x + quadVertices[v].pos[1] * axisY.x + spr.position.x;
+                vertices[v].pos[1] =
+                    quadVertices[v].pos[0] * axisX.y + quadVertices[v].pos[1] * axisY.y + spr.position.y;
+                vertices[v].texCoord[0] =
+                    static_cast<uint16>(quadVertices[v].texCoord[0] ? texCoordRect.z : texCoordRect.x);
+                vertices[v].texCoord[1] =
+                    static_cast<uint16>(quadVertices[v].texCoord[1] ? texCoordRect.w : texCoordRect.y);
+                vertices[v].colorAndAlpha = packedColor;
+                vertices[v].textureIndex = spr.textureIndex;
+            }
+        }
+    }
+}
+}
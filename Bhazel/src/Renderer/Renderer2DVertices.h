@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Core/Utils.h"
+#include "Renderer/Renderer2D.h"
+
+
+namespace BZ {
+
+struct Renderer2DVertex {
+    float pos[2];
+    uint16 texCoord[2];
+    uint32 colorAndAlpha;
+    uint32 textureIndex; // Only used on bindless mode.
+};
+
+struct Renderer2DSprite {
+    glm::vec2 position;
+    glm::vec2 dimensions;
+    float rotationDeg;
+    glm::vec4 tintAndAlpha;
+    glm::vec4 texCoordRect;
+    SpriteBlendMode blendMode;
+    uint64 textureHash;
+    uint32 textureIndex;
+};
+
+/*
+ * Vertex generation of the Renderer2D, apart from it so it can run without an Engine. Each sprite is expanded into the
+ * four corners of its quad. The rotations are turned into sines and cosines a group of sprites at a time, four at once
+ * with SSE when compiled with it, and with the same polynomials on scalar code otherwise.
+ */
+namespace Renderer2DVertices {
+
+    // Minimum amount of sprites processed by each job of a parallelFor.
+    constexpr uint32 SPRITES_PER_JOB = 2048;
+
+    // Writes the vertices of the sprites referenced by sortedEntries on [begin, end), at four times their sorted
+    // position.
+    void generate(const Renderer2DSprite sprites[], const Utils::SortKeyIndex sortedEntries[], uint32 begin,
+                  uint32 end, Renderer2DVertex outVertices[]);
+
+    // Exact for multiples of 90 degrees, and within 1e-6 of std::sin and std::cos otherwise.
+    void sinCosDegrees(const float degrees[], uint32 count, float outSines[], float outCosines[]);
+}
+}
@@ -102,6 +102,9 @@ void RendererCoordinator::initEditorMode() {
     const Ref<Framebuffer> &swapchainFramebuffer = BZ_GRAPHICS_CTX.getSwapchainAquiredImageFramebuffer();
     const glm::uvec3 SWAPCHAIN_DIMS = swapchainFramebuffer->getDimensionsAndLayers();
 
+    offscreenTextureDescriptorSetLayout =
+        DescriptorSetLayout::create({ { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1 } });
+
     for (uint32 i = 0; i < GraphicsContext::MAX_FRAMES_IN_FLIGHT; ++i) {
         auto swapchainReplicaTex =
             Texture2D::createRenderTarget(SWAPCHAIN_DIMS.x, SWAPCHAIN_DIMS.y, 1, 1,
@@ -111,12 +114,6 @@ void RendererCoordinator::initEditorMode() {
 
         offscreenFramebuffers[i] =
             Framebuffer::create(swapchainRenderPass, { swapchainReplicaTexView }, SWAPCHAIN_DIMS);
-
-        Ref<DescriptorSetLayout> descriptorSetLayout = DescriptorSetLayout::create(
-            { { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1 } });
-        offscreenTextureDescriptorSets[i] = &BZ_GRAPHICS_CTX.getDescriptorPool().getDescriptorSet(descriptorSetLayout);
-        offscreenTextureDescriptorSets[i]->setCombinedTextureSampler(swapchainReplicaTexView,
-                                                                     Renderer::getDefaultSampler(), 0);
     }
 
     renderFunction = [this]() {
@@ -194,6 +191,7 @@ void RendererCoordinator::destroy() {
     for (uint32 i = 0; i < GraphicsContext::MAX_FRAMES_IN_FLIGHT; ++i) {
         this->offscreenFramebuffers[i].reset();
     }
+    offscreenTextureDescriptorSetLayout.reset();
 }
 
 void RendererCoordinator::onEvent(Event &e) {
@@ -206,7 +204,10 @@ void RendererCoordinator::render() {
 
 DescriptorSet *RendererCoordinator::getOffscreenTextureDescriptorSet() {
     uint32 currentFrame = BZ_GRAPHICS_CTX.getCurrentFrameIndex();
-    return offscreenTextureDescriptorSets[currentFrame];
+    DescriptorSet &descriptorSet = DescriptorSet::getTransient(offscreenTextureDescriptorSetLayout);
+    descriptorSet.setCombinedTextureSampler(offscreenFramebuffers[currentFrame]->getColorAttachmentTextureView(0),
+                                            Renderer::getDefaultSampler(), 0);
+    return &descriptorSet;
 }
 
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ class RenderPass;
 class Framebuffer;
 class Event;
 class DescriptorSet;
+class DescriptorSetLayout;
 
 
 /*
@@ -29,11 +30,12 @@ class RendererCoordinator {
     void onEvent(Event &ev);
     void render();
 
+    // On editor mode. Transient, valid for the current frame only.
     DescriptorSet *getOffscreenTextureDescriptorSet();
 
   private:
     Ref<Framebuffer> offscreenFramebuffers[GraphicsContext::MAX_FRAMES_IN_FLIGHT];
-    DescriptorSet *offscreenTextureDescriptorSets[GraphicsContext::MAX_FRAMES_IN_FLIGHT];
+    Ref<DescriptorSetLayout> offscreenTextureDescriptorSetLayout;
 
     Ref<RenderPass> firstPass;
     Ref<RenderPass> secondPass;
@@ -10,10 +10,14 @@
 #include "Graphics/RenderPass.h"
 
 #include "Collisions/AABB.h"
+#include "Collisions/TriangleMesh.h"
 
 
 namespace BZ {
 
+// In world units. Dynamic Entities moving less than this don't touch their BVH.
+constexpr float DYNAMIC_BVH_MARGIN = 1.0f;
+
 DirectionalLight::DirectionalLight() {
     shadowMapFramebuffer = Renderer::createShadowMapFramebuffer();
 }
@@ -23,31 +27,204 @@ void DirectionalLight::setDirection(const glm::vec3 &direction) {
 }
 
 
-Entity::Entity(Mesh &mesh, Transform &transform, bool castShadow) :
-    mesh(mesh), transform(transform), castShadow(castShadow) {
+SpotLight::SpotLight() :
+    innerAngle(glm::radians(20.0f)), outerAngle(glm::radians(30.0f)), direction(0.0f, 0.0f, -1.0f) {
+}
+
+void SpotLight::setDirection(const glm::vec3 &direction) {
+    this->direction = glm::normalize(direction);
+}
+
+
+Entity::Entity(Mesh &mesh, TransformHierarchy::NodeId transformNode, bool castShadow) :
+    mesh(mesh), transformNode(transformNode), castShadow(castShadow) {
+}
+
+Entity::Entity(Mesh &mesh, TransformHierarchy::NodeId transformNode, Material &overrideMaterial, bool castShadow) :
+    mesh(mesh), transformNode(transformNode), overrideMaterial(overrideMaterial), castShadow(castShadow) {
 }
 
-Entity::Entity(Mesh &mesh, Transform &transform, Material &overrideMaterial, bool castShadow) :
-    mesh(mesh), transform(transform), overrideMaterial(overrideMaterial), castShadow(castShadow) {
+
+Scene::Scene() : dynamicBVH(DYNAMIC_BVH_MARGIN) {
+    descriptorSet = Renderer::createSceneDescriptorSet();
 }
 
+Scene::Scene(Camera &camera) : camera(&camera), dynamicBVH(DYNAMIC_BVH_MARGIN) {
+    descriptorSet = Renderer::createSceneDescriptorSet();
+}
 
-Scene::Scene() {
-    descriptorSet = &Renderer::createSceneDescriptorSet();
+uint32 Scene::addEntity(Mesh &mesh, Transform &transform, bool castShadow) {
+    BZ_ASSERT_CORE(entities.size() < Renderer::MAX_ENTITIES_PER_SCENE, "Reached the maximum ammount of Entities!");
+    entities.push_back({ mesh, transformHierarchy.addNode(transform), castShadow });
+    return onEntityAdded();
 }
 
-Scene::Scene(Camera &camera) : camera(&camera) {
-    descriptorSet = &Renderer::createSceneDescriptorSet();
+uint32 Scene::addEntity(Mesh &mesh, Transform &transform, Material &overrideMaterial, bool castShadow) {
+    BZ_ASSERT_CORE(entities.size() < Renderer::MAX_ENTITIES_PER_SCENE, "Reached the maximum ammount of Entities!");
+    entities.push_back({ mesh, transformHierarchy.addNode(transform), overrideMaterial, castShadow });
+    return onEntityAdded();
 }
 
-void Scene::addEntity(Mesh &mesh, Transform &transform, bool castShadow) {
+uint32 Scene::addChildEntity(uint32 parentEntity, Mesh &mesh, Transform &transform, bool castShadow) {
     BZ_ASSERT_CORE(entities.size() < Renderer::MAX_ENTITIES_PER_SCENE, "Reached the maximum ammount of Entities!");
-    entities.push_back({ mesh, transform, castShadow });
+    BZ_ASSERT_CORE(parentEntity < entities.size(), "Invalid parent Entity!");
+    const TransformHierarchy::NodeId node = transformHierarchy.addNode(transform, entities[parentEntity].transformNode);
+    entities.push_back({ mesh, node, castShadow });
+    return onEntityAdded();
 }
 
-void Scene::addEntity(Mesh &mesh, Transform &transform, Material &overrideMaterial, bool castShadow) {
+uint32 Scene::addChildEntity(uint32 parentEntity, Mesh &mesh, Transform &transform, Material &overrideMaterial,
+                             bool castShadow) {
     BZ_ASSERT_CORE(entities.size() < Renderer::MAX_ENTITIES_PER_SCENE, "Reached the maximum ammount of Entities!");
-    entities.push_back({ mesh, transform, overrideMaterial, castShadow });
+    BZ_ASSERT_CORE(parentEntity < entities.size(), "Invalid parent Entity!");
+    const TransformHierarchy::NodeId node = transformHierarchy.addNode(transform, entities[parentEntity].transformNode);
+    entities.push_back({ mesh, node, overrideMaterial, castShadow });
+    return onEntityAdded();
+}
+
+uint32 Scene::onEntityAdded() {
+    const uint32 entityIndex = static_cast<uint32>(entities.size() - 1);
+    const TransformHierarchy::NodeId node = entities.back().transformNode;
+    if (node >= transformNodeToEntity.size()) {
+        transformNodeToEntity.resize(node + 1, INVALID_ENTITY);
+    }
+    transformNodeToEntity[node] = entityIndex;
+
+    bvhsDirty = true;
+    return entityIndex;
+}
+
+void Scene::setEntityStatic(uint32 entityIndex, bool isStatic) {
+    BZ_ASSERT_CORE(entityIndex < entities.size(), "Invalid Entity index!");
+
+    entityProxies.resize(entities.size());
+    entityProxies[entityIndex].isStatic = isStatic;
+    bvhsDirty = true;
+}
+
+AABB Scene::getEntityAABB(uint32 entityIndex) const {
+    const Entity &entity = entities[entityIndex];
+    return AABB(entity.mesh.getAABB(), transformHierarchy.getLocalToWorldMatrix(entity.transformNode));
+}
+
+void Scene::queryAABB(const AABB &aabb, const BVH::QueryFn &fn) const {
+    updateBVHs();
+    staticBVH.queryAABB(aabb, fn);
+    dynamicBVH.queryAABB(aabb, fn);
+}
+
+void Scene::querySphere(const BoundingSphere &sphere, const BVH::QueryFn &fn) const {
+    updateBVHs();
+    staticBVH.querySphere(sphere, fn);
+    dynamicBVH.querySphere(sphere, fn);
+}
+
+void Scene::queryFrustum(const Frustum &frustum, const BVH::QueryFn &fn) const {
+    updateBVHs();
+    staticBVH.queryFrustum(frustum, fn);
+    dynamicBVH.queryFrustum(frustum, fn);
+}
+
+void Scene::raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                    const BVH::RaycastFn &fn) const {
+    updateBVHs();
+
+    // Carry the closest hit from one BVH to the other.
+    staticBVH.raycast(origin, direction, maxDistance, [&fn, &maxDistance](uint32 entityIndex, float distance) {
+        maxDistance = fn(entityIndex, distance);
+        return maxDistance;
+    });
+    if (maxDistance > 0.0f) {
+        dynamicBVH.raycast(origin, direction, maxDistance, fn);
+    }
+}
+
+bool Scene::raycastClosest(const Ray &ray, float maxDistance, RaycastHit &outHit) const {
+    BZ_PROFILE_FUNCTION();
+
+    bool hit = false;
+    raycast(ray.getOrigin(), ray.getDirection(), maxDistance, [&](uint32 entityIndex, float currentMaxDistance) {
+        const Entity &entity = entities[entityIndex];
+        const Ref<TriangleMesh> triangleMesh = entity.mesh.getTriangleMesh();
+        if (!triangleMesh) {
+            return currentMaxDistance;
+        }
+
+        // The local Ray keeps the distances of the world one, as the direction is not normalized.
+        const Ray localRay =
+            ray.transformed(glm::inverse(transformHierarchy.getLocalToWorldMatrix(entity.transformNode)));
+
+        float distance;
+        uint32 triangle;
+        if (triangleMesh->raycast(localRay, currentMaxDistance, distance, triangle)) {
+            hit = true;
+            outHit.entityIndex = entityIndex;
+            outHit.triangleIndex = triangle;
+            outHit.distance = distance;
+            return distance;
+        }
+        return currentMaxDistance;
+    });
+
+    if (hit) {
+        outHit.point = ray.getPoint(outHit.distance);
+    }
+    return hit;
+}
+
+void Scene::updateBVHs() const {
+    transformHierarchy.takeChangedNodes(changedTransformNodes);
+    if (!bvhsDirty && changedTransformNodes.empty()) {
+        return;
+    }
+
+    BZ_PROFILE_FUNCTION();
+
+    bool staticBVHChanged = false;
+    if (bvhsDirty) {
+        entityProxies.resize(entities.size());
+        for (uint32 i = 0; i < entities.size(); ++i) {
+            staticBVHChanged |= updateEntityProxy(i);
+        }
+    }
+    else {
+        // Nodes added directly to the TransformHierarchy have no Entity.
+        for (TransformHierarchy::NodeId node : changedTransformNodes) {
+            if (node < transformNodeToEntity.size() && transformNodeToEntity[node] != INVALID_ENTITY) {
+                staticBVHChanged |= updateEntityProxy(transformNodeToEntity[node]);
+            }
+        }
+    }
+
+    if (staticBVHChanged) {
+        staticBVH.rebuild();
+    }
+    bvhsDirty = false;
+}
+
+bool Scene::updateEntityProxy(uint32 entityIndex) const {
+    EntityProxy &entityProxy = entityProxies[entityIndex];
+    const AABB aabb = getEntityAABB(entityIndex);
+    bool staticBVHChanged = false;
+
+    if (entityProxy.proxy != BVH::INVALID_PROXY && entityProxy.onStaticBVH != entityProxy.isStatic) {
+        (entityProxy.onStaticBVH ? staticBVH : dynamicBVH).remove(entityProxy.proxy);
+        entityProxy.proxy = BVH::INVALID_PROXY;
+        staticBVHChanged |= entityProxy.onStaticBVH;
+    }
+
+    if (entityProxy.proxy == BVH::INVALID_PROXY) {
+        entityProxy.onStaticBVH = entityProxy.isStatic;
+        entityProxy.proxy = (entityProxy.isStatic ? staticBVH : dynamicBVH).insert(aabb, entityIndex);
+        staticBVHChanged |= entityProxy.isStatic;
+    }
+    else if (entityProxy.isStatic) {
+        staticBVHChanged |= staticBVH.update(entityProxy.proxy, aabb);
+    }
+    else {
+        dynamicBVH.update(entityProxy.proxy, aabb);
+    }
+    return staticBVHChanged;
 }
 
 void Scene::addDirectionalLight(DirectionalLight &light) {
@@ -70,6 +247,20 @@ void Scene::addDirectionalLight(DirectionalLight &light) {
                                               Renderer::getShadowSampler(), 3);
 }
 
+uint32 Scene::addPointLight(const PointLight &light) {
+    BZ_ASSERT_CORE(pointLights.size() + spotLights.size() < Renderer::MAX_LOCAL_LIGHTS_PER_SCENE,
+                   "Reached the maximum ammount of Point and Spot Lights!");
+    pointLights.push_back(light);
+    return static_cast<uint32>(pointLights.size() - 1);
+}
+
+uint32 Scene::addSpotLight(const SpotLight &light) {
+    BZ_ASSERT_CORE(pointLights.size() + spotLights.size() < Renderer::MAX_LOCAL_LIGHTS_PER_SCENE,
+                   "Reached the maximum ammount of Point and Spot Lights!");
+    spotLights.push_back(light);
+    return static_cast<uint32>(spotLights.size() - 1);
+}
+
 void Scene::enableSkyBox(const char *albedoBasePath, const char *albedoFileNames[6], const char *irradianceMapBasePath,
                          const char *irradianceMapFileNames[6], const char *radianceMapBasePath,
                          const char *radianceMapFileNames[6], uint32 radianceMipmapCount) {
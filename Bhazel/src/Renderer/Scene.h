@@ -3,6 +3,10 @@
 #include "Camera.h"
 #include "Mesh.h"
 #include "Transform.h"
+#include "TransformHierarchy.h"
+
+#include "Collisions/BVH.h"
+#include "Collisions/Ray.h"
 
 
 namespace BZ {
@@ -27,19 +31,71 @@ class DirectionalLight {
     glm::vec3 direction;
 };
 
+/*
+ * Point and Spot lights only reach what's inside their radius, and don't cast shadows. A Scene can have thousands of
+ * them: they are culled and binned on the froxels of the LightClusterer, and each fragment only walks the lights of
+ * its own froxel.
+ */
+class PointLight {
+  public:
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 1.0f;
+
+    // In world units. The light fades to zero there.
+    float radius = 1.0f;
+};
+
+class SpotLight {
+  public:
+    SpotLight();
+
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 1.0f;
+
+    // In world units. The light fades to zero there.
+    float radius = 1.0f;
+
+    // Half angles of the cone, in radians. Full intensity inside the inner one, fading to zero at the outer one.
+    float innerAngle;
+    float outerAngle;
+
+    const glm::vec3 &getDirection() const { return direction; }
+    void setDirection(const glm::vec3 &direction);
+
+  private:
+    glm::vec3 direction;
+};
+
 class Entity {
   public:
-    Entity(Mesh &mesh, Transform &transform, bool castShadow);
-    Entity(Mesh &mesh, Transform &transform, Material &overrideMaterial, bool castShadow);
+    Entity(Mesh &mesh, TransformHierarchy::NodeId transformNode, bool castShadow);
+    Entity(Mesh &mesh, TransformHierarchy::NodeId transformNode, Material &overrideMaterial, bool castShadow);
 
     Mesh mesh;
-    Transform transform;
+
+    // On the TransformHierarchy of the Scene.
+    TransformHierarchy::NodeId transformNode;
     bool castShadow;
 
+    // Rasterized into the occlusion culling depth buffer, to hide the Entities behind it. Best for big and simple
+    // Meshes, like walls.
+    bool occluder = false;
+
     // If present, will override the Mesh Material
     Material overrideMaterial;
 };
 
+struct RaycastHit {
+    uint32 entityIndex;
+    uint32 triangleIndex;
+
+    // In units of the Ray direction.
+    float distance;
+    glm::vec3 point;
+};
+
 struct SkyBox {
     Mesh mesh;
     Ref<TextureView> irradianceMapView;
@@ -51,20 +107,53 @@ class Scene {
     Scene();
     Scene(Camera &camera);
 
-    void addEntity(Mesh &mesh, Transform &transform, bool castShadow = true);
-    void addEntity(Mesh &mesh, Transform &transform, Material &overrideMaterial, bool castShadow = true);
+    // Return the index of the new Entity. Transforms are relative to the parent Entity, if any.
+    uint32 addEntity(Mesh &mesh, Transform &transform, bool castShadow = true);
+    uint32 addEntity(Mesh &mesh, Transform &transform, Material &overrideMaterial, bool castShadow = true);
+    uint32 addChildEntity(uint32 parentEntity, Mesh &mesh, Transform &transform, bool castShadow = true);
+    uint32 addChildEntity(uint32 parentEntity, Mesh &mesh, Transform &transform, Material &overrideMaterial,
+                          bool castShadow = true);
     void addDirectionalLight(DirectionalLight &light);
+
+    // Return the index of the new light.
+    uint32 addPointLight(const PointLight &light);
+    uint32 addSpotLight(const SpotLight &light);
     void enableSkyBox(const char *albedoBasePath, const char *albedoFileNames[6], const char *irradianceMapBasePath,
                       const char *irradianceMapFileNames[6], const char *radianceMapBasePath,
                       const char *radianceMapFileNames[6], uint32 radianceMipmapCount);
     void setCamera(Camera &camera);
 
+    // Static Entities go on a separate BVH, rebuilt with the best quality when they change. Moving them is slow.
+    void setEntityStatic(uint32 entityIndex, bool isStatic);
+
+    // Of the Mesh AABB, in world space.
+    AABB getEntityAABB(uint32 entityIndex) const;
+
+    // Spatial queries over the Entity AABBs. The callbacks receive Entity indices, see BVH.
+    void queryAABB(const AABB &aabb, const BVH::QueryFn &fn) const;
+    void querySphere(const BoundingSphere &sphere, const BVH::QueryFn &fn) const;
+    void queryFrustum(const Frustum &frustum, const BVH::QueryFn &fn) const;
+    void raycast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance,
+                 const BVH::RaycastFn &fn) const;
+
+    // Closest hit against the triangles of the Entities. Walks the BVHs, then the TriangleMesh of each candidate.
+    bool raycastClosest(const Ray &ray, float maxDistance, RaycastHit &outHit) const;
+
     std::vector<Entity> &getEntities() { return entities; }
     const std::vector<Entity> &getEntities() const { return entities; }
 
+    TransformHierarchy &getTransformHierarchy() { return transformHierarchy; }
+    const TransformHierarchy &getTransformHierarchy() const { return transformHierarchy; }
+
     std::vector<DirectionalLight> &getDirectionalLights() { return lights; }
     const std::vector<DirectionalLight> &getDirectionalLights() const { return lights; }
 
+    std::vector<PointLight> &getPointLights() { return pointLights; }
+    const std::vector<PointLight> &getPointLights() const { return pointLights; }
+
+    std::vector<SpotLight> &getSpotLights() { return spotLights; }
+    const std::vector<SpotLight> &getSpotLights() const { return spotLights; }
+
     bool hasSkyBox() const { return skyBox.mesh.isValid(); }
     const SkyBox &getSkyBox() const { return skyBox; }
 
@@ -75,11 +164,38 @@ class Scene {
 
   private:
     std::vector<Entity> entities;
+    TransformHierarchy transformHierarchy;
     std::vector<DirectionalLight> lights;
+    std::vector<PointLight> pointLights;
+    std::vector<SpotLight> spotLights;
 
     Camera *camera = nullptr;
     SkyBox skyBox;
 
-    DescriptorSet *descriptorSet = nullptr;
+    Ref<DescriptorSet> descriptorSet;
+
+    struct EntityProxy {
+        uint32 proxy = BVH::INVALID_PROXY;
+        bool isStatic = false;
+        bool onStaticBVH = false;
+    };
+
+    static constexpr uint32 INVALID_ENTITY = 0xffffffff;
+
+    // Brought up to date with the TransformHierarchy before each query, only visiting the Entities that moved.
+    mutable std::vector<EntityProxy> entityProxies;
+    mutable BVH staticBVH;
+    mutable BVH dynamicBVH;
+    mutable std::vector<TransformHierarchy::NodeId> changedTransformNodes;
+    mutable bool bvhsDirty = false;
+
+    // Indexed by NodeId.
+    std::vector<uint32> transformNodeToEntity;
+
+    uint32 onEntityAdded();
+    void updateBVHs() const;
+
+    // Returns true if the static BVH changed.
+    bool updateEntityProxy(uint32 entityIndex) const;
 };
 }
\ No newline at end of file
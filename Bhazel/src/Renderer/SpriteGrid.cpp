@@ -0,0 +1,45 @@
+#include "bzpch.h"
+
+#include "SpriteGrid.h"
+
+
+namespace BZ {
+
+SpriteGrid::SpriteGrid(const glm::vec2 &min, const glm::vec2 &max, float cellSize) : min(min), cellSize(cellSize) {
+    BZ_ASSERT_CORE(cellSize > 0.0f, "Invalid cellSize!");
+    BZ_ASSERT_CORE(max.x > min.x && max.y > min.y, "Invalid SpriteGrid bounds!");
+
+    cellCount = glm::max(glm::uvec2(glm::ceil((max - min) / cellSize)), glm::uvec2(1));
+    cells.resize(cellCount.x * cellCount.y);
+}
+
+void SpriteGrid::addSprite(const Sprite &sprite) {
+    const glm::ivec2 coords = getCellCoords(sprite.position);
+    cells[coords.y * cellCount.x + coords.x].push_back(sprite);
+    spriteCount++;
+
+    const glm::vec2 dimensions = glm::abs(sprite.dimensions);
+    const float halfExtent =
+        sprite.rotationDeg == 0.0f ? glm::max(dimensions.x, dimensions.y) * 0.5f : glm::length(dimensions) * 0.5f;
+    maxHalfExtent = glm::max(maxHalfExtent, halfExtent);
+}
+
+void SpriteGrid::clear() {
+    for (auto &cell : cells) {
+        cell.clear();
+    }
+    spriteCount = 0;
+    maxHalfExtent = 0.0f;
+}
+
+glm::uvec4 SpriteGrid::getCellRange(const glm::vec4 &rect) const {
+    const glm::ivec2 minCoords = getCellCoords(glm::vec2(rect.x, rect.y) - maxHalfExtent);
+    const glm::ivec2 maxCoords = getCellCoords(glm::vec2(rect.z, rect.w) + maxHalfExtent);
+    return glm::uvec4(minCoords.x, minCoords.y, maxCoords.x + 1, maxCoords.y + 1);
+}
+
+glm::ivec2 SpriteGrid::getCellCoords(const glm::vec2 &position) const {
+    const glm::ivec2 coords = glm::ivec2(glm::floor((position - min) / cellSize));
+    return glm::clamp(coords, glm::ivec2(0), glm::ivec2(cellCount) - 1);
+}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Renderer/Renderer2D.h"
+
+
+namespace BZ {
+
+/*
+ * Uniform grid spatial index for static Sprites, like tile maps. Each Sprite is stored on the cell containing its
+ * center and queries are expanded by the largest Sprite half extent, so nothing is missed or visited twice.
+ * Renderer2D only visits the cells overlapping the camera view rectangle.
+ */
+class SpriteGrid {
+  public:
+    // Sprites outside [min, max] are stored on the closest border cell.
+    SpriteGrid(const glm::vec2 &min, const glm::vec2 &max, float cellSize);
+
+    BZ_NON_COPYABLE(SpriteGrid);
+
+    void addSprite(const Sprite &sprite);
+    void clear();
+
+    // Cells overlapped by the rectangle (min on xy, max on zw), expanded by the largest Sprite half extent.
+    // Inclusive min cell on xy, exclusive max cell on zw.
+    glm::uvec4 getCellRange(const glm::vec4 &rect) const;
+    const std::vector<Sprite> &getCell(uint32 x, uint32 y) const { return cells[y * cellCount.x + x]; }
+
+    const glm::uvec2 &getCellCount() const { return cellCount; }
+    uint32 getSpriteCount() const { return spriteCount; }
+
+  private:
+    glm::vec2 min;
+    float cellSize;
+    glm::uvec2 cellCount;
+
+    std::vector<std::vector<Sprite>> cells;
+    uint32 spriteCount = 0;
+
+    // Conservative, rotated Sprites use their bounding circle.
+    float maxHalfExtent = 0.0f;
+
+    glm::ivec2 getCellCoords(const glm::vec2 &position) const;
+};
+}
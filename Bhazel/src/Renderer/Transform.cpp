@@ -29,7 +29,7 @@ void Transform::setTranslation(float x, float y, float z, Space space) {
         translation.y = transParent.y;
         translation.z = transParent.z;
     }
-    matricesDirty = true;
+    markChanged();
 }
 
 void Transform::translate(float x, float y, float z, Space space) {
@@ -45,7 +45,7 @@ void Transform::translate(float x, float y, float z, Space space) {
         translation.y += transParent.y;
         translation.z += transParent.z;
     }
-    matricesDirty = true;
+    markChanged();
 }
 
 void Transform::setOrientation(const glm::quat &quat, Space space) {
@@ -56,7 +56,7 @@ void Transform::setOrientation(const glm::quat &quat, Space space) {
         glm::vec3 axisParent = getLocalToParentMatrix() * glm::vec4(glm::axis(quat), 0.0f);
         orientation = glm::angleAxis(glm::angle(quat), axisParent);
     }
-    matricesDirty = true;
+    markChanged();
 }
 
 void Transform::rotate(const glm::quat &quat, Space space) {
@@ -68,7 +68,7 @@ void Transform::rotate(const glm::quat &quat, Space space) {
         glm::quat orientationParent = glm::angleAxis(glm::angle(quat), axisParent);
         orientation = glm::normalize(orientationParent * orientation);
     }
-    matricesDirty = true;
+    markChanged();
 }
 
 void Transform::lookAt(const glm::vec3 &point, const glm::vec3 &up) {
@@ -78,7 +78,7 @@ void Transform::lookAt(const glm::vec3 &point, const glm::vec3 &up) {
 
     glm::mat3 rot(x, y, z);
     orientation = glm::quat(rot);
-    matricesDirty = true;
+    markChanged();
 }
 
 const glm::mat4 &Transform::getLocalToParentMatrix() const {
@@ -40,19 +40,19 @@ class Transform {
     const glm::vec3 &getScale() const { return scale; }
     void setScale(const glm::vec3 &sc) {
         scale = sc;
-        matricesDirty = true;
+        markChanged();
     }
     void setScale(float x, float y, float z) {
         scale.x = x;
         scale.y = y;
         scale.z = z;
-        matricesDirty = true;
+        markChanged();
     }
     void setScale(float sc) {
         scale.x = sc;
         scale.y = sc;
         scale.z = sc;
-        matricesDirty = true;
+        markChanged();
     }
 
     // Parameters expected in parent space
@@ -62,6 +62,9 @@ class Transform {
     const glm::mat4 &getParentToLocalMatrix() const;
     const glm::mat3 &getNormalMatrix() const;
 
+    // Increments every time the transform changes.
+    uint32 getVersion() const { return version; }
+
   private:
     glm::vec3 translation = {};
     glm::quat orientation = { 1.0f, 0.0f, 0.0f, 0.0f };
@@ -74,7 +77,12 @@ class Transform {
     mutable glm::mat3 localToParentNormalMatrix;
 
     mutable bool matricesDirty = true;
+    uint32 version = 0;
 
+    void markChanged() {
+        matricesDirty = true;
+        version++;
+    }
     void computeMatrices() const;
 };
 }
\ No newline at end of file
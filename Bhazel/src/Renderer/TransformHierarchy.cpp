@@ -0,0 +1,232 @@
+#include "bzpch.h"
+
+#include "TransformHierarchy.h"
+
+#include "Renderer/Transform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define BZ_TRANSFORM_SSE
+#endif
+
+
+namespace BZ {
+
+// parentToWorld * localToParent, where localToParent has the axes on the first three columns and the translation on the
+// last one. Each column of the result is a sum of the parent columns, four floats at once.
+static void multiplyAffine(const glm::mat4 &parentToWorld, const glm::vec3 axes[3], const glm::vec3 &translation,
+                           glm::mat4 &outLocalToWorld) {
+#ifdef BZ_TRANSFORM_SSE
+    const __m128 p0 = _mm_loadu_ps(&parentToWorld[0][0]);
+    const __m128 p1 = _mm_loadu_ps(&parentToWorld[1][0]);
+    const __m128 p2 = _mm_loadu_ps(&parentToWorld[2][0]);
+    const __m128 p3 = _mm_loadu_ps(&parentToWorld[3][0]);
+    for (uint32 c = 0; c < 3; ++c) {
+        __m128 column = _mm_mul_ps(p0, _mm_set1_ps(axes[c].x));
+        column = _mm_add_ps(column, _mm_mul_ps(p1, _mm_set1_ps(axes[c].y)));
+        column = _mm_add_ps(column, _mm_mul_ps(p2, _mm_set1_ps(axes[c].z)));
+        _mm_storeu_ps(&outLocalToWorld[c][0], column);
+    }
+    __m128 column = _mm_add_ps(p3, _mm_mul_ps(p0, _mm_set1_ps(translation.x)));
+    column = _mm_add_ps(column, _mm_mul_ps(p1, _mm_set1_ps(translation.y)));
+    column = _mm_add_ps(column, _mm_mul_ps(p2, _mm_set1_ps(translation.z)));
+    _mm_storeu_ps(&outLocalToWorld[3][0], column);
+#else
+    for (uint32 c = 0; c < 3; ++c) {
+        outLocalToWorld[c] = parentToWorld[0] * axes[c].x + parentToWorld[1] * axes[c].y + parentToWorld[2] * axes[c].z;
+    }
+    outLocalToWorld[3] = parentToWorld[3] + parentToWorld[0] * translation.x + parentToWorld[1] * translation.y +
+                         parentToWorld[2] * translation.z;
+#endif
+}
+
+TransformHierarchy::NodeId TransformHierarchy::addNode(const Transform &localTransform, NodeId parent) {
+    BZ_ASSERT_CORE(parent == INVALID_NODE || parent < nodeToIndex.size(), "Invalid parent node!");
+
+    const uint32 parentIndex = parent == INVALID_NODE ? INVALID_INDEX : nodeToIndex[parent];
+    const uint32 depth = parent == INVALID_NODE ? 0 : depths[parentIndex] + 1;
+
+    // The parent already exists, so it stays before the new node even before sorting.
+    if (!depths.empty() && depth < depths.back()) {
+        sortPending = true;
+    }
+
+    const uint32 index = static_cast<uint32>(indexToNode.size());
+    const NodeId node = static_cast<NodeId>(nodeToIndex.size());
+    nodeToIndex.push_back(index);
+    changedNodeFlags.push_back(0);
+
+    indexToNode.push_back(node);
+    parentIndices.push_back(parentIndex);
+    depths.push_back(depth);
+    translations.push_back(localTransform.getTranslation());
+    orientations.push_back(localTransform.getOrientation());
+    scales.push_back(localTransform.getScale());
+    localToWorldMatrices.emplace_back(1.0f);
+    normalMatrices.emplace_back(1.0f);
+    dirtyFlags.push_back(0);
+
+    markDirty(index);
+    return node;
+}
+
+TransformHierarchy::NodeId TransformHierarchy::getParent(NodeId node) const {
+    const uint32 parentIndex = parentIndices[nodeToIndex[node]];
+    return parentIndex == INVALID_INDEX ? INVALID_NODE : indexToNode[parentIndex];
+}
+
+void TransformHierarchy::setTranslation(NodeId node, const glm::vec3 &translation) {
+    const uint32 index = nodeToIndex[node];
+    translations[index] = translation;
+    markDirty(index);
+}
+
+void TransformHierarchy::setOrientation(NodeId node, const glm::quat &orientation) {
+    const uint32 index = nodeToIndex[node];
+    orientations[index] = orientation;
+    markDirty(index);
+}
+
+void TransformHierarchy::setScale(NodeId node, const glm::vec3 &scale) {
+    const uint32 index = nodeToIndex[node];
+    scales[index] = scale;
+    markDirty(index);
+}
+
+void TransformHierarchy::setLocalTransform(NodeId node, const Transform &localTransform) {
+    const uint32 index = nodeToIndex[node];
+    translations[index] = localTransform.getTranslation();
+    orientations[index] = localTransform.getOrientation();
+    scales[index] = localTransform.getScale();
+    markDirty(index);
+}
+
+const glm::mat4 &TransformHierarchy::getLocalToWorldMatrix(NodeId node) const {
+    if (anyDirty) {
+        updateWorldMatrices();
+    }
+    return localToWorldMatrices[nodeToIndex[node]];
+}
+
+const glm::mat3 &TransformHierarchy::getNormalMatrix(NodeId node) const {
+    if (anyDirty) {
+        updateWorldMatrices();
+    }
+    return normalMatrices[nodeToIndex[node]];
+}
+
+void TransformHierarchy::updateWorldMatrices() const {
+    BZ_PROFILE_FUNCTION();
+
+    if (!anyDirty) {
+        return;
+    }
+
+    if (sortPending) {
+        sortByDepth();
+    }
+
+    const uint32 count = static_cast<uint32>(indexToNode.size());
+    for (uint32 i = 0; i < count; ++i) {
+        // Parents were already visited, so a dirty parent marks its whole subtree.
+        const uint32 parentIndex = parentIndices[i];
+        if (parentIndex != INVALID_INDEX) {
+            dirtyFlags[i] |= dirtyFlags[parentIndex];
+        }
+        if (!dirtyFlags[i]) {
+            continue;
+        }
+
+        const glm::mat3 rot = glm::mat3_cast(orientations[i]);
+        const glm::vec3 &scale = scales[i];
+        const glm::vec3 axes[3] = { rot[0] * scale.x, rot[1] * scale.y, rot[2] * scale.z };
+
+        glm::mat4 &localToWorld = localToWorldMatrices[i];
+        if (parentIndex == INVALID_INDEX) {
+            localToWorld = glm::mat4(glm::vec4(axes[0], 0.0f), glm::vec4(axes[1], 0.0f), glm::vec4(axes[2], 0.0f),
+                                     glm::vec4(translations[i], 1.0f));
+        }
+        else {
+            multiplyAffine(localToWorldMatrices[parentIndex], axes, translations[i], localToWorld);
+        }
+
+        // The cofactor matrix is the inverse transpose scaled by the determinant. Cheaper than inverting.
+        // All the columns get the same factor, so non uniform scales still bend the normals. Dividing by |det|^(2/3)
+        // cancels uniform scales, and the sign of det undoes the flip it causes on mirroring transforms.
+        const glm::mat3 m(localToWorld);
+        const glm::mat3 cofactor(glm::cross(m[1], m[2]), glm::cross(m[2], m[0]), glm::cross(m[0], m[1]));
+        const float det = glm::dot(m[0], cofactor[0]);
+        const float absDet = glm::abs(det);
+        normalMatrices[i] =
+            absDet > 0.0f ? cofactor * (glm::sign(det) / glm::pow(absDet, 2.0f / 3.0f)) : glm::mat3(1.0f);
+
+        const NodeId node = indexToNode[i];
+        if (!changedNodeFlags[node]) {
+            changedNodeFlags[node] = 1;
+            changedNodes.push_back(node);
+        }
+    }
+
+    std::fill(dirtyFlags.begin(), dirtyFlags.end(), 0);
+    anyDirty = false;
+    version++;
+}
+
+void TransformHierarchy::sortByDepth() const {
+    BZ_PROFILE_FUNCTION();
+
+    const uint32 count = static_cast<uint32>(indexToNode.size());
+    const uint32 maxDepth = *std::max_element(depths.begin(), depths.end());
+
+    // First new index of each depth.
+    std::vector<uint32> depthOffsets(maxDepth + 2, 0);
+    for (uint32 depth : depths) {
+        depthOffsets[depth + 1]++;
+    }
+    for (uint32 depth = 1; depth < depthOffsets.size(); ++depth) {
+        depthOffsets[depth] += depthOffsets[depth - 1];
+    }
+
+    std::vector<uint32> oldToNew(count);
+    for (uint32 i = 0; i < count; ++i) {
+        oldToNew[i] = depthOffsets[depths[i]]++;
+    }
+
+    auto reorder = [&oldToNew](auto &values) {
+        std::remove_reference_t<decltype(values)> sortedValues(values.size());
+        for (uint32 i = 0; i < values.size(); ++i) {
+            sortedValues[oldToNew[i]] = values[i];
+        }
+        values.swap(sortedValues);
+    };
+    reorder(indexToNode);
+    reorder(parentIndices);
+    reorder(depths);
+    reorder(translations);
+    reorder(orientations);
+    reorder(scales);
+    reorder(localToWorldMatrices);
+    reorder(normalMatrices);
+    reorder(dirtyFlags);
+
+    for (uint32 &parentIndex : parentIndices) {
+        if (parentIndex != INVALID_INDEX) {
+            parentIndex = oldToNew[parentIndex];
+        }
+    }
+    for (uint32 &index : nodeToIndex) {
+        index = oldToNew[index];
+    }
+    sortPending = false;
+}
+
+void TransformHierarchy::takeChangedNodes(std::vector<NodeId> &outNodes) const {
+    updateWorldMatrices();
+
+    outNodes.swap(changedNodes);
+    changedNodes.clear();
+    for (NodeId node : outNodes) {
+        changedNodeFlags[node] = 0;
+    }
+}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+
+namespace BZ {
+
+class Transform;
+
+/*
+ * Parent/child hierarchy of transforms, stored as arrays (SoA) sorted by depth, so every parent comes before its
+ * children. Local-to-world matrices, and the normal matrices, are propagated lazily in a single linear pass over the
+ * nodes, only recomputing dirty nodes and their subtrees. The matrix products use SSE when compiled with it.
+ * Nodes are referenced by NodeId, which stays valid as more nodes are added and the arrays are reordered.
+ */
+class TransformHierarchy {
+  public:
+    using NodeId = uint32;
+    static constexpr NodeId INVALID_NODE = 0xffffffff;
+
+    TransformHierarchy() = default;
+
+    // Appends the node, amortized O(1). When that breaks the depth order, the next update sorts the nodes again.
+    NodeId addNode(const Transform &localTransform, NodeId parent = INVALID_NODE);
+
+    NodeId getParent(NodeId node) const;
+    uint32 getDepth(NodeId node) const { return depths[nodeToIndex[node]]; }
+    uint32 getNodeCount() const { return static_cast<uint32>(nodeToIndex.size()); }
+
+    // Local transforms, relative to the parent node.
+    const glm::vec3 &getTranslation(NodeId node) const { return translations[nodeToIndex[node]]; }
+    void setTranslation(NodeId node, const glm::vec3 &translation);
+
+    const glm::quat &getOrientation(NodeId node) const { return orientations[nodeToIndex[node]]; }
+    void setOrientation(NodeId node, const glm::quat &orientation);
+
+    glm::vec3 getRotationEuler(NodeId node) const { return glm::degrees(glm::eulerAngles(getOrientation(node))); }
+    void setRotationEuler(NodeId node, const glm::vec3 &rot) { setOrientation(node, glm::quat(glm::radians(rot))); }
+
+    const glm::vec3 &getScale(NodeId node) const { return scales[nodeToIndex[node]]; }
+    void setScale(NodeId node, const glm::vec3 &scale);
+
+    void setLocalTransform(NodeId node, const Transform &localTransform);
+
+    const glm::mat4 &getLocalToWorldMatrix(NodeId node) const;
+
+    // Inverse transpose of the local to world matrix, rescaled to cancel uniform scales. Normals transformed by it still
+    // need normalization.
+    const glm::mat3 &getNormalMatrix(NodeId node) const;
+
+    // Done lazily by the getters. Can be called to control when the work happens.
+    void updateWorldMatrices() const;
+
+    // Increments every time some world matrix changes.
+    uint32 getVersion() const { return version; }
+
+    // Nodes whose world matrix changed since the last call, in no particular order. Meant for a single owner keeping
+    // something in sync with the nodes, like the Scene with its BVHs.
+    void takeChangedNodes(std::vector<NodeId> &outNodes) const;
+
+  private:
+    static constexpr uint32 INVALID_INDEX = 0xffffffff;
+
+    // The arrays are only reordered by the lazy depth sort, which doesn't change what the getters return.
+
+    // Indexed by NodeId.
+    mutable std::vector<uint32> nodeToIndex;
+
+    // Indexed by the position on the depth sorted order.
+    mutable std::vector<NodeId> indexToNode;
+    mutable std::vector<uint32> parentIndices;
+    mutable std::vector<uint32> depths;
+    mutable std::vector<glm::vec3> translations;
+    mutable std::vector<glm::quat> orientations;
+    mutable std::vector<glm::vec3> scales;
+
+    mutable std::vector<glm::mat4> localToWorldMatrices;
+    mutable std::vector<glm::mat3> normalMatrices;
+    mutable std::vector<uint8> dirtyFlags;
+
+    // Flags indexed by NodeId.
+    mutable std::vector<NodeId> changedNodes;
+    mutable std::vector<uint8> changedNodeFlags;
+
+    mutable bool anyDirty = false;
+    mutable bool sortPending = false;
+    mutable uint32 version = 0;
+
+    // Stable counting sort by depth, nodes of the same depth keep the order they were added in.
+    void sortByDepth() const;
+
+    void markDirty(uint32 index) {
+        dirtyFlags[index] = 1;
+        anyDirty = true;
+    }
+};
+}
@@ -0,0 +1,342 @@
+#include "Testing.h"
+
+#include <cstdio>
+
+#include "Collisions/BVH.h"
+#include "Collisions/BoundingSphere.h"
+#include "Collisions/CollisionUtils.h"
+#include "Collisions/Frustum.h"
+#include "Core/Timer.h"
+#include "Core/Utils.h"
+
+
+namespace BZ {
+
+static constexpr float WORLD_EXTENT = 500.0f;
+static constexpr float BVH_MARGIN = 0.5f;
+
+/*
+ * A BVH and the tight AABBs it was fed, indexed by user data, to compare every query against a brute-force loop.
+ * The BVH reports the proxies by the fat AABBs, so those are the brute-force reference, and the tight ones must be a
+ * subset of the result.
+ */
+struct BVHFixture {
+    BVH bvh;
+    std::vector<AABB> aabbs;
+    std::vector<uint32> proxies;
+
+    BVHFixture() : bvh(BVH_MARGIN) {}
+
+    uint32 add(const AABB &aabb) {
+        const uint32 userData = static_cast<uint32>(aabbs.size());
+        aabbs.push_back(aabb);
+        proxies.push_back(bvh.insert(aabb, userData));
+        return userData;
+    }
+
+    void remove(uint32 userData) {
+        bvh.remove(proxies[userData]);
+        proxies[userData] = BVH::INVALID_PROXY;
+    }
+
+    void move(uint32 userData, const AABB &aabb) {
+        aabbs[userData] = aabb;
+        bvh.update(proxies[userData], aabb);
+    }
+
+    bool isAlive(uint32 userData) const { return proxies[userData] != BVH::INVALID_PROXY; }
+    const AABB &getFatAABB(uint32 userData) const { return bvh.getFatAABB(proxies[userData]); }
+};
+
+static AABB randomAABB() {
+    return AABB(Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT), Testing::randomVec3(0.5f, 10.0f));
+}
+
+static Frustum randomFrustum() {
+    const glm::vec3 eye = Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT);
+    const glm::vec3 target = Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT);
+    const glm::mat4 view = glm::lookAtRH(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 projection =
+        Utils::perspective(Testing::randomFloat(30.0f, 90.0f), Testing::randomFloat(0.5f, 2.0f), 0.1f, 300.0f);
+    return Frustum(projection * view);
+}
+
+// Entry distance of the ray on the AABB, or maxDistance if it doesn't hit before. Origins inside hit at 0.
+static float rayEntryDistance(const AABB &aabb, const glm::vec3 &origin, const glm::vec3 &direction,
+                              float maxDistance) {
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (direction[axis] == 0.0f) {
+            if (origin[axis] < aabb.getMin()[axis] || origin[axis] > aabb.getMax()[axis]) {
+                return maxDistance;
+            }
+            continue;
+        }
+        float t1 = (aabb.getMin()[axis] - origin[axis]) / direction[axis];
+        float t2 = (aabb.getMax()[axis] - origin[axis]) / direction[axis];
+        tMin = glm::max(tMin, glm::min(t1, t2));
+        tMax = glm::min(tMax, glm::max(t1, t2));
+    }
+    return tMin <= tMax ? tMin : maxDistance;
+}
+
+static std::vector<uint32> sorted(std::vector<uint32> userDatas) {
+    std::sort(userDatas.begin(), userDatas.end());
+    return userDatas;
+}
+
+template <typename OverlapsFn>
+static std::vector<uint32> bruteForce(const BVHFixture &fixture, const OverlapsFn &overlapsFn) {
+    std::vector<uint32> result;
+    for (uint32 userData = 0; userData < fixture.aabbs.size(); ++userData) {
+        if (fixture.isAlive(userData) && overlapsFn(fixture.getFatAABB(userData))) {
+            result.push_back(userData);
+        }
+    }
+    return result;
+}
+
+// The query must report each overlapping proxy once, and every proxy whose tight AABB overlaps.
+template <typename OverlapsFn>
+static void checkQuery(const BVHFixture &fixture, const std::vector<uint32> &queryResult,
+                       const OverlapsFn &overlapsFn) {
+    const std::vector<uint32> result = sorted(queryResult);
+    BZ_CHECK(result == bruteForce(fixture, overlapsFn));
+
+    for (uint32 userData = 0; userData < fixture.aabbs.size(); ++userData) {
+        if (fixture.isAlive(userData) && overlapsFn(fixture.aabbs[userData])) {
+            BZ_CHECK(std::binary_search(result.begin(), result.end(), userData));
+        }
+    }
+}
+
+static void checkQueries(const BVHFixture &fixture, uint32 queryCount) {
+    for (uint32 i = 0; i < queryCount; ++i) {
+        std::vector<uint32> result;
+        auto collect = [&result](uint32 userData) {
+            result.push_back(userData);
+            return true;
+        };
+
+        const AABB aabb(Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT), Testing::randomVec3(1.0f, 100.0f));
+        fixture.bvh.queryAABB(aabb, collect);
+        checkQuery(fixture, result, [&aabb](const AABB &other) { return CollisionUtils::overlaps(other, aabb); });
+
+        result.clear();
+        const BoundingSphere sphere(Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT),
+                                    Testing::randomFloat(1.0f, 50.0f));
+        fixture.bvh.querySphere(sphere, collect);
+        checkQuery(fixture, result, [&sphere](const AABB &other) { return CollisionUtils::overlaps(other, sphere); });
+
+        result.clear();
+        const Frustum frustum = randomFrustum();
+        fixture.bvh.queryFrustum(frustum, collect);
+        checkQuery(fixture, result, [&frustum](const AABB &other) { return frustum.overlaps(other); });
+
+        // Every hit, not shortening the ray.
+        result.clear();
+        const glm::vec3 origin = Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT);
+        const glm::vec3 direction = Testing::randomVec3(-1.0f, 1.0f);
+        const float maxDistance = Testing::randomFloat(10.0f, 2.0f * WORLD_EXTENT);
+        fixture.bvh.raycast(origin, direction, maxDistance, [&result](uint32 userData, float maxDistance) {
+            result.push_back(userData);
+            return maxDistance;
+        });
+        const glm::vec3 invDirection = CollisionUtils::safeInverse(direction);
+        checkQuery(fixture, result, [&](const AABB &other) {
+            return CollisionUtils::overlapsRay(other, origin, invDirection, maxDistance);
+        });
+
+        // Closest hit on the tight AABBs, shortening the ray as it goes.
+        float closestDistance = maxDistance;
+        fixture.bvh.raycast(origin, direction, maxDistance, [&](uint32 userData, float maxDistance) {
+            closestDistance = glm::min(closestDistance, rayEntryDistance(fixture.aabbs[userData], origin, direction,
+                                                                         maxDistance));
+            return closestDistance;
+        });
+
+        float bruteForceClosestDistance = maxDistance;
+        for (uint32 userData = 0; userData < fixture.aabbs.size(); ++userData) {
+            if (fixture.isAlive(userData)) {
+                bruteForceClosestDistance =
+                    glm::min(bruteForceClosestDistance,
+                             rayEntryDistance(fixture.aabbs[userData], origin, direction, maxDistance));
+            }
+        }
+        BZ_CHECK(closestDistance == bruteForceClosestDistance);
+    }
+}
+
+BZ_TEST(bvhQueriesMatchBruteForce) {
+    BVHFixture fixture;
+    for (uint32 i = 0; i < 10000; ++i) {
+        fixture.add(randomAABB());
+    }
+    BZ_CHECK(fixture.bvh.getProxyCount() == 10000);
+    checkQueries(fixture, 100);
+
+    // Small movements stay inside the margin, big ones reinsert.
+    for (uint32 userData = 0; userData < 10000; userData += 3) {
+        const glm::vec3 offset = userData % 2 ? Testing::randomVec3(-0.2f, 0.2f) : Testing::randomVec3(-50.0f, 50.0f);
+        const AABB &aabb = fixture.aabbs[userData];
+        fixture.move(userData, AABB(aabb.getCenter() + offset, aabb.getDimensions()));
+    }
+    checkQueries(fixture, 100);
+
+    for (uint32 userData = 0; userData < 10000; userData += 5) {
+        fixture.remove(userData);
+    }
+    for (uint32 i = 0; i < 1000; ++i) {
+        fixture.add(randomAABB());
+    }
+    BZ_CHECK(fixture.bvh.getProxyCount() == 9000);
+    checkQueries(fixture, 100);
+
+    fixture.bvh.rebuild();
+    BZ_CHECK(fixture.bvh.getProxyCount() == 9000);
+    checkQueries(fixture, 100);
+}
+
+// Without a margin the fat AABBs are the tight ones. Updating to the same AABB must not touch the tree, the Scene
+// rebuilds its static BVH whenever it does.
+BZ_TEST(bvhZeroMarginUpdateWithSameAABB) {
+    BVH bvh;
+    std::vector<AABB> aabbs;
+    std::vector<uint32> proxies;
+    for (uint32 i = 0; i < 1000; ++i) {
+        aabbs.push_back(randomAABB());
+        proxies.push_back(bvh.insert(aabbs.back(), i));
+    }
+    bvh.rebuild();
+
+    for (uint32 i = 0; i < 1000; ++i) {
+        const AABB &fatAABB = bvh.getFatAABB(proxies[i]);
+        BZ_CHECK(fatAABB.getMin() == aabbs[i].getMin() && fatAABB.getMax() == aabbs[i].getMax());
+        BZ_CHECK(!bvh.update(proxies[i], aabbs[i]));
+    }
+
+    // Any growth does touch it.
+    const AABB grown(aabbs[0].getCenter(), aabbs[0].getDimensions() + glm::vec3(0.01f));
+    BZ_CHECK(bvh.update(proxies[0], grown));
+    BZ_CHECK(!bvh.update(proxies[0], grown));
+}
+
+BZ_TEST(bvhQueriesCanStop) {
+    BVHFixture fixture;
+    for (uint32 i = 0; i < 1000; ++i) {
+        fixture.add(AABB(glm::vec3(0.0f), glm::vec3(1.0f)));
+    }
+
+    uint32 callCount = 0;
+    fixture.bvh.queryAABB(AABB(glm::vec3(0.0f), glm::vec3(1.0f)), [&callCount](uint32 userData) {
+        return ++callCount < 10;
+    });
+    BZ_CHECK(callCount == 10);
+
+    callCount = 0;
+    fixture.bvh.raycast(glm::vec3(-10.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 100.0f,
+                        [&callCount](uint32 userData, float maxDistance) {
+                            callCount++;
+                            return 0.0f;
+                        });
+    BZ_CHECK(callCount == 1);
+}
+
+BZ_BENCHMARK(bvhQueries100k) {
+    constexpr uint32 OBJECT_COUNT = 100000;
+    constexpr uint32 QUERY_COUNT = 1000;
+
+    BVHFixture fixture;
+    fixture.aabbs.reserve(OBJECT_COUNT);
+    fixture.proxies.reserve(OBJECT_COUNT);
+
+    Timer timer;
+    timer.start();
+    for (uint32 i = 0; i < OBJECT_COUNT; ++i) {
+        fixture.add(randomAABB());
+    }
+    std::printf("    insert %u: %.2f ms, cost %.1f, height %u\n", OBJECT_COUNT,
+                timer.getCountedTime().asMillisecondsFloat(), fixture.bvh.getCost(), fixture.bvh.getHeight());
+
+    timer.restart();
+    fixture.bvh.rebuild();
+    std::printf("    rebuild: %.2f ms, cost %.1f, height %u\n", timer.getCountedTime().asMillisecondsFloat(),
+                fixture.bvh.getCost(), fixture.bvh.getHeight());
+
+    std::vector<AABB> queryAABBs;
+    std::vector<glm::vec3> rayOrigins;
+    std::vector<glm::vec3> rayDirections;
+    std::vector<Frustum> frustums;
+    for (uint32 i = 0; i < QUERY_COUNT; ++i) {
+        queryAABBs.emplace_back(Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT), Testing::randomVec3(1.0f, 50.0f));
+        rayOrigins.push_back(Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT));
+        rayDirections.push_back(Testing::randomVec3(-1.0f, 1.0f));
+        frustums.push_back(randomFrustum());
+    }
+
+    uint64 hitCount = 0;
+    auto count = [&hitCount](uint32 userData) {
+        hitCount++;
+        return true;
+    };
+
+    timer.restart();
+    for (const AABB &aabb : queryAABBs) {
+        fixture.bvh.queryAABB(aabb, count);
+    }
+    const float bvhAABBMs = timer.getCountedTime().asMillisecondsFloat();
+
+    timer.restart();
+    for (const AABB &aabb : queryAABBs) {
+        for (const AABB &other : fixture.aabbs) {
+            hitCount += CollisionUtils::overlaps(aabb, other);
+        }
+    }
+    std::printf("    %u AABB queries: %.2f ms, brute force %.2f ms\n", QUERY_COUNT, bvhAABBMs,
+                timer.getCountedTime().asMillisecondsFloat());
+
+    timer.restart();
+    for (const Frustum &frustum : frustums) {
+        fixture.bvh.queryFrustum(frustum, count);
+    }
+    const float bvhFrustumMs = timer.getCountedTime().asMillisecondsFloat();
+
+    timer.restart();
+    for (const Frustum &frustum : frustums) {
+        for (const AABB &other : fixture.aabbs) {
+            hitCount += frustum.overlaps(other);
+        }
+    }
+    std::printf("    %u frustum queries: %.2f ms, brute force %.2f ms\n", QUERY_COUNT, bvhFrustumMs,
+                timer.getCountedTime().asMillisecondsFloat());
+
+    timer.restart();
+    for (uint32 i = 0; i < QUERY_COUNT; ++i) {
+        fixture.bvh.raycast(rayOrigins[i], rayDirections[i], 2.0f * WORLD_EXTENT,
+                            [&hitCount](uint32 userData, float maxDistance) {
+                                hitCount++;
+                                return maxDistance;
+                            });
+    }
+    const float bvhRaycastMs = timer.getCountedTime().asMillisecondsFloat();
+
+    timer.restart();
+    for (uint32 i = 0; i < QUERY_COUNT; ++i) {
+        const glm::vec3 invDirection = CollisionUtils::safeInverse(rayDirections[i]);
+        for (const AABB &other : fixture.aabbs) {
+            hitCount += CollisionUtils::overlapsRay(other, rayOrigins[i], invDirection, 2.0f * WORLD_EXTENT);
+        }
+    }
+    std::printf("    %u raycasts: %.2f ms, brute force %.2f ms\n", QUERY_COUNT, bvhRaycastMs,
+                timer.getCountedTime().asMillisecondsFloat());
+
+    timer.restart();
+    for (uint32 userData = 0; userData < OBJECT_COUNT; ++userData) {
+        const AABB &aabb = fixture.aabbs[userData];
+        fixture.move(userData, AABB(aabb.getCenter() + Testing::randomVec3(-2.0f, 2.0f), aabb.getDimensions()));
+    }
+    std::printf("    update %u: %.2f ms (%llu hits)\n", OBJECT_COUNT, timer.getCountedTime().asMillisecondsFloat(),
+                hitCount);
+}
+}
@@ -0,0 +1,260 @@
+#include "Testing.h"
+
+#include <cstdio>
+
+#include "Collisions/BatchIntersections.h"
+#include "Collisions/BoundingSphere.h"
+#include "Collisions/CollisionUtils.h"
+#include "Collisions/Frustum.h"
+#include "Core/Timer.h"
+#include "Core/Utils.h"
+
+
+namespace BZ {
+
+// Up to a few SIMD blocks plus every possible remainder.
+static constexpr uint32 MAX_BATCH_COUNT = 67;
+
+/*
+ * Volumes on an integer grid, so faces, corners and ray origins often land exactly on each other. These are the cases
+ * where the SIMD and the scalar paths can disagree.
+ */
+static float randomGridFloat(int32 min, int32 max) {
+    return static_cast<float>(std::uniform_int_distribution<int32>(min, max)(Testing::getRandomEngine()));
+}
+
+static glm::vec3 randomGridVec3(int32 min, int32 max) {
+    return glm::vec3(randomGridFloat(min, max), randomGridFloat(min, max), randomGridFloat(min, max));
+}
+
+static AABB randomGridAABB() {
+    // Zero dimensions too.
+    return AABB(randomGridVec3(-4, 4), randomGridVec3(0, 4) * 2.0f);
+}
+
+static BoundingSphere randomGridSphere() {
+    return BoundingSphere(randomGridVec3(-4, 4), randomGridFloat(0, 4));
+}
+
+static AABB randomAABB() {
+    return AABB(Testing::randomVec3(-10.0f, 10.0f), Testing::randomVec3(0.0f, 5.0f));
+}
+
+static BoundingSphere randomSphere() {
+    return BoundingSphere(Testing::randomVec3(-10.0f, 10.0f), Testing::randomFloat(0.0f, 5.0f));
+}
+
+static Frustum randomFrustum() {
+    const glm::vec3 eye = Testing::randomVec3(-10.0f, 10.0f);
+    const glm::mat4 view = glm::lookAtRH(eye, eye + Testing::randomVec3(-1.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return Frustum(Utils::perspective(Testing::randomFloat(30.0f, 90.0f), 1.0f, 0.1f, 20.0f) * view);
+}
+
+// Includes zero and axis aligned directions, which produce the infinite inverses.
+static glm::vec3 randomGridDirection() {
+    return randomGridVec3(-1, 1);
+}
+
+// Every element against the reference, and the bits past the count must be clear.
+template <typename ReferenceFn>
+static void checkMask(const std::vector<uint32> &mask, uint32 count, const ReferenceFn &referenceFn) {
+    for (uint32 i = 0; i < count; ++i) {
+        BZ_CHECK(BatchIntersections::isBitSet(mask.data(), i) == referenceFn(i));
+    }
+    for (uint32 i = count; i < mask.size() * 32; ++i) {
+        BZ_CHECK(!BatchIntersections::isBitSet(mask.data(), i));
+    }
+}
+
+static void checkAABBBatch(const std::vector<AABB> &aabbs, const AABB &aabb, const BoundingSphere &sphere,
+                           const Frustum &frustum, const glm::vec3 &origin, const glm::vec3 &direction,
+                           float maxDistance) {
+    AABBBatch batch;
+    for (const AABB &other : aabbs) {
+        batch.add(other);
+    }
+    const uint32 count = batch.getCount();
+    std::vector<uint32> mask(BatchIntersections::getMaskWordCount(count));
+
+    BatchIntersections::overlaps(batch, aabb, mask.data());
+    checkMask(mask, count, [&](uint32 i) { return CollisionUtils::overlaps(aabbs[i], aabb); });
+
+    BatchIntersections::overlaps(batch, sphere, mask.data());
+    checkMask(mask, count, [&](uint32 i) { return CollisionUtils::overlaps(aabbs[i], sphere); });
+
+    BatchIntersections::overlapsFrustum(batch, frustum.getPlanes(), mask.data());
+    checkMask(mask, count, [&](uint32 i) { return CollisionUtils::overlapsFrustum(aabbs[i], frustum.getPlanes()); });
+
+    const glm::vec3 invDirection = CollisionUtils::safeInverse(direction);
+    BatchIntersections::overlapsRay(batch, origin, direction, maxDistance, mask.data());
+    checkMask(mask, count, [&](uint32 i) {
+        return CollisionUtils::overlapsRay(aabbs[i], origin, invDirection, maxDistance);
+    });
+}
+
+static void checkSphereBatch(const std::vector<BoundingSphere> &spheres, const AABB &aabb,
+                             const BoundingSphere &sphere, const Frustum &frustum, const glm::vec3 &origin,
+                             const glm::vec3 &direction, float maxDistance) {
+    SphereBatch batch;
+    for (const BoundingSphere &other : spheres) {
+        batch.add(other);
+    }
+    const uint32 count = batch.getCount();
+    std::vector<uint32> mask(BatchIntersections::getMaskWordCount(count));
+
+    BatchIntersections::overlaps(batch, aabb, mask.data());
+    checkMask(mask, count, [&](uint32 i) { return CollisionUtils::overlaps(aabb, spheres[i]); });
+
+    BatchIntersections::overlaps(batch, sphere, mask.data());
+    checkMask(mask, count, [&](uint32 i) { return CollisionUtils::overlaps(spheres[i], sphere); });
+
+    BatchIntersections::overlapsFrustum(batch, frustum.getPlanes(), mask.data());
+    checkMask(mask, count,
+              [&](uint32 i) { return CollisionUtils::overlapsFrustum(spheres[i], frustum.getPlanes()); });
+
+    BatchIntersections::overlapsRay(batch, origin, direction, maxDistance, mask.data());
+    checkMask(mask, count,
+              [&](uint32 i) { return CollisionUtils::overlapsRay(spheres[i], origin, direction, maxDistance); });
+}
+
+BZ_TEST(batchIntersectionsMatchCollisionUtils) {
+    for (uint32 count = 0; count <= MAX_BATCH_COUNT; ++count) {
+        for (uint32 iteration = 0; iteration < 50; ++iteration) {
+            std::vector<AABB> aabbs;
+            std::vector<BoundingSphere> spheres;
+            for (uint32 i = 0; i < count; ++i) {
+                aabbs.push_back(randomAABB());
+                spheres.push_back(randomSphere());
+            }
+
+            const glm::vec3 origin = Testing::randomVec3(-10.0f, 10.0f);
+            const glm::vec3 direction = Testing::randomVec3(-1.0f, 1.0f);
+            const float maxDistance = Testing::randomFloat(0.0f, 30.0f);
+            const Frustum frustum = randomFrustum();
+            checkAABBBatch(aabbs, randomAABB(), randomSphere(), frustum, origin, direction, maxDistance);
+            checkSphereBatch(spheres, randomAABB(), randomSphere(), frustum, origin, direction, maxDistance);
+        }
+    }
+}
+
+BZ_TEST(batchIntersectionsMatchCollisionUtilsOnTouchingVolumes) {
+    for (uint32 count = 0; count <= MAX_BATCH_COUNT; ++count) {
+        for (uint32 iteration = 0; iteration < 50; ++iteration) {
+            std::vector<AABB> aabbs;
+            std::vector<BoundingSphere> spheres;
+            for (uint32 i = 0; i < count; ++i) {
+                aabbs.push_back(randomGridAABB());
+                spheres.push_back(randomGridSphere());
+            }
+
+            // Origins on the faces of the volumes, with zero and axis aligned directions.
+            const glm::vec3 origin = randomGridVec3(-4, 4);
+            const glm::vec3 direction = iteration % 5 == 0 ? glm::vec3(0.0f) : randomGridDirection();
+            const float maxDistance = randomGridFloat(0, 8);
+            const Frustum frustum = randomFrustum();
+            checkAABBBatch(aabbs, randomGridAABB(), randomGridSphere(), frustum, origin, direction, maxDistance);
+            checkSphereBatch(spheres, randomGridAABB(), randomGridSphere(), frustum, origin, direction, maxDistance);
+        }
+    }
+}
+
+BZ_TEST(batchIntersectionsZeroDirectionRay) {
+    AABBBatch aabbBatch;
+    aabbBatch.add(AABB(glm::vec3(0.0f), glm::vec3(2.0f)));
+    uint32 mask[1];
+
+    // The origin on a face and not moving touches the AABB. A plain 1 / 0 gives 0 * inf = NaN on that axis.
+    BatchIntersections::overlapsRay(aabbBatch, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f), 10.0f, mask);
+    BZ_CHECK(BatchIntersections::isBitSet(mask, 0));
+    BZ_CHECK(CollisionUtils::overlapsRay(AABB(glm::vec3(0.0f), glm::vec3(2.0f)), glm::vec3(1.0f, 0.0f, 0.0f),
+                                         CollisionUtils::safeInverse(glm::vec3(0.0f)), 10.0f));
+
+    BatchIntersections::overlapsRay(aabbBatch, glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(0.0f), 10.0f, mask);
+    BZ_CHECK(!BatchIntersections::isBitSet(mask, 0));
+
+    SphereBatch sphereBatch;
+    sphereBatch.add(BoundingSphere(glm::vec3(0.0f), 1.0f));
+    BatchIntersections::overlapsRay(sphereBatch, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f), 10.0f, mask);
+    BZ_CHECK(BatchIntersections::isBitSet(mask, 0));
+    BatchIntersections::overlapsRay(sphereBatch, glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(0.0f), 10.0f, mask);
+    BZ_CHECK(!BatchIntersections::isBitSet(mask, 0));
+}
+
+BZ_BENCHMARK(batchIntersectionsThroughput) {
+    constexpr uint32 COUNT = 100000;
+    constexpr uint32 REPEATS = 100;
+
+    AABBBatch aabbBatch;
+    SphereBatch sphereBatch;
+    std::vector<AABB> aabbs;
+    std::vector<BoundingSphere> spheres;
+    aabbBatch.reserve(COUNT);
+    sphereBatch.reserve(COUNT);
+    for (uint32 i = 0; i < COUNT; ++i) {
+        aabbs.push_back(randomAABB());
+        spheres.push_back(randomSphere());
+        aabbBatch.add(aabbs.back());
+        sphereBatch.add(spheres.back());
+    }
+    std::vector<uint32> mask(BatchIntersections::getMaskWordCount(COUNT));
+
+    const AABB aabb = randomAABB();
+    const BoundingSphere sphere = randomSphere();
+    const Frustum frustum = randomFrustum();
+    const glm::vec3 origin = Testing::randomVec3(-10.0f, 10.0f);
+    const glm::vec3 direction = Testing::randomVec3(-1.0f, 1.0f);
+    const glm::vec3 invDirection = CollisionUtils::safeInverse(direction);
+
+    // The scalar loops write the same mask, so the work is comparable.
+    uint32 checksum = 0;
+    auto measure = [&](const char *name, const auto &batchFn, const auto &scalarFn) {
+        Timer timer;
+        timer.start();
+        for (uint32 r = 0; r < REPEATS; ++r) {
+            batchFn();
+            checksum += mask[r % mask.size()];
+        }
+        const float batchMs = timer.getCountedTime().asMillisecondsFloat();
+
+        timer.restart();
+        for (uint32 r = 0; r < REPEATS; ++r) {
+            std::fill(mask.begin(), mask.end(), 0u);
+            for (uint32 i = 0; i < COUNT; ++i) {
+                mask[i / 32] |= (scalarFn(i) ? 1u : 0u) << (i % 32);
+            }
+            checksum += mask[r % mask.size()];
+        }
+        const float scalarMs = timer.getCountedTime().asMillisecondsFloat();
+
+        const float tests = static_cast<float>(COUNT) * REPEATS;
+        std::printf("    %s: %.1f Mtests/s, CollisionUtils %.1f Mtests/s (x%.2f)\n", name, tests / (batchMs * 1000.0f),
+                    tests / (scalarMs * 1000.0f), scalarMs / batchMs);
+    };
+
+    std::printf("    SIMD width %u, %u volumes\n", BatchIntersections::getSimdWidth(), COUNT);
+    measure(
+        "AABB vs AABB", [&]() { BatchIntersections::overlaps(aabbBatch, aabb, mask.data()); },
+        [&](uint32 i) { return CollisionUtils::overlaps(aabbs[i], aabb); });
+    measure(
+        "AABB vs sphere", [&]() { BatchIntersections::overlaps(aabbBatch, sphere, mask.data()); },
+        [&](uint32 i) { return CollisionUtils::overlaps(aabbs[i], sphere); });
+    measure(
+        "AABB vs frustum", [&]() { BatchIntersections::overlapsFrustum(aabbBatch, frustum.getPlanes(), mask.data()); },
+        [&](uint32 i) { return CollisionUtils::overlapsFrustum(aabbs[i], frustum.getPlanes()); });
+    measure(
+        "AABB vs ray", [&]() { BatchIntersections::overlapsRay(aabbBatch, origin, direction, 30.0f, mask.data()); },
+        [&](uint32 i) { return CollisionUtils::overlapsRay(aabbs[i], origin, invDirection, 30.0f); });
+    measure(
+        "sphere vs sphere", [&]() { BatchIntersections::overlaps(sphereBatch, sphere, mask.data()); },
+        [&](uint32 i) { return CollisionUtils::overlaps(spheres[i], sphere); });
+    measure(
+        "sphere vs frustum",
+        [&]() { BatchIntersections::overlapsFrustum(sphereBatch, frustum.getPlanes(), mask.data()); },
+        [&](uint32 i) { return CollisionUtils::overlapsFrustum(spheres[i], frustum.getPlanes()); });
+    measure(
+        "sphere vs ray", [&]() { BatchIntersections::overlapsRay(sphereBatch, origin, direction, 30.0f, mask.data()); },
+        [&](uint32 i) { return CollisionUtils::overlapsRay(spheres[i], origin, direction, 30.0f); });
+
+    std::printf("    (checksum %u)\n", checksum);
+}
+}
@@ -0,0 +1,235 @@
+#include "Testing.h"
+
+#include <cstdio>
+
+#include "Collisions/CollisionUtils.h"
+#include "Collisions/GridBroadphase.h"
+#include "Collisions/SweepAndPruneBroadphase.h"
+#include "Core/Timer.h"
+
+
+namespace BZ {
+
+using Pairs = std::vector<std::pair<uint32, uint32>>;
+
+/*
+ * A Broadphase and the AABBs it was fed, indexed by user data. The Broadphase keeps pointers to the volumes, so they
+ * live on the heap and are changed in place.
+ */
+struct BroadphaseFixture {
+    std::unique_ptr<Broadphase> broadphase;
+    std::vector<std::unique_ptr<AABB>> volumes;
+    std::vector<uint32> colliders;
+
+    explicit BroadphaseFixture(std::unique_ptr<Broadphase> broadphase) : broadphase(std::move(broadphase)) {}
+
+    uint32 add(const AABB &aabb) {
+        const uint32 userData = static_cast<uint32>(volumes.size());
+        volumes.push_back(std::make_unique<AABB>(aabb));
+        colliders.push_back(broadphase->addCollider(*volumes.back(), userData));
+        return userData;
+    }
+
+    void remove(uint32 userData) {
+        broadphase->removeCollider(colliders[userData]);
+        colliders[userData] = Broadphase::INVALID_COLLIDER;
+    }
+
+    void move(uint32 userData, const AABB &aabb) {
+        *volumes[userData] = aabb;
+        broadphase->updateCollider(colliders[userData]);
+    }
+
+    bool isAlive(uint32 userData) const { return colliders[userData] != Broadphase::INVALID_COLLIDER; }
+
+    // Sorted, with the lower user data first on each pair.
+    Pairs findPairs() {
+        broadphase->findContacts([](uint32 userDataA, uint32 userDataB, const IntersectionResult &result) {});
+
+        Pairs pairs;
+        broadphase->getPairs(pairs);
+        for (auto &pair : pairs) {
+            if (pair.first > pair.second) {
+                std::swap(pair.first, pair.second);
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    Pairs bruteForcePairs() const {
+        Pairs pairs;
+        for (uint32 a = 0; a < volumes.size(); ++a) {
+            for (uint32 b = a + 1; b < volumes.size(); ++b) {
+                if (isAlive(a) && isAlive(b) && CollisionUtils::overlaps(*volumes[a], *volumes[b])) {
+                    pairs.emplace_back(a, b);
+                }
+            }
+        }
+        return pairs;
+    }
+};
+
+static std::vector<BroadphaseFixture> makeFixtures(float gridCellSize) {
+    std::vector<BroadphaseFixture> fixtures;
+    fixtures.emplace_back(std::make_unique<SweepAndPruneBroadphase>());
+    fixtures.emplace_back(std::make_unique<GridBroadphase>(gridCellSize));
+    return fixtures;
+}
+
+static AABB randomAABB() {
+    return AABB(Testing::randomVec3(-100.0f, 100.0f), Testing::randomVec3(0.5f, 10.0f));
+}
+
+// On an integer grid, with cells of the same size, so faces touch each other and the cell boundaries.
+static AABB randomGridAABB() {
+    auto randomInt = [](int32 min, int32 max) {
+        return static_cast<float>(std::uniform_int_distribution<int32>(min, max)(Testing::getRandomEngine()));
+    };
+    const glm::vec3 min(randomInt(-8, 8), randomInt(-8, 8), randomInt(-8, 8));
+    return AABB(min + glm::vec3(1.0f), glm::vec3(2.0f));
+}
+
+template <typename RandomAABBFn>
+static void checkAgainstBruteForce(float gridCellSize, uint32 colliderCount, const RandomAABBFn &randomAABBFn,
+                                   const glm::vec3 &maxStep) {
+    for (BroadphaseFixture &fixture : makeFixtures(gridCellSize)) {
+        for (uint32 i = 0; i < colliderCount; ++i) {
+            fixture.add(randomAABBFn());
+        }
+        BZ_CHECK(fixture.findPairs() == fixture.bruteForcePairs());
+
+        for (uint32 frame = 0; frame < 20; ++frame) {
+            // Some small steps, some teleports.
+            for (uint32 userData = 0; userData < fixture.volumes.size(); ++userData) {
+                if (!fixture.isAlive(userData) || userData % 3 == frame % 3) {
+                    continue;
+                }
+                const AABB &aabb = *fixture.volumes[userData];
+                if (userData % 7 == 0) {
+                    fixture.move(userData, randomAABBFn());
+                }
+                else {
+                    const glm::vec3 step = glm::round(Testing::randomVec3(-1.0f, 1.0f) * maxStep);
+                    fixture.move(userData, AABB(aabb.getCenter() + step, aabb.getDimensions()));
+                }
+            }
+
+            // Some removals, and additions reusing the colliders.
+            for (uint32 i = 0; i < 5; ++i) {
+                const uint32 userData = (frame * 37 + i * 11) % static_cast<uint32>(fixture.volumes.size());
+                if (fixture.isAlive(userData)) {
+                    fixture.remove(userData);
+                }
+                fixture.add(randomAABBFn());
+            }
+
+            BZ_CHECK(fixture.findPairs() == fixture.bruteForcePairs());
+        }
+    }
+}
+
+BZ_TEST(broadphasePairsMatchBruteForce) {
+    checkAgainstBruteForce(10.0f, 1000, randomAABB, glm::vec3(3.0f));
+}
+
+// Whole unit steps on the integer grid, so intervals keep ending exactly where others start.
+BZ_TEST(broadphasePairsMatchBruteForceOnTouchingAABBs) {
+    checkAgainstBruteForce(2.0f, 300, randomGridAABB, glm::vec3(2.0f));
+}
+
+BZ_TEST(broadphaseTouchingAABBsOverlap) {
+    for (BroadphaseFixture &fixture : makeFixtures(1.0f)) {
+        const uint32 a = fixture.add(AABB(glm::vec3(0.0f), glm::vec3(2.0f)));
+        const uint32 b = fixture.add(AABB(glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(2.0f)));
+        BZ_CHECK(fixture.findPairs() == Pairs({ { a, b } }));
+
+        // Apart, and touching again from the other side.
+        fixture.move(b, AABB(glm::vec3(2.5f, 0.0f, 0.0f), glm::vec3(2.0f)));
+        BZ_CHECK(fixture.findPairs().empty());
+        fixture.move(b, AABB(glm::vec3(-2.0f, 0.0f, 0.0f), glm::vec3(2.0f)));
+        BZ_CHECK(fixture.findPairs() == Pairs({ { a, b } }));
+
+        // Touching on a corner.
+        fixture.move(b, AABB(glm::vec3(-2.0f, 2.0f, -2.0f), glm::vec3(2.0f)));
+        BZ_CHECK(fixture.findPairs() == Pairs({ { a, b } }));
+        fixture.move(b, AABB(glm::vec3(-2.0f, 2.0f, -2.1f), glm::vec3(2.0f)));
+        BZ_CHECK(fixture.findPairs().empty());
+    }
+}
+
+// Cells far apart from each other, which used to share a key, never pair up.
+BZ_TEST(gridBroadphaseFarCellsDontCollide) {
+    BroadphaseFixture fixture(std::make_unique<GridBroadphase>(1.0f));
+    fixture.add(AABB(glm::vec3(0.5f), glm::vec3(0.5f)));
+    fixture.add(AABB(glm::vec3(0.5f + static_cast<float>(1 << 21), 0.5f, 0.5f), glm::vec3(0.5f)));
+    fixture.add(AABB(glm::vec3(0.5f, 0.5f - static_cast<float>(1 << 21), 0.5f), glm::vec3(0.5f)));
+    BZ_CHECK(fixture.findPairs().empty());
+    BZ_CHECK(fixture.bruteForcePairs().empty());
+}
+
+BZ_BENCHMARK(broadphase10kMovingColliders) {
+    constexpr uint32 COLLIDER_COUNT = 10000;
+    constexpr uint32 FRAME_COUNT = 60;
+    constexpr uint32 BRUTE_FORCE_FRAME_COUNT = 3;
+    constexpr float WORLD_EXTENT = 200.0f;
+
+    std::vector<AABB> initialAABBs;
+    std::vector<glm::vec3> velocities;
+    for (uint32 i = 0; i < COLLIDER_COUNT; ++i) {
+        initialAABBs.emplace_back(Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT), Testing::randomVec3(1.0f, 4.0f));
+        velocities.push_back(Testing::randomVec3(-0.5f, 0.5f));
+    }
+
+    auto moveAll = [&velocities](BroadphaseFixture &fixture) {
+        for (uint32 i = 0; i < COLLIDER_COUNT; ++i) {
+            const AABB &aabb = *fixture.volumes[i];
+            fixture.move(i, AABB(aabb.getCenter() + velocities[i], aabb.getDimensions()));
+        }
+    };
+
+    const char *names[] = { "sweep and prune", "grid" };
+    std::vector<BroadphaseFixture> fixtures = makeFixtures(4.0f);
+    for (uint32 f = 0; f < fixtures.size(); ++f) {
+        BroadphaseFixture &fixture = fixtures[f];
+
+        Timer timer;
+        timer.start();
+        for (const AABB &aabb : initialAABBs) {
+            fixture.add(aabb);
+        }
+        const float addMs = timer.getCountedTime().asMillisecondsFloat();
+
+        uint64 pairCount = 0;
+        timer.restart();
+        for (uint32 frame = 0; frame < FRAME_COUNT; ++frame) {
+            moveAll(fixture);
+            fixture.broadphase->findContacts(
+                [](uint32 userDataA, uint32 userDataB, const IntersectionResult &result) {});
+            pairCount += fixture.broadphase->getPairCount();
+        }
+        std::printf("    %s: add %.2f ms, %.3f ms per frame, %.1f pairs per frame\n", names[f], addMs,
+                    timer.getCountedTime().asMillisecondsFloat() / FRAME_COUNT,
+                    static_cast<float>(pairCount) / FRAME_COUNT);
+    }
+
+    // Same movement, testing every pair.
+    std::vector<AABB> aabbs = initialAABBs;
+    uint64 pairCount = 0;
+    Timer timer;
+    timer.start();
+    for (uint32 frame = 0; frame < BRUTE_FORCE_FRAME_COUNT; ++frame) {
+        for (uint32 i = 0; i < COLLIDER_COUNT; ++i) {
+            aabbs[i] = AABB(aabbs[i].getCenter() + velocities[i], aabbs[i].getDimensions());
+        }
+        for (uint32 a = 0; a < COLLIDER_COUNT; ++a) {
+            for (uint32 b = a + 1; b < COLLIDER_COUNT; ++b) {
+                pairCount += CollisionUtils::overlaps(aabbs[a], aabbs[b]);
+            }
+        }
+    }
+    std::printf("    brute force: %.3f ms per frame, %.1f pairs per frame\n",
+                timer.getCountedTime().asMillisecondsFloat() / BRUTE_FORCE_FRAME_COUNT,
+                static_cast<float>(pairCount) / BRUTE_FORCE_FRAME_COUNT);
+}
+}
@@ -0,0 +1,293 @@
+#include "Testing.h"
+
+#include "Collisions/AABB.h"
+#include "Collisions/Frustum.h"
+#include "Core/Utils.h"
+
+
+namespace BZ {
+
+// Points closer than this to a plane, relative to w, are not compared. Both sides are right there.
+static constexpr float CLIP_EPSILON = 1e-3f;
+
+/*
+ * The frustum as the brute force sees it: a point is inside when it's inside the Vulkan clip volume,
+ * -w <= x, y <= w and 0 <= z <= w.
+ */
+struct FrustumFixture {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    float nearDistance;
+    float farDistance;
+    Frustum frustum;
+
+    FrustumFixture(const glm::mat4 &view, const glm::mat4 &projection, float nearDistance, float farDistance) :
+        view(view), projection(projection), viewProjection(projection * view), nearDistance(nearDistance),
+        farDistance(farDistance), frustum(viewProjection) {}
+
+    // The six clip space distances, positive inside, in the order of Frustum::getPlanes().
+    void getClipDistances(const glm::vec3 &point, float outDistances[6]) const {
+        const glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+        outDistances[0] = clip.w + clip.x;
+        outDistances[1] = clip.w - clip.x;
+        outDistances[2] = clip.w + clip.y;
+        outDistances[3] = clip.w - clip.y;
+        outDistances[4] = clip.z;
+        outDistances[5] = clip.w - clip.z;
+    }
+
+    float getEpsilon(const glm::vec3 &point) const {
+        const glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+        return CLIP_EPSILON * glm::max(1.0f, glm::abs(clip.w));
+    }
+
+    // False if too close to call.
+    bool isClearlyInsideOrOutside(const glm::vec3 &point) const {
+        float distances[6];
+        getClipDistances(point, distances);
+        const float epsilon = getEpsilon(point);
+        for (float distance : distances) {
+            if (glm::abs(distance) < epsilon) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isInside(const glm::vec3 &point) const {
+        float distances[6];
+        getClipDistances(point, distances);
+        for (float distance : distances) {
+            if (distance < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Around the frustum volume, so there are points on both sides of every plane.
+    glm::vec3 randomPoint() const {
+        AABB bounds(frustum.getCorners(), Frustum::CORNER_COUNT);
+        const glm::vec3 t(Testing::randomFloat(-0.25f, 1.25f), Testing::randomFloat(-0.25f, 1.25f),
+                          Testing::randomFloat(-0.25f, 1.25f));
+        return bounds.getMin() + bounds.getDimensions() * t;
+    }
+};
+
+static glm::mat4 randomView() {
+    const glm::vec3 eye = Testing::randomVec3(-20.0f, 20.0f);
+    return glm::lookAtRH(eye, eye + Testing::randomVec3(-1.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+static std::vector<FrustumFixture> randomFixtures(uint32 count) {
+    std::vector<FrustumFixture> fixtures;
+    for (uint32 i = 0; i < count; ++i) {
+        const float nearDistance = Testing::randomFloat(0.1f, 2.0f);
+        const float farDistance = nearDistance + Testing::randomFloat(5.0f, 100.0f);
+        const float aspectRatio = Testing::randomFloat(0.5f, 2.5f);
+        if (i % 2 == 0) {
+            fixtures.emplace_back(
+                randomView(),
+                Utils::perspective(Testing::randomFloat(20.0f, 120.0f), aspectRatio, nearDistance, farDistance),
+                nearDistance, farDistance);
+        }
+        else {
+            const float halfHeight = Testing::randomFloat(1.0f, 50.0f);
+            const float halfWidth = halfHeight * aspectRatio;
+            fixtures.emplace_back(
+                randomView(),
+                Utils::ortho(-halfWidth, halfWidth, -halfHeight, halfHeight, nearDistance, farDistance),
+                nearDistance, farDistance);
+        }
+    }
+    return fixtures;
+}
+
+static void getAABBCorners(const AABB &aabb, glm::vec3 outCorners[8]) {
+    for (uint32 i = 0; i < 8; ++i) {
+        outCorners[i] = glm::vec3((i & 1) ? aabb.getMax().x : aabb.getMin().x,
+                                  (i & 2) ? aabb.getMax().y : aabb.getMin().y,
+                                  (i & 4) ? aabb.getMax().z : aabb.getMin().z);
+    }
+}
+
+BZ_TEST(frustumContainsMatchesClipSpace) {
+    for (const FrustumFixture &fixture : randomFixtures(50)) {
+        for (uint32 i = 0; i < 2000; ++i) {
+            const glm::vec3 point = fixture.randomPoint();
+            if (fixture.isClearlyInsideOrOutside(point)) {
+                BZ_CHECK(fixture.frustum.contains(point) == fixture.isInside(point));
+            }
+        }
+    }
+}
+
+BZ_TEST(frustumCornersAreOnThePlanes) {
+    for (const FrustumFixture &fixture : randomFixtures(50)) {
+        const glm::vec3 *corners = fixture.frustum.getCorners();
+        const glm::vec4 *planes = fixture.frustum.getPlanes();
+        const float scale = glm::distance(corners[0], corners[7]);
+
+        for (uint32 c = 0; c < Frustum::CORNER_COUNT; ++c) {
+            // Index bits are x, y and z, so each corner is on one plane of each pair.
+            const uint32 cornerPlanes[3] = { (c & 1) ? 1u : 0u, (c & 2) ? 3u : 2u, (c & 4) ? 5u : 4u };
+            for (uint32 p = 0; p < Frustum::PLANE_COUNT; ++p) {
+                const float distance = glm::dot(glm::vec3(planes[p]), corners[c]) + planes[p].w;
+                const bool isOnPlane = p == cornerPlanes[0] || p == cornerPlanes[1] || p == cornerPlanes[2];
+                if (isOnPlane) {
+                    BZ_CHECK(glm::abs(distance) <= 1e-3f * scale);
+                }
+                else {
+                    BZ_CHECK(distance >= -1e-3f * scale);
+                }
+            }
+        }
+
+        // The bounding sphere encloses all of them.
+        const BoundingSphere sphere = fixture.frustum.getBoundingSphere();
+        for (uint32 c = 0; c < Frustum::CORNER_COUNT; ++c) {
+            BZ_CHECK(glm::distance(sphere.getCenter(), corners[c]) <= sphere.getRadius() * (1.0f + 1e-4f));
+        }
+    }
+}
+
+// An AABB is rejected exactly when all its corners are outside the same clip plane.
+BZ_TEST(frustumOverlapsAABBMatchesClipSpaceCorners) {
+    for (const FrustumFixture &fixture : randomFixtures(50)) {
+        for (uint32 i = 0; i < 2000; ++i) {
+            const float depthRange = fixture.farDistance - fixture.nearDistance;
+            const AABB aabb(fixture.randomPoint(), Testing::randomVec3(0.0f, 0.1f) * depthRange);
+            glm::vec3 corners[8];
+            getAABBCorners(aabb, corners);
+
+            bool isCloseCall = false;
+            bool isOutside = false;
+            uint32 insideCount = 0;
+            float distances[8][6];
+            for (uint32 c = 0; c < 8; ++c) {
+                fixture.getClipDistances(corners[c], distances[c]);
+                isCloseCall |= !fixture.isClearlyInsideOrOutside(corners[c]);
+                insideCount += fixture.isInside(corners[c]);
+            }
+            for (uint32 p = 0; p < 6; ++p) {
+                bool allOutside = true;
+                for (uint32 c = 0; c < 8; ++c) {
+                    allOutside &= distances[c][p] < 0.0f;
+                }
+                isOutside |= allOutside;
+            }
+            if (isCloseCall) {
+                continue;
+            }
+
+            BZ_CHECK(fixture.frustum.overlaps(aabb) == !isOutside);
+
+            uint32 planeMask = Frustum::ALL_PLANES_MASK;
+            uint32 lastPlane = i % Frustum::PLANE_COUNT;
+            const Frustum::TestResult result = fixture.frustum.test(aabb, planeMask, lastPlane);
+            BZ_CHECK((result == Frustum::TestResult::Outside) == isOutside);
+            BZ_CHECK((result == Frustum::TestResult::Inside) == (insideCount == 8));
+            BZ_CHECK((result == Frustum::TestResult::Inside) == (planeMask == 0));
+        }
+    }
+}
+
+// Any point of the volume inside the frustum means it overlaps. Fully inside means every point is.
+BZ_TEST(frustumOverlapsMatchesSampledPoints) {
+    for (const FrustumFixture &fixture : randomFixtures(20)) {
+        for (uint32 i = 0; i < 500; ++i) {
+            const float size = Testing::randomFloat(0.0f, 0.1f) * (fixture.farDistance - fixture.nearDistance);
+            const AABB aabb(fixture.randomPoint(), Testing::randomVec3(0.0f, 1.0f) * size);
+            const BoundingSphere sphere(fixture.randomPoint(), size);
+
+            uint32 aabbPlaneMask = Frustum::ALL_PLANES_MASK;
+            uint32 spherePlaneMask = Frustum::ALL_PLANES_MASK;
+            uint32 lastPlane = 0;
+            const Frustum::TestResult aabbResult = fixture.frustum.test(aabb, aabbPlaneMask, lastPlane);
+            const Frustum::TestResult sphereResult = fixture.frustum.test(sphere, spherePlaneMask, lastPlane);
+            BZ_CHECK((aabbResult != Frustum::TestResult::Outside) == fixture.frustum.overlaps(aabb));
+            BZ_CHECK((sphereResult != Frustum::TestResult::Outside) == fixture.frustum.overlaps(sphere));
+
+            for (uint32 s = 0; s < 64; ++s) {
+                const glm::vec3 aabbPoint = aabb.getMin() + aabb.getDimensions() * Testing::randomVec3(0.0f, 1.0f);
+                if (fixture.isClearlyInsideOrOutside(aabbPoint)) {
+                    if (fixture.isInside(aabbPoint)) {
+                        BZ_CHECK(aabbResult != Frustum::TestResult::Outside);
+                    }
+                    else {
+                        BZ_CHECK(aabbResult != Frustum::TestResult::Inside);
+                    }
+                }
+
+                glm::vec3 offset = Testing::randomVec3(-1.0f, 1.0f);
+                if (glm::dot(offset, offset) > 1.0f) {
+                    continue;
+                }
+                const glm::vec3 spherePoint = sphere.getCenter() + offset * sphere.getRadius();
+                if (fixture.isClearlyInsideOrOutside(spherePoint)) {
+                    if (fixture.isInside(spherePoint)) {
+                        BZ_CHECK(sphereResult != Frustum::TestResult::Outside);
+                    }
+                    else {
+                        BZ_CHECK(sphereResult != Frustum::TestResult::Inside);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// The mask of a parent only skips planes its children are also inside of.
+BZ_TEST(frustumPlaneMaskMatchesFullTest) {
+    for (const FrustumFixture &fixture : randomFixtures(20)) {
+        for (uint32 i = 0; i < 500; ++i) {
+            const glm::vec3 parentSize = Testing::randomVec3(0.0f, 0.2f) * (fixture.farDistance - fixture.nearDistance);
+            const AABB parent(fixture.randomPoint(), parentSize);
+
+            uint32 parentMask = Frustum::ALL_PLANES_MASK;
+            uint32 lastPlane = 0;
+            if (fixture.frustum.test(parent, parentMask, lastPlane) == Frustum::TestResult::Outside) {
+                continue;
+            }
+
+            for (uint32 c = 0; c < 8; ++c) {
+                const glm::vec3 childSize = parentSize * Testing::randomVec3(0.0f, 1.0f);
+                const glm::vec3 childMin = parent.getMin() + (parentSize - childSize) * Testing::randomVec3(0.0f, 1.0f);
+                const AABB child(childMin + childSize * 0.5f, childSize);
+
+                uint32 childMask = parentMask;
+                uint32 fullMask = Frustum::ALL_PLANES_MASK;
+                const Frustum::TestResult maskedResult = fixture.frustum.test(child, childMask, lastPlane);
+                const Frustum::TestResult fullResult = fixture.frustum.test(child, fullMask, lastPlane);
+                BZ_CHECK((maskedResult == Frustum::TestResult::Outside) ==
+                         (fullResult == Frustum::TestResult::Outside));
+            }
+        }
+    }
+}
+
+BZ_TEST(frustumSliceMatchesViewDepth) {
+    for (const FrustumFixture &fixture : randomFixtures(50)) {
+        const float nearFraction = Testing::randomFloat(0.0f, 0.9f);
+        const float farFraction = Testing::randomFloat(nearFraction + 0.05f, 1.0f);
+        const Frustum slice = fixture.frustum.getSlice(nearFraction, farFraction);
+
+        const float sliceNear = fixture.nearDistance + (fixture.farDistance - fixture.nearDistance) * nearFraction;
+        const float sliceFar = fixture.nearDistance + (fixture.farDistance - fixture.nearDistance) * farFraction;
+        const float depthEpsilon = 1e-3f * fixture.farDistance;
+
+        for (uint32 i = 0; i < 2000; ++i) {
+            const glm::vec3 point = fixture.randomPoint();
+            const float depth = -(fixture.view * glm::vec4(point, 1.0f)).z;
+            if (!fixture.isClearlyInsideOrOutside(point) || glm::abs(depth - sliceNear) < depthEpsilon ||
+                glm::abs(depth - sliceFar) < depthEpsilon) {
+                continue;
+            }
+
+            const bool isInside = fixture.isInside(point) && depth >= sliceNear && depth <= sliceFar;
+            BZ_CHECK(slice.contains(point) == isInside);
+        }
+    }
+}
+}
@@ -0,0 +1,332 @@
+#include "Testing.h"
+
+#include <cstdio>
+
+#include "Collisions/BVH.h"
+#include "Collisions/BoundingSphere.h"
+#include "Collisions/Ray.h"
+#include "Collisions/TriangleMesh.h"
+#include "Core/Timer.h"
+
+
+namespace BZ {
+
+// Hits closer than this to an edge, to the ray origin or to maxDistance are not compared. Both answers are right.
+static constexpr double CLOSE_CALL_EPSILON = 1e-4;
+
+struct MeshData {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32> indices;
+};
+
+// UV sphere of radius 1, with ringCount * segmentCount * 2 triangles.
+static MeshData makeSphere(uint32 ringCount, uint32 segmentCount) {
+    MeshData mesh;
+    for (uint32 ring = 0; ring <= ringCount; ++ring) {
+        const float theta = glm::pi<float>() * ring / ringCount;
+        for (uint32 segment = 0; segment <= segmentCount; ++segment) {
+            const float phi = glm::two_pi<float>() * segment / segmentCount;
+            mesh.positions.emplace_back(glm::sin(theta) * glm::cos(phi), glm::cos(theta),
+                                        glm::sin(theta) * glm::sin(phi));
+        }
+    }
+    for (uint32 ring = 0; ring < ringCount; ++ring) {
+        for (uint32 segment = 0; segment < segmentCount; ++segment) {
+            const uint32 a = ring * (segmentCount + 1) + segment;
+            const uint32 b = a + segmentCount + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+    return mesh;
+}
+
+static MeshData makeTriangleSoup(uint32 triangleCount, float extent) {
+    MeshData mesh;
+    for (uint32 i = 0; i < triangleCount; ++i) {
+        const glm::vec3 center = Testing::randomVec3(-extent, extent);
+        for (uint32 v = 0; v < 3; ++v) {
+            mesh.indices.push_back(static_cast<uint32>(mesh.positions.size()));
+            mesh.positions.push_back(center + Testing::randomVec3(-1.0f, 1.0f));
+        }
+    }
+    return mesh;
+}
+
+static TriangleMesh makeTriangleMesh(const MeshData &mesh) {
+    return TriangleMesh(mesh.positions.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+}
+
+/*
+ * Reference ray/triangle test in double precision: the hit on the triangle plane, and then the barycentric coordinates
+ * of it. Sets isCloseCall when the hit is too close to an edge or to the ends of the ray to compare.
+ */
+static bool referenceIntersectsTriangle(const glm::vec3 &origin, const glm::vec3 &direction,
+                                        const glm::vec3 vertices[3], double maxDistance, double &outDistance,
+                                        bool &isCloseCall) {
+    const glm::dvec3 o(origin), d(direction), v0(vertices[0]), v1(vertices[1]), v2(vertices[2]);
+    const glm::dvec3 normal = glm::cross(v1 - v0, v2 - v0);
+    const double denominator = glm::dot(normal, d);
+    isCloseCall = false;
+
+    if (glm::abs(denominator) < CLOSE_CALL_EPSILON * glm::length(normal) * glm::length(d)) {
+        isCloseCall = denominator != 0.0;
+        return false;
+    }
+
+    const double distance = glm::dot(normal, v0 - o) / denominator;
+    const glm::dvec3 point = o + d * distance;
+
+    // Barycentric coordinates, by the areas of the sub triangles over the whole one.
+    const double area = glm::dot(normal, normal);
+    const double b0 = glm::dot(glm::cross(v2 - v1, point - v1), normal) / area;
+    const double b1 = glm::dot(glm::cross(v0 - v2, point - v2), normal) / area;
+    const double b2 = 1.0 - b0 - b1;
+
+    const double scale = glm::max(1.0, glm::abs(distance));
+    isCloseCall = glm::abs(b0) < CLOSE_CALL_EPSILON || glm::abs(b1) < CLOSE_CALL_EPSILON ||
+                  glm::abs(b2) < CLOSE_CALL_EPSILON || glm::abs(distance) < CLOSE_CALL_EPSILON * scale ||
+                  glm::abs(distance - maxDistance) < CLOSE_CALL_EPSILON * scale;
+
+    if (b0 < 0.0 || b1 < 0.0 || b2 < 0.0 || distance < 0.0 || distance > maxDistance) {
+        return false;
+    }
+    outDistance = distance;
+    return true;
+}
+
+BZ_TEST(rayIntersectsTriangleMatchesReference) {
+    uint32 hitCount = 0;
+    for (uint32 i = 0; i < 200000; ++i) {
+        const glm::vec3 vertices[3] = { Testing::randomVec3(-1.0f, 1.0f), Testing::randomVec3(-1.0f, 1.0f),
+                                        Testing::randomVec3(-1.0f, 1.0f) };
+        const Ray ray(Testing::randomVec3(-3.0f, 3.0f), Testing::randomVec3(-1.0f, 1.0f));
+        const float maxDistance = Testing::randomFloat(0.0f, 10.0f);
+
+        double referenceDistance;
+        bool isCloseCall;
+        const bool referenceHit = referenceIntersectsTriangle(ray.getOrigin(), ray.getDirection(), vertices,
+                                                              maxDistance, referenceDistance, isCloseCall);
+        if (isCloseCall) {
+            continue;
+        }
+
+        // The same from any vertex, and on both faces.
+        for (uint32 first = 0; first < 3; ++first) {
+            const glm::vec3 &v0 = vertices[first];
+            const glm::vec3 &v1 = vertices[(first + 1) % 3];
+            const glm::vec3 &v2 = vertices[(first + 2) % 3];
+            float distance;
+            const bool hit = ray.intersectsTriangle(v0, v1 - v0, v2 - v0, maxDistance, distance);
+            const bool flippedHit = ray.intersectsTriangle(v0, v2 - v0, v1 - v0, maxDistance, distance);
+
+            BZ_CHECK(hit == referenceHit);
+            BZ_CHECK(flippedHit == referenceHit);
+            if (hit && referenceHit) {
+                BZ_CHECK(glm::abs(distance - referenceDistance) <= 1e-3 * glm::max(1.0, referenceDistance));
+            }
+        }
+        hitCount += referenceHit;
+    }
+    BZ_CHECK(hitCount > 1000);
+}
+
+BZ_TEST(rayIntersectsSphereMatchesReference) {
+    uint32 hitCount = 0;
+    for (uint32 i = 0; i < 200000; ++i) {
+        const BoundingSphere sphere(Testing::randomVec3(-3.0f, 3.0f), Testing::randomFloat(0.1f, 2.0f));
+        const glm::vec3 direction = i % 100 == 0 ? glm::vec3(0.0f) : Testing::randomVec3(-1.0f, 1.0f);
+        const Ray ray(Testing::randomVec3(-3.0f, 3.0f), direction);
+        const float maxDistance = Testing::randomFloat(0.0f, 10.0f);
+
+        // Solve |o + d * t - c| = r for the smallest t, in double precision.
+        const glm::dvec3 fromCenter = glm::dvec3(ray.getOrigin()) - glm::dvec3(sphere.getCenter());
+        const glm::dvec3 d(direction);
+        const double radius = sphere.getRadius();
+        const double a = glm::dot(d, d);
+        const double b = glm::dot(fromCenter, d);
+        const double c = glm::dot(fromCenter, fromCenter) - radius * radius;
+
+        bool referenceHit;
+        double referenceDistance = 0.0;
+        bool isCloseCall = glm::abs(c) < CLOSE_CALL_EPSILON * radius * radius;
+        if (c <= 0.0) {
+            referenceHit = true;
+        }
+        else if (a == 0.0) {
+            referenceHit = false;
+        }
+        else {
+            const double discriminant = b * b - a * c;
+            isCloseCall |= glm::abs(discriminant) < CLOSE_CALL_EPSILON * b * b;
+            referenceDistance = (-b - glm::sqrt(glm::max(discriminant, 0.0))) / a;
+            isCloseCall |= glm::abs(referenceDistance - maxDistance) < CLOSE_CALL_EPSILON * glm::max(1.0, maxDistance);
+            referenceHit = discriminant >= 0.0 && referenceDistance >= 0.0 && referenceDistance <= maxDistance;
+        }
+        if (isCloseCall) {
+            continue;
+        }
+
+        float distance;
+        const bool hit = ray.intersects(sphere, maxDistance, distance);
+        BZ_CHECK(hit == referenceHit);
+        if (hit && referenceHit) {
+            BZ_CHECK(glm::abs(distance - referenceDistance) <= 1e-3 * glm::max(1.0, referenceDistance));
+        }
+        hitCount += referenceHit;
+    }
+    BZ_CHECK(hitCount > 1000);
+}
+
+// The BVH of the TriangleMesh must find the same closest hit as testing every triangle.
+BZ_TEST(triangleMeshRaycastMatchesBruteForce) {
+    const MeshData meshes[] = { makeSphere(32, 64), makeTriangleSoup(5000, 20.0f) };
+    for (const MeshData &meshData : meshes) {
+        const TriangleMesh mesh = makeTriangleMesh(meshData);
+        BZ_CHECK(mesh.getTriangleCount() == meshData.indices.size() / 3);
+
+        uint32 hitCount = 0;
+        for (uint32 i = 0; i < 2000; ++i) {
+            const Ray ray(Testing::randomVec3(-25.0f, 25.0f), Testing::randomVec3(-1.0f, 1.0f));
+            const float maxDistance = Testing::randomFloat(1.0f, 100.0f);
+
+            float bruteForceDistance = maxDistance;
+            bool bruteForceHit = false;
+            for (uint32 triangle = 0; triangle < mesh.getTriangleCount(); ++triangle) {
+                glm::vec3 vertices[3];
+                mesh.getTriangle(triangle, vertices);
+                float distance;
+                if (ray.intersectsTriangle(vertices[0], vertices[1] - vertices[0], vertices[2] - vertices[0],
+                                           bruteForceDistance, distance)) {
+                    bruteForceDistance = distance;
+                    bruteForceHit = true;
+                }
+            }
+
+            float distance;
+            uint32 triangle;
+            const bool hit = mesh.raycast(ray, maxDistance, distance, triangle);
+            BZ_CHECK(hit == bruteForceHit);
+            if (hit && bruteForceHit) {
+                BZ_CHECK(glm::abs(distance - bruteForceDistance) <= 1e-5f * glm::max(1.0f, bruteForceDistance));
+
+                // And the reported triangle is hit there.
+                glm::vec3 vertices[3];
+                mesh.getTriangle(triangle, vertices);
+                float triangleDistance;
+                BZ_CHECK(ray.intersectsTriangle(vertices[0], vertices[1] - vertices[0], vertices[2] - vertices[0],
+                                                maxDistance, triangleDistance));
+            }
+            hitCount += hit;
+        }
+        BZ_CHECK(hitCount > 100);
+    }
+}
+
+// Distances are kept when moving the Ray to model space, so hits can be compared between Meshes.
+BZ_TEST(rayTransformedKeepsDistances) {
+    const MeshData meshData = makeSphere(16, 32);
+    const TriangleMesh mesh = makeTriangleMesh(meshData);
+
+    for (uint32 i = 0; i < 1000; ++i) {
+        const glm::quat rotation =
+            glm::normalize(glm::quat(Testing::randomFloat(-1.0f, 1.0f), Testing::randomVec3(-1.0f, 1.0f)));
+        const glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), Testing::randomVec3(-10.0f, 10.0f)) *
+                                      glm::mat4_cast(rotation) *
+                                      glm::scale(glm::mat4(1.0f), Testing::randomVec3(0.5f, 3.0f));
+
+        // From outside, towards the center.
+        const glm::vec3 center(modelMatrix[3]);
+        const glm::vec3 origin = center + glm::normalize(Testing::randomVec3(-1.0f, 1.0f)) * 20.0f;
+        const Ray ray(origin, (center - origin) * Testing::randomFloat(0.1f, 2.0f));
+        const Ray localRay = ray.transformed(glm::inverse(modelMatrix));
+
+        float distance;
+        uint32 triangle;
+        if (!mesh.raycast(localRay, 100.0f, distance, triangle)) {
+            BZ_CHECK(false);
+            continue;
+        }
+
+        const glm::vec3 worldPoint = ray.getPoint(distance);
+        const glm::vec3 localPoint = modelMatrix * glm::vec4(localRay.getPoint(distance), 1.0f);
+        BZ_CHECK(glm::distance(worldPoint, localPoint) <= 1e-3f * glm::length(worldPoint - origin));
+    }
+}
+
+/*
+ * Mouse picking as Scene::raycastClosest does it, without the Engine a Scene needs: a BVH of the Entity AABBs in
+ * world space, and then the TriangleMesh of each candidate with the Ray in its model space.
+ */
+BZ_BENCHMARK(rayPicking10kEntities) {
+    constexpr uint32 ENTITY_COUNT = 10000;
+    constexpr uint32 PICK_COUNT = 1000;
+    constexpr uint32 BRUTE_FORCE_PICK_COUNT = 10;
+    constexpr float WORLD_EXTENT = 500.0f;
+
+    const MeshData meshData = makeSphere(32, 64);
+    const TriangleMesh mesh = makeTriangleMesh(meshData);
+    const AABB meshAABB(meshData.positions.data(), static_cast<uint32>(meshData.positions.size()));
+
+    std::vector<glm::mat4> modelMatrices;
+    std::vector<glm::mat4> invModelMatrices;
+    BVH bvh;
+    for (uint32 i = 0; i < ENTITY_COUNT; ++i) {
+        const glm::mat4 modelMatrix =
+            glm::translate(glm::mat4(1.0f), Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT)) *
+            glm::scale(glm::mat4(1.0f), Testing::randomVec3(1.0f, 5.0f));
+        modelMatrices.push_back(modelMatrix);
+        invModelMatrices.push_back(glm::inverse(modelMatrix));
+        bvh.insert(AABB(meshAABB, modelMatrix), i);
+    }
+    bvh.rebuild();
+
+    std::vector<Ray> rays;
+    for (uint32 i = 0; i < PICK_COUNT; ++i) {
+        rays.emplace_back(Testing::randomVec3(-WORLD_EXTENT, WORLD_EXTENT), Testing::randomVec3(-1.0f, 1.0f));
+    }
+    const float maxDistance = 4.0f * WORLD_EXTENT;
+
+    auto pick = [&](const Ray &ray, bool useBVH) {
+        float closestDistance = maxDistance;
+        auto testEntity = [&](uint32 entity, float currentMaxDistance) {
+            float distance;
+            uint32 triangle;
+            if (mesh.raycast(ray.transformed(invModelMatrices[entity]), currentMaxDistance, distance, triangle)) {
+                closestDistance = distance;
+                return distance;
+            }
+            return currentMaxDistance;
+        };
+
+        if (useBVH) {
+            bvh.raycast(ray.getOrigin(), ray.getDirection(), maxDistance, testEntity);
+        }
+        else {
+            for (uint32 entity = 0; entity < ENTITY_COUNT; ++entity) {
+                testEntity(entity, closestDistance);
+            }
+        }
+        return closestDistance;
+    };
+
+    Timer timer;
+    timer.start();
+    uint32 hitCount = 0;
+    for (const Ray &ray : rays) {
+        hitCount += pick(ray, true) < maxDistance;
+    }
+    const float bvhMs = timer.getCountedTime().asMillisecondsFloat();
+
+    timer.restart();
+    uint32 mismatchCount = 0;
+    for (uint32 i = 0; i < BRUTE_FORCE_PICK_COUNT; ++i) {
+        mismatchCount += pick(rays[i], false) != pick(rays[i], true);
+    }
+    const float bruteForceMs = timer.getCountedTime().asMillisecondsFloat();
+    BZ_CHECK(mismatchCount == 0);
+
+    std::printf("    %u Entities of %u triangles: %.4f ms per pick (%u of %u hit), brute force %.2f ms per pick\n",
+                ENTITY_COUNT, mesh.getTriangleCount(), bvhMs / PICK_COUNT, hitCount, PICK_COUNT,
+                bruteForceMs / BRUTE_FORCE_PICK_COUNT);
+}
+}
@@ -0,0 +1,99 @@
+#include "Testing.h"
+
+#include "Core/FixedTimestep.h"
+
+
+namespace BZ {
+
+static constexpr uint64 NANOS_PER_MILLISECOND = 1000000;
+
+// 60 Hz, not a whole number of nanoseconds in floating point, but it is in integers.
+static const TimeDuration STEP_DURATION(16666667);
+
+struct FrameResult {
+    uint32 steps;
+    float alpha;
+
+    bool operator==(const FrameResult &other) const { return steps == other.steps && alpha == other.alpha; }
+};
+
+// Variable frames around 60 Hz, with some spikes.
+static std::vector<TimeDuration> randomFrameDurations(uint32 count) {
+    std::vector<TimeDuration> durations;
+    for (uint32 i = 0; i < count; ++i) {
+        const float milliseconds = i % 50 == 0 ? Testing::randomFloat(30.0f, 60.0f) : Testing::randomFloat(5.0f, 25.0f);
+        durations.emplace_back(static_cast<uint64>(milliseconds * NANOS_PER_MILLISECOND));
+    }
+    return durations;
+}
+
+static std::vector<FrameResult> run(FixedTimestep &timestep, const std::vector<TimeDuration> &durations) {
+    std::vector<FrameResult> results;
+    for (const TimeDuration &duration : durations) {
+        const uint32 steps = timestep.advance(duration);
+        results.push_back({ steps, timestep.getInterpolationAlpha() });
+    }
+    return results;
+}
+
+BZ_TEST(fixedTimestepStepCountMatchesTotalTime) {
+    FixedTimestep timestep(STEP_DURATION, 1000);
+
+    // Exact multiples, and the same total time in odd pieces.
+    BZ_CHECK(timestep.advance(TimeDuration(STEP_DURATION.asNanoseconds() * 3)) == 3);
+    BZ_CHECK(timestep.getInterpolationAlpha() == 0.0f);
+    BZ_CHECK(timestep.advance(TimeDuration(STEP_DURATION.asNanoseconds() / 2)) == 0);
+    BZ_CHECK(timestep.advance(TimeDuration(STEP_DURATION.asNanoseconds() / 2)) == 0);
+    BZ_CHECK(timestep.advance(TimeDuration(1)) == 1);
+    BZ_CHECK(timestep.getStepCount() == 4);
+
+    // Everything fits under the cap, so the steps are the whole ones in the total time.
+    const std::vector<TimeDuration> durations = randomFrameDurations(10000);
+    FixedTimestep uncapped(STEP_DURATION, 1000);
+    uint64 totalNanos = 0;
+    uint64 totalSteps = 0;
+    for (const TimeDuration &duration : durations) {
+        totalNanos += duration.asNanoseconds();
+        totalSteps += uncapped.advance(duration);
+    }
+    BZ_CHECK(totalSteps == totalNanos / STEP_DURATION.asNanoseconds());
+    BZ_CHECK(uncapped.getStepCount() == totalSteps);
+    BZ_CHECK(uncapped.getDroppedStepCount() == 0);
+}
+
+BZ_TEST(fixedTimestepCapsLongFrames) {
+    FixedTimestep timestep(STEP_DURATION, 4);
+
+    // A hitch of 60 steps, 4 run and the rest are dropped.
+    BZ_CHECK(timestep.advance(TimeDuration(STEP_DURATION.asNanoseconds() * 60)) == 4);
+    BZ_CHECK(timestep.getStepCount() == 4);
+    BZ_CHECK(timestep.getDroppedStepCount() == 56);
+
+    // The dropped time doesn't come back on the next frames.
+    BZ_CHECK(timestep.advance(TimeDuration(STEP_DURATION.asNanoseconds())) == 1);
+    BZ_CHECK(timestep.getDroppedStepCount() == 56);
+
+    // Under the cap, nothing is dropped.
+    BZ_CHECK(timestep.advance(TimeDuration(STEP_DURATION.asNanoseconds() * 4)) == 4);
+    BZ_CHECK(timestep.getDroppedStepCount() == 56);
+    BZ_CHECK(timestep.getStepCount() == 9);
+}
+
+BZ_TEST(fixedTimestepAlphaStaysInRange) {
+    FixedTimestep timestep(STEP_DURATION, 4);
+    for (const FrameResult &result : run(timestep, randomFrameDurations(10000))) {
+        BZ_CHECK(result.alpha >= 0.0f && result.alpha < 1.0f);
+        BZ_CHECK(result.steps <= 4);
+    }
+}
+
+BZ_TEST(fixedTimestepReplaysDeterministically) {
+    const std::vector<TimeDuration> durations = randomFrameDurations(10000);
+
+    FixedTimestep first(STEP_DURATION, 4);
+    FixedTimestep second(STEP_DURATION, 4);
+    BZ_CHECK(run(first, durations) == run(second, durations));
+    BZ_CHECK(first.getStepCount() == second.getStepCount());
+    BZ_CHECK(first.getDroppedStepCount() == second.getDroppedStepCount());
+}
+}
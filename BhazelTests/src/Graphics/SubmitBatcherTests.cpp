@@ -0,0 +1,145 @@
+#include "Testing.h"
+
+#include "Graphics/Internal/Queue.h"
+#include "Graphics/Internal/SubmitBatcher.h"
+
+
+namespace BZ {
+
+// Only compared, never given to Vulkan. Non dispatchable handles are integers on 32 bit builds.
+static VkSemaphore makeSemaphore(uint32 id) {
+    return (VkSemaphore)(uintptr_t)id;
+}
+
+static VkCommandBuffer makeCommandBuffer(uint32 id) {
+    return (VkCommandBuffer)(uintptr_t)id;
+}
+
+// Enqueues a single CommandBuffer, with up to one wait and one signal.
+static void enqueue(SubmitBatcher &batcher, const Queue &queue, VkSemaphore wait = VK_NULL_HANDLE,
+                    VkSemaphore signal = VK_NULL_HANDLE) {
+    static uint32 nextCommandBuffer = 1;
+    const VkCommandBuffer commandBuffer = makeCommandBuffer(nextCommandBuffer++);
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    batcher.enqueue(queue, &commandBuffer, 1, &wait, &waitStage, wait != VK_NULL_HANDLE ? 1 : 0, &signal,
+                    signal != VK_NULL_HANDLE ? 1 : 0);
+}
+
+static bool isQueueSubmit(const SubmitBatcher::QueueSubmit &queueSubmit, const Queue &queue, uint32 submitInfoCount) {
+    return queueSubmit.queue == &queue && queueSubmit.submitInfoCount == submitInfoCount;
+}
+
+BZ_TEST(submitBatcherMergesSubmitsWithoutSemaphores) {
+    Queue graphics;
+    SubmitBatcher batcher;
+    std::vector<SubmitBatcher::QueueSubmit> queueSubmits;
+
+    for (uint32 i = 0; i < 5; ++i) {
+        enqueue(batcher, graphics);
+    }
+    batcher.getPendingQueueSubmits(queueSubmits);
+    BZ_CHECK(queueSubmits.size() == 1);
+    BZ_CHECK(isQueueSubmit(queueSubmits[0], graphics, 1));
+
+    // A wait starts a new VkSubmitInfo, and so does anything after a signal.
+    enqueue(batcher, graphics, makeSemaphore(1), makeSemaphore(2));
+    enqueue(batcher, graphics);
+    batcher.getPendingQueueSubmits(queueSubmits);
+    BZ_CHECK(queueSubmits.size() == 1);
+    BZ_CHECK(isQueueSubmit(queueSubmits[0], graphics, 3));
+}
+
+BZ_TEST(submitBatcherSubmitsSignalsBeforeCrossQueueWaits) {
+    Queue graphics;
+    Queue compute;
+    SubmitBatcher batcher;
+    std::vector<SubmitBatcher::QueueSubmit> queueSubmits;
+
+    const VkSemaphore imageAvailable = makeSemaphore(1);
+    const VkSemaphore computeDone = makeSemaphore(2);
+    const VkSemaphore graphicsDone = makeSemaphore(3);
+
+    // Graphics is used first, but its second submit waits on compute.
+    enqueue(batcher, graphics, imageAvailable);
+    enqueue(batcher, compute, VK_NULL_HANDLE, computeDone);
+    enqueue(batcher, graphics, computeDone, graphicsDone);
+    enqueue(batcher, compute, graphicsDone);
+    enqueue(batcher, graphics);
+
+    batcher.getPendingQueueSubmits(queueSubmits);
+    BZ_CHECK(queueSubmits.size() == 4);
+    BZ_CHECK(isQueueSubmit(queueSubmits[0], compute, 1));
+    BZ_CHECK(isQueueSubmit(queueSubmits[1], graphics, 2));
+    BZ_CHECK(isQueueSubmit(queueSubmits[2], graphics, 1));
+    BZ_CHECK(isQueueSubmit(queueSubmits[3], compute, 1));
+}
+
+BZ_TEST(submitBatcherKeepsWaitsOnTheSameQueueTogether) {
+    Queue graphics;
+    Queue compute;
+    SubmitBatcher batcher;
+    std::vector<SubmitBatcher::QueueSubmit> queueSubmits;
+
+    // Signaled and waited on the same Queue, and a semaphore signaled from outside, like the swapchain ones.
+    enqueue(batcher, graphics, VK_NULL_HANDLE, makeSemaphore(1));
+    enqueue(batcher, compute, makeSemaphore(2));
+    enqueue(batcher, graphics, makeSemaphore(1));
+    enqueue(batcher, compute);
+
+    batcher.getPendingQueueSubmits(queueSubmits);
+    BZ_CHECK(queueSubmits.size() == 2);
+    BZ_CHECK(isQueueSubmit(queueSubmits[0], graphics, 2));
+    BZ_CHECK(isQueueSubmit(queueSubmits[1], compute, 1));
+}
+
+/*
+ * vkQueueSubmit calls of a frame laid out like the Renderer does it: transfers, the shadow cascades, the color pass,
+ * post processing and UI, each submitted on its own. With async compute, the culling goes to the compute Queue and the
+ * color pass waits on it.
+ */
+BZ_BENCHMARK(submitBatcherFrameSubmitCount) {
+    constexpr uint32 FRAME_COUNT = 1000;
+    constexpr uint32 SHADOW_PASS_COUNT = 4;
+
+    Queue graphics;
+    Queue compute;
+    std::vector<SubmitBatcher::QueueSubmit> queueSubmits;
+
+    for (bool asyncCompute : { false, true }) {
+        uint32 submissionCount = 0;
+        uint32 vkSubmitCount = 0;
+
+        Timer timer;
+        timer.start();
+        for (uint32 frame = 0; frame < FRAME_COUNT; ++frame) {
+            SubmitBatcher batcher;
+            const VkSemaphore imageAvailable = makeSemaphore(1);
+            const VkSemaphore cullingDone = makeSemaphore(2);
+            const VkSemaphore renderFinished = makeSemaphore(3);
+
+            enqueue(batcher, graphics);
+            for (uint32 i = 0; i < SHADOW_PASS_COUNT; ++i) {
+                enqueue(batcher, graphics);
+            }
+            if (asyncCompute) {
+                enqueue(batcher, compute, VK_NULL_HANDLE, cullingDone);
+            }
+            enqueue(batcher, graphics, imageAvailable);
+            if (asyncCompute) {
+                enqueue(batcher, graphics, cullingDone);
+            }
+            enqueue(batcher, graphics);
+            enqueue(batcher, graphics, VK_NULL_HANDLE, renderFinished);
+            submissionCount += asyncCompute ? 10 : 8;
+
+            batcher.getPendingQueueSubmits(queueSubmits);
+            vkSubmitCount += static_cast<uint32>(queueSubmits.size());
+        }
+        const float frameMs = timer.getCountedTime().asMillisecondsFloat() / FRAME_COUNT;
+
+        std::printf("    %s: %.1f submissions and %.1f vkQueueSubmit calls per frame, %.4f ms batching\n",
+                    asyncCompute ? "async compute" : "graphics only", static_cast<float>(submissionCount) / FRAME_COUNT,
+                    static_cast<float>(vkSubmitCount) / FRAME_COUNT, frameMs);
+    }
+}
+}
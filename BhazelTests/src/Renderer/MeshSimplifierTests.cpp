@@ -0,0 +1,268 @@
+#include "Testing.h"
+
+#include <array>
+#include <map>
+#include <set>
+
+#include "Renderer/MeshSimplifier.h"
+
+
+namespace BZ {
+
+struct MeshData {
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<uint32> indices;
+};
+
+static Mesh::Vertex makeVertex(const glm::vec3 &position, const glm::vec3 &normal) {
+    Mesh::Vertex vertex = {};
+    vertex.position = position;
+    vertex.normal = normal;
+    return vertex;
+}
+
+// UV sphere of radius 1. The seam and pole vertices are duplicated, and welded back by the MeshSimplifier into a
+// closed surface.
+static MeshData makeSphere(uint32 ringCount, uint32 segmentCount) {
+    MeshData mesh;
+    for (uint32 ring = 0; ring <= ringCount; ++ring) {
+        const float theta = glm::pi<float>() * ring / ringCount;
+        for (uint32 segment = 0; segment <= segmentCount; ++segment) {
+            const float phi = glm::two_pi<float>() * (segment % segmentCount) / segmentCount;
+            const glm::vec3 position(glm::sin(theta) * glm::cos(phi), glm::cos(theta), glm::sin(theta) * glm::sin(phi));
+            mesh.vertices.push_back(makeVertex(ring == 0 || ring == ringCount ? glm::vec3(0.0f, position.y, 0.0f)
+                                                                               : position,
+                                               position));
+        }
+    }
+    for (uint32 ring = 0; ring < ringCount; ++ring) {
+        for (uint32 segment = 0; segment < segmentCount; ++segment) {
+            const uint32 a = ring * (segmentCount + 1) + segment;
+            const uint32 b = a + segmentCount + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+    return mesh;
+}
+
+// Grid on xz of size by size quads, flat or with random heights.
+static MeshData makeGrid(uint32 size, float bumpHeight) {
+    MeshData mesh;
+    for (uint32 z = 0; z <= size; ++z) {
+        for (uint32 x = 0; x <= size; ++x) {
+            const float height = bumpHeight > 0.0f ? Testing::randomFloat(-bumpHeight, bumpHeight) : 0.0f;
+            mesh.vertices.push_back(makeVertex(glm::vec3(x, height, z), glm::vec3(0.0f, 1.0f, 0.0f)));
+        }
+    }
+    for (uint32 z = 0; z < size; ++z) {
+        for (uint32 x = 0; x < size; ++x) {
+            const uint32 a = z * (size + 1) + x;
+            const uint32 b = a + size + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+    return mesh;
+}
+
+// Ericson, Real-Time Collision Detection 5.1.5.
+static glm::vec3 closestPointOnTriangle(const glm::vec3 &p, const glm::vec3 &a, const glm::vec3 &b,
+                                        const glm::vec3 &c) {
+    const glm::vec3 ab = b - a;
+    const glm::vec3 ac = c - a;
+    const glm::vec3 ap = p - a;
+    const float d1 = glm::dot(ab, ap);
+    const float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return a;
+    }
+
+    const glm::vec3 bp = p - b;
+    const float d3 = glm::dot(ab, bp);
+    const float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return b;
+    }
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    const glm::vec3 cp = p - c;
+    const float d5 = glm::dot(ab, cp);
+    const float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return c;
+    }
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    const float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+// Largest distance from the original vertices to the simplified surface.
+static float getMaxDistanceToSimplified(const MeshData &mesh, const std::vector<uint32> &simplifiedIndices) {
+    float maxDistance = 0.0f;
+    for (uint32 original : mesh.indices) {
+        const glm::vec3 &point = mesh.vertices[original].position;
+        float distance = std::numeric_limits<float>::max();
+        for (uint32 i = 0; i < simplifiedIndices.size(); i += 3) {
+            const glm::vec3 closest =
+                closestPointOnTriangle(point, mesh.vertices[simplifiedIndices[i]].position,
+                                       mesh.vertices[simplifiedIndices[i + 1]].position,
+                                       mesh.vertices[simplifiedIndices[i + 2]].position);
+            distance = glm::min(distance, glm::distance(point, closest));
+        }
+        maxDistance = glm::max(maxDistance, distance);
+    }
+    return maxDistance;
+}
+
+BZ_TEST(meshSimplifierShrinksTowardsTarget) {
+    const MeshData mesh = makeSphere(32, 64);
+    MeshSimplifier simplifier(mesh.vertices.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+
+    // The degenerate triangles on the poles are dropped.
+    const uint32 startIndexCount = simplifier.getIndexCount();
+    BZ_CHECK(startIndexCount == mesh.indices.size() - 64 * 2 * 3);
+
+    uint32 lastIndexCount = startIndexCount;
+    float lastError = 0.0f;
+    for (uint32 divisor : { 2, 4, 10, 25 }) {
+        const uint32 target = startIndexCount / divisor;
+        const float error = simplifier.simplify(target);
+
+        // Each collapse removes two triangles.
+        BZ_CHECK(simplifier.getIndexCount() <= target);
+        BZ_CHECK(simplifier.getIndexCount() + 6 > target);
+        BZ_CHECK(simplifier.getIndexCount() < lastIndexCount);
+        BZ_CHECK(error >= lastError);
+
+        std::vector<uint32> indices;
+        simplifier.getIndices(indices);
+        BZ_CHECK(indices.size() == simplifier.getIndexCount());
+
+        lastIndexCount = simplifier.getIndexCount();
+        lastError = error;
+    }
+}
+
+BZ_TEST(meshSimplifierKeepsTheSurfaceClosed) {
+    const MeshData mesh = makeSphere(24, 48);
+    MeshSimplifier simplifier(mesh.vertices.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+    simplifier.simplify(simplifier.getIndexCount() / 20);
+
+    std::vector<uint32> indices;
+    simplifier.getIndices(indices);
+
+    // By position, since seam corners may take any of the duplicates. Every edge has exactly two triangles, and no two
+    // triangles share the same three vertices.
+    std::unordered_map<glm::vec3, uint32> positionIds;
+    auto getId = [&](uint32 index) {
+        return positionIds.emplace(mesh.vertices[index].position, static_cast<uint32>(positionIds.size()))
+            .first->second;
+    };
+
+    std::map<std::pair<uint32, uint32>, uint32> edgeCounts;
+    std::set<std::array<uint32, 3>> triangleSet;
+    for (uint32 i = 0; i < indices.size(); i += 3) {
+        std::array<uint32, 3> ids = { getId(indices[i]), getId(indices[i + 1]), getId(indices[i + 2]) };
+        for (uint32 k = 0; k < 3; ++k) {
+            edgeCounts[std::minmax(ids[k], ids[(k + 1) % 3])]++;
+        }
+        std::sort(ids.begin(), ids.end());
+        BZ_CHECK(triangleSet.insert(ids).second);
+    }
+    for (const auto &edge : edgeCounts) {
+        BZ_CHECK(edge.second == 2);
+    }
+
+    // Euler characteristic of a sphere.
+    const int32 vertexCount = static_cast<int32>(positionIds.size());
+    const int32 edgeCount = static_cast<int32>(edgeCounts.size());
+    const int32 faceCount = static_cast<int32>(indices.size() / 3);
+    BZ_CHECK(vertexCount - edgeCount + faceCount == 2);
+}
+
+BZ_TEST(meshSimplifierNeverMovesBorders) {
+    constexpr uint32 SIZE = 40;
+    const MeshData mesh = makeGrid(SIZE, 0.3f);
+    MeshSimplifier simplifier(mesh.vertices.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+    simplifier.simplify(simplifier.getIndexCount() / 10);
+    BZ_CHECK(simplifier.getIndexCount() < mesh.indices.size() / 2);
+
+    std::vector<uint32> indices;
+    simplifier.getIndices(indices);
+
+    auto isOnBorder = [](const glm::vec3 &position) {
+        return position.x == 0.0f || position.x == SIZE || position.z == 0.0f || position.z == SIZE;
+    };
+
+    // Every border vertex is still there.
+    std::vector<uint8> used(mesh.vertices.size(), 0);
+    for (uint32 index : indices) {
+        used[index] = 1;
+    }
+    for (uint32 i = 0; i < mesh.vertices.size(); ++i) {
+        if (isOnBorder(mesh.vertices[i].position)) {
+            BZ_CHECK(used[i]);
+        }
+    }
+
+    // And the border of the result only goes through them.
+    std::map<std::pair<uint32, uint32>, uint32> edgeCounts;
+    for (uint32 i = 0; i < indices.size(); i += 3) {
+        for (uint32 k = 0; k < 3; ++k) {
+            edgeCounts[std::minmax(indices[i + k], indices[i + (k + 1) % 3])]++;
+        }
+    }
+    for (const auto &edge : edgeCounts) {
+        if (edge.second == 1) {
+            BZ_CHECK(isOnBorder(mesh.vertices[edge.first.first].position));
+            BZ_CHECK(isOnBorder(mesh.vertices[edge.first.second].position));
+        }
+    }
+}
+
+BZ_TEST(meshSimplifierErrorIsZeroOnFlatGrid) {
+    const MeshData mesh = makeGrid(30, 0.0f);
+    MeshSimplifier simplifier(mesh.vertices.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+    const float error = simplifier.simplify(simplifier.getIndexCount() / 10);
+    BZ_CHECK(simplifier.getIndexCount() < mesh.indices.size() / 4);
+    BZ_CHECK(error == 0.0f);
+
+    std::vector<uint32> indices;
+    simplifier.getIndices(indices);
+    BZ_CHECK(getMaxDistanceToSimplified(mesh, indices) <= 1e-5f);
+}
+
+/*
+ * The reported error is the distance from the kept vertices to the planes of the triangles merged into them. On a
+ * smooth surface the deviation of the original vertices from the simplified triangles is of the same order, about the
+ * sagitta of the new edges, and never reaches twice it.
+ */
+BZ_TEST(meshSimplifierErrorBoundsDistanceOnSphere) {
+    const MeshData mesh = makeSphere(32, 64);
+    MeshSimplifier simplifier(mesh.vertices.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+
+    for (uint32 divisor : { 4, 16, 64 }) {
+        const float error = simplifier.simplify(static_cast<uint32>(mesh.indices.size()) / divisor);
+        BZ_CHECK(error > 0.0f);
+
+        std::vector<uint32> indices;
+        simplifier.getIndices(indices);
+        const float distance = getMaxDistanceToSimplified(mesh, indices);
+        BZ_CHECK(distance > 0.0f);
+        BZ_CHECK(distance <= 2.0f * error);
+    }
+}
+}
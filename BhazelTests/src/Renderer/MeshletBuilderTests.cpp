@@ -0,0 +1,196 @@
+#include "Testing.h"
+
+#include <array>
+
+#include "Renderer/MeshletBuilder.h"
+
+
+namespace BZ {
+
+struct MeshData {
+    std::vector<Mesh::Vertex> vertices;
+    std::vector<uint32> indices;
+};
+
+static Mesh::Vertex makeVertex(const glm::vec3 &position) {
+    Mesh::Vertex vertex = {};
+    vertex.position = position;
+    return vertex;
+}
+
+// UV sphere of radius 1, counter clockwise seen from outside.
+static MeshData makeSphere(uint32 ringCount, uint32 segmentCount) {
+    MeshData mesh;
+    for (uint32 ring = 0; ring <= ringCount; ++ring) {
+        const float theta = glm::pi<float>() * ring / ringCount;
+        for (uint32 segment = 0; segment <= segmentCount; ++segment) {
+            const float phi = glm::two_pi<float>() * segment / segmentCount;
+            mesh.vertices.push_back(makeVertex(
+                glm::vec3(glm::sin(theta) * glm::cos(phi), glm::cos(theta), glm::sin(theta) * glm::sin(phi))));
+        }
+    }
+    for (uint32 ring = 0; ring < ringCount; ++ring) {
+        for (uint32 segment = 0; segment < segmentCount; ++segment) {
+            const uint32 a = ring * (segmentCount + 1) + segment;
+            const uint32 b = a + segmentCount + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+    return mesh;
+}
+
+// Height field on xz, with random heights.
+static MeshData makeBumpyGrid(uint32 size) {
+    MeshData mesh;
+    for (uint32 z = 0; z <= size; ++z) {
+        for (uint32 x = 0; x <= size; ++x) {
+            mesh.vertices.push_back(makeVertex(glm::vec3(x, Testing::randomFloat(-0.5f, 0.5f), z)));
+        }
+    }
+    for (uint32 z = 0; z < size; ++z) {
+        for (uint32 x = 0; x < size; ++x) {
+            const uint32 a = z * (size + 1) + x;
+            const uint32 b = a + size + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+    return mesh;
+}
+
+// Disconnected triangles, so meshlets run out of neighbours.
+static MeshData makeTriangleSoup(uint32 triangleCount) {
+    MeshData mesh;
+    for (uint32 i = 0; i < triangleCount; ++i) {
+        const glm::vec3 center = Testing::randomVec3(-10.0f, 10.0f);
+        for (uint32 v = 0; v < 3; ++v) {
+            mesh.indices.push_back(static_cast<uint32>(mesh.vertices.size()));
+            mesh.vertices.push_back(makeVertex(center + Testing::randomVec3(-1.0f, 1.0f)));
+        }
+    }
+    return mesh;
+}
+
+// The same triangles in a random order, which is what most exporters give.
+static MeshData shuffleTriangles(MeshData mesh) {
+    const uint32 triangleCount = static_cast<uint32>(mesh.indices.size() / 3);
+    for (uint32 i = triangleCount - 1; i > 0; --i) {
+        const uint32 j = std::uniform_int_distribution<uint32>(0, i)(Testing::getRandomEngine());
+        std::swap_ranges(&mesh.indices[i * 3], &mesh.indices[i * 3 + 3], &mesh.indices[j * 3]);
+    }
+    return mesh;
+}
+
+static std::vector<MeshData> makeMeshes() {
+    std::vector<MeshData> meshes;
+    meshes.push_back(makeSphere(48, 96));
+    meshes.push_back(shuffleTriangles(makeSphere(32, 64)));
+    meshes.push_back(makeBumpyGrid(60));
+    meshes.push_back(makeTriangleSoup(1000));
+    return meshes;
+}
+
+// Rotated to start on the lowest index, which keeps the winding.
+static std::array<uint32, 3> getCanonicalTriangle(const uint32 *indices) {
+    const uint32 first =
+        indices[0] < indices[1] ? (indices[0] < indices[2] ? 0 : 2) : (indices[1] < indices[2] ? 1 : 2);
+    return { indices[first], indices[(first + 1) % 3], indices[(first + 2) % 3] };
+}
+
+static std::vector<std::array<uint32, 3>> getSortedTriangles(const uint32 *indices, uint32 indexCount) {
+    std::vector<std::array<uint32, 3>> triangles;
+    for (uint32 i = 0; i < indexCount; i += 3) {
+        triangles.push_back(getCanonicalTriangle(&indices[i]));
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+BZ_TEST(meshletBuilderKeepsEveryTriangleOnce) {
+    for (const MeshData &mesh : makeMeshes()) {
+        const uint32 indexCount = static_cast<uint32>(mesh.indices.size());
+        MeshletBuilder builder(mesh.vertices.data(), mesh.indices.data(), indexCount);
+
+        const std::vector<uint32> &indices = builder.getIndices();
+        BZ_CHECK(indices.size() == indexCount);
+        BZ_CHECK(getSortedTriangles(indices.data(), static_cast<uint32>(indices.size())) ==
+                 getSortedTriangles(mesh.indices.data(), indexCount));
+
+        // Meshlets are contiguous ranges covering all the indices, in order.
+        uint32 nextIndexOffset = 0;
+        for (const Mesh::Meshlet &meshlet : builder.getMeshlets()) {
+            BZ_CHECK(meshlet.indexOffset == nextIndexOffset);
+            BZ_CHECK(meshlet.indexCount > 0 && meshlet.indexCount % 3 == 0);
+            nextIndexOffset += meshlet.indexCount;
+        }
+        BZ_CHECK(nextIndexOffset == indexCount);
+    }
+}
+
+BZ_TEST(meshletBuilderRespectsLimits) {
+    for (const MeshData &mesh : makeMeshes()) {
+        MeshletBuilder builder(mesh.vertices.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+        const std::vector<uint32> &indices = builder.getIndices();
+
+        for (const Mesh::Meshlet &meshlet : builder.getMeshlets()) {
+            std::vector<uint32> meshletVertices(&indices[meshlet.indexOffset],
+                                                &indices[meshlet.indexOffset] + meshlet.indexCount);
+            std::sort(meshletVertices.begin(), meshletVertices.end());
+            const auto uniqueEnd = std::unique(meshletVertices.begin(), meshletVertices.end());
+            const uint32 vertexCount = static_cast<uint32>(uniqueEnd - meshletVertices.begin());
+
+            BZ_CHECK(vertexCount <= Mesh::MESHLET_MAX_VERTICES);
+            BZ_CHECK(meshlet.indexCount / 3 <= Mesh::MESHLET_MAX_TRIANGLES);
+        }
+    }
+}
+
+BZ_TEST(meshletBuilderSpheresBoundTheTriangles) {
+    for (const MeshData &mesh : makeMeshes()) {
+        MeshletBuilder builder(mesh.vertices.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+        const std::vector<uint32> &indices = builder.getIndices();
+        for (const Mesh::Meshlet &meshlet : builder.getMeshlets()) {
+            for (uint32 i = 0; i < meshlet.indexCount; ++i) {
+                const glm::vec3 &position = mesh.vertices[indices[meshlet.indexOffset + i]].position;
+                BZ_CHECK(glm::distance(position, meshlet.center) <= meshlet.radius * (1.0f + 1e-5f));
+            }
+        }
+    }
+}
+
+// No Meshlet rejected by its cone from a point has a triangle facing that point.
+BZ_TEST(meshletConesAreConservative) {
+    uint32 culledCount = 0;
+    for (const MeshData &mesh : makeMeshes()) {
+        MeshletBuilder builder(mesh.vertices.data(), mesh.indices.data(), static_cast<uint32>(mesh.indices.size()));
+        const std::vector<uint32> &indices = builder.getIndices();
+
+        // Near, far and inside the Mesh.
+        std::vector<glm::vec3> viewpoints;
+        for (uint32 i = 0; i < 100; ++i) {
+            const float distance = i % 3 == 0 ? 0.5f : (i % 3 == 1 ? 3.0f : 100.0f);
+            viewpoints.push_back(Testing::randomVec3(-distance, distance) + glm::vec3(i % 2 == 0 ? 0.0f : 30.0f));
+        }
+
+        for (const glm::vec3 &viewpoint : viewpoints) {
+            for (const Mesh::Meshlet &meshlet : builder.getMeshlets()) {
+                const glm::vec3 toCenter = meshlet.center - viewpoint;
+                if (glm::dot(toCenter, meshlet.coneAxis) <
+                    meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius) {
+                    continue;
+                }
+                culledCount++;
+
+                for (uint32 i = 0; i < meshlet.indexCount; i += 3) {
+                    const glm::vec3 &a = mesh.vertices[indices[meshlet.indexOffset + i]].position;
+                    const glm::vec3 &b = mesh.vertices[indices[meshlet.indexOffset + i + 1]].position;
+                    const glm::vec3 &c = mesh.vertices[indices[meshlet.indexOffset + i + 2]].position;
+                    const glm::vec3 normal = glm::cross(b - a, c - a);
+                    const glm::vec3 toViewpoint = viewpoint - a;
+                    BZ_CHECK(glm::dot(normal, toViewpoint) <= 1e-5f * glm::length(normal) * glm::length(toViewpoint));
+                }
+            }
+        }
+    }
+    BZ_CHECK(culledCount > 1000);
+}
+}
@@ -0,0 +1,268 @@
+#include "Testing.h"
+
+#include "Collisions/AABB.h"
+#include "Collisions/TriangleMesh.h"
+#include "Core/Utils.h"
+#include "Renderer/OcclusionBuffer.h"
+
+
+namespace BZ {
+
+static constexpr uint32 BUFFER_WIDTH = 128;
+static constexpr uint32 BUFFER_HEIGHT = 64;
+
+// In pixels. Points this close to a triangle edge count as inside it, shared edges are on both sides.
+static constexpr float EDGE_EPSILON = 1e-3f;
+static constexpr float DEPTH_EPSILON = 1e-6f;
+
+/*
+ * Occluders in world space, and their triangles projected to the screen for the brute force. The Camera looks down -z
+ * from the origin, and every vertex is kept in front of the near plane.
+ */
+struct OcclusionFixture {
+    struct ScreenTriangle {
+        glm::vec2 vertices[3];
+        float depth;
+    };
+
+    glm::mat4 viewProjection;
+    std::vector<std::unique_ptr<TriangleMesh>> meshes;
+    std::vector<ScreenTriangle> triangles;
+    OcclusionBuffer buffer;
+
+    OcclusionFixture() {
+        const glm::mat4 view =
+            glm::lookAtRH(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        viewProjection = Utils::perspective(60.0f, 2.0f, 0.1f, 100.0f) * view;
+        buffer.init(BUFFER_WIDTH, BUFFER_HEIGHT);
+    }
+
+    ~OcclusionFixture() { buffer.destroy(); }
+
+    glm::vec3 project(const glm::vec3 &point) const {
+        const glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        return glm::vec3((glm::vec2(ndc) * 0.5f + 0.5f) * glm::vec2(BUFFER_WIDTH, BUFFER_HEIGHT), ndc.z);
+    }
+
+    void addOccluder(const std::vector<glm::vec3> &positions, const std::vector<uint32> &indices) {
+        meshes.push_back(
+            std::make_unique<TriangleMesh>(positions.data(), indices.data(), static_cast<uint32>(indices.size())));
+
+        // The buffer writes merged triangle pairs with the farthest of their vertices. The occluders have at most two
+        // triangles, so their farthest vertex is the depth the buffer can use.
+        float depth = 0.0f;
+        for (const glm::vec3 &position : positions) {
+            depth = glm::max(depth, project(position).z);
+        }
+
+        for (uint32 i = 0; i < indices.size(); i += 3) {
+            ScreenTriangle triangle;
+            for (uint32 v = 0; v < 3; ++v) {
+                triangle.vertices[v] = glm::vec2(project(positions[indices[i + v]]));
+            }
+            triangle.depth = depth;
+            triangles.push_back(triangle);
+        }
+    }
+
+    // A rectangle from min to max, slanted along z from the bottom edge to the top one.
+    void addWall(const glm::vec3 &min, const glm::vec3 &max) {
+        addOccluder({ glm::vec3(min.x, min.y, min.z), glm::vec3(max.x, min.y, min.z), glm::vec3(max.x, max.y, max.z),
+                      glm::vec3(min.x, max.y, max.z) },
+                    { 0, 1, 2, 0, 2, 3 });
+    }
+
+    void render(uint32 rowsPerBand) {
+        buffer.begin(viewProjection, static_cast<uint32>(meshes.size()));
+        for (uint32 i = 0; i < meshes.size(); ++i) {
+            buffer.setupOccluder(i, *meshes[i], glm::mat4(1.0f));
+        }
+        for (uint32 row = 0; row < BUFFER_HEIGHT; row += rowsPerBand) {
+            buffer.rasterizeRows(row, glm::min(row + rowsPerBand, BUFFER_HEIGHT));
+        }
+        buffer.end();
+    }
+
+    // Depth of the closest triangle containing the screen point, 1 if none.
+    float getDepthAt(const glm::vec2 &point, float epsilon) const {
+        float depth = 1.0f;
+        for (const ScreenTriangle &triangle : triangles) {
+            if (contains(triangle, point, epsilon)) {
+                depth = glm::min(depth, triangle.depth);
+            }
+        }
+        return depth;
+    }
+
+    static bool contains(const ScreenTriangle &triangle, const glm::vec2 &point, float epsilon) {
+        const glm::vec2 *v = triangle.vertices;
+        const float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+        if (area == 0.0f) {
+            return false;
+        }
+
+        // Distances to the edges, positive inside whatever the winding.
+        for (uint32 i = 0; i < 3; ++i) {
+            const glm::vec2 &a = v[i];
+            const glm::vec2 &b = v[(i + 1) % 3];
+            const glm::vec2 edge = b - a;
+            const float distance = (edge.x * (point.y - a.y) - edge.y * (point.x - a.x)) / glm::length(edge);
+            if (distance * glm::sign(area) < -epsilon) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+static void addRandomOccluders(OcclusionFixture &fixture, uint32 count) {
+    for (uint32 i = 0; i < count; ++i) {
+        const glm::vec3 center(Testing::randomFloat(-20.0f, 20.0f), Testing::randomFloat(-10.0f, 10.0f),
+                               Testing::randomFloat(-40.0f, -10.0f));
+        if (i % 2 == 0) {
+            // Slanted walls, so the two triangles are not always parallel to the screen.
+            const glm::vec3 halfDimensions(Testing::randomFloat(0.5f, 6.0f), Testing::randomFloat(0.5f, 6.0f),
+                                           Testing::randomFloat(-3.0f, 3.0f));
+            fixture.addWall(center - halfDimensions, center + halfDimensions);
+        }
+        else {
+            fixture.addOccluder({ center + Testing::randomVec3(-5.0f, 5.0f), center + Testing::randomVec3(-5.0f, 5.0f),
+                                  center + Testing::randomVec3(-5.0f, 5.0f) },
+                                { 0, 1, 2 });
+        }
+    }
+}
+
+// Every written texel is fully covered by occluders at least as close as its depth.
+BZ_TEST(occlusionBufferNeverCoversMoreThanTheOccluders) {
+    for (uint32 scene = 0; scene < 20; ++scene) {
+        OcclusionFixture fixture;
+        addRandomOccluders(fixture, 12);
+        fixture.render(8);
+
+        for (uint32 y = 0; y < BUFFER_HEIGHT; ++y) {
+            for (uint32 x = 0; x < BUFFER_WIDTH; ++x) {
+                const float depth = fixture.buffer.getDepth(x, y);
+                if (depth == 1.0f) {
+                    continue;
+                }
+                for (uint32 sample = 0; sample < 25; ++sample) {
+                    const glm::vec2 point(x + (sample % 5) * 0.25f, y + (sample / 5) * 0.25f);
+                    BZ_CHECK(fixture.getDepthAt(point, EDGE_EPSILON) <= depth + DEPTH_EPSILON);
+                }
+            }
+        }
+    }
+}
+
+// Every texel fully inside a single triangle is written, at most with its depth.
+BZ_TEST(occlusionBufferCoversTexelsInsideTriangles) {
+    for (uint32 scene = 0; scene < 20; ++scene) {
+        OcclusionFixture fixture;
+        addRandomOccluders(fixture, 12);
+        fixture.render(BUFFER_HEIGHT);
+
+        uint32 writtenCount = 0;
+        for (uint32 y = 0; y < BUFFER_HEIGHT; ++y) {
+            for (uint32 x = 0; x < BUFFER_WIDTH; ++x) {
+                const float depth = fixture.buffer.getDepth(x, y);
+                writtenCount += depth < 1.0f;
+
+                for (const OcclusionFixture::ScreenTriangle &triangle : fixture.triangles) {
+                    bool isInside = true;
+                    for (uint32 corner = 0; corner < 4; ++corner) {
+                        const glm::vec2 point(x + (corner & 1), y + (corner >> 1));
+                        isInside &= OcclusionFixture::contains(triangle, point, -EDGE_EPSILON);
+                    }
+                    if (isInside) {
+                        BZ_CHECK(depth <= triangle.depth + DEPTH_EPSILON);
+                    }
+                }
+            }
+        }
+        BZ_CHECK(writtenCount > 0);
+    }
+}
+
+BZ_TEST(occlusionBufferMergesQuads) {
+    OcclusionFixture fixture;
+    fixture.addWall(glm::vec3(-4.0f, -2.0f, -10.0f), glm::vec3(4.0f, 2.0f, -10.0f));
+    fixture.render(BUFFER_HEIGHT);
+    BZ_CHECK(fixture.buffer.getPolygonCount() == 1);
+
+    // No seam along the diagonal. Only the texels on the border can be partially covered.
+    const glm::vec2 corner0(fixture.project(glm::vec3(-4.0f, -2.0f, -10.0f)));
+    const glm::vec2 corner1(fixture.project(glm::vec3(4.0f, 2.0f, -10.0f)));
+    const glm::vec2 min = glm::min(corner0, corner1);
+    const glm::vec2 max = glm::max(corner0, corner1);
+    for (uint32 y = static_cast<uint32>(min.y) + 1; y < static_cast<uint32>(max.y); ++y) {
+        for (uint32 x = static_cast<uint32>(min.x) + 1; x < static_cast<uint32>(max.x); ++x) {
+            BZ_CHECK(fixture.buffer.getDepth(x, y) < 1.0f);
+        }
+    }
+}
+
+// A gap between two walls, half a texel wide. Whatever is seen through it must not be culled.
+BZ_TEST(occlusionBufferKeepsThinGaps) {
+    OcclusionFixture fixture;
+    const float texelsPerUnit = glm::abs(
+        fixture.project(glm::vec3(1.0f, 0.0f, -10.0f)).x - fixture.project(glm::vec3(0.0f, 0.0f, -10.0f)).x);
+    const float halfGap = 0.25f / texelsPerUnit;
+    fixture.addWall(glm::vec3(-10.0f, -4.0f, -10.0f), glm::vec3(-halfGap, 4.0f, -10.0f));
+    fixture.addWall(glm::vec3(halfGap, -4.0f, -10.0f), glm::vec3(10.0f, 4.0f, -10.0f));
+    fixture.render(8);
+
+    // Behind the gap.
+    BZ_CHECK(!fixture.buffer.isOccluded(AABB(glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(halfGap, 2.0f, 1.0f))));
+
+    // Behind the walls.
+    BZ_CHECK(fixture.buffer.isOccluded(AABB(glm::vec3(-5.0f, 0.0f, -20.0f), glm::vec3(1.0f))));
+    BZ_CHECK(fixture.buffer.isOccluded(AABB(glm::vec3(5.0f, 0.0f, -20.0f), glm::vec3(1.0f))));
+
+    // In front of them.
+    BZ_CHECK(!fixture.buffer.isOccluded(AABB(glm::vec3(-5.0f, 0.0f, -5.0f), glm::vec3(1.0f))));
+
+    // The gap column is never written.
+    const uint32 gapX = static_cast<uint32>(fixture.project(glm::vec3(0.0f, 0.0f, -10.0f)).x);
+    for (uint32 y = 0; y < BUFFER_HEIGHT; ++y) {
+        BZ_CHECK(fixture.buffer.getDepth(gapX, y) == 1.0f);
+    }
+}
+
+// Every visible point of a culled AABB is behind some occluder.
+BZ_TEST(occlusionBufferIsOccludedMatchesBruteForce) {
+    uint32 occludedCount = 0;
+    for (uint32 scene = 0; scene < 20; ++scene) {
+        OcclusionFixture fixture;
+        addRandomOccluders(fixture, 12);
+        fixture.render(8);
+
+        for (uint32 i = 0; i < 500; ++i) {
+            const AABB aabb(glm::vec3(Testing::randomFloat(-30.0f, 30.0f), Testing::randomFloat(-15.0f, 15.0f),
+                                      Testing::randomFloat(-60.0f, -5.0f)),
+                            Testing::randomVec3(0.1f, 4.0f));
+            if (!fixture.buffer.isOccluded(aabb)) {
+                continue;
+            }
+            occludedCount++;
+
+            for (uint32 sample = 0; sample < 64; ++sample) {
+                const glm::vec3 &min = aabb.getMin();
+                const glm::vec3 &max = aabb.getMax();
+                const glm::vec3 point =
+                    sample < 8 ? glm::vec3((sample & 1) ? max.x : min.x, (sample & 2) ? max.y : min.y,
+                                           (sample & 4) ? max.z : min.z)
+                               : min + aabb.getDimensions() * Testing::randomVec3(0.0f, 1.0f);
+
+                const glm::vec3 screen = fixture.project(point);
+                if (screen.x < 0.0f || screen.y < 0.0f || screen.x > BUFFER_WIDTH || screen.y > BUFFER_HEIGHT) {
+                    continue;
+                }
+                BZ_CHECK(fixture.getDepthAt(glm::vec2(screen), EDGE_EPSILON) < screen.z);
+            }
+        }
+    }
+    BZ_CHECK(occludedCount > 0);
+}
+}
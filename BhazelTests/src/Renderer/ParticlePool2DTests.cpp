@@ -0,0 +1,122 @@
+#include "Testing.h"
+
+#include "Renderer/ParticlePool2D.h"
+
+
+namespace BZ {
+
+static Particle2D makeParticle(float timeToLiveSecs) {
+    Particle2D particle = {};
+    particle.timeToLiveSecs = timeToLiveSecs;
+    return particle;
+}
+
+// Emits and kills particles like Emitter2D::onUpdate does, with swap-and-pop deaths.
+static void simulateFrame(ParticleBlockList2D &list, uint32 emitCount, float deltaSecs) {
+    for (uint32 i = 0; i < emitCount; ++i) {
+        list.push(makeParticle(Testing::randomFloat(0.1f, 1.0f)));
+    }
+
+    for (uint32 i = 0; i < list.getCount();) {
+        list[i].timeToLiveSecs -= deltaSecs;
+        if (list[i].timeToLiveSecs <= 0.0f) {
+            list.swapAndPop(i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+BZ_TEST(particlePoolSteadyStateDoesNotAllocate) {
+    ParticlePool2D pool;
+    pool.init(4 * ParticlePool2D::BLOCK_SIZE);
+
+    {
+        ParticleBlockList2D list(pool);
+        list.setCapacity(4 * ParticlePool2D::BLOCK_SIZE);
+
+        // Bursts grow and shrink the list over many blocks.
+        for (uint32 frame = 0; frame < 60; ++frame) {
+            simulateFrame(list, frame % 10 == 0 ? 600 : 20, 1.0f / 60.0f);
+        }
+
+        const uint64 allocationsBefore = Testing::getAllocationCount();
+        for (uint32 frame = 0; frame < 600; ++frame) {
+            simulateFrame(list, frame % 10 == 0 ? 600 : 20, 1.0f / 60.0f);
+        }
+        BZ_CHECK(Testing::getAllocationCount() == allocationsBefore);
+
+        list.clear();
+        BZ_CHECK(list.getCount() == 0);
+    }
+
+    BZ_CHECK(pool.getFreeBlockCount() == pool.getBlockCount());
+    pool.destroy();
+}
+
+BZ_TEST(particlePoolReturnsEmptyBlocks) {
+    ParticlePool2D pool;
+    pool.init(2 * ParticlePool2D::BLOCK_SIZE);
+
+    {
+        ParticleBlockList2D list(pool);
+        list.setCapacity(2 * ParticlePool2D::BLOCK_SIZE);
+
+        for (uint32 i = 0; i < ParticlePool2D::BLOCK_SIZE + 1; ++i) {
+            BZ_CHECK(list.push(makeParticle(1.0f)));
+        }
+        BZ_CHECK(pool.getFreeBlockCount() == 0);
+
+        list.swapAndPop(0);
+        BZ_CHECK(pool.getFreeBlockCount() == 1);
+
+        // Over the list capacity.
+        while (list.getCount() < list.getCapacity()) {
+            list.push(makeParticle(1.0f));
+        }
+        BZ_CHECK(!list.push(makeParticle(1.0f)));
+    }
+
+    BZ_CHECK(pool.getFreeBlockCount() == pool.getBlockCount());
+    pool.destroy();
+}
+
+BZ_TEST(particlePoolHigherPriorityTakesBlocks) {
+    ParticlePool2D pool;
+    pool.init(2 * ParticlePool2D::BLOCK_SIZE);
+
+    {
+        ParticleBlockList2D lowList(pool);
+        lowList.setCapacity(2 * ParticlePool2D::BLOCK_SIZE);
+        lowList.priority = 0;
+
+        ParticleBlockList2D highList(pool);
+        highList.setCapacity(2 * ParticlePool2D::BLOCK_SIZE);
+        highList.priority = 1;
+
+        while (lowList.push(makeParticle(1.0f))) {
+        }
+        BZ_CHECK(lowList.getCount() == 2 * ParticlePool2D::BLOCK_SIZE);
+
+        // Over budget. The high priority list takes the last block of the low priority one.
+        BZ_CHECK(highList.push(makeParticle(1.0f)));
+        BZ_CHECK(lowList.getCount() == ParticlePool2D::BLOCK_SIZE);
+        BZ_CHECK(pool.getCulledParticleCount() == ParticlePool2D::BLOCK_SIZE);
+
+        // But not the other way around.
+        while (highList.getCount() < ParticlePool2D::BLOCK_SIZE) {
+            highList.push(makeParticle(1.0f));
+        }
+        lowList.clear();
+        BZ_CHECK(lowList.push(makeParticle(1.0f)));
+        while (lowList.getCount() < ParticlePool2D::BLOCK_SIZE) {
+            lowList.push(makeParticle(1.0f));
+        }
+        BZ_CHECK(!lowList.push(makeParticle(1.0f)));
+        BZ_CHECK(highList.getCount() == ParticlePool2D::BLOCK_SIZE);
+    }
+
+    pool.destroy();
+}
+}
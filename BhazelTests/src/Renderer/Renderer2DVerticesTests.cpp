@@ -0,0 +1,158 @@
+#include "Testing.h"
+
+#include "Core/JobSystem.h"
+#include "Renderer/Renderer2DVertices.h"
+
+
+namespace BZ {
+
+static Renderer2DSprite makeSprite(float rotationDeg) {
+    Renderer2DSprite sprite = {};
+    sprite.position = glm::vec2(Testing::randomFloat(0.0f, 1000.0f), Testing::randomFloat(0.0f, 1000.0f));
+    sprite.dimensions = glm::vec2(Testing::randomFloat(1.0f, 20.0f), Testing::randomFloat(1.0f, 20.0f));
+    sprite.rotationDeg = rotationDeg;
+    sprite.tintAndAlpha = glm::vec4(Testing::randomFloat(0.0f, 1.0f), Testing::randomFloat(0.0f, 1.0f),
+                                    Testing::randomFloat(0.0f, 1.0f), 1.0f);
+    sprite.texCoordRect = glm::vec4(Testing::randomFloat(0.0f, 0.5f), Testing::randomFloat(0.0f, 0.5f),
+                                    Testing::randomFloat(0.5f, 1.0f), Testing::randomFloat(0.5f, 1.0f));
+    return sprite;
+}
+
+// Sprites on a random sorted order, as they come from the Renderer2D sort.
+static std::vector<Utils::SortKeyIndex> makeSortedEntries(uint32 count) {
+    std::vector<Utils::SortKeyIndex> entries(count);
+    for (uint32 i = 0; i < count; ++i) {
+        entries[i] = { 0, i };
+    }
+    std::shuffle(entries.begin(), entries.end(), Testing::getRandomEngine());
+    return entries;
+}
+
+BZ_TEST(sinCosDegreesMatchesStd) {
+    // Not a multiple of the SIMD width, so the scalar remainder runs too.
+    std::vector<float> degrees;
+    for (int32 i = -8; i <= 8; ++i) {
+        degrees.push_back(i * 90.0f);
+    }
+    for (uint32 i = 0; i < 1001; ++i) {
+        degrees.push_back(Testing::randomFloat(-1000.0f, 1000.0f));
+    }
+
+    std::vector<float> sines(degrees.size());
+    std::vector<float> cosines(degrees.size());
+    Renderer2DVertices::sinCosDegrees(degrees.data(), static_cast<uint32>(degrees.size()), sines.data(),
+                                      cosines.data());
+
+    for (uint32 i = 0; i < degrees.size(); ++i) {
+        const double radians = glm::radians(static_cast<double>(degrees[i]));
+        BZ_CHECK(std::abs(sines[i] - std::sin(radians)) <= 1e-6);
+        BZ_CHECK(std::abs(cosines[i] - std::cos(radians)) <= 1e-6);
+
+        // Axis aligned sprites keep exact corners.
+        if (i <= 16) {
+            BZ_CHECK(sines[i] == static_cast<float>(std::round(std::sin(radians))));
+            BZ_CHECK(cosines[i] == static_cast<float>(std::round(std::cos(radians))));
+        }
+    }
+}
+
+BZ_TEST(spriteVerticesAreTheQuadCorners) {
+    constexpr uint32 SPRITE_COUNT = 301;
+    std::vector<Renderer2DSprite> sprites;
+    for (uint32 i = 0; i < SPRITE_COUNT; ++i) {
+        sprites.push_back(makeSprite(i % 3 == 0 ? 0.0f : Testing::randomFloat(-360.0f, 360.0f)));
+    }
+    const std::vector<Utils::SortKeyIndex> entries = makeSortedEntries(SPRITE_COUNT);
+
+    std::vector<Renderer2DVertex> vertices(SPRITE_COUNT * 4);
+    Renderer2DVertices::generate(sprites.data(), entries.data(), 0, SPRITE_COUNT, vertices.data());
+
+    const glm::vec2 corners[4] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+    const bool usesMaxTexCoord[4][2] = { { false, false }, { true, false }, { true, true }, { false, true } };
+    for (uint32 i = 0; i < SPRITE_COUNT; ++i) {
+        const Renderer2DSprite &sprite = sprites[entries[i].index];
+        const float radians = glm::radians(sprite.rotationDeg);
+        const glm::mat2 rotation(std::cos(radians), std::sin(radians), -std::sin(radians), std::cos(radians));
+
+        for (uint32 v = 0; v < 4; ++v) {
+            const Renderer2DVertex &vertex = vertices[i * 4 + v];
+            const glm::vec2 expected = sprite.position + rotation * (corners[v] * sprite.dimensions);
+            BZ_CHECK(glm::distance(glm::vec2(vertex.pos[0], vertex.pos[1]), expected) <= 1e-3f);
+            BZ_CHECK(vertex.colorAndAlpha == Utils::packColor(sprite.tintAndAlpha));
+
+            // Rounded to the nearest 16 bit value.
+            const glm::vec2 texCoord = glm::vec2(usesMaxTexCoord[v][0] ? sprite.texCoordRect.z : sprite.texCoordRect.x,
+                                                 usesMaxTexCoord[v][1] ? sprite.texCoordRect.w : sprite.texCoordRect.y);
+            BZ_CHECK(vertex.texCoord[0] == std::lround(texCoord.x * 65535.0f));
+            BZ_CHECK(vertex.texCoord[1] == std::lround(texCoord.y * 65535.0f));
+        }
+    }
+}
+
+/*
+ * The Renderer2D vertex kernel over a full frame of sprites, on one thread and through the JobSystem like the
+ * Renderer2D runs it. The sine and cosine line shows the part of the rotated case spent on the rotations, with the
+ * SIMD polynomials and with std.
+ */
+BZ_BENCHMARK(spriteVertices100k) {
+    constexpr uint32 SPRITE_COUNT = 100'000;
+    constexpr uint32 REPETITIONS = 20;
+
+    const std::vector<Utils::SortKeyIndex> entries = makeSortedEntries(SPRITE_COUNT);
+    std::vector<Renderer2DVertex> vertices(SPRITE_COUNT * 4);
+
+    JobSystem jobSystem;
+    jobSystem.init(glm::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+    for (bool rotated : { false, true }) {
+        std::vector<Renderer2DSprite> sprites;
+        for (uint32 i = 0; i < SPRITE_COUNT; ++i) {
+            sprites.push_back(makeSprite(rotated ? Testing::randomFloat(0.0f, 360.0f) : 0.0f));
+        }
+
+        Timer timer;
+        timer.start();
+        for (uint32 r = 0; r < REPETITIONS; ++r) {
+            Renderer2DVertices::generate(sprites.data(), entries.data(), 0, SPRITE_COUNT, vertices.data());
+        }
+        const float singleMs = timer.getCountedTime().asMillisecondsFloat() / REPETITIONS;
+
+        timer.restart();
+        for (uint32 r = 0; r < REPETITIONS; ++r) {
+            jobSystem.parallelFor(SPRITE_COUNT, Renderer2DVertices::SPRITES_PER_JOB, [&](uint32 begin, uint32 end) {
+                Renderer2DVertices::generate(sprites.data(), entries.data(), begin, end, vertices.data());
+            });
+        }
+        const float parallelMs = timer.getCountedTime().asMillisecondsFloat() / REPETITIONS;
+
+        std::printf("    %s: %.3f ms on one thread, %.3f ms on %u workers and the caller\n",
+                    rotated ? "rotated" : "unrotated", singleMs, parallelMs, jobSystem.getWorkerCount());
+    }
+
+    std::vector<float> degrees;
+    for (uint32 i = 0; i < SPRITE_COUNT; ++i) {
+        degrees.push_back(Testing::randomFloat(0.0f, 360.0f));
+    }
+    std::vector<float> sines(SPRITE_COUNT);
+    std::vector<float> cosines(SPRITE_COUNT);
+
+    Timer timer;
+    timer.start();
+    for (uint32 r = 0; r < REPETITIONS; ++r) {
+        Renderer2DVertices::sinCosDegrees(degrees.data(), SPRITE_COUNT, sines.data(), cosines.data());
+    }
+    const float simdMs = timer.getCountedTime().asMillisecondsFloat() / REPETITIONS;
+
+    timer.restart();
+    for (uint32 r = 0; r < REPETITIONS; ++r) {
+        for (uint32 i = 0; i < SPRITE_COUNT; ++i) {
+            sines[i] = std::sin(glm::radians(degrees[i]));
+            cosines[i] = std::cos(glm::radians(degrees[i]));
+        }
+    }
+    const float stdMs = timer.getCountedTime().asMillisecondsFloat() / REPETITIONS;
+    std::printf("    sine and cosine: %.3f ms SIMD, %.3f ms std (%f)\n", simdMs, stdMs, sines[SPRITE_COUNT / 2]);
+
+    jobSystem.destroy();
+}
+}
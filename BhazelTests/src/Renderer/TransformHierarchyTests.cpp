@@ -0,0 +1,157 @@
+#include "Testing.h"
+
+#include "Renderer/Transform.h"
+#include "Renderer/TransformHierarchy.h"
+
+
+namespace BZ {
+
+static Transform makeTransform() {
+    return Transform(Testing::randomVec3(-10.0f, 10.0f), Testing::randomVec3(-180.0f, 180.0f),
+                     Testing::randomVec3(0.5f, 2.0f));
+}
+
+// A forest where every node hangs from a random earlier one, so most additions break the depth order.
+static void addRandomNodes(TransformHierarchy &hierarchy, std::vector<Transform> &transforms,
+                           std::vector<TransformHierarchy::NodeId> &parents, uint32 count) {
+    for (uint32 i = 0; i < count; ++i) {
+        const uint32 nodeCount = hierarchy.getNodeCount();
+        const TransformHierarchy::NodeId parent =
+            nodeCount == 0 || Testing::randomFloat(0.0f, 1.0f) < 0.1f
+                ? TransformHierarchy::INVALID_NODE
+                : std::uniform_int_distribution<uint32>(0, nodeCount - 1)(Testing::getRandomEngine());
+
+        transforms.push_back(makeTransform());
+        parents.push_back(parent);
+        BZ_CHECK(hierarchy.addNode(transforms.back(), parent) == nodeCount);
+    }
+}
+
+// Relative to the largest element, the translations grow with the depth.
+static bool isClose(const glm::mat4 &a, const glm::mat4 &b) {
+    float maxValue = 1.0f;
+    float maxDifference = 0.0f;
+    for (uint32 c = 0; c < 4; ++c) {
+        for (uint32 r = 0; r < 4; ++r) {
+            maxValue = glm::max(maxValue, glm::max(glm::abs(a[c][r]), glm::abs(b[c][r])));
+            maxDifference = glm::max(maxDifference, glm::abs(a[c][r] - b[c][r]));
+        }
+    }
+    return maxDifference <= 1e-4f * maxValue;
+}
+
+// World matrices by composing the Transforms, parents always come first.
+static void checkAgainstTransforms(const TransformHierarchy &hierarchy, const std::vector<Transform> &transforms,
+                                   const std::vector<TransformHierarchy::NodeId> &parents) {
+    std::vector<glm::mat4> expected(transforms.size());
+    std::vector<uint32> expectedDepths(transforms.size());
+    for (uint32 node = 0; node < transforms.size(); ++node) {
+        const bool isRoot = parents[node] == TransformHierarchy::INVALID_NODE;
+        expected[node] = isRoot ? transforms[node].getLocalToParentMatrix()
+                                : expected[parents[node]] * transforms[node].getLocalToParentMatrix();
+        expectedDepths[node] = isRoot ? 0 : expectedDepths[parents[node]] + 1;
+
+        BZ_CHECK(hierarchy.getParent(node) == parents[node]);
+        BZ_CHECK(hierarchy.getDepth(node) == expectedDepths[node]);
+        BZ_CHECK(hierarchy.getTranslation(node) == transforms[node].getTranslation());
+        BZ_CHECK(isClose(hierarchy.getLocalToWorldMatrix(node), expected[node]));
+    }
+}
+
+BZ_TEST(transformHierarchyMatchesTransformProducts) {
+    TransformHierarchy hierarchy;
+    std::vector<Transform> transforms;
+    std::vector<TransformHierarchy::NodeId> parents;
+
+    addRandomNodes(hierarchy, transforms, parents, 2000);
+    checkAgainstTransforms(hierarchy, transforms, parents);
+
+    // Added after an update, so the nodes are sorted again.
+    addRandomNodes(hierarchy, transforms, parents, 500);
+    checkAgainstTransforms(hierarchy, transforms, parents);
+}
+
+BZ_TEST(transformHierarchyUpdatesChangedSubtrees) {
+    TransformHierarchy hierarchy;
+    std::vector<Transform> transforms;
+    std::vector<TransformHierarchy::NodeId> parents;
+    addRandomNodes(hierarchy, transforms, parents, 1000);
+
+    std::vector<TransformHierarchy::NodeId> changedNodes;
+    hierarchy.takeChangedNodes(changedNodes);
+    BZ_CHECK(changedNodes.size() == 1000);
+
+    const uint32 version = hierarchy.getVersion();
+    hierarchy.updateWorldMatrices();
+    BZ_CHECK(hierarchy.getVersion() == version);
+
+    // Moving some nodes changes them and everything under them.
+    std::vector<uint8> expectedChanged(transforms.size(), 0);
+    for (uint32 i = 0; i < 20; ++i) {
+        const TransformHierarchy::NodeId node =
+            std::uniform_int_distribution<uint32>(0, hierarchy.getNodeCount() - 1)(Testing::getRandomEngine());
+        transforms[node] = makeTransform();
+        hierarchy.setLocalTransform(node, transforms[node]);
+        expectedChanged[node] = 1;
+    }
+    for (uint32 node = 0; node < transforms.size(); ++node) {
+        if (parents[node] != TransformHierarchy::INVALID_NODE && expectedChanged[parents[node]]) {
+            expectedChanged[node] = 1;
+        }
+    }
+    addRandomNodes(hierarchy, transforms, parents, 100);
+    expectedChanged.resize(transforms.size(), 1);
+
+    hierarchy.takeChangedNodes(changedNodes);
+    BZ_CHECK(hierarchy.getVersion() == version + 1);
+
+    std::vector<uint8> changed(transforms.size(), 0);
+    for (TransformHierarchy::NodeId node : changedNodes) {
+        BZ_CHECK(!changed[node]);
+        changed[node] = 1;
+    }
+    BZ_CHECK(changed == expectedChanged);
+    checkAgainstTransforms(hierarchy, transforms, parents);
+}
+
+BZ_BENCHMARK(transformHierarchy100k) {
+    constexpr uint32 NODE_COUNT = 100'000;
+    constexpr uint32 FRAME_COUNT = 50;
+
+    std::vector<Transform> transforms;
+    std::vector<TransformHierarchy::NodeId> roots;
+    for (uint32 i = 0; i < NODE_COUNT; ++i) {
+        transforms.push_back(makeTransform());
+    }
+
+    TransformHierarchy hierarchy;
+    Timer timer;
+    timer.start();
+    for (uint32 i = 0; i < NODE_COUNT; ++i) {
+        // Chains of 10 nodes, so every root breaks the depth order.
+        const bool isRoot = i % 10 == 0;
+        hierarchy.addNode(transforms[i], isRoot ? TransformHierarchy::INVALID_NODE : i - 1);
+        if (isRoot) {
+            roots.push_back(i);
+        }
+    }
+    const float addMs = timer.getCountedTime().asMillisecondsFloat();
+
+    timer.restart();
+    hierarchy.updateWorldMatrices();
+    const float firstUpdateMs = timer.getCountedTime().asMillisecondsFloat();
+
+    // Every object moves, so every node is recomputed.
+    timer.restart();
+    for (uint32 frame = 0; frame < FRAME_COUNT; ++frame) {
+        for (TransformHierarchy::NodeId root : roots) {
+            hierarchy.setTranslation(root, hierarchy.getTranslation(root) + glm::vec3(0.1f));
+        }
+        hierarchy.updateWorldMatrices();
+    }
+    const float updateMs = timer.getCountedTime().asMillisecondsFloat() / FRAME_COUNT;
+
+    std::printf("    add %.2f ms, first update with sort %.2f ms, %.3f ms per full update\n", addMs, firstUpdateMs,
+                updateMs);
+}
+}
@@ -0,0 +1,23 @@
+#include "Testing.h"
+
+#include <cstring>
+
+
+// Usage: BhazelTests [--benchmarks] [filter]
+// Returns the number of failed tests, so 0 on success.
+int main(int argc, char **argv) {
+    BZ::Log::get(); // Init Logger.
+
+    bool runBenchmarks = false;
+    const char *filter = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--benchmarks") == 0) {
+            runBenchmarks = true;
+        }
+        else {
+            filter = argv[i];
+        }
+    }
+
+    return static_cast<int>(BZ::Testing::run(runBenchmarks, filter));
+}
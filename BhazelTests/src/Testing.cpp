@@ -0,0 +1,119 @@
+#include "Testing.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+
+static std::atomic<BZ::uint64> allocationCount{ 0 };
+
+// Counting every allocation of the process, for the tests that check some code path doesn't allocate.
+void *operator new(size_t size) {
+    allocationCount++;
+    void *ptr = std::malloc(size > 0 ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+
+namespace BZ {
+
+struct RegisteredFn {
+    const char *name;
+    Testing::Fn fn;
+};
+
+struct TestingData {
+    std::vector<RegisteredFn> tests;
+    std::vector<RegisteredFn> benchmarks;
+
+    uint32 currentFailureCount = 0;
+};
+
+// Function local, so it exists before the registrars of the other translation units run.
+static TestingData &getTestingData() {
+    static TestingData data;
+    return data;
+}
+
+static constexpr uint32 MAX_REPORTED_FAILURES_PER_TEST = 10;
+
+void Testing::addTest(const char *name, Fn fn) {
+    getTestingData().tests.push_back({ name, fn });
+}
+
+void Testing::addBenchmark(const char *name, Fn fn) {
+    getTestingData().benchmarks.push_back({ name, fn });
+}
+
+uint32 Testing::run(bool runBenchmarks, const char *filter) {
+    TestingData &data = getTestingData();
+
+    uint32 runCount = 0;
+    uint32 failedCount = 0;
+    for (const RegisteredFn &test : data.tests) {
+        if (filter && !std::strstr(test.name, filter)) {
+            continue;
+        }
+
+        data.currentFailureCount = 0;
+        test.fn();
+        runCount++;
+
+        if (data.currentFailureCount > 0) {
+            std::printf("[FAILED] %s (%u failed checks)\n", test.name, data.currentFailureCount);
+            failedCount++;
+        }
+        else {
+            std::printf("[PASSED] %s\n", test.name);
+        }
+    }
+    std::printf("%u of %u tests passed.\n", runCount - failedCount, runCount);
+
+    if (runBenchmarks) {
+        for (const RegisteredFn &benchmark : data.benchmarks) {
+            if (!filter || std::strstr(benchmark.name, filter)) {
+                std::printf("[BENCHMARK] %s\n", benchmark.name);
+                benchmark.fn();
+            }
+        }
+    }
+    return failedCount;
+}
+
+void Testing::reportFailure(const char *file, int line, const char *expression) {
+    TestingData &data = getTestingData();
+    if (data.currentFailureCount++ < MAX_REPORTED_FAILURES_PER_TEST) {
+        std::printf("    %s(%d): check failed: %s\n", file, line, expression);
+    }
+}
+
+uint64 Testing::getAllocationCount() {
+    return allocationCount;
+}
+
+std::mt19937 &Testing::getRandomEngine() {
+    static std::mt19937 engine(12345);
+    return engine;
+}
+
+float Testing::randomFloat(float min, float max) {
+    return std::uniform_real_distribution<float>(min, max)(getRandomEngine());
+}
+
+glm::vec3 Testing::randomVec3(float min, float max) {
+    return glm::vec3(randomFloat(min, max), randomFloat(min, max), randomFloat(min, max));
+}
+}
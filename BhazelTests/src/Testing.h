@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Bhazel.h>
+
+#include <random>
+
+
+namespace BZ {
+
+/*
+ * Minimal registry for the BhazelTests executable. Tests and benchmarks register themselves at static initialization
+ * through BZ_TEST and BZ_BENCHMARK, and are run by main(). Only code that doesn't need an Engine (window and graphics
+ * device) can be tested here.
+ * A failed check is reported and the test goes on, so a run shows every mismatch at once.
+ */
+class Testing {
+  public:
+    using Fn = void (*)();
+
+    static void addTest(const char *name, Fn fn);
+    static void addBenchmark(const char *name, Fn fn);
+
+    // Runs the tests, and the benchmarks if asked to, with names containing filter. Returns the failed test count.
+    static uint32 run(bool runBenchmarks, const char *filter);
+
+    static void reportFailure(const char *file, int line, const char *expression);
+
+    // Allocations done through the global operator new since the start.
+    static uint64 getAllocationCount();
+
+    // Seeded the same on every run, so failures can be reproduced.
+    static std::mt19937 &getRandomEngine();
+    static float randomFloat(float min, float max);
+    static glm::vec3 randomVec3(float min, float max);
+};
+
+struct TestRegistrar {
+    TestRegistrar(const char *name, Testing::Fn fn, bool isBenchmark) {
+        isBenchmark ? Testing::addBenchmark(name, fn) : Testing::addTest(name, fn);
+    }
+};
+}
+
+#define BZ_TEST(name)                                                        \
+    static void name();                                                      \
+    static BZ::TestRegistrar name##Registrar(#name, name, false);            \
+    static void name()
+
+#define BZ_BENCHMARK(name)                                                   \
+    static void name();                                                      \
+    static BZ::TestRegistrar name##Registrar(#name, name, true);             \
+    static void name()
+
+#define BZ_CHECK(condition)                                                  \
+    do {                                                                     \
+        if (!(condition)) {                                                  \
+            BZ::Testing::reportFailure(__FILE__, __LINE__, #condition);      \
+        }                                                                    \
+    } while (false)
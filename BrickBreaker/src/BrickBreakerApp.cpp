@@ -3,26 +3,28 @@
 #include <glm/gtc/random.hpp>
 
 
-void Ball::init(const BZ::Ref<BZ::Texture2D> &ballTexture, const BZ::Ref<BZ::Texture2D> &ballParticleTexture) {
-    sprite.dimensions = ballTexture->getDimensions();
+void Ball::init(const BZ::TextureAtlasRegion &ballRegion, const BZ::TextureAtlasRegion &ballParticleRegion) {
+    sprite.dimensions = ballRegion.dimensions;
     sprite.rotationDeg = 0.0f;
-    sprite.texture = ballTexture;
+    sprite.setAtlasRegion(ballRegion);
     sprite.tintAndAlpha = BALL_TINT;
     secsToTint = 0.0f;
 
     setToInitialPosition();
+    boundingSphere = BZ::BoundingSphere(glm::vec3(sprite.position, 0.1f), BALL_RADIUS);
 
     BZ::Particle2DRanges ranges;
     ranges.dimensionRange = { { 15.0f, 15.0f }, { 20.0f, 20.0f } };
     ranges.angularVelocityRange = { -180.0f, 180.0f };
     ranges.tintAndAlphaRange = BALL_TINT;
-    particleSystem.addEmitter({ 0.0f, 0.0f }, 100, -1, ranges, ballParticleTexture);
+    particleSystem.addEmitter({ 0.0f, 0.0f }, 100, -1, ranges, ballParticleRegion);
     particleSystem.start();
 }
 
-void Ball::onUpdate(const BZ::FrameTiming &frameTiming, BrickMap &brickMap, Paddle &paddle) {
+void Ball::onFixedUpdate(const BZ::FrameTiming &frameTiming, BrickMap &brickMap, Paddle &paddle) {
     const auto WINDOW_DIMS = BZ::Engine::get().getWindow().getDimensionsFloat();
 
+    previousPosition = sprite.position;
     sprite.position += velocity * frameTiming.deltaTime.asSeconds();
 
     if (sprite.position.x < 0) {
@@ -44,14 +46,18 @@ void Ball::onUpdate(const BZ::FrameTiming &frameTiming, BrickMap &brickMap, Padd
 
     boundingSphere = BZ::BoundingSphere(glm::vec3(sprite.position, 0.1f), BALL_RADIUS);
 
-    for (Brick &brick : brickMap.bricks) {
-        if (brick.isCollidable) {
-            auto intResult = BZ::CollisionUtils::intersects(brick.aabb, boundingSphere);
-            if (intResult.intersects) {
-                sprite.position.x += intResult.penetration.x;
-                sprite.position.y += intResult.penetration.y;
-                // velocity = glm::normalize(intResult.penetration) * BALL_SPEED;
-                velocity = glm::reflect(velocity, glm::normalize(glm::vec2(intResult.penetration)));
+    brickMap.broadphase.updateCollider(collider);
+    brickMap.broadphase.findContacts(
+        [this, &brickMap](uint32 userDataA, uint32 userDataB, const BZ::IntersectionResult &result) {
+            // Bricks don't overlap each other, one of them is the Ball. Penetration needs to go from the Brick to it.
+            const bool ballIsA = userDataA == BALL_USER_DATA;
+            Brick &brick = brickMap.bricks[ballIsA ? userDataB : userDataA];
+            const glm::vec2 penetration = ballIsA ? -glm::vec2(result.penetration) : glm::vec2(result.penetration);
+
+            if (brick.isCollidable) {
+                sprite.position += penetration;
+                // velocity = glm::normalize(penetration) * BALL_SPEED;
+                velocity = glm::reflect(velocity, glm::normalize(penetration));
                 brick.isCollidable = false;
                 brick.secsToFade = BRICK_FADE_SECONDS;
 
@@ -60,8 +66,7 @@ void Ball::onUpdate(const BZ::FrameTiming &frameTiming, BrickMap &brickMap, Padd
 
                 brickMap.startParticleSystem(brick);
             }
-        }
-    }
+        });
 
     auto intResult = BZ::CollisionUtils::intersects(paddle.aabb, boundingSphere);
     if (intResult.intersects) {
@@ -75,18 +80,23 @@ void Ball::onUpdate(const BZ::FrameTiming &frameTiming, BrickMap &brickMap, Padd
         // (MAX_DISPLACEMENT * positionInPaddle))) * BALL_SPEED;
         velocity = glm::reflect(velocity, glm::normalize(glm::vec2(intResult.penetration)));
     }
+}
 
+void Ball::onUpdate(const BZ::FrameTiming &frameTiming) {
     if (secsToTint > 0.0f) {
         sprite.tintAndAlpha = glm::mix(BALL_TINT, colorToTint, secsToTint / BALL_TINT_SECONDS);
         secsToTint -= frameTiming.deltaTime.asSeconds();
     }
-    BZ::Renderer2D::renderSprite(sprite);
+
+    BZ::Sprite renderedSprite = sprite;
+    renderedSprite.position = glm::mix(previousPosition, sprite.position, frameTiming.interpolationAlpha);
+    BZ::Renderer2D::renderSprite(renderedSprite);
 
     for (auto &emitter : particleSystem.getEmitters()) {
         emitter.ranges.tintAndAlphaRange = sprite.tintAndAlpha;
     }
 
-    particleSystem.setPosition(sprite.position);
+    particleSystem.setPosition(renderedSprite.position);
     particleSystem.onUpdate(frameTiming);
     BZ::Renderer2D::renderParticleSystem2D(particleSystem);
 }
@@ -96,23 +106,27 @@ void Ball::setToInitialPosition() {
     const auto WINDOW_HALF_DIMS = WINDOW_DIMS * 0.5f;
 
     sprite.position = { WINDOW_HALF_DIMS.x, PADDLE_Y + BRICK_MARGIN };
+    previousPosition = sprite.position;
     velocity = glm::normalize(glm::vec2(glm::linearRand(-1.0f, 1.0f), 1.0f)) * BALL_SPEED;
 }
 
-void Paddle::init(const BZ::Ref<BZ::Texture2D> &texture) {
+void Paddle::init(const BZ::TextureAtlasRegion &region) {
     const auto WINDOW_DIMS = BZ::Engine::get().getWindow().getDimensionsFloat();
     const auto WINDOW_HALF_DIMS = WINDOW_DIMS * 0.5f;
 
     sprite.position = { WINDOW_HALF_DIMS.x, PADDLE_Y };
-    sprite.dimensions = texture->getDimensions();
+    previousPosition = sprite.position;
+    sprite.dimensions = region.dimensions;
     sprite.rotationDeg = 0.0f;
-    sprite.texture = texture;
+    sprite.setAtlasRegion(region);
     sprite.tintAndAlpha = { 1.0f, 1.0f, 1.0f, 1.0f };
 }
 
-void Paddle::onUpdate(const BZ::FrameTiming &frameTiming) {
+void Paddle::onFixedUpdate(const BZ::FrameTiming &frameTiming) {
     const auto WINDOW_DIMS = BZ::Engine::get().getWindow().getDimensionsFloat();
 
+    previousPosition = sprite.position;
+
     if (BZ::Input::isKeyPressed(BZ_KEY_LEFT)) {
         sprite.position.x -= PADDLE_VELOCITY * frameTiming.deltaTime.asSeconds();
     }
@@ -128,12 +142,17 @@ void Paddle::onUpdate(const BZ::FrameTiming &frameTiming) {
     }
 
     aabb = BZ::AABB(glm::vec3(sprite.position, 0.1f), glm::vec3(PADDLE_DIMS, 0.1f));
-    BZ::Renderer2D::renderSprite(sprite);
+}
+
+void Paddle::onUpdate(const BZ::FrameTiming &frameTiming) {
+    BZ::Sprite renderedSprite = sprite;
+    renderedSprite.position = glm::mix(previousPosition, sprite.position, frameTiming.interpolationAlpha);
+    BZ::Renderer2D::renderSprite(renderedSprite);
     // BZ::Renderer2D::renderQuad(glm::vec2(aabb.getCenter()), glm::vec2(aabb.getDimensions()), 0.0f, { 1.0f, 0.0f,
     // 0.0f, 1.0f });
 }
 
-void BrickMap::init(const BZ::Ref<BZ::Texture2D> &brickTexture, const BZ::Ref<BZ::Texture2D> &explosionTexture) {
+void BrickMap::init(const BZ::TextureAtlasRegion &brickRegion, const BZ::TextureAtlasRegion &explosionRegion) {
     const auto &WINDOW_DIMS = BZ::Engine::get().getWindow().getDimensions();
 
     bool flip = true;
@@ -146,9 +165,9 @@ void BrickMap::init(const BZ::Ref<BZ::Texture2D> &brickTexture, const BZ::Ref<BZ
             brick.isCollidable = true;
             brick.secsToFade = 0.0f;
             brick.sprite.position = { x, y };
-            brick.sprite.dimensions = brickTexture->getDimensions();
+            brick.sprite.dimensions = brickRegion.dimensions;
             brick.sprite.rotationDeg = 0.0f;
-            brick.sprite.texture = brickTexture;
+            brick.sprite.setAtlasRegion(brickRegion);
             brick.sprite.tintAndAlpha = flip ? BRICK_TINT1 : BRICK_TINT2;
             brick.aabb = BZ::AABB(glm::vec3(brick.sprite.position, 0.1f), glm::vec3(BRICK_DIMS, 0.1f));
             bricks.push_back(brick);
@@ -156,6 +175,11 @@ void BrickMap::init(const BZ::Ref<BZ::Texture2D> &brickTexture, const BZ::Ref<BZ
         }
     }
 
+    // After filling the vector, the colliders point to the Brick AABBs.
+    for (uint32 i = 0; i < bricks.size(); ++i) {
+        bricks[i].collider = broadphase.addCollider(bricks[i].aabb, i);
+    }
+
     for (int i = 0; i < PARTICLE_SYSTEMS_COUNT; ++i) {
         BZ::ParticleSystem2D &ps = particleSystems[i];
         BZ::Particle2DRanges ranges;
@@ -164,7 +188,7 @@ void BrickMap::init(const BZ::Ref<BZ::Texture2D> &brickTexture, const BZ::Ref<BZ
         ranges.angularVelocityRange = { -180.0f, 180.0f };
         ranges.tintAndAlphaRange = BRICK_HIT_TINT;
         ranges.lifeSecsRange = { 0.5f, 0.75f };
-        ps.addEmitter({ 0.0f, 0.0f }, 500, 0.05f, ranges, explosionTexture);
+        ps.addEmitter({ 0.0f, 0.0f }, 500, 0.05f, ranges, explosionRegion);
     }
 
     currentParticleSystem = 0;
@@ -173,6 +197,11 @@ void BrickMap::init(const BZ::Ref<BZ::Texture2D> &brickTexture, const BZ::Ref<BZ
 void BrickMap::onUpdate(const BZ::FrameTiming &frameTiming) {
     for (uint32 i = 0; i < bricks.size(); ++i) {
         Brick &brick = bricks[i];
+        if (!brick.isCollidable && brick.collider != BZ::Broadphase::INVALID_COLLIDER) {
+            broadphase.removeCollider(brick.collider);
+            brick.collider = BZ::Broadphase::INVALID_COLLIDER;
+        }
+
         if (brick.isVisible) {
             if (brick.secsToFade > 0.0f) {
                 // brick.sprite.tintAndAlpha = { 1.0f, 0.0f, 0.0f, brick.secsToFade / BRICK_FADE_SECONDS };
@@ -215,20 +244,26 @@ void MainLayer::onAttachToEngine() {
     camera.getTransform().setTranslation(WINDOW_HALF_DIMS.x, WINDOW_HALF_DIMS.y, 0.0f, BZ::Space::Parent);
     cameraController = BZ::CameraController2D(camera, 400.0f, true, 45.0f);
 
-    brickTexture = BZ::Texture2D::create("BrickBreaker/textures/brick.png", VK_FORMAT_R8G8B8A8_SRGB,
-                                         BZ::MipmapData::Options::Generate);
-    paddleTexture = BZ::Texture2D::create("BrickBreaker/textures/paddle.png", VK_FORMAT_R8G8B8A8_SRGB,
-                                          BZ::MipmapData::Options::Generate);
-    ballTexture = BZ::Texture2D::create("BrickBreaker/textures/ball.png", VK_FORMAT_R8G8B8A8_SRGB,
-                                        BZ::MipmapData::Options::Generate);
-    ballParticleTexture = BZ::Texture2D::create("BrickBreaker/textures/particle2.png", VK_FORMAT_R8G8B8A8_SRGB,
-                                                BZ::MipmapData::Options::Generate);
-    brickExplosionTexture = BZ::Texture2D::create("BrickBreaker/textures/particle1.png", VK_FORMAT_R8G8B8A8_SRGB,
-                                                  BZ::MipmapData::Options::Generate);
-
-    brickMap.init(brickTexture, brickExplosionTexture);
-    paddle.init(paddleTexture);
-    ball.init(ballTexture, ballParticleTexture);
+    // All the sprites on a single atlas page, rendered with a single draw call.
+    BZ::TextureAtlas::Builder atlasBuilder;
+    atlasBuilder.addImage("brick", "BrickBreaker/textures/brick.png");
+    atlasBuilder.addImage("paddle", "BrickBreaker/textures/paddle.png");
+    atlasBuilder.addImage("ball", "BrickBreaker/textures/ball.png");
+    atlasBuilder.addImage("ballParticle", "BrickBreaker/textures/particle2.png");
+    atlasBuilder.addImage("brickExplosion", "BrickBreaker/textures/particle1.png");
+    atlas = atlasBuilder.build();
+
+    brickMap.init(atlas->getRegion("brick"), atlas->getRegion("brickExplosion"));
+    paddle.init(atlas->getRegion("paddle"));
+    ball.init(atlas->getRegion("ball"), atlas->getRegion("ballParticle"));
+    ball.collider = brickMap.broadphase.addCollider(ball.boundingSphere, BALL_USER_DATA);
+}
+
+void MainLayer::onFixedUpdate(const BZ::FrameTiming &frameTiming) {
+    BZ_PROFILE_FUNCTION();
+
+    paddle.onFixedUpdate(frameTiming);
+    ball.onFixedUpdate(frameTiming, brickMap, paddle);
 }
 
 void MainLayer::onUpdate(const BZ::FrameTiming &frameTiming) {
@@ -240,7 +275,7 @@ void MainLayer::onUpdate(const BZ::FrameTiming &frameTiming) {
 
     brickMap.onUpdate(frameTiming);
     paddle.onUpdate(frameTiming);
-    ball.onUpdate(frameTiming, brickMap, paddle);
+    ball.onUpdate(frameTiming);
 
     BZ::Renderer2D::end();
 }
@@ -21,22 +21,29 @@ const glm::vec4 BRICK_TINT2 = { 0.1f, 0.6f, 0.2f, 1.0f };
 const glm::vec4 BRICK_HIT_TINT = { 0.9f, 0.9f, 0.1f, 1.0f };
 const float BRICK_MARGIN = 20.0f;
 
+// Bricks use their index.
+const uint32 BALL_USER_DATA = 0xffffffff;
+
 
 struct Brick {
     BZ::Sprite sprite;
     bool isVisible;
     bool isCollidable;
     BZ::AABB aabb;
+    uint32 collider;
     float secsToFade;
 };
 
 class BrickMap {
   public:
-    void init(const BZ::Ref<BZ::Texture2D> &brickTexture, const BZ::Ref<BZ::Texture2D> &explosionTexture);
+    void init(const BZ::TextureAtlasRegion &brickRegion, const BZ::TextureAtlasRegion &explosionRegion);
     void onUpdate(const BZ::FrameTiming &frameTiming);
 
     std::vector<Brick> bricks;
 
+    // Bricks and the Ball.
+    BZ::SweepAndPruneBroadphase broadphase;
+
     void startParticleSystem(const Brick &brick);
 
   private:
@@ -49,7 +56,11 @@ struct Paddle {
     BZ::Sprite sprite;
     BZ::AABB aabb;
 
-    void init(const BZ::Ref<BZ::Texture2D> &texture);
+    // Before the last fixed update, to interpolate the rendered position.
+    glm::vec2 previousPosition;
+
+    void init(const BZ::TextureAtlasRegion &region);
+    void onFixedUpdate(const BZ::FrameTiming &frameTiming);
     void onUpdate(const BZ::FrameTiming &frameTiming);
 };
 
@@ -57,14 +68,19 @@ class Ball {
   public:
     BZ::Sprite sprite;
     BZ::BoundingSphere boundingSphere;
+    uint32 collider;
     glm::vec2 velocity;
     float secsToTint;
     glm::vec4 colorToTint;
 
+    // Before the last fixed update, to interpolate the rendered position.
+    glm::vec2 previousPosition;
+
     BZ::ParticleSystem2D particleSystem;
 
-    void init(const BZ::Ref<BZ::Texture2D> &ballTexture, const BZ::Ref<BZ::Texture2D> &ballParticleTexture);
-    void onUpdate(const BZ::FrameTiming &frameTiming, BrickMap &brickMap, Paddle &paddle);
+    void init(const BZ::TextureAtlasRegion &ballRegion, const BZ::TextureAtlasRegion &ballParticleRegion);
+    void onFixedUpdate(const BZ::FrameTiming &frameTiming, BrickMap &brickMap, Paddle &paddle);
+    void onUpdate(const BZ::FrameTiming &frameTiming);
 
     void setToInitialPosition();
 };
@@ -76,6 +92,7 @@ class MainLayer : public BZ::Layer {
 
     void onAttachToEngine() override;
 
+    void onFixedUpdate(const BZ::FrameTiming &frameTiming) override;
     void onUpdate(const BZ::FrameTiming &frameTiming) override;
     void onEvent(BZ::Event &event) override;
     void onImGuiRender(const BZ::FrameTiming &frameTiming) override;
@@ -88,11 +105,7 @@ class MainLayer : public BZ::Layer {
     Ball ball;
     Paddle paddle;
 
-    BZ::Ref<BZ::Texture2D> brickTexture;
-    BZ::Ref<BZ::Texture2D> paddleTexture;
-    BZ::Ref<BZ::Texture2D> ballTexture;
-    BZ::Ref<BZ::Texture2D> ballParticleTexture;
-    BZ::Ref<BZ::Texture2D> brickExplosionTexture;
+    BZ::Ref<BZ::TextureAtlas> atlas;
 };
 
 
@@ -100,6 +113,10 @@ class BrickBreakerApp : public BZ::Application {
   public:
     BrickBreakerApp() {
         settings.enable3dRenderer = false;
+
+        // The Ball moves a fixed distance per step, so it doesn't tunnel through Bricks on long frames.
+        settings.fixedTimestep = true;
+        settings.fixedUpdatesPerSecond = 120;
         pushLayer(new MainLayer());
     }
 };
\ No newline at end of file
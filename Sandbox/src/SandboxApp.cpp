@@ -80,6 +80,28 @@ Layer3D::Layer3D() : Layer("3D") {
 }
 
 
+// Many lights stress test, a grid of Point Lights under the ground and a Spot Light over the middle.
+static void addManyLights(BZ::Scene &scene) {
+    constexpr int LIGHT_GRID_SIZE = 32;
+    for (int z = 0; z < LIGHT_GRID_SIZE; ++z) {
+        for (int x = 0; x < LIGHT_GRID_SIZE; ++x) {
+            BZ::PointLight pointLight;
+            pointLight.position = { (x - LIGHT_GRID_SIZE / 2) * 6.0f, -20.0f, (z - LIGHT_GRID_SIZE / 2) * 6.0f };
+            pointLight.color = glm::abs(glm::sin(glm::vec3(x, z, x + z) * 0.7f));
+            pointLight.intensity = 40.0f;
+            pointLight.radius = 10.0f;
+            scene.addPointLight(pointLight);
+        }
+    }
+
+    BZ::SpotLight spotLight;
+    spotLight.position = { 0.0f, 20.0f, 0.0f };
+    spotLight.setDirection({ 0.0f, -1.0f, 0.0f });
+    spotLight.intensity = 2000.0f;
+    spotLight.radius = 80.0f;
+    scene.addSpotLight(spotLight);
+}
+
 void Layer3D::onAttachToEngine() {
     const auto &WINDOW_DIMS = BZ::Engine::get().getWindow().getDimensionsFloat();
     const glm::vec2 WINDOW_HALF_DIMS = WINDOW_DIMS * 0.5f;
@@ -181,7 +203,7 @@ void Layer3D::onAttachToEngine() {
     houseTransform.setScale(10.0f, 10.0f, 10.0f);
     houseTransform.setTranslation(0.4f, -29.0f, 0.0f, BZ::Space::Parent);
     houseTransform.setRotationEuler(0.0f, 295.0f, 0.0f, BZ::Space::Parent);
-    scenes[0]->addEntity(houseMesh, houseTransform);
+    const BZ::uint32 houseEntity = scenes[0]->addEntity(houseMesh, houseTransform);
     scenes[1]->addEntity(houseMesh, houseTransform);
     scenes[2]->addEntity(houseMesh, houseTransform);
     
@@ -189,7 +211,7 @@ void Layer3D::onAttachToEngine() {
     houseTransform2.setScale(10.0f, 10.0f, 10.0f);
     houseTransform2.setTranslation(-83.0f, -29.0f, -27.4f, BZ::Space::Parent);
     houseTransform2.setRotationEuler(0.0f, -218.0f, 0.0f, BZ::Space::Parent);
-    scenes[0]->addEntity(houseMesh, houseTransform2);
+    const BZ::uint32 houseEntity2 = scenes[0]->addEntity(houseMesh, houseTransform2);
     scenes[1]->addEntity(houseMesh, houseTransform2);
     scenes[2]->addEntity(houseMesh, houseTransform2);
     
@@ -197,9 +219,16 @@ void Layer3D::onAttachToEngine() {
     houseTransform3.setScale(10.0f, 10.0f, 10.0f);
     houseTransform3.setTranslation(-20.0f, -29.0f, -100.0f, BZ::Space::Parent);
     houseTransform3.setRotationEuler(0.0f, 151.0f, 0.0f, BZ::Space::Parent);
-    scenes[0]->addEntity(houseMesh, houseTransform3);
+    const BZ::uint32 houseEntity3 = scenes[0]->addEntity(houseMesh, houseTransform3);
     scenes[1]->addEntity(houseMesh, houseTransform3);
     scenes[2]->addEntity(houseMesh, houseTransform3);
+
+    // Big and closed, so good occluders. The Entity indices are the same on all the Scenes.
+    for (BZ::Scene *scene : scenes) {
+        for (BZ::uint32 entity : { houseEntity, houseEntity2, houseEntity3 }) {
+            scene->getEntities()[entity].occluder = true;
+        }
+    }
 #endif
 
     // Sphere Wall
@@ -260,6 +289,15 @@ void Layer3D::onUpdate(const BZ::FrameTiming &frameTiming) {
     else
         rotateCameraController.onUpdate(frameTiming);
 
+    if (BZ::Input::isMouseButtonPressed(BZ_MOUSE_BUTTON_MIDDLE)) {
+        const BZ::Ray ray = camera.screenPointToRay(glm::vec2(BZ::Input::getMousePosition()),
+                                                    BZ::Engine::get().getWindow().getDimensionsFloat());
+        BZ::RaycastHit hit;
+        pickedEntity = scenes[activeScene]->raycastClosest(ray, camera.getParameters().far, hit)
+                           ? static_cast<int>(hit.entityIndex)
+                           : -1;
+    }
+
     // scenes[activeScene].getEntities()[2].transform.yaw(frameTiming.deltaTime.asSeconds() * 10.0f, BZ::Space::Local);
 
     BZ::Renderer::renderScene(*scenes[activeScene]);
@@ -297,6 +335,19 @@ void Layer3D::onImGuiRender(const BZ::FrameTiming &frameTiming) {
         const char *const items[] = { "Scene1", "Scene2", "Scene3" };
         if (ImGui::ListBox("", &activeScene, items, sizeof(items) / sizeof(char *))) {
         }
+
+        // The Scenes have no other Point or Spot Lights, all of them can go.
+        if (ImGui::Checkbox("Many Lights", &manyLights)) {
+            for (BZ::Scene *scene : scenes) {
+                if (manyLights) {
+                    addManyLights(*scene);
+                }
+                else {
+                    scene->getPointLights().clear();
+                    scene->getSpotLights().clear();
+                }
+            }
+        }
     }
     ImGui::End();
 
@@ -304,20 +355,25 @@ void Layer3D::onImGuiRender(const BZ::FrameTiming &frameTiming) {
 
     int i = 0;
     if (ImGui::Begin("Transforms")) {
+        BZ::TransformHierarchy &transformHierarchy = scene.getTransformHierarchy();
         for (auto &entity : scene.getEntities()) {
-            auto translation = entity.transform.getTranslation();
-            auto rot = entity.transform.getRotationEuler();
-            auto scale = entity.transform.getScale();
+            auto translation = transformHierarchy.getTranslation(entity.transformNode);
+            auto rot = transformHierarchy.getRotationEuler(entity.transformNode);
+            auto scale = transformHierarchy.getScale(entity.transformNode);
             ImGui::PushID(i);
+            if (i == pickedEntity) {
+                ImGui::Text("Picked");
+            }
             if (ImGui::DragFloat3("Translation", &translation[0], 0.1f, -100.0f, 100.0f)) {
-                entity.transform.setTranslation(translation, BZ::Space::Parent);
+                transformHierarchy.setTranslation(entity.transformNode, translation);
             }
             if (ImGui::DragFloat3("Rotation", &rot[0], 1.0f, -359.0f, 359.0f)) {
-                entity.transform.setRotationEuler(rot, BZ::Space::Parent);
+                transformHierarchy.setRotationEuler(entity.transformNode, rot);
             }
             if (ImGui::DragFloat3("Scale", &scale[0], 0.05f, 0.0f, 100.0f)) {
-                entity.transform.setScale(scale);
+                transformHierarchy.setScale(entity.transformNode, scale);
             }
+            ImGui::Checkbox("Occluder", &entity.occluder);
             ImGui::Separator();
             ImGui::PopID();
             i++;
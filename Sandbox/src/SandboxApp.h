@@ -38,11 +38,17 @@ class Layer3D : public BZ::Layer {
     BZ::Scene* scenes[3]; //TODO: it's not very nice to have a bunch of Scene pointers here
     int activeScene = 0;
 
+    // Stress test for the LightClusterer, off by default.
+    bool manyLights = false;
+
     BZ::PerspectiveCamera camera;
     BZ::RotateCameraController rotateCameraController;
     BZ::FreeCameraController freeCameraController;
     bool useFreeCamera = false;
 
+    // Picked with the middle mouse button.
+    int pickedEntity = -1;
+
     BZ::OrthographicCamera orthoCamera;
 };
 
@@ -0,0 +1,88 @@
+#version 450 core
+#pragma shader_stage(compute)
+
+#define BLOOM_TEXTURE_MIPS 5
+#define RADIUS 4
+#define GROUP_SIZE 16
+#define TILE_SIZE (GROUP_SIZE + RADIUS * 2)
+
+//Separable 9-tap gaussian of one bloom mip, both directions on the same dispatch using shared memory, followed by a
+//tent filtered upsample of the previous (smaller) mip result, dual filter style.
+layout(local_size_x = GROUP_SIZE, local_size_y = GROUP_SIZE) in;
+
+layout(set = 0, binding = 0) uniform sampler2D uInputTexSampler;
+layout(set = 0, binding = 1) uniform sampler2D uPreviousMipTexSampler;
+layout(set = 0, binding = 2, rgba16f) uniform writeonly image2D uOutput;
+
+layout(push_constant) uniform Data {
+    uint currentMip;
+    float blurWeight;
+} uData;
+
+const float weight[5] = float[] (0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
+
+shared vec3 sTile[TILE_SIZE][TILE_SIZE];
+shared vec3 sHorizontal[TILE_SIZE][GROUP_SIZE];
+
+
+void main() {
+    ivec2 localId = ivec2(gl_LocalInvocationID.xy);
+    ivec2 tileBase = ivec2(gl_WorkGroupID.xy) * GROUP_SIZE - RADIUS;
+    ivec2 inputSize = textureSize(uInputTexSampler, 0);
+    int localIndex = localId.y * GROUP_SIZE + localId.x;
+
+    //Load the tile with the borders needed by the kernel, clamping to the edges.
+    for(int i = localIndex; i < TILE_SIZE * TILE_SIZE; i += GROUP_SIZE * GROUP_SIZE) {
+        ivec2 tileCoord = ivec2(i % TILE_SIZE, i / TILE_SIZE);
+        ivec2 coord = clamp(tileBase + tileCoord, ivec2(0), inputSize - 1);
+        sTile[tileCoord.y][tileCoord.x] = texelFetch(uInputTexSampler, coord, 0).rgb;
+    }
+    barrier();
+
+    //Horizontal, on all the tile rows.
+    for(int i = localIndex; i < TILE_SIZE * GROUP_SIZE; i += GROUP_SIZE * GROUP_SIZE) {
+        int x = i % GROUP_SIZE;
+        int y = i / GROUP_SIZE;
+        vec3 result = sTile[y][x + RADIUS] * weight[0];
+        for(int j = 1; j <= RADIUS; ++j) {
+            result += (sTile[y][x + RADIUS + j] + sTile[y][x + RADIUS - j]) * weight[j];
+        }
+        sHorizontal[y][x] = result;
+    }
+    barrier();
+
+    //Vertical.
+    ivec2 coord = tileBase + RADIUS + localId;
+    ivec2 outputSize = imageSize(uOutput);
+    if(any(greaterThanEqual(coord, outputSize))) {
+        return;
+    }
+
+    vec3 result = sHorizontal[localId.y + RADIUS][localId.x] * weight[0];
+    for(int j = 1; j <= RADIUS; ++j) {
+        result += (sHorizontal[localId.y + RADIUS + j][localId.x] + sHorizontal[localId.y + RADIUS - j][localId.x]) *
+                  weight[j];
+    }
+
+    //Control the weight of the current blur mip.
+    result *= uData.blurWeight;
+
+    //All mips except the last one sum with the previous, upsampled with a 3x3 tent filter.
+    if(uData.currentMip < BLOOM_TEXTURE_MIPS - 1) {
+        vec2 uv = (vec2(coord) + 0.5) / vec2(outputSize);
+        vec2 offset = 1.0 / vec2(textureSize(uPreviousMipTexSampler, 0));
+
+        vec3 upsample = texture(uPreviousMipTexSampler, uv).rgb * 4.0;
+        upsample += texture(uPreviousMipTexSampler, uv + vec2(-offset.x, 0.0)).rgb * 2.0;
+        upsample += texture(uPreviousMipTexSampler, uv + vec2(offset.x, 0.0)).rgb * 2.0;
+        upsample += texture(uPreviousMipTexSampler, uv + vec2(0.0, -offset.y)).rgb * 2.0;
+        upsample += texture(uPreviousMipTexSampler, uv + vec2(0.0, offset.y)).rgb * 2.0;
+        upsample += texture(uPreviousMipTexSampler, uv + vec2(-offset.x, -offset.y)).rgb;
+        upsample += texture(uPreviousMipTexSampler, uv + vec2(offset.x, -offset.y)).rgb;
+        upsample += texture(uPreviousMipTexSampler, uv + vec2(-offset.x, offset.y)).rgb;
+        upsample += texture(uPreviousMipTexSampler, uv + vec2(offset.x, offset.y)).rgb;
+        result += upsample / 16.0;
+    }
+
+    imageStore(uOutput, coord, vec4(result, 1.0));
+}
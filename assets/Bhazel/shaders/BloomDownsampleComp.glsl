@@ -0,0 +1,70 @@
+#version 450 core
+#pragma shader_stage(compute)
+
+#define BLOOM_TEXTURE_MIPS 5
+
+//Single pass downsampling. Each workgroup reduces a 64x64 tile of the input into all the bloom mips, keeping the
+//intermediate results on shared memory. With 5 mips the tiles never need data from other workgroups.
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(set = 0, binding = 0) uniform sampler2D uInputTexSampler;
+layout(set = 0, binding = 1, rgba16f) uniform writeonly image2D uMips[BLOOM_TEXTURE_MIPS];
+
+shared vec3 sTile[16][16];
+
+
+//Constant indices only, dynamic indexing of storage image arrays is an optional feature.
+void storeMip(int mip, ivec2 coord, vec3 value) {
+    switch(mip) {
+        case 0: if(all(lessThan(coord, imageSize(uMips[0])))) imageStore(uMips[0], coord, vec4(value, 1.0)); break;
+        case 1: if(all(lessThan(coord, imageSize(uMips[1])))) imageStore(uMips[1], coord, vec4(value, 1.0)); break;
+        case 2: if(all(lessThan(coord, imageSize(uMips[2])))) imageStore(uMips[2], coord, vec4(value, 1.0)); break;
+        case 3: if(all(lessThan(coord, imageSize(uMips[3])))) imageStore(uMips[3], coord, vec4(value, 1.0)); break;
+        case 4: if(all(lessThan(coord, imageSize(uMips[4])))) imageStore(uMips[4], coord, vec4(value, 1.0)); break;
+    }
+}
+
+void main() {
+    ivec2 localId = ivec2(gl_LocalInvocationID.xy);
+    ivec2 groupId = ivec2(gl_WorkGroupID.xy);
+    vec2 inputTexelSize = 1.0 / textureSize(uInputTexSampler, 0);
+
+    //Mip 0. Each thread outputs a 2x2 block, each texel being a bilinear sample on the center of 2x2 input texels.
+    ivec2 mip0Base = groupId * 32 + localId * 2;
+    vec3 sum = vec3(0.0);
+    for(int y = 0; y < 2; ++y) {
+        for(int x = 0; x < 2; ++x) {
+            ivec2 coord = mip0Base + ivec2(x, y);
+            vec3 value = texture(uInputTexSampler, vec2(coord * 2 + 1) * inputTexelSize).rgb;
+            storeMip(0, coord, value);
+            sum += value;
+        }
+    }
+
+    //Mip 1. Straight from registers.
+    vec3 value = sum * 0.25;
+    storeMip(1, groupId * 16 + localId, value);
+    sTile[localId.y][localId.x] = value;
+
+    //Mips 2 to 4. Halving the active threads on each step.
+    int size = 8;
+    for(int mip = 2; mip < BLOOM_TEXTURE_MIPS; ++mip) {
+        barrier();
+
+        bool active = all(lessThan(localId, ivec2(size)));
+        if(active) {
+            ivec2 src = localId * 2;
+            value = (sTile[src.y][src.x] + sTile[src.y][src.x + 1] +
+                     sTile[src.y + 1][src.x] + sTile[src.y + 1][src.x + 1]) * 0.25;
+            storeMip(mip, groupId * size + localId, value);
+        }
+
+        //Everyone needs to be done reading before overwriting.
+        barrier();
+
+        if(active) {
+            sTile[localId.y][localId.x] = value;
+        }
+        size /= 2;
+    }
+}
@@ -0,0 +1,85 @@
+#version 450 core
+#pragma shader_stage(compute)
+
+//Meshlet culling for the color pass, the GPU path of MeshletCuller. One invocation per Meshlet, writing the
+//VkDrawIndexedIndirectCommand at the same index, with no indices when culled. Same normal cone and Frustum tests as
+//the CPU path, the depth pyramid of the OcclusionCuller only lives on the CPU.
+layout(local_size_x = 64) in;
+
+struct Slot {
+    mat4 modelMatrix;
+    vec4 modelCameraPositionAndScale; //Camera position in model space, and the largest scale of the model matrix.
+    uint testCones; //Off for mirroring model matrices.
+};
+
+//Same as Mesh::Meshlet, plus the Slot of the SubMesh it belongs to.
+struct Meshlet {
+    vec4 centerAndRadius;
+    vec4 coneAxisAndCutoff;
+    uint indexOffset;
+    uint indexCount;
+    uint slot;
+};
+
+//VkDrawIndexedIndirectCommand.
+struct DrawCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(set = 0, binding = 0, std140) uniform CullData {
+    vec4 frustumPlanes[6]; //Normals pointing inside on xyz, distance on w.
+    uint meshletCount;
+} uCullData;
+
+layout(set = 0, binding = 1, std430) readonly buffer Slots {
+    Slot slots[];
+} bSlots;
+
+layout(set = 0, binding = 2, std430) readonly buffer Meshlets {
+    Meshlet meshlets[];
+} bMeshlets;
+
+layout(set = 0, binding = 3, std430) writeonly buffer DrawCommands {
+    DrawCommand commands[];
+} bDrawCommands;
+
+
+bool isVisible(Meshlet meshlet) {
+    Slot slot = bSlots.slots[meshlet.slot];
+
+    vec3 toCenter = meshlet.centerAndRadius.xyz - slot.modelCameraPositionAndScale.xyz;
+    if(slot.testCones != 0 &&
+       dot(toCenter, meshlet.coneAxisAndCutoff.xyz) >= meshlet.coneAxisAndCutoff.w * length(toCenter) + meshlet.centerAndRadius.w) {
+        return false;
+    }
+
+    vec3 center = (slot.modelMatrix * vec4(meshlet.centerAndRadius.xyz, 1.0)).xyz;
+    float radius = meshlet.centerAndRadius.w * slot.modelCameraPositionAndScale.w;
+    for(int i = 0; i < 6; ++i) {
+        if(dot(uCullData.frustumPlanes[i].xyz, center) + uCullData.frustumPlanes[i].w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void main() {
+    uint id = gl_GlobalInvocationID.x;
+    if(id >= uCullData.meshletCount) {
+        return;
+    }
+
+    Meshlet meshlet = bMeshlets.meshlets[id];
+
+    DrawCommand command;
+    command.indexCount = isVisible(meshlet) ? meshlet.indexCount : 0;
+    command.instanceCount = 1;
+    command.firstIndex = meshlet.indexOffset;
+    command.vertexOffset = 0;
+    command.firstInstance = 0;
+    bDrawCommands.commands[id] = command;
+}
@@ -0,0 +1,52 @@
+#version 450 core
+#pragma shader_stage(compute)
+#extension GL_GOOGLE_include_directive : require
+
+#define PARTICLES_SET 0
+#include "include/Particles2DCommon.glsl"
+
+//Each invocation revives a particle from the dead list, if there's any left, with values from the emitter ranges.
+layout(local_size_x = GROUP_SIZE) in;
+
+vec2 randomRange(inout uint state, vec4 range) {
+    return mix(range.xy, range.zw, vec2(random(state), random(state)));
+}
+
+float randomRange(inout uint state, vec2 range) {
+    return mix(range.x, range.y, random(state));
+}
+
+
+void main() {
+    uint id = gl_GlobalInvocationID.x;
+    if(id >= uEmitterData.emitCount) {
+        return;
+    }
+
+    //Nothing is added to the dead list during emission, so the taken indices are stable.
+    int deadCount = atomicAdd(bCounters.deadCount, -1);
+    if(deadCount <= 0) {
+        atomicAdd(bCounters.deadCount, 1);
+        return;
+    }
+    uint particleIndex = bDeadList.indices[deadCount - 1];
+
+    uint state = pcgHash(pcgHash(uEmitterData.seed) + id);
+
+    Particle particle;
+    particle.position = uEmitterData.emitterPosition + randomRange(state, uEmitterData.positionRange);
+    particle.dimensions = randomRange(state, uEmitterData.dimensionRange);
+    particle.rotationDeg = randomRange(state, uEmitterData.rotationAndLifeRange.xy);
+    particle.tintAndAlpha = mix(uEmitterData.tintAndAlphaMin, uEmitterData.tintAndAlphaMax,
+                                vec4(random(state), random(state), random(state), random(state)));
+    particle.originalAlpha = particle.tintAndAlpha.a;
+    particle.totalLifeSecs = randomRange(state, uEmitterData.rotationAndLifeRange.zw);
+    particle.timeToLiveSecs = particle.totalLifeSecs;
+    particle.velocity = randomRange(state, uEmitterData.velocityRange);
+    particle.angularVelocity = randomRange(state, uEmitterData.angularVelocityRange.xy);
+    particle.acceleration = randomRange(state, uEmitterData.accelerationRange);
+    bParticles.particles[particleIndex] = particle;
+
+    uint aliveIndex = atomicAdd(bCounters.instanceCount, 1);
+    bAliveLists.indices[uEmitterData.nextAliveListOffset + aliveIndex] = particleIndex;
+}
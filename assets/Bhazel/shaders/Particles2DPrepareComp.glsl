@@ -0,0 +1,33 @@
+#version 450 core
+#pragma shader_stage(compute)
+#extension GL_GOOGLE_include_directive : require
+
+#define PARTICLES_SET 0
+#include "include/Particles2DCommon.glsl"
+
+//Starts a simulation step: the particles alive on the last step become the current ones. On reset all the particles
+//are dead, dispatched over maxParticles to fill the dead list.
+layout(local_size_x = GROUP_SIZE) in;
+
+
+void main() {
+    uint id = gl_GlobalInvocationID.x;
+
+    if(uEmitterData.reset != 0) {
+        if(id < uEmitterData.maxParticles) {
+            bDeadList.indices[id] = id;
+        }
+        if(id == 0) {
+            bCounters.vertexCount = 6;
+            bCounters.instanceCount = 0;
+            bCounters.firstVertex = 0;
+            bCounters.firstInstance = 0;
+            bCounters.aliveCount = 0;
+            bCounters.deadCount = int(uEmitterData.maxParticles);
+        }
+    }
+    else if(id == 0) {
+        bCounters.aliveCount = bCounters.instanceCount;
+        bCounters.instanceCount = 0;
+    }
+}
@@ -0,0 +1,39 @@
+#version 450 core
+#pragma shader_stage(compute)
+#extension GL_GOOGLE_include_directive : require
+
+#define PARTICLES_SET 0
+#include "include/Particles2DCommon.glsl"
+
+//Updates the current alive particles. Dead ones go to the dead list, the others are appended to the next alive list.
+layout(local_size_x = GROUP_SIZE) in;
+
+
+void main() {
+    uint id = gl_GlobalInvocationID.x;
+    if(id >= bCounters.aliveCount) {
+        return;
+    }
+
+    uint particleIndex = bAliveLists.indices[uEmitterData.currentAliveListOffset + id];
+    Particle particle = bParticles.particles[particleIndex];
+    float deltaSecs = uEmitterData.deltaSecs;
+
+    //Same steps as Emitter2D::onUpdate(), including the lifetime being decremented before and after the culling.
+    particle.timeToLiveSecs -= deltaSecs;
+    if(particle.timeToLiveSecs <= 0.0) {
+        int deadIndex = atomicAdd(bCounters.deadCount, 1);
+        bDeadList.indices[deadIndex] = particleIndex;
+        return;
+    }
+
+    particle.velocity += particle.acceleration * deltaSecs;
+    particle.position += particle.velocity * deltaSecs;
+    particle.rotationDeg += particle.angularVelocity * deltaSecs;
+    particle.timeToLiveSecs -= deltaSecs;
+    particle.tintAndAlpha.a = particle.originalAlpha * (particle.timeToLiveSecs / particle.totalLifeSecs);
+    bParticles.particles[particleIndex] = particle;
+
+    uint aliveIndex = atomicAdd(bCounters.instanceCount, 1);
+    bAliveLists.indices[uEmitterData.nextAliveListOffset + aliveIndex] = particleIndex;
+}
@@ -0,0 +1,39 @@
+#version 450 core
+#pragma shader_stage(vertex)
+#extension GL_GOOGLE_include_directive : require
+
+#define PARTICLES_SET 2
+#define BUFFER_QUALIFIER readonly
+#include "include/Particles2DCommon.glsl"
+
+layout (set = 0, binding = 0, std140) uniform Constants {
+    mat4 viewProjectionMatrix;
+} uConstants;
+
+layout(location = 0) out vec2 outTexCoord;
+layout(location = 1) flat out uint outColorPacked;
+layout(location = 2) flat out uint outTextureIndex;
+
+//Two triangles per instance, with the same corners as the Renderer2D quads.
+const vec2 QUAD_CORNERS[6] = vec2[](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5),
+                                    vec2(0.5, 0.5), vec2(-0.5, 0.5), vec2(-0.5, -0.5));
+
+
+void main() {
+    uint particleIndex = bAliveLists.indices[uEmitterData.nextAliveListOffset + gl_InstanceIndex];
+    Particle particle = bParticles.particles[particleIndex];
+
+    vec2 corner = QUAD_CORNERS[gl_VertexIndex];
+    float angle = radians(particle.rotationDeg);
+    float c = cos(angle);
+    float s = sin(angle);
+    vec2 local = corner * particle.dimensions;
+    vec2 position = vec2(local.x * c - local.y * s, local.x * s + local.y * c) + particle.position;
+
+    gl_Position = uConstants.viewProjectionMatrix * vec4(position, 0.0, 1.0);
+    outTexCoord = mix(uEmitterData.texCoordRect.xy, uEmitterData.texCoordRect.zw, corner + 0.5);
+
+    //Same packing as Utils::packColor(): ARGB from the most significant byte.
+    outColorPacked = packUnorm4x8(particle.tintAndAlpha.bgra);
+    outTextureIndex = uEmitterData.textureIndex;
+}
@@ -0,0 +1,57 @@
+#version 450 core
+#pragma shader_stage(fragment)
+
+#define LUT_SIZE 16.0
+
+//Needs to match the flags on UberPass. Each combination is a pipeline permutation, disabled effects are compiled out.
+layout(constant_id = 0) const bool bloomEnabled = true;
+layout(constant_id = 1) const bool colorGradingEnabled = true;
+
+layout(location = 0) in vec2 inTexCoord;
+
+layout(set = 0, binding = 0) uniform sampler2D uInputTexSampler;
+
+layout (set = 0, binding = 1, std140) uniform PostProcessConstants {
+    vec4 cameraExposureAndBloomIntensity;
+} uPostProcessConstants;
+
+layout(set = 1, binding = 0) uniform sampler2D uBloomTexSampler;
+layout(set = 2, binding = 0) uniform sampler2D uColorGradingLutSampler;
+
+layout(location = 0) out vec4 outColor;
+
+
+float luma(vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+//The LUT has the blue slices side by side on a 2D strip. Interpolate manually between the two closest slices.
+vec3 colorGrade(vec3 color) {
+    float blue = color.b * (LUT_SIZE - 1.0);
+    float slice0 = floor(blue);
+    float slice1 = min(slice0 + 1.0, LUT_SIZE - 1.0);
+
+    vec2 uv = (color.rg * (LUT_SIZE - 1.0) + 0.5) / vec2(LUT_SIZE * LUT_SIZE, LUT_SIZE);
+    vec3 color0 = texture(uColorGradingLutSampler, uv + vec2(slice0 / LUT_SIZE, 0.0)).rgb;
+    vec3 color1 = texture(uColorGradingLutSampler, uv + vec2(slice1 / LUT_SIZE, 0.0)).rgb;
+    return mix(color0, color1, blue - slice0);
+}
+
+void main() {
+    vec3 hdrColor = texture(uInputTexSampler, inTexCoord).rgb;
+
+    if(bloomEnabled) {
+        vec3 bloom = texture(uBloomTexSampler, inTexCoord).rgb;
+        hdrColor = mix(hdrColor, bloom, uPostProcessConstants.cameraExposureAndBloomIntensity.y);
+    }
+
+    vec3 mapped = vec3(1.0) - exp(-hdrColor * uPostProcessConstants.cameraExposureAndBloomIntensity.x);
+
+    if(colorGradingEnabled) {
+        mapped = colorGrade(mapped);
+    }
+
+    //Compute luma based on gamma space color. Gamma 2.0 is fine for FXAA purposes.
+    float lumaGamma = luma(sqrt(mapped));
+    outColor = vec4(mapped, lumaGamma);
+}
@@ -0,0 +1,26 @@
+#version 450 core
+#pragma shader_stage(fragment)
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 1, binding = 0) uniform sampler2D uTextures[];
+
+layout(location = 0) in vec2 inTexCoord;
+layout(location = 1) flat in uint inColorPacked;
+layout(location = 2) flat in uint inTextureIndex;
+
+layout(location = 0) out vec4 outColor;
+
+vec4 unpackColorInt(uint color) {
+    vec4 vec;
+    vec.a = ((color >> 24) & 255) / 255.0;
+    vec.r = ((color >> 16) & 255) / 255.0;
+    vec.g = ((color >> 8) & 255) / 255.0;
+    vec.b = (color & 255) / 255.0;
+    return vec;
+}
+
+
+void main() {
+    //Sprites with different textures share the same draw call, so the index is not uniform.
+    outColor = texture(uTextures[nonuniformEXT(inTextureIndex)], inTexCoord) * unpackColorInt(inColorPacked);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#version 450 core
+#pragma shader_stage(fragment)
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_nonuniform_qualifier : require
+
+//Same as RendererFrag, but the Material comes from push constants and the textures from the bindless array.
+//The Material is the same for the whole draw call, so the indices are uniform.
+layout(push_constant, std430) uniform MaterialConstants {
+    vec4 normalMetallicRoughnessAndAO;
+    vec4 heightAndUvScale;
+    uvec4 albedoNormalMetallicRoughnessIndices;
+    uvec4 heightAndAOIndices;
+} uMaterialConstants;
+
+layout(set = 5, binding = 0) uniform sampler2D uTextures[];
+
+#define ALBEDO_TEX uTextures[uMaterialConstants.albedoNormalMetallicRoughnessIndices.x]
+#define NORMAL_TEX uTextures[uMaterialConstants.albedoNormalMetallicRoughnessIndices.y]
+#define METALLIC_TEX uTextures[uMaterialConstants.albedoNormalMetallicRoughnessIndices.z]
+#define ROUGHNESS_TEX uTextures[uMaterialConstants.albedoNormalMetallicRoughnessIndices.w]
+#define HEIGHT_TEX uTextures[uMaterialConstants.heightAndAOIndices.x]
+#define AO_TEX uTextures[uMaterialConstants.heightAndAOIndices.y]
+
+#include "include/RendererFragCommon.glsl"
\ No newline at end of file
@@ -21,6 +21,7 @@ layout (set = 1, binding = 0, std140) uniform SceneConstants {
     vec4 dirLightDirectionsAndIntensities[MAX_DIR_LIGHTS_PER_SCENE];
     vec4 dirLightColors[MAX_DIR_LIGHTS_PER_SCENE];
     vec4 cascadeSplits; //View space
+    vec4 clusterScalesAndBiases; //See LightClusterer
     vec2 dirLightCountAndRadianceMapMips;
 } uSceneConstants;
 
@@ -37,8 +38,8 @@ layout(location = 0) out struct {
     //In Light NDC space
     vec3 positionsLightNDC[MAX_DIR_LIGHTS_PER_SCENE * SHADOW_MAPPING_CASCADE_COUNT];
 
-    //View space
-    vec3 positionView;
+    //xyz in world space, w is the view space z
+    vec4 positionWorldAndViewZ;
 
     //From here, all in tangent space
     //vec3 positionTan;
@@ -64,7 +65,7 @@ void main() {
         outData.positionsLightNDC[i] = posLightClip.xyz / posLightClip.w;
     }
 
-    outData.positionView = vec3(uPassConstants.viewMatrix * positionWorld);
+    outData.positionWorldAndViewZ = vec4(positionWorld.xyz, (uPassConstants.viewMatrix * positionWorld).z);
 
     for(int i = 0; i < uSceneConstants.dirLightCountAndRadianceMapMips.x ; ++i) {
         outData.LTan[i] = -normalize(uSceneConstants.dirLightDirectionsAndIntensities[i].xyz * outData.TBN);
@@ -0,0 +1,78 @@
+//Shared by the Particles2D compute and vertex shaders. Not compiled by itself.
+//The includer defines PARTICLES_SET and, on the vertex stage, BUFFER_QUALIFIER as readonly.
+
+#ifndef BUFFER_QUALIFIER
+#define BUFFER_QUALIFIER
+#endif
+
+#define GROUP_SIZE 64
+
+struct Particle {
+    vec2 position;
+    vec2 dimensions;
+    vec2 velocity;
+    vec2 acceleration;
+    vec4 tintAndAlpha;
+    float rotationDeg;
+    float angularVelocity;
+    float timeToLiveSecs;
+    float totalLifeSecs;
+    float originalAlpha;
+};
+
+layout(set = PARTICLES_SET, binding = 0, std140) uniform EmitterData {
+    vec4 positionRange; //Min on xy, max on zw.
+    vec4 dimensionRange;
+    vec4 velocityRange;
+    vec4 accelerationRange;
+    vec4 rotationAndLifeRange; //Rotation min and max on xy, life min and max on zw.
+    vec4 angularVelocityRange; //Min and max on xy.
+    vec4 tintAndAlphaMin;
+    vec4 tintAndAlphaMax;
+    vec4 texCoordRect;
+    vec2 emitterPosition;
+    float deltaSecs;
+    uint emitCount;
+    uint maxParticles;
+    uint seed;
+    uint currentAliveListOffset; //Particles of the last step, read by the simulation.
+    uint nextAliveListOffset; //Particles of this step, written by simulation and emission and drawn.
+    uint textureIndex;
+    uint reset;
+} uEmitterData;
+
+layout(set = PARTICLES_SET, binding = 1, std430) BUFFER_QUALIFIER buffer Particles {
+    Particle particles[];
+} bParticles;
+
+//Two lists of maxParticles indices, ping-ponged every step.
+layout(set = PARTICLES_SET, binding = 2, std430) BUFFER_QUALIFIER buffer AliveLists {
+    uint indices[];
+} bAliveLists;
+
+layout(set = PARTICLES_SET, binding = 3, std430) BUFFER_QUALIFIER buffer DeadList {
+    uint indices[];
+} bDeadList;
+
+//Starts with a VkDrawIndirectCommand, its instanceCount is the size of the next alive list.
+layout(set = PARTICLES_SET, binding = 4, std430) BUFFER_QUALIFIER buffer Counters {
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+    uint aliveCount;
+    int deadCount;
+} bCounters;
+
+//Same as ParticleRandom2D on the CPU.
+uint pcgHash(uint value) {
+    uint state = value * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+//On [0, 1].
+float random(inout uint state) {
+    state = pcgHash(state);
+    return float(state) / 4294967295.0;
+}
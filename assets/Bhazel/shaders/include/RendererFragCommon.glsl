@@ -0,0 +1,315 @@
+//Shared by RendererFrag and RendererBindlessFrag. Not compiled by itself.
+//The includer declares uMaterialConstants and the ALBEDO_TEX, NORMAL_TEX, METALLIC_TEX, ROUGHNESS_TEX, HEIGHT_TEX
+//and AO_TEX samplers.
+
+#define MAX_DIR_LIGHTS_PER_SCENE 2
+#define SHADOW_MAPPING_CASCADE_COUNT 4
+
+//Froxel grid of the LightClusterer
+#define CLUSTER_COUNT_X 16
+#define CLUSTER_COUNT_Y 9
+#define CLUSTER_COUNT_Z 24
+
+layout(set = 0, binding = 0) uniform sampler2D uBrdfLookupTexture;
+
+layout (set = 1, binding = 0, std140) uniform SceneConstants {
+    mat4 lightMatrices[MAX_DIR_LIGHTS_PER_SCENE * SHADOW_MAPPING_CASCADE_COUNT];
+    vec4 dirLightDirectionsAndIntensities[MAX_DIR_LIGHTS_PER_SCENE];
+    vec4 dirLightColors[MAX_DIR_LIGHTS_PER_SCENE];
+    vec4 cascadeSplits; //View space
+    vec4 clusterScalesAndBiases; //See LightClusterer
+    float dirLightCount;
+} uSceneConstants;
+
+layout(set = 1, binding = 1) uniform samplerCube uIrradianceMapTexSampler;
+layout(set = 1, binding = 2) uniform samplerCube uRadianceMapTexSampler;
+layout(set = 1, binding = 3) uniform sampler2DArrayShadow uShadowMapSamplers[MAX_DIR_LIGHTS_PER_SCENE];
+
+//Point and Spot Lights. Point Lights have a spot scale of 0 and offset of 1, so the cone never attenuates them.
+struct LocalLight {
+    vec4 positionAndRadius; //World space
+    vec4 colorAndSpotOffset; //Color premultiplied by the intensity
+    vec4 directionAndSpotScale; //World space
+};
+
+layout(set = 1, binding = 4, std430) readonly buffer LocalLights {
+    LocalLight lights[];
+} uLocalLights;
+
+//Offset on uLightIndices and light count of each froxel.
+layout(set = 1, binding = 5, std430) readonly buffer Clusters {
+    uvec2 offsetsAndCounts[];
+} uClusters;
+
+layout(set = 1, binding = 6, std430) readonly buffer LightIndices {
+    uint indices[];
+} uLightIndices;
+
+layout(location = 0) in struct {
+    //TBN matrix goes from tangent space to world space
+    mat3 TBN;
+    vec2 texCoord;
+
+    //In Light NDC space
+    vec3 positionsLightNDC[MAX_DIR_LIGHTS_PER_SCENE * SHADOW_MAPPING_CASCADE_COUNT];
+
+    //xyz in world space, w is the view space z
+    vec4 positionWorldAndViewZ;
+
+    //From here, all in tangent space
+    //vec3 positionTan;
+    vec3 LTan[MAX_DIR_LIGHTS_PER_SCENE];
+    vec3 VTan;
+} inData;
+
+layout(location = 0) out vec4 outColor;
+
+#define PI 3.14159265359
+
+//One per bit of Material::getFeatureBits(). Each Material draws with a pipeline permutation where these are known,
+//so the unused texture fetches and branches are compiled out.
+layout(constant_id = 0) const bool hasNormalMap = true;
+layout(constant_id = 1) const bool hasMetallicMap = true;
+layout(constant_id = 2) const bool hasRoughnessMap = true;
+layout(constant_id = 3) const bool hasHeightMap = true;
+layout(constant_id = 4) const bool hasAOMap = true;
+
+//Set by the Renderer, after the feature bits.
+layout(constant_id = 5) const int parallaxLayerCount = 10;
+
+
+vec2 parallaxOcclusionMap(vec2 texCoord, vec3 viewDirTangentSpace) {
+    if(!hasHeightMap)
+        return texCoord;
+
+    const float LAYERS = float(parallaxLayerCount);
+    float layerDepth = 1.0 / LAYERS;
+    float currentLayerDepth = 0.0;
+
+    vec2 P = viewDirTangentSpace.xy * uMaterialConstants.heightAndUvScale.x;
+    vec2 deltaTexCoords = P / LAYERS;
+
+    vec2  currentTexCoords = texCoord;
+    float currentDepthMapValue = 1.0 - texture(HEIGHT_TEX, currentTexCoords).r;
+    
+    while(currentLayerDepth < currentDepthMapValue) {
+        currentTexCoords -= deltaTexCoords;
+        currentDepthMapValue = 1.0 - texture(HEIGHT_TEX, currentTexCoords).r;
+        currentLayerDepth += layerDepth;
+    }
+
+    vec2 prevTexCoords = currentTexCoords + deltaTexCoords;
+
+    float afterDepth  = currentDepthMapValue - currentLayerDepth;
+    float beforeDepth = (1.0 - texture(HEIGHT_TEX, prevTexCoords).r) - currentLayerDepth + layerDepth;
+    
+    float weight = afterDepth / (afterDepth - beforeDepth);
+    vec2 ret = prevTexCoords * weight + currentTexCoords * (1.0 - weight);
+
+    const vec2 uvScale = uMaterialConstants.heightAndUvScale.yz;
+    if(ret.x > uvScale.x || ret.y > uvScale.y || ret.x < 0.0 || ret.y < 0.0)
+        discard;
+
+    return ret;
+}
+
+vec3 fresnelSchlick(float HdotV, vec3 F0) {
+    return F0 + (1.0 - F0) * pow(1.0 - HdotV, 5.0);
+}
+
+float distributionGGX(float NdotH, float roughness) {
+    float a = roughness * roughness;
+    float a2 = a * a;
+    float NdotH2 = NdotH * NdotH;
+    
+    float denom = max(NdotH2 * (a2 - 1.0) + 1.0, 0.001);
+    denom = PI * denom * denom;
+    return a2 / denom;
+}
+
+float geometrySchlickGGX(float NdotV, float roughness) {
+    float r = (roughness + 1.0);
+    float k = (r * r) / 8.0;
+    float denom = NdotV * (1.0 - k) + k;
+    return NdotV / denom;
+}
+
+float geometrySmith(float NdotV, float NdotL, float roughness) {
+    float ggx2  = geometrySchlickGGX(NdotV, roughness);
+    float ggx1  = geometrySchlickGGX(NdotL, roughness);
+    return ggx1 * ggx2;
+}
+
+//Cook-Torrance
+vec3 directLight(vec3 N, vec3 V, vec3 L, vec3 albedo, vec3 F0, float roughness, vec3 lightRadiance, vec2 texCoord) {
+    vec3 H = normalize(V + L);
+
+    float NdotV = max(dot(N, V), 0.0);
+    float NdotL = max(dot(N, L), 0.0);
+    float HdotV = max(dot(H, V), 0.0);
+    float NdotH = max(dot(N, H), 0.0);
+
+    vec3 F = fresnelSchlick(HdotV, F0);
+
+    float G = geometrySmith(NdotV, NdotL, roughness);
+    float NDF = distributionGGX(NdotH, roughness);
+
+    vec3 specular = (NDF * G * F) / max((4.0 * NdotV * NdotL), 0.001);
+
+    vec3 kDiffuse = 1.0 - F;
+
+    //return (kDiffuse * albedo / PI + specular) * PI * lightRadiance * NdotL; Simplify to:
+    return (kDiffuse * albedo + specular * PI) * lightRadiance * NdotL;
+}
+
+vec3 indirectLight(vec3 N, vec3 V, vec3 F0, vec3 albedo, float roughness, vec2 texCoord) {
+    float NdotV = max(dot(N, V), 0.0);
+
+    vec3 F = fresnelSchlick(NdotV, F0);
+    vec3 kSpecular = F;
+    vec3 kDiffuse = 1.0 - kSpecular;
+
+    vec3 cubeDirection = normalize(inData.TBN * N);
+    cubeDirection.z = -cubeDirection.z;
+
+    vec3 irradiance = texture(uIrradianceMapTexSampler, cubeDirection).rgb;
+    vec3 diffuse = albedo * irradiance;
+
+    vec3 R = reflect(-V, N);
+    vec3 worldR = normalize(inData.TBN * R);
+    worldR.z = -worldR.z;
+
+    int radianceMapMips = textureQueryLevels(uRadianceMapTexSampler);
+    vec3 radiance = textureLod(uRadianceMapTexSampler, worldR, roughness * float(radianceMapMips)).rgb;
+    vec2 envBRDF = texture(uBrdfLookupTexture, vec2(NdotV, roughness)).rg;
+    vec3 specular = radiance * (F * envBRDF.x + envBRDF.y);
+
+    float ao = hasAOMap ? texture(AO_TEX, texCoord).r : 1.0f;
+    return (kDiffuse * diffuse + specular) * ao; 
+}
+
+int findShadowMapCascade() {
+    for(int cascadeIdx = 0; cascadeIdx < SHADOW_MAPPING_CASCADE_COUNT; ++cascadeIdx) {
+        if(inData.positionWorldAndViewZ.w > uSceneConstants.cascadeSplits[cascadeIdx])
+            return cascadeIdx;
+    }
+}
+
+uvec2 findCluster() {
+    vec4 scalesAndBiases = uSceneConstants.clusterScalesAndBiases;
+    float viewDepth = -inData.positionWorldAndViewZ.w;
+
+    uvec3 cluster;
+    cluster.xy = uvec2(gl_FragCoord.xy * scalesAndBiases.xy);
+    cluster.z = uint(max(log(viewDepth) * scalesAndBiases.z + scalesAndBiases.w, 0.0));
+    cluster = min(cluster, uvec3(CLUSTER_COUNT_X - 1, CLUSTER_COUNT_Y - 1, CLUSTER_COUNT_Z - 1));
+    return uClusters.offsetsAndCounts[(cluster.z * CLUSTER_COUNT_Y + cluster.y) * CLUSTER_COUNT_X + cluster.x];
+}
+
+vec3 localLights(vec3 N, vec3 V, vec3 albedo, vec3 F0, float roughness, vec2 texCoord) {
+    uvec2 offsetAndCount = findCluster();
+
+    vec3 col = vec3(0.0);
+    for(uint i = 0; i < offsetAndCount.y; ++i) {
+        LocalLight light = uLocalLights.lights[uLightIndices.indices[offsetAndCount.x + i]];
+
+        vec3 toLight = light.positionAndRadius.xyz - inData.positionWorldAndViewZ.xyz;
+        float distanceSq = dot(toLight, toLight);
+        float radiusSq = light.positionAndRadius.w * light.positionAndRadius.w;
+        if(distanceSq >= radiusSq)
+            continue;
+
+        vec3 LWorld = toLight * inversesqrt(distanceSq);
+
+        //Inverse square falloff, windowed to reach zero at the radius.
+        float window = clamp(1.0 - (distanceSq * distanceSq) / (radiusSq * radiusSq), 0.0, 1.0);
+        float spot = clamp(dot(-LWorld, light.directionAndSpotScale.xyz) * light.directionAndSpotScale.w + light.colorAndSpotOffset.w, 0.0, 1.0);
+        float attenuation = window * window * spot * spot / max(distanceSq, 0.0001);
+
+        //Multiply on the left is equal to multiply with the transpose. So transforming from world to tangent space.
+        vec3 L = normalize(LWorld * inData.TBN);
+        col += directLight(N, V, L, albedo, F0, roughness, light.colorAndSpotOffset.rgb * attenuation, texCoord);
+    }
+    return col;
+}
+
+float shadowMapping(int lightIdx, int cascadeIdx) {
+    //Try to use cascade i - 1 even if we are on cascade i. Possible because the interceptions between cascades.
+    int previousCascade = max(0, cascadeIdx - 1);
+    for(int i = previousCascade; i <= cascadeIdx; ++i) {
+        vec3 posLightNDC = inData.positionsLightNDC[i + lightIdx * SHADOW_MAPPING_CASCADE_COUNT];
+
+        if(posLightNDC.x < -1.0 || posLightNDC.x > 1.0 ||
+           posLightNDC.y < -1.0 || posLightNDC.y > 1.0 ||
+           posLightNDC.z < 0.0 || posLightNDC.z > 1.0) {
+            continue;
+        }
+        else {
+            vec2 shadowMapTexCoord = posLightNDC.xy * 0.5 + 0.5;
+            vec4 coordLayerAndCompare = vec4(shadowMapTexCoord, float(i), posLightNDC.z);
+            return texture(uShadowMapSamplers[lightIdx], coordLayerAndCompare);
+        }
+    }
+    return 1.0;
+}
+
+//float shadowMapping2(int lightIdx, int cascadeIdx) {
+//    vec3 posLightNDC = inData.positionsLightNDC[0];
+//
+//    vec2 shadowMapTexCoord = posLightNDC.xy * 0.5 + 0.5;
+//    //In Vulkan texCoord y=0 is the top line. This texture was not flipped by Bhazel like the ones loaded from disk, so flip it here.
+//    shadowMapTexCoord.y = 1.0 - shadowMapTexCoord.y;
+//
+//    vec4 coordLayerAndCompare = vec4(shadowMapTexCoord, 0.0, posLightNDC.z);
+//    return texture(uShadowMapSamplers[lightIdx], coordLayerAndCompare);
+//}
+
+vec3 lighting(vec3 N, vec3 V, vec2 texCoord) {
+    vec3 albedo = texture(ALBEDO_TEX, texCoord).rgb;
+    float metallic = hasMetallicMap ? texture(METALLIC_TEX, texCoord).r : uMaterialConstants.normalMetallicRoughnessAndAO.y;
+    float roughness = hasRoughnessMap ? texture(ROUGHNESS_TEX, texCoord).r : uMaterialConstants.normalMetallicRoughnessAndAO.z;
+
+    //Hardcoded reflectance for dielectrics
+    vec3 F0 = mix(vec3(0.04), albedo, metallic);
+
+    vec3 col = indirectLight(N, V, F0, albedo, roughness, texCoord);
+    int cascadeIdx = findShadowMapCascade();
+
+    for(int lightIdx = 0; lightIdx < int(uSceneConstants.dirLightCount); ++lightIdx) {
+        //No need to normalize, it was done on VS and the direction is constant.
+        vec3 L = inData.LTan[lightIdx];
+
+        float shadow = shadowMapping(lightIdx, cascadeIdx);
+        col += shadow * directLight(N, V, L, albedo, F0, roughness, uSceneConstants.dirLightColors[lightIdx].xyz * uSceneConstants.dirLightDirectionsAndIntensities[lightIdx].w, texCoord);
+    }
+
+    col += localLights(N, V, albedo, F0, roughness, texCoord);
+    return col;
+}
+
+/*vec3 cascadeColor(int cascade) {
+    if(cascade==0) return vec3(1,0,0);
+    if(cascade==1) return vec3(1,1,0);
+    if(cascade==2) return vec3(0,1,0);
+    if(cascade==3) return vec3(0.5,0.5,0.5);
+}
+
+vec3 debugCascades() {
+    for(int cascade = 0; cascade < SHADOW_MAPPING_CASCADE_COUNT; ++cascade) {
+        if(inData.positionWorldAndViewZ.w > uSceneConstants.cascadeSplits[cascade]) {
+            return cascadeColor(cascade);
+        }
+    }
+}*/
+
+void main() {
+    vec3 V = normalize(inData.VTan);
+
+    const vec2 uvScale = uMaterialConstants.heightAndUvScale.yz;
+    vec2 texCoord = parallaxOcclusionMap(inData.texCoord * uvScale, V);
+
+    vec3 N = hasNormalMap ? normalize(texture(NORMAL_TEX, texCoord).rgb * 2.0 - 1.0) : vec3(0.0, 0.0, 1.0);
+
+    vec3 col = lighting(N, V, texCoord);
+    outColor = vec4(col, 1.0);
+}
\ No newline at end of file
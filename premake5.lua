@@ -38,6 +38,7 @@ include "Bhazel"
 include "BhazelEd"
 include "Sandbox"
 include "BrickBreaker"
+include "BhazelTests"
 include "Bhazel/vendor/glfw_premake5.lua"
 include "Bhazel/vendor/imgui_premake5.lua"
 include "Bhazel/vendor/stb_image"
\ No newline at end of file